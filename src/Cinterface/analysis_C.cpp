@@ -120,3 +120,14 @@ C_INTERFACE CalculateAndStoreStepTypes(
 
 	return OK;
 }
+
+C_INTERFACE CalculateAndStoreClearance(
+	HF::SpatialStructures::Graph* g,
+	HF::RayTracer::EmbreeRayTracer* ray_tracer,
+	const char* attribute,
+	float height,
+	float max_distance)
+{
+	HF::GraphGenerator::CalculateAndStoreClearance(*g, *ray_tracer, std::string(attribute), height, max_distance);
+	return OK;
+}
@@ -241,6 +241,27 @@ C_INTERFACE CalculateAndStoreStepTypes(
 	HF::SpatialStructures::Graph* g,
 	HF::RayTracer::EmbreeRayTracer* ray_tracer
 );
+
+/*!
+	\brief		Calculate the distance from every node in a graph to the nearest wall or obstacle, and store it as a node attribute.
+
+	\param		g						Graph to calculate the clearance of.
+	\param		ray_tracer				Raytracer containing the geometry the graph was generated on.
+	\param		attribute				Name of the node attribute to store the clearance in.
+	\param		height					Height above each node to measure clearance from.
+	\param		max_distance			Maximum clearance to search for. Set to -1 for infinite distance.
+
+	\returns	\link HF_STATUS::OK \endlink on completion.
+
+	\see HF::GraphGenerator::CalculateAndStoreClearance
+*/
+C_INTERFACE CalculateAndStoreClearance(
+	HF::SpatialStructures::Graph* g,
+	HF::RayTracer::EmbreeRayTracer* ray_tracer,
+	const char* attribute,
+	float height,
+	float max_distance
+);
 /**@}*/ 
 
 #endif /* ANALYSIS_C_H */
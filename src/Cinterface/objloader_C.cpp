@@ -56,6 +56,45 @@ C_INTERFACE LoadOBJ(
 	return HF_STATUS::OK;
 }
 
+C_INTERFACE LoadMeshFile(
+	const char* path,
+	HF::Geometry::GROUP_METHOD gm,
+	float xrot,
+	float yrot,
+	float zrot,
+	MeshInfo<float> *** out_data_array,
+	int* num_meshes
+) {
+	std::string filepath(path);
+
+	try {
+		// Pick a loader based on the file's extension
+		auto loaded_meshes = HF::Geometry::LoadMeshFile(filepath, gm, false);
+
+		*num_meshes = loaded_meshes.size();
+		for (auto& mesh : loaded_meshes)
+			mesh.PerformRotation(xrot, yrot, zrot);
+
+		// Move the meshes into the output array, since their buffers may be large
+		MeshInfo<float> ** data_array = new MeshInfo<float>*[*num_meshes];
+		for (int i = 0; i < *num_meshes; i++)
+			data_array[i] = new MeshInfo<float>(std::move(loaded_meshes[i]));
+		*out_data_array = data_array;
+
+		return HF_STATUS::OK;
+	}
+	catch (const HF::Exceptions::InvalidOBJ & e) {
+		return HF_STATUS::INVALID_OBJ;
+	}
+	catch (const HF::Exceptions::FileNotFound & e) {
+		return HF_STATUS::NOT_FOUND;
+	}
+	catch (...) {
+		std::cerr << "Generic Error" << std::endl;
+		return HF_STATUS::GENERIC_ERROR;
+	}
+}
+
 C_INTERFACE StoreMesh(
 	MeshInfo<float> ** out_info,
 	const int* indices,
@@ -148,6 +148,42 @@ C_INTERFACE LoadOBJ(
 	int * num_meshes
 );
 
+/*!
+	\brief Load the meshes in a PLY, STL, glTF, GLB or OBJ file, then rotate them by x, y, and z
+
+	\param path Filepath to the file to load. Its extension decides which loader is used.
+	\param gm Method to use for dividing an OBJ into multiple meshes. Ignored for other formats.
+	\param xrot Degrees to rotate the meshes on the x axis.
+	\param yrot Degrees to rotate the meshes on the y axis.
+	\param zrot Degrees to rotate the meshes on the z axis.
+	\param out_data_array Output parameter for the new array of meshinfo
+	\param num_meshes Output parameter for size of `out_data_array`
+
+	\returns `HF_STATUS::OK` If the file was loaded successfully
+	\returns `HF_STATUS::GENERIC_ERROR` If an unexpected error occurred while reading the file.
+	\returns `HF_STATUS::INVALID_OBJ` if the extension isn't supported, or the file couldn't be read by its loader.
+	\returns `HF_STATUS::NOT_FOUND` if the file at the given path couldn't be found.
+
+	\details
+	glTF and GLB files produce a mesh for every node with triangles, where each mesh's ID is the index
+	of its node in the file. The other formats are loaded the same way as HF::Geometry::LoadMeshFile.
+
+	\attention
+	Call DestroyMeshInfoPtrArray to deallocate out_data_array, and call DestroyMeshInfo on each
+	instance of MeshInfo to deallocate them individually, just like \link LoadOBJ \endlink.
+
+	\see HF::Geometry::LoadPLY, HF::Geometry::LoadSTL, HF::Geometry::LoadGLTF
+*/
+C_INTERFACE LoadMeshFile(
+	const char* path,
+	HF::Geometry::GROUP_METHOD gm,
+	float xrot,
+	float yrot,
+	float zrot,
+	HF::Geometry::MeshInfo<float> *** out_data_array,
+	int * num_meshes
+);
+
 /*!
 	\brief Store a mesh in a format usable with DHARTAPI
 	
@@ -9,6 +9,8 @@
 #include <path.h>
 #include <numeric>
 #include <boost_graph.h>
+#include <csr_path_finder.h>
+#include <contraction_hierarchy.h>
 
 using std::unique_ptr;
 using std::make_unique;
@@ -22,11 +24,19 @@ using HF::Exceptions::HF_STATUS;
 using namespace HF::Pathfinding;
 
 
-C_INTERFACE CreatePath(
+/*!
+	\brief Create a boost graph from `g` then use `path_func` to find a path between start and end.
+
+	\details Shared implementation of CreatePath and its variants, which only differ in the algorithm
+	used to find the path.
+*/
+template <typename path_func_t>
+inline int CreatePathWith(
+	path_func_t path_func,
 	const HF::SpatialStructures::Graph* g,
 	int start,
 	int end,
-	const char * cost_type,
+	const char* cost_type,
 	int* out_size,
 	HF::SpatialStructures::Path** out_path,
 	HF::SpatialStructures::PathMember** out_data
@@ -51,7 +61,7 @@ C_INTERFACE CreatePath(
 	Path* P = new Path();
 
 	// Generate a path using the boost graph we just created.
-	*P = FindPath(bg.get(), start, end);
+	*P = path_func(bg.get(), start, end);
 
 	// If P isn't empty, set our output pointer to it
 	if (!P->empty()) {
@@ -69,8 +79,230 @@ C_INTERFACE CreatePath(
 	}
 }
 
-C_INTERFACE CreatePaths(
+C_INTERFACE CreatePath(
+	HF::SpatialStructures::Graph* g,
+	int start,
+	int end,
+	const char * cost_type,
+	int* out_size,
+	HF::SpatialStructures::Path** out_path,
+	HF::SpatialStructures::PathMember** out_data
+) {
+	Path* P;
+	try {
+		// Search the graph's CSR directly instead of copying it into a boost graph.
+		// The path finder reads the CSR, so the graph must be compressed first.
+		g->Compress();
+		CSRPathFinder path_finder(*g, std::string(cost_type));
+		P = new Path(path_finder.FindPath(start, end));
+	}
+	catch (HF::Exceptions::NoCost) {
+		return HF::Exceptions::HF_STATUS::NO_COST;
+	}
+	catch (...) {
+		return HF::Exceptions::GENERIC_ERROR;
+	}
+
+	// If P isn't empty, set our output pointer to it
+	if (!P->empty()) {
+		*out_path = P;
+		*out_data = P->GetPMPointer();
+		*out_size = P->size();
+		return HF::Exceptions::HF_STATUS::OK;
+	}
+
+	// Otherwise, free the memory for it and signal that no path
+	// could be found
+	else {
+		delete P;
+		return HF::Exceptions::HF_STATUS::NO_PATH;
+	}
+}
+
+C_INTERFACE CreatePathAStar(
+	const HF::SpatialStructures::Graph* g,
+	int start,
+	int end,
+	int* out_size,
+	HF::SpatialStructures::Path** out_path,
+	HF::SpatialStructures::PathMember** out_data
+) {
+	// The straight line heuristic is only valid for the graph's default cost
+	return CreatePathWith(FindPathAStar, g, start, end, "", out_size, out_path, out_data);
+}
+
+C_INTERFACE CreatePathBidirectional(
 	const HF::SpatialStructures::Graph* g,
+	int start,
+	int end,
+	const char* cost_type,
+	int* out_size,
+	HF::SpatialStructures::Path** out_path,
+	HF::SpatialStructures::PathMember** out_data
+) {
+	return CreatePathWith(FindPathBidirectional, g, start, end, cost_type, out_size, out_path, out_data);
+}
+
+C_INTERFACE CalculateNearestSources(
+	const Graph* g,
+	const int* source_ids,
+	int num_sources,
+	const char* cost_type,
+	float max_cost,
+	bool reverse,
+	vector<float>** out_dist_vector,
+	float** out_dist_data,
+	vector<int>** out_source_vector,
+	int** out_source_data,
+	vector<int>** out_pred_vector,
+	int** out_pred_data
+) {
+	try {
+		auto bg = CreateBoostGraph(*g, string(cost_type));
+
+		const vector<int> sources(source_ids, source_ids + num_sources);
+		NearestSources nearest = FindNearestSources(bg.get(), sources, max_cost, reverse);
+
+		// Move the results into vectors owned by the caller
+		*out_dist_vector = new vector<float>(std::move(nearest.distance));
+		*out_source_vector = new vector<int>(std::move(nearest.source));
+		*out_pred_vector = new vector<int>(std::move(nearest.predecessor));
+
+		*out_dist_data = (*out_dist_vector)->data();
+		*out_source_data = (*out_source_vector)->data();
+		*out_pred_data = (*out_pred_vector)->data();
+	}
+	catch (HF::Exceptions::NoCost) {
+		return HF_STATUS::NO_COST;
+	}
+
+	return HF_STATUS::OK;
+}
+
+C_INTERFACE CalculateReachable(
+	const Graph* g,
+	const int* source_ids,
+	int num_sources,
+	const char* cost_type,
+	float max_cost,
+	bool reverse,
+	vector<int>** out_node_vector,
+	int** out_node_data,
+	vector<float>** out_cost_vector,
+	float** out_cost_data,
+	int* out_size
+) {
+	try {
+		auto bg = CreateBoostGraph(*g, string(cost_type));
+
+		const vector<int> sources(source_ids, source_ids + num_sources);
+		const auto reachable = FindReachable(bg.get(), sources, max_cost, reverse);
+
+		// Split the reachable nodes into separate arrays of IDs and costs
+		*out_node_vector = new vector<int>(reachable.size());
+		*out_cost_vector = new vector<float>(reachable.size());
+		for (int i = 0; i < reachable.size(); i++) {
+			(**out_node_vector)[i] = reachable[i].node;
+			(**out_cost_vector)[i] = reachable[i].cost;
+		}
+
+		*out_node_data = (*out_node_vector)->data();
+		*out_cost_data = (*out_cost_vector)->data();
+		*out_size = static_cast<int>(reachable.size());
+	}
+	catch (HF::Exceptions::NoCost) {
+		return HF_STATUS::NO_COST;
+	}
+
+	return HF_STATUS::OK;
+}
+
+C_INTERFACE CreateContractionHierarchy(
+	Graph* g,
+	const char* cost_type,
+	ContractionHierarchy** out_ch
+) {
+	try {
+		// The hierarchy is built from the graph's CSR, so the graph must be compressed first
+		g->Compress();
+		*out_ch = new ContractionHierarchy(*g, string(cost_type));
+	}
+	catch (HF::Exceptions::NoCost) {
+		return HF_STATUS::NO_COST;
+	}
+	catch (...) {
+		return HF_STATUS::GENERIC_ERROR;
+	}
+
+	return HF_STATUS::OK;
+}
+
+C_INTERFACE SaveContractionHierarchy(const ContractionHierarchy* ch, const char* path) {
+	return ch->SaveBinary(string(path)) ? HF_STATUS::OK : HF_STATUS::GENERIC_ERROR;
+}
+
+C_INTERFACE LoadContractionHierarchy(const char* path, ContractionHierarchy** out_ch) {
+	try {
+		*out_ch = new ContractionHierarchy(ContractionHierarchy::LoadBinary(string(path)));
+	}
+	catch (HF::Exceptions::FileNotFound) {
+		return HF_STATUS::NOT_FOUND;
+	}
+	catch (...) {
+		return HF_STATUS::GENERIC_ERROR;
+	}
+
+	return HF_STATUS::OK;
+}
+
+C_INTERFACE CreatePathCH(
+	const ContractionHierarchy* ch,
+	int start,
+	int end,
+	int* out_size,
+	Path** out_path,
+	PathMember** out_data
+) {
+	Path* P = new Path(ch->FindPath(start, end));
+
+	// If P isn't empty, set our output pointer to it
+	if (!P->empty()) {
+		*out_path = P;
+		*out_data = P->GetPMPointer();
+		*out_size = P->size();
+		return HF_STATUS::OK;
+	}
+
+	// Otherwise, free the memory for it and signal that no path
+	// could be found
+	delete P;
+	return HF_STATUS::NO_PATH;
+}
+
+C_INTERFACE CreatePathsCH(
+	const ContractionHierarchy* ch,
+	const int* start_ids,
+	const int* end_ids,
+	Path** out_path_ptr_holder,
+	PathMember** out_path_member_ptr_holder,
+	int* out_sizes,
+	int num_paths
+) {
+	vector<int> starts(start_ids, start_ids + num_paths);
+	vector<int> ends(end_ids, end_ids + num_paths);
+
+	ch->InsertPathsIntoArray(starts, ends, out_path_ptr_holder, out_path_member_ptr_holder, out_sizes);
+
+	return HF_STATUS::OK;
+}
+
+C_INTERFACE DestroyContractionHierarchy(ContractionHierarchy* ch) {
+	DeleteRawPtr(ch);
+	return HF_STATUS::OK;
+}
+
+C_INTERFACE CreatePaths(
+	HF::SpatialStructures::Graph* g,
 	const int* start,
 	const int* end,
 	const char* cost_type,
@@ -83,13 +315,20 @@ C_INTERFACE CreatePaths(
 	vector<int> starts(start, start + num_paths);
 	vector<int> ends(end, end + num_paths);
 
-	// Get a boost graph from *g
-	std::unique_ptr<BoostGraph, BoostGraphDeleter> bg;
-	
 	try {
 		// If cost_name is not a valid cost type in *g,
-		// std::out_of_range is thrown by Graph::GetEdges
-		bg = CreateBoostGraph(*g, std::string(cost_type));
+		// HF::Exceptions::NoCost is thrown by Graph::GetCSRPointers
+		g->Compress();
+		CSRPathFinder path_finder(*g, std::string(cost_type));
+
+		// Find all the asked for paths
+		path_finder.InsertPathsIntoArray(
+			starts,
+			ends,
+			out_path_ptr_holder,
+			out_path_member_ptr_holder,
+			out_sizes
+		);
 	}
 	catch (HF::Exceptions::NoCost) {
 		return HF::Exceptions::HF_STATUS::NO_COST;
@@ -98,16 +337,6 @@ C_INTERFACE CreatePaths(
 		return HF::Exceptions::HF_STATUS::GENERIC_ERROR;
 	}
 
-	// Find all the asked for paths
-	InsertPathsIntoArray(
-		bg.get(),
-		starts,
-		ends,
-		out_path_ptr_holder,
-		out_path_member_ptr_holder,
-		out_sizes
-	);
-
 	return HF::Exceptions::HF_STATUS::OK;
 }
 
@@ -246,6 +475,39 @@ C_INTERFACE CreateAllPredToPath(
 
 }
 
+C_INTERFACE CalculateDistanceMatrixToFile(
+	const Graph* g,
+	const char* cost_name,
+	const char* path,
+	int format,
+	float scale,
+	bool upper_triangle,
+	int tile_rows
+) {
+	try {
+		auto bg = CreateBoostGraph(*g, string(cost_name));
+
+		const bool written = WriteDistanceMatrix(
+			*bg.get(),
+			string(path),
+			static_cast<DISTANCE_FORMAT>(format),
+			scale,
+			upper_triangle,
+			tile_rows
+		);
+
+		if (!written) return HF_STATUS::NOT_FOUND;
+	}
+	catch (HF::Exceptions::NoCost) {
+		return HF_STATUS::NO_COST;
+	}
+	catch (const std::out_of_range&) {
+		return HF_STATUS::OUT_OF_RANGE;
+	}
+
+	return HF_STATUS::OK;
+}
+
 
 
 //C_INTERFACE CreateAllPredToPath(
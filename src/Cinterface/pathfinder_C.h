@@ -19,7 +19,7 @@
 
 namespace HF {
 	namespace SpatialStructures { class Graph; class Path; class PathMember; }
-	namespace Pathfinding { class BoostGraph; }
+	namespace Pathfinding { class BoostGraph; class ContractionHierarchy; }
 }
 
 /*!
@@ -200,7 +200,7 @@ namespace HF {
 /*!
 	\brief	 Find the shortest path from start to end.
 
-	\param	g			The graph to conduct the search on.
+	\param	g			The graph to conduct the search on. Compressed if it isn't already.
 	\param	start		Start node of the path.
 	\param	end			End node of the path.
 
@@ -215,6 +215,9 @@ namespace HF {
 	\returns			`HF_STATUS::NO_PATH` No path could be found
 	\returns			`HF_STATUS::NO_COST` `cost_name` is not an empty string or the key of a cost that already exists in G
 
+	\details The path is found directly in the CSR of `g` by a HF::Pathfinding::CSRPathFinder,
+	so `g` isn't copied.
+
 	\pre 1) `start` and `end` contain both contain the Ids of nodes already in the graph
 	\pre 2) If not set to the empty string, `cost_name` is the key to a valid cost type already defined in `g`.
 
@@ -257,7 +260,7 @@ namespace HF {
 	`>>> Total path cost: 77.6772`\n
 */
 C_INTERFACE CreatePath(
-	const HF::SpatialStructures::Graph* g,
+	HF::SpatialStructures::Graph* g,
 	int start,
 	int end,
 	const char * cost_type,
@@ -266,10 +269,299 @@ C_INTERFACE CreatePath(
 	HF::SpatialStructures::PathMember** out_data
 );
 
+/*!
+	\brief	 Find the shortest path from start to end using A*.
+
+	\param	g			The graph to conduct the search on.
+	\param	start		Start node of the path.
+	\param	end			End node of the path.
+	\param	out_size	Updated to the length of the found path on success. Set to 0 if no path could be found.
+	\param	out_path	Output parameter for a pointer to the generated path. Will be null if no path could be found
+	\param	out_data	Output parameter for a pointer to the data of the generated path. Will be null if no path could be found.
+
+	\returns			`HF_STATUS::OK` The function completed successfully. 
+	\returns			`HF_STATUS::NO_PATH` No path could be found
+
+	\details
+	Uses the straight line distance between each node and `end` to search towards `end` first, and stops
+	as soon as `end` is reached. This is much faster than CreatePath for single queries on large graphs.
+
+	\pre 1) `start` and `end` contain both contain the Ids of nodes already in the graph
+	\pre 2) The default cost of `g` is the distance between nodes, or is otherwise never less than the
+	straight line distance between the nodes of an edge. This is true for graphs created by the graph
+	generator. If this isn't the case, use \link CreatePathBidirectional \endlink instead.
+
+	\post If `OK` is returned, `out_size`, `out_path`, and `out_data` are updated the same way as CreatePath. 
+
+	\warning
+	The caller is responsible for deleting the path returned by out_path by calling DestroyPath
+	if this function completes successfully.
+
+	\see \link CreatePath \endlink for a version that uses Dijkstra's algorithm.
+	\see \link DestroyPath \endlink for information on deleting the path after usage.
+*/
+C_INTERFACE CreatePathAStar(
+	const HF::SpatialStructures::Graph* g,
+	int start,
+	int end,
+	int* out_size,
+	HF::SpatialStructures::Path** out_path,
+	HF::SpatialStructures::PathMember** out_data
+);
+
+/*!
+	\brief	 Find the shortest path from start to end using bidirectional Dijkstra.
+
+	\param	g			The graph to conduct the search on.
+	\param	start		Start node of the path.
+	\param	end			End node of the path.
+
+	\param	cost_type	The name of the cost in `g` to use for shortest path calculations. Set to an empty string
+						to use the cost `g` was constructed with.
+
+	\param	out_size	Updated to the length of the found path on success. Set to 0 if no path could be found.
+	\param	out_path	Output parameter for a pointer to the generated path. Will be null if no path could be found
+	\param	out_data	Output parameter for a pointer to the data of the generated path. Will be null if no path could be found.
+
+	\returns			`HF_STATUS::OK` The function completed successfully. 
+	\returns			`HF_STATUS::NO_PATH` No path could be found
+	\returns			`HF_STATUS::NO_COST` `cost_type` is not an empty string or the key of a cost that already exists in G
+
+	\details
+	Searches from both `start` and `end` at the same time, and stops once the two searches meet on the
+	shortest path. Unlike CreatePathAStar, this works with any cost type.
+
+	\pre 1) `start` and `end` contain both contain the Ids of nodes already in the graph
+	\pre 2) If not set to the empty string, `cost_type` is the key to a valid cost type already defined in `g`.
+
+	\post If `OK` is returned, `out_size`, `out_path`, and `out_data` are updated the same way as CreatePath. 
+
+	\warning
+	The caller is responsible for deleting the path returned by out_path by calling DestroyPath
+	if this function completes successfully.
+
+	\see \link CreatePath \endlink for a version that uses Dijkstra's algorithm.
+	\see \link DestroyPath \endlink for information on deleting the path after usage.
+*/
+C_INTERFACE CreatePathBidirectional(
+	const HF::SpatialStructures::Graph* g,
+	int start,
+	int end,
+	const char* cost_type,
+	int* out_size,
+	HF::SpatialStructures::Path** out_path,
+	HF::SpatialStructures::PathMember** out_data
+);
+
+/*!
+	\brief	Find the cost from the nearest of several source nodes to every node in a graph with a single search.
+
+	\param	g				The graph to conduct the search on.
+	\param	source_ids		IDs of every source node.
+	\param	num_sources		Number of IDs in `source_ids`.
+	\param	cost_type		The name of the cost type to use. Leaving as an empty string will use the default cost of `g`.
+	\param	max_cost			Nodes farther than this from every source are treated as unreachable. If negative, there is no limit.
+	\param	reverse			If true, find the cost from every node to its nearest source instead, such as the
+							distance from every node to the nearest exit.
+	\param out_dist_vector	Output parameter for a vector containing the cost from the nearest source to every node.
+							Nodes that weren't reached are set to -1.
+	\param out_dist_data	Output parameter for the data of `out_dist_vector`.
+	\param out_source_vector Output parameter for a vector containing the ID of the nearest source to every node.
+							Nodes that weren't reached are set to -1.
+	\param out_source_data	Output parameter for the data of `out_source_vector`.
+	\param out_pred_vector	Output parameter for a vector containing the ID of the node before every node on its
+							path from the nearest source, or after it if `reverse` is true. Nodes that weren't
+							reached are set to -1.
+	\param out_pred_data	Output parameter for the data of `out_pred_vector`.
+
+	\returns `HF_STATUS::OK` If the function completed successfully.
+	\returns `HF_STATUS::NO_COST` If `cost_type` was not the key of any existing cost type in the graph.
+
+	\warning
+	It is the caller's responsibility to deallocate all three vectors by calling DestroyFloatVector and
+	DestroyIntVector.
+
+	\see HF::Pathfinding::FindNearestSources for details on the search.
+*/
+C_INTERFACE CalculateNearestSources(
+	const HF::SpatialStructures::Graph* g,
+	const int* source_ids,
+	int num_sources,
+	const char* cost_type,
+	float max_cost,
+	bool reverse,
+	std::vector<float>** out_dist_vector,
+	float** out_dist_data,
+	std::vector<int>** out_source_vector,
+	int** out_source_data,
+	std::vector<int>** out_pred_vector,
+	int** out_pred_data
+);
+
+/*!
+	\brief	Find every node that can be reached from a set of source nodes within a maximum cost.
+
+	\param	g				The graph to conduct the search on.
+	\param	source_ids		IDs of every source node.
+	\param	num_sources		Number of IDs in `source_ids`.
+	\param	cost_type		The name of the cost type to use. Leaving as an empty string will use the default cost of `g`.
+	\param	max_cost			Maximum cost to reach a node from its nearest source.
+	\param	reverse			If true, find every node that can reach a source within `max_cost` instead.
+	\param out_node_vector	Output parameter for a vector containing the ID of every reachable node, in order of increasing cost.
+	\param out_node_data	Output parameter for the data of `out_node_vector`.
+	\param out_cost_vector	Output parameter for a vector containing the cost to reach every node in `out_node_vector`.
+	\param out_cost_data	Output parameter for the data of `out_cost_vector`.
+	\param out_size			Output parameter for the number of reachable nodes.
+
+	\returns `HF_STATUS::OK` If the function completed successfully.
+	\returns `HF_STATUS::NO_COST` If `cost_type` was not the key of any existing cost type in the graph.
+
+	\warning
+	It is the caller's responsibility to deallocate both vectors by calling DestroyIntVector and DestroyFloatVector.
+
+	\see HF::Pathfinding::FindReachable for details on the search.
+*/
+C_INTERFACE CalculateReachable(
+	const HF::SpatialStructures::Graph* g,
+	const int* source_ids,
+	int num_sources,
+	const char* cost_type,
+	float max_cost,
+	bool reverse,
+	std::vector<int>** out_node_vector,
+	int** out_node_data,
+	std::vector<float>** out_cost_vector,
+	float** out_cost_data,
+	int* out_size
+);
+
+/*!
+	\brief	Build a contraction hierarchy for fast repeated path queries on `g`.
+
+	\param	g			The graph to build the hierarchy from. Compressed if it isn't already.
+	\param	cost_type	The name of the cost type to use. Leaving as an empty string will use the default cost of `g`.
+	\param	out_ch		Output parameter for the new hierarchy.
+
+	\returns `HF_STATUS::OK` If the function completed successfully.
+	\returns `HF_STATUS::NO_COST` If `cost_type` was not the key of any existing cost type in the graph.
+	\returns `HF_STATUS::GENERIC_ERROR` If `g` has an edge with a negative cost.
+
+	\details
+	Building the hierarchy is much slower than finding a single path, but every path found
+	with CreatePathCH or CreatePathsCH afterwards is much faster than CreatePath. The hierarchy
+	doesn't reference `g`, so it must be rebuilt if `g` changes.
+
+	\warning
+	It is the caller's responsibility to delete the hierarchy by calling DestroyContractionHierarchy.
+
+	\see HF::Pathfinding::ContractionHierarchy for details on the hierarchy.
+*/
+C_INTERFACE CreateContractionHierarchy(
+	HF::SpatialStructures::Graph* g,
+	const char* cost_type,
+	HF::Pathfinding::ContractionHierarchy** out_ch
+);
+
+/*!
+	\brief	Save a contraction hierarchy to a file so it doesn't have to be rebuilt.
+
+	\param	ch		The hierarchy to save.
+	\param	path	Path to write the hierarchy to. Any existing file will be overwritten.
+
+	\returns `HF_STATUS::OK` If the hierarchy was saved.
+	\returns `HF_STATUS::GENERIC_ERROR` If the file couldn't be written.
+*/
+C_INTERFACE SaveContractionHierarchy(
+	const HF::Pathfinding::ContractionHierarchy* ch,
+	const char* path
+);
+
+/*!
+	\brief	Load a contraction hierarchy from a file written by SaveContractionHierarchy.
+
+	\param	path	Path to the hierarchy file.
+	\param	out_ch	Output parameter for the loaded hierarchy.
+
+	\returns `HF_STATUS::OK` If the hierarchy was loaded.
+	\returns `HF_STATUS::NOT_FOUND` If no file exists at `path`.
+	\returns `HF_STATUS::GENERIC_ERROR` If the file isn't a valid hierarchy file.
+
+	\warning
+	It is the caller's responsibility to delete the hierarchy by calling DestroyContractionHierarchy.
+*/
+C_INTERFACE LoadContractionHierarchy(
+	const char* path,
+	HF::Pathfinding::ContractionHierarchy** out_ch
+);
+
+/*!
+	\brief	Find the shortest path from start to end using a contraction hierarchy.
+
+	\param	ch			The hierarchy to conduct the search on.
+	\param	start		Start node of the path.
+	\param	end			End node of the path.
+	\param	out_size	Updated to the length of the found path on success.
+	\param	out_path	Output parameter for a pointer to the generated path. Will be null if no path could be found.
+	\param	out_data	Output parameter for a pointer to the data of the generated path.
+
+	\returns `HF_STATUS::OK` The function completed successfully.
+	\returns `HF_STATUS::NO_PATH` No path could be found.
+
+	\warning
+	The caller is responsible for deleting the path returned by out_path by calling DestroyPath.
+
+	\see CreatePath for the equivalent search without a hierarchy.
+*/
+C_INTERFACE CreatePathCH(
+	const HF::Pathfinding::ContractionHierarchy* ch,
+	int start,
+	int end,
+	int* out_size,
+	HF::SpatialStructures::Path** out_path,
+	HF::SpatialStructures::PathMember** out_data
+);
+
+/*!
+	\brief	Find multiple shortest paths in parallel using a contraction hierarchy.
+
+	\param	ch							The hierarchy to conduct the search on.
+	\param	start_ids					Start nodes of every path.
+	\param	end_ids						End nodes of every path.
+	\param	out_path_ptr_holder			Array to hold a pointer to every path. Paths that couldn't be found are null.
+	\param	out_path_member_ptr_holder	Array to hold a pointer to the members of every path.
+	\param	out_sizes					Array to hold the size of every path. 0 for paths that couldn't be found.
+	\param	num_paths					Number of paths to find.
+
+	\returns `HF_STATUS::OK` The function completed successfully.
+
+	\warning
+	The caller is responsible for deleting every path in `out_path_ptr_holder` by calling DestroyPath.
+
+	\see CreatePaths for the equivalent search without a hierarchy.
+*/
+C_INTERFACE CreatePathsCH(
+	const HF::Pathfinding::ContractionHierarchy* ch,
+	const int* start_ids,
+	const int* end_ids,
+	HF::SpatialStructures::Path** out_path_ptr_holder,
+	HF::SpatialStructures::PathMember** out_path_member_ptr_holder,
+	int* out_sizes,
+	int num_paths
+);
+
+/*!
+	\brief	Delete a contraction hierarchy.
+
+	\param	ch	The hierarchy to delete.
+
+	\returns `HF_STATUS::OK` on return.
+*/
+C_INTERFACE DestroyContractionHierarchy(HF::Pathfinding::ContractionHierarchy* ch);
+
 /*!
 	\brief	 Find multiple shortest paths in paralllel.	
 	
-	\param	g			The graph to conduct the search on
+	\param	g			The graph to conduct the search on. Compressed if it isn't already.
 
 	\param	start		An array of ids for starting nodes.
 						Length must match that of end and all the IDS must belong to
@@ -295,6 +587,9 @@ C_INTERFACE CreatePath(
 	\returns			`HF_STATUS::OK` if the function completes successfully
 	\returns			`HF_STATUS::NO_COST` is `cost_name` is not a valid cost type name
 
+	\details Paths are found directly in the CSR of `g` by a HF::Pathfinding::CSRPathFinder,
+	one search per unique start point, in parallel.
+
 	\pre 1) The length of `start_ids`, `end_ids`, and `out_size` must be equal.
 	\pre 2) If `cost_type` is specified, `cost_type` must be the the key of an already existing cost in `g`
 	
@@ -332,7 +627,7 @@ C_INTERFACE CreatePath(
 	`>>> TODO output`\n
 */
 C_INTERFACE CreatePaths(
-	const HF::SpatialStructures::Graph* g,
+	HF::SpatialStructures::Graph* g,
 	const int* start,
 	const int* end,
 	const char * cost_type,
@@ -522,6 +817,38 @@ C_INTERFACE CreateAllPredToPath(
 	int** out_lengths_data // Output: Array of path lengths
 );
 
+/*!
+	\brief Write the distance from every node in a graph to every other node to a file, without
+		   holding the full distance matrix in memory.
+
+	\param g				The graph to calculate distances in.
+	\param cost_name		The name of the cost type to use for calculating distances. Leaving as an empty string
+							will use the default cost of `g`.
+	\param path				Path of the file to create. Any existing file will be replaced.
+	\param format			0 to store distances as floats, 1 to store them as 16-bit integers.
+							See HF::Pathfinding::DISTANCE_FORMAT.
+	\param scale				Distance represented by 1 when `format` is 1. Ignored otherwise.
+	\param upper_triangle	If true, only write the distance from each node to nodes with a higher ID.
+							Only use this for undirected graphs.
+	\param tile_rows		Number of rows of the matrix to hold in memory at a time.
+
+	\returns `HF_STATUS::OK` If the file was written successfully.
+	\returns `HF_STATUS::NO_COST` If `cost_name` was not the key of any existing cost type in the graph.
+	\returns `HF_STATUS::OUT_OF_RANGE` If `tile_rows` was less than 1, or `format` was 1 and `scale` wasn't greater than 0.
+	\returns `HF_STATUS::NOT_FOUND` If the file at `path` couldn't be written to.
+
+	\see HF::Pathfinding::WriteDistanceMatrix for the layout of the file.
+*/
+C_INTERFACE CalculateDistanceMatrixToFile(
+	const HF::SpatialStructures::Graph* g,
+	const char* cost_name,
+	const char* path,
+	int format,
+	float scale,
+	bool upper_triangle,
+	int tile_rows
+);
+
 /**@}*/
 
 #endif /* PATHFINDER_C_H */
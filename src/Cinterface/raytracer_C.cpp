@@ -88,6 +88,85 @@ C_INTERFACE AddMesh(HF::RayTracer::EmbreeRayTracer* ERT,MeshInfo* MI)
 	return HF_STATUS::OK;
 }
 
+C_INTERFACE RemoveMesh(EmbreeRayTracer* ERT, int mesh_id, bool commit)
+{
+	if (!ERT->RemoveMesh(mesh_id, commit))
+		return NOT_FOUND;
+
+	return OK;
+}
+
+C_INTERFACE UpdateMeshVertices(EmbreeRayTracer* ERT, int mesh_id, const float* vertices, int num_vertices, bool commit)
+{
+	const vector<float> vertex_vector(vertices, vertices + (num_vertices * 3));
+	if (!ERT->UpdateMeshVertices(mesh_id, vertex_vector, commit))
+		return NOT_FOUND;
+
+	return OK;
+}
+
+/*! \brief Copy 12 floats into an InstanceTransform. */
+inline HF::RayTracer::InstanceTransform ToTransform(const float* transform) {
+	HF::RayTracer::InstanceTransform out_transform;
+	std::copy(transform, transform + out_transform.size(), out_transform.begin());
+	return out_transform;
+}
+
+C_INTERFACE TransformMesh(EmbreeRayTracer* ERT, int mesh_id, const float* transform, bool commit)
+{
+	if (!ERT->TransformMesh(mesh_id, ToTransform(transform), commit))
+		return NOT_FOUND;
+
+	return OK;
+}
+
+C_INTERFACE ReplaceMesh(EmbreeRayTracer* ERT, MeshInfo* MI, bool commit)
+{
+	try {
+		ERT->ReplaceMesh(*MI, commit);
+	}
+	catch (const HF::Exceptions::InvalidOBJ&) {
+		return INVALID_OBJ;
+	}
+	return OK;
+}
+
+C_INTERFACE AddMeshPrototype(EmbreeRayTracer* ERT, MeshInfo* MI, int* out_prototype)
+{
+	try {
+		*out_prototype = ERT->AddPrototype(*MI);
+	}
+	catch (const HF::Exceptions::InvalidOBJ&) {
+		return INVALID_OBJ;
+	}
+	return OK;
+}
+
+C_INTERFACE AddMeshInstance(EmbreeRayTracer* ERT, int prototype, const float* transform, int mesh_id, bool commit, int* out_id)
+{
+	try {
+		*out_id = ERT->AddInstance(prototype, ToTransform(transform), mesh_id, commit);
+	}
+	catch (const std::out_of_range&) {
+		return OUT_OF_RANGE;
+	}
+	return OK;
+}
+
+C_INTERFACE SetInstanceTransform(EmbreeRayTracer* ERT, int mesh_id, const float* transform, bool commit)
+{
+	if (!ERT->SetInstanceTransform(mesh_id, ToTransform(transform), commit))
+		return NOT_FOUND;
+
+	return OK;
+}
+
+C_INTERFACE CommitRaytracer(EmbreeRayTracer* ERT)
+{
+	ERT->CommitScene();
+	return OK;
+}
+
 C_INTERFACE DestroyRayTracer(HF::RayTracer::EmbreeRayTracer* rt_to_destroy)
 {
 	if (rt_to_destroy)
@@ -196,31 +275,57 @@ C_INTERFACE CastRay(EmbreeRayTracer* ert, float& x, float& y, float& z, float dx
 	return OK;
 }
 
-C_INTERFACE CastMultipleRays(
+/*!
+	\brief Cast a stream of rays and move every point in `out_points` that hit to its point of intersection.
+
+	\param ert Raytracer to cast the rays with.
+	\param origin_array Origin points of each ray.
+	\param dir_array Directions of each ray.
+	\param max_distance Maximum distance of each ray.
+	\param out_points Array of floats to write hitpoints to. Every 3 floats represents one point.
+	\param result_array Set to true for every ray that hit and false for every ray that missed.
+*/
+inline void CastStreamToPoints(
 	EmbreeRayTracer* ert,
-	float* origins,
-	const float* directions,
-	int size,
+	const std::vector<std::array<float, 3>>& origin_array,
+	const std::vector<std::array<float, 3>>& dir_array,
 	float max_distance,
+	float* out_points,
 	bool* result_array
 ) {
-	auto origin_array = ConvertRawFloatArrayToPoints(origins, size);
-	auto dir_array = ConvertRawFloatArrayToPoints(directions, size);
-	auto results = ert->PointIntersections(origin_array, dir_array, size, true, max_distance);
+	const auto results = ert->IntersectStream(origin_array, dir_array, max_distance, true);
+	const bool one_origin = origin_array.size() == 1;
+	const bool one_direction = dir_array.size() == 1;
 
-	for (int i = 0; i < size; i++) {
-		if (results[i])
+	for (int i = 0; i < results.size(); i++) {
+		if (results[i].DidHit())
 		{
+			// Translate the origin along the direction by the distance to the hit
+			const auto& origin = origin_array[one_origin ? 0 : i];
+			const auto& direction = dir_array[one_direction ? 0 : i];
 			const int offset = i * 3;
-			const auto& hit_point = origin_array[i];
-			origins[offset] = hit_point[0];
-			origins[offset + 1] = hit_point[1];
-			origins[offset + 2] = hit_point[2];
+			out_points[offset] = origin[0] + (direction[0] * results[i].distance);
+			out_points[offset + 1] = origin[1] + (direction[1] * results[i].distance);
+			out_points[offset + 2] = origin[2] + (direction[2] * results[i].distance);
 			result_array[i] = true;
 		}
 		else
 			result_array[i] = false;
 	}
+}
+
+C_INTERFACE CastMultipleRays(
+	EmbreeRayTracer* ert,
+	float* origins,
+	const float* directions,
+	int size,
+	float max_distance,
+	bool* result_array
+) {
+	auto origin_array = ConvertRawFloatArrayToPoints(origins, size);
+	auto dir_array = ConvertRawFloatArrayToPoints(directions, size);
+	CastStreamToPoints(ert, origin_array, dir_array, max_distance, origins, result_array);
+
 	return OK;
 }
 
@@ -228,21 +333,8 @@ C_INTERFACE CastMultipleOriginsOneDirection(EmbreeRayTracer* ert, float* origins
 {
 	auto origin_array = ConvertRawFloatArrayToPoints(origins, size);
 	auto dir_array = ConvertRawFloatArrayToPoints(direction, 1);
-	auto results = ert->PointIntersections(origin_array, dir_array, size, true, max_distance);
+	CastStreamToPoints(ert, origin_array, dir_array, max_distance, origins, result_array);
 
-	for (int i = 0; i < size; i++) {
-		if (results[i])
-		{
-			const int offset = i * 3;
-			const auto& hit_point = origin_array[i];
-			origins[offset] = hit_point[0];
-			origins[offset + 1] = hit_point[1];
-			origins[offset + 2] = hit_point[2];
-			result_array[i] = true;
-		}
-		else
-			result_array[i] = false;
-	}
 	return OK;
 }
 
@@ -250,34 +342,45 @@ C_INTERFACE CastMultipleDirectionsOneOrigin(EmbreeRayTracer* ert, const float* o
 {
 	auto origin_array = ConvertRawFloatArrayToPoints(origin, 1);
 	auto dir_array = ConvertRawFloatArrayToPoints(directions, size);
-	auto results = ert->PointIntersections(origin_array, dir_array, size, true, max_distance);
+	CastStreamToPoints(ert, origin_array, dir_array, max_distance, directions, result_array);
 
-	for (int i = 0; i < size; i++) {
-		if (results[i])
-		{
-			const int offset = i * 3;
-			const auto& hit_point = dir_array[i];
-			directions[offset] = hit_point[0];
-			directions[offset + 1] = hit_point[1];
-			directions[offset + 2] = hit_point[2];
-			result_array[i] = true;
-		}
-		else
-			result_array[i] = false;
-	}
 	return OK;
 }
 
 C_INTERFACE CastOcclusionRays(EmbreeRayTracer* ert, const float* origins, const float* directions, int origin_size, int direction_size, float max_distance, bool* result_array)
 {
+	if (origin_size != direction_size && origin_size != 1 && direction_size != 1)
+		return HF::Exceptions::GENERIC_ERROR;
+
 	auto origin_array = ConvertRawFloatArrayToPoints(origins, origin_size);
 	auto direction_array = ConvertRawFloatArrayToPoints(directions, direction_size);
-	const auto results = ert->Occlusions(origin_array, direction_array, max_distance, true);
+	const auto results = ert->OccludedStream(origin_array, direction_array, max_distance, true);
 
 	std::copy(results.begin(), results.end(), result_array);
 	return OK;
 }
 
+C_INTERFACE FindClosestPoints(
+	EmbreeRayTracer* ert,
+	const float* points,
+	int num_points,
+	float max_distance,
+	bool ignore_horizontal,
+	float* out_distances,
+	int* out_meshids,
+	float* out_points)
+{
+	const auto point_array = ConvertRawFloatArrayToPoints(points, num_points);
+	const auto results = ert->FindClosestPoints(point_array, max_distance, ignore_horizontal);
+
+	for (int i = 0; i < num_points; i++) {
+		out_distances[i] = results[i].distance;
+		out_meshids[i] = results[i].meshid;
+		std::copy(results[i].point.begin(), results[i].point.end(), out_points + (i * 3));
+	}
+	return OK;
+}
+
 C_INTERFACE DestroyRayResultVector(std::vector<RayResult>* var) {
 	DeleteRawPtr(var);
 	return OK;
@@ -301,3 +404,35 @@ C_INTERFACE PreciseIntersection(
 
 	return OK;
 }
+
+C_INTERFACE SaveRaytracerScene(EmbreeRayTracer* ert, const char* path, uint64_t key)
+{
+	if (!ert->SaveScene(std::string(path), key))
+		return NOT_FOUND;
+
+	return OK;
+}
+
+C_INTERFACE LoadRaytracerScene(
+	const char* path,
+	uint64_t key,
+	bool use_precise,
+	int build_quality,
+	EmbreeRayTracer** out_raytracer)
+{
+	try {
+		*out_raytracer = new EmbreeRayTracer(EmbreeRayTracer::LoadScene(
+			std::string(path),
+			key,
+			use_precise,
+			static_cast<HF::RayTracer::BUILD_QUALITY>(build_quality)
+		));
+	}
+	catch (const HF::Exceptions::FileNotFound&) {
+		return NOT_FOUND;
+	}
+	catch (const std::runtime_error&) {
+		return GENERIC_ERROR;
+	}
+	return OK;
+}
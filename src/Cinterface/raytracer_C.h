@@ -11,6 +11,7 @@
 
 #include <vector>
 #include <array>
+#include <cstdint>
 
 namespace HF {
 	namespace RayTracer {
@@ -177,6 +178,126 @@ C_INTERFACE AddMeshes(
 	int number_of_meshes
 );
 
+/*!
+	\brief Remove a mesh or instance from a raytracer.
+
+	\param ERT Raytracer to remove the mesh from.
+	\param mesh_id ID of the mesh or instance to remove.
+	\param commit If true, commit the scene. Only do this after the last edit in a batch.
+
+	\returns HF_STATUS::OK on completion.
+	\returns HF_STATUS::NOT_FOUND if there was no mesh with `mesh_id` in the raytracer.
+
+	\see HF::RayTracer::EmbreeRayTracer::RemoveMesh
+*/
+C_INTERFACE RemoveMesh(HF::RayTracer::EmbreeRayTracer* ERT, int mesh_id, bool commit);
+
+/*!
+	\brief Overwrite the vertices of a mesh in a raytracer and refit its BVH.
+
+	\param ERT Raytracer containing the mesh.
+	\param mesh_id ID of the mesh to update.
+	\param vertices New vertices of the mesh, with every 3 floats representing a vertex, in the same
+					order as the mesh's existing vertices.
+	\param num_vertices Number of vertices in `vertices`. Must match the number of vertices in the mesh.
+	\param commit If true, commit the scene.
+
+	\returns HF_STATUS::OK on completion.
+	\returns HF_STATUS::NOT_FOUND if there was no mesh with `mesh_id`, or it has a different number of vertices.
+
+	\see HF::RayTracer::EmbreeRayTracer::UpdateMeshVertices
+*/
+C_INTERFACE UpdateMeshVertices(
+	HF::RayTracer::EmbreeRayTracer* ERT,
+	int mesh_id,
+	const float* vertices,
+	int num_vertices,
+	bool commit
+);
+
+/*!
+	\brief Apply a transform to every vertex of a mesh in a raytracer.
+
+	\param ERT Raytracer containing the mesh.
+	\param mesh_id ID of the mesh to transform.
+	\param transform 12 floats representing a 3x4 column major transform. See HF::RayTracer::InstanceTransform.
+	\param commit If true, commit the scene.
+
+	\returns HF_STATUS::OK on completion.
+	\returns HF_STATUS::NOT_FOUND if there was no mesh with `mesh_id`.
+*/
+C_INTERFACE TransformMesh(HF::RayTracer::EmbreeRayTracer* ERT, int mesh_id, const float* transform, bool commit);
+
+/*!
+	\brief Replace the mesh in a raytracer that has the same ID as `MI`.
+
+	\param ERT Raytracer containing the mesh.
+	\param MI Mesh to replace the existing mesh with. If no mesh has its ID, it will be added instead.
+	\param commit If true, commit the scene.
+
+	\returns HF_STATUS::OK on completion.
+	\returns HF_STATUS::INVALID_OBJ if `MI` has no vertices or triangles.
+
+	\see HF::RayTracer::EmbreeRayTracer::ReplaceMesh
+*/
+C_INTERFACE ReplaceMesh(HF::RayTracer::EmbreeRayTracer* ERT, HF::Geometry::MeshInfo<float>* MI, bool commit);
+
+/*!
+	\brief Build a BVH for a mesh that can be instanced with AddMeshInstance.
+
+	\param ERT Raytracer to add the prototype to.
+	\param MI Mesh to instance.
+	\param out_prototype Output parameter for the index of the new prototype.
+
+	\returns HF_STATUS::OK on completion.
+	\returns HF_STATUS::INVALID_OBJ if `MI` has no vertices or triangles.
+*/
+C_INTERFACE AddMeshPrototype(HF::RayTracer::EmbreeRayTracer* ERT, HF::Geometry::MeshInfo<float>* MI, int* out_prototype);
+
+/*!
+	\brief Place an instance of a prototype in a raytracer.
+
+	\param ERT Raytracer to add the instance to.
+	\param prototype Index of the prototype from AddMeshPrototype.
+	\param transform 12 floats representing a 3x4 column major transform. See HF::RayTracer::InstanceTransform.
+	\param mesh_id ID to try to give the instance, or -1 to use the next available ID.
+	\param commit If true, commit the scene.
+	\param out_id Output parameter for the ID of the instance. Hits on the instance report this ID.
+
+	\returns HF_STATUS::OK on completion.
+	\returns HF_STATUS::OUT_OF_RANGE if `prototype` isn't a prototype in `ERT`.
+*/
+C_INTERFACE AddMeshInstance(
+	HF::RayTracer::EmbreeRayTracer* ERT,
+	int prototype,
+	const float* transform,
+	int mesh_id,
+	bool commit,
+	int* out_id
+);
+
+/*!
+	\brief Move an instance in a raytracer by replacing its transform.
+
+	\param ERT Raytracer containing the instance.
+	\param mesh_id ID of the instance.
+	\param transform 12 floats representing a 3x4 column major transform. See HF::RayTracer::InstanceTransform.
+	\param commit If true, commit the scene.
+
+	\returns HF_STATUS::OK on completion.
+	\returns HF_STATUS::NOT_FOUND if there was no instance with `mesh_id`.
+*/
+C_INTERFACE SetInstanceTransform(HF::RayTracer::EmbreeRayTracer* ERT, int mesh_id, const float* transform, bool commit);
+
+/*!
+	\brief Commit every change made to a raytracer's scene since it was last committed.
+
+	\param ERT Raytracer to commit.
+
+	\returns HF_STATUS::OK on completion.
+*/
+C_INTERFACE CommitRaytracer(HF::RayTracer::EmbreeRayTracer* ERT);
+
 
 /*!
 	\brief		Delete an existing raytracer.
@@ -366,7 +487,7 @@ C_INTERFACE CastRay(HF::RayTracer::EmbreeRayTracer* ert, float& x, float& y, flo
 
 /*!
 	\brief		Cast multiple rays at once in parallel and receive their hitpoints in return. The number of
-				directions must be equal to the number of origins.
+				directions must be equal to the number of origins. Rays are submitted to Embree as ray streams.
 
 	\param	ert				Raytracer to cast each ray from.
 
@@ -522,10 +643,12 @@ C_INTERFACE CastMultipleDirectionsOneOrigin(HF::RayTracer::EmbreeRayTracer* ert,
 	\param	max_distance	Maximum distance a ray can travel and still hit a target.
 	\param	result_array	Output array booleans
 
-	\returns		HF_STATUS::OK on completion
+	\returns		HF_STATUS::OK on completion.
+				HF_STATUS::GENERIC_ERROR if origin_size and direction_size don't match and neither is equal to one.
 
 	\remarks	Occlusion rays are noticably faster than standard rays but are only capable of returning whether
-				they hit something or not. This makes them good for line of sight checks.
+				they hit something or not. This makes them good for line of sight checks. Rays are submitted
+				to Embree in streams of HF::RayTracer::RAY_STREAM_SIZE rays.
 
 	\see	\ref mesh_setup (how to create a mesh), \ref mesh_teardown (how to destroy a mesh)
 	\see	\ref raytracer_setup (how to create a BVH), \ref raytracer_teardown (how to destroy a BVH)
@@ -564,6 +687,36 @@ C_INTERFACE CastOcclusionRays(
 	bool* result_array
 );
 
+/*!
+	\brief Find the closest point on any geometry to every point in an array.
+
+	\param ert Raytracer to query.
+	\param points X, Y, Z coordinates of every point. Must hold `num_points * 3` floats.
+	\param num_points Number of points in `points`.
+	\param max_distance Only consider geometry within this distance of each point. Set to -1 for infinite distance.
+	\param ignore_horizontal If true, ignore triangles that face within 45 degrees of straight up or down.
+	\param out_distances Output array for the distance to the closest point, or -1 if none was found.
+	\param out_meshids Output array for the ID of the mesh the closest point is on, or -1 if none was found.
+	\param out_points Output array for the X, Y, Z coordinates of every closest point.
+
+	\returns HF_STATUS::OK on completion.
+
+	\pre `out_distances` and `out_meshids` must be large enough to hold `num_points` values, and `out_points`
+		 must be large enough to hold `num_points * 3` values.
+
+	\see HF::RayTracer::EmbreeRayTracer::FindClosestPoints
+*/
+C_INTERFACE FindClosestPoints(
+	HF::RayTracer::EmbreeRayTracer* ert,
+	const float* points,
+	int num_points,
+	float max_distance,
+	bool ignore_horizontal,
+	float* out_distances,
+	int* out_meshids,
+	float* out_points
+);
+
 /*!
 	\brief	Destroy a vector of rayresults.
 
@@ -582,6 +735,43 @@ C_INTERFACE DestroyRayResultVector(
 
 C_INTERFACE PreciseIntersection(HF::RayTracer::EmbreeRayTracer* RT, double x, double y, double z, double dx, double dy, double dz, double * out_distance);
 
+/*!
+	\brief Save the geometry in a raytracer's scene to a scene cache.
+
+	\param ert Raytracer to save.
+	\param path Path to write the scene cache to.
+	\param key Value identifying the geometry the scene was built from. See HF::RayTracer::SceneCacheKey.
+
+	\returns HF_STATUS::OK on completion.
+	\returns HF_STATUS::NOT_FOUND if the file couldn't be written.
+
+	\see HF::RayTracer::EmbreeRayTracer::SaveScene
+*/
+C_INTERFACE SaveRaytracerScene(HF::RayTracer::EmbreeRayTracer* ert, const char* path, uint64_t key);
+
+/*!
+	\brief Create a raytracer from a scene cache written by SaveRaytracerScene.
+
+	\param path Path to the scene cache.
+	\param key If not 0, only load the cache if it was saved with this key.
+	\param use_precise If true, use a more precise but slower method of triangle intersections.
+	\param build_quality Quality of the BVH to build. 0 for low, 1 for medium, 2 for high.
+	\param out_raytracer Output parameter for the new raytracer.
+
+	\returns HF_STATUS::OK on completion.
+	\returns HF_STATUS::NOT_FOUND if no file exists at `path`.
+	\returns HF_STATUS::GENERIC_ERROR if the file isn't a valid scene cache or doesn't match `key`.
+
+	\see HF::RayTracer::EmbreeRayTracer::LoadScene
+*/
+C_INTERFACE LoadRaytracerScene(
+	const char* path,
+	uint64_t key,
+	bool use_precise,
+	int build_quality,
+	HF::RayTracer::EmbreeRayTracer** out_raytracer
+);
+
 /**@}*/
 
 #endif /* RAYTRACER_C_H */
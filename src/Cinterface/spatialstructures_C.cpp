@@ -2,6 +2,7 @@
 #include <spatialstructures_C.h>
 #include <HFExceptions.h>
 #include <graph.h>
+#include <node_index.h>
 #include <edge.h>
 #include <node.h>
 #include <robin_hood.h>
@@ -705,3 +706,153 @@ C_INTERFACE GraphAttrsToCosts(
 	// fulfilled. 
 	return HF::Exceptions::OK;
 }
+
+C_INTERFACE SaveGraph(Graph* g, const char* path)
+{
+	try {
+		// Compress the caller's graph so SaveBinary doesn't have to copy it
+		g->Compress();
+		if (!g->SaveBinary(std::string(path)))
+			return HF::Exceptions::HF_STATUS::NOT_FOUND;
+	}
+	catch (...) {
+		return HF::Exceptions::HF_STATUS::GENERIC_ERROR;
+	}
+	return HF::Exceptions::OK;
+}
+
+C_INTERFACE LoadGraph(const char* path, Graph** out_graph)
+{
+	try {
+		*out_graph = new Graph(Graph::LoadBinary(std::string(path)));
+	}
+	catch (const HF::Exceptions::FileNotFound&) {
+		return HF::Exceptions::HF_STATUS::NOT_FOUND;
+	}
+	catch (const std::runtime_error&) {
+		return HF::Exceptions::HF_STATUS::GENERIC_ERROR;
+	}
+	return HF::Exceptions::OK;
+}
+
+C_INTERFACE GetNodeAttributePointers(
+	const Graph* g,
+	const char* attribute,
+	int* out_type,
+	const void** out_values,
+	const uint8_t** out_assigned,
+	int* out_size)
+{
+	const auto column = g->GetNodeAttributeColumn(std::string(attribute));
+	if (!column)
+		return HF::Exceptions::HF_STATUS::NOT_FOUND;
+
+	*out_type = static_cast<int>(column->Type());
+	*out_values = column->Data();
+	*out_assigned = column->AssignedData();
+	*out_size = column->size();
+
+	return HF::Exceptions::OK;
+}
+
+C_INTERFACE SetNodeAttributeColumn(
+	Graph* g,
+	const char* attribute,
+	int type,
+	const void* values,
+	int num_values)
+{
+	using HF::SpatialStructures::NODE_ATTRIBUTE_TYPE;
+
+	if (!values)
+		return HF::Exceptions::HF_STATUS::INVALID_PTR;
+	if (type < static_cast<int>(NODE_ATTRIBUTE_TYPE::FLOAT) || type > static_cast<int>(NODE_ATTRIBUTE_TYPE::STRING))
+		return HF::Exceptions::HF_STATUS::OUT_OF_RANGE;
+
+	try {
+		g->SetNodeAttributeColumn(std::string(attribute), static_cast<NODE_ATTRIBUTE_TYPE>(type), values, num_values);
+	}
+	catch (const std::out_of_range&) {
+		return HF::Exceptions::HF_STATUS::OUT_OF_RANGE;
+	}
+
+	return HF::Exceptions::OK;
+}
+
+C_INTERFACE GetClosestNodes(
+	const Graph* g,
+	const float* points,
+	int num_points,
+	bool use_x,
+	bool use_y,
+	bool use_z,
+	int* out_ids,
+	float* out_distances)
+{
+	if (!points || !out_ids || !(use_x || use_y || use_z))
+		return HF::Exceptions::HF_STATUS::INVALID_PTR;
+
+	const auto& index = g->GetNodeIndex(use_x, use_y, use_z);
+	index.Nearest(points, num_points, out_ids, out_distances);
+
+	return HF::Exceptions::OK;
+}
+
+C_INTERFACE GetKNearestNodes(
+	const Graph* g,
+	const float* points,
+	int num_points,
+	int k,
+	bool use_x,
+	bool use_y,
+	bool use_z,
+	int* out_ids,
+	float* out_distances)
+{
+	if (!points || !out_ids || !(use_x || use_y || use_z))
+		return HF::Exceptions::HF_STATUS::INVALID_PTR;
+	if (k < 1)
+		return HF::Exceptions::HF_STATUS::OUT_OF_RANGE;
+
+	const auto& index = g->GetNodeIndex(use_x, use_y, use_z);
+	index.KNearest(points, num_points, k, out_ids, out_distances);
+
+	return HF::Exceptions::OK;
+}
+
+C_INTERFACE GetNodesWithinRadius(
+	const Graph* g,
+	const float* points,
+	int num_points,
+	float radius,
+	bool use_x,
+	bool use_y,
+	bool use_z,
+	vector<int>** out_offsets_vector,
+	int** out_offsets_data,
+	vector<int>** out_ids_vector,
+	int** out_ids_data,
+	vector<float>** out_distances_vector,
+	float** out_distances_data,
+	int* out_size)
+{
+	if (!points || !(use_x || use_y || use_z))
+		return HF::Exceptions::HF_STATUS::INVALID_PTR;
+
+	const auto& index = g->GetNodeIndex(use_x, use_y, use_z);
+
+	auto offsets = new vector<int>();
+	auto ids = new vector<int>();
+	auto distances = new vector<float>();
+	index.WithinRadius(points, num_points, radius, *offsets, *ids, *distances);
+
+	*out_offsets_vector = offsets;
+	*out_offsets_data = offsets->data();
+	*out_ids_vector = ids;
+	*out_ids_data = ids->data();
+	*out_distances_vector = distances;
+	*out_distances_data = distances->data();
+	*out_size = static_cast<int>(ids->size());
+
+	return HF::Exceptions::OK;
+}
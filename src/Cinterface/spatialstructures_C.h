@@ -1064,8 +1064,8 @@ C_INTERFACE GetNodeAttributesByIDFloat(
 	\param		g			The pointer of the graph to check
 	\param		attribute	The attribute to check
 
-	\returns	1 if the attribute exists in the graph and contains only float values.
-				0 otherwise.
+	\returns	1 if the attribute exists in the graph and contains numeric values that
+				can be read with GetNodeAttributesFloat. 0 otherwise.
 */
 C_INTERFACE IsFloatAttribute(
 	const HF::SpatialStructures::Graph* g,
@@ -1298,4 +1298,212 @@ C_INTERFACE AlternateCostsAlongPathStruct(
 	const char* cost_type,
 	float* out_scores,
 	int* out_score_size);
+
+/*!
+	\brief		Save a graph to a binary file.
+
+	\param	g		The graph to save.
+	\param	path	Path to write the graph to. Any existing file will be overwritten.
+
+	\returns \link HF_STATUS::OK \endlink if the graph was saved.
+	\returns \link HF_STATUS::NOT_FOUND \endlink if the file at `path` couldn't be written.
+	\returns \link HF_STATUS::GENERIC_ERROR \endlink if the graph couldn't be compressed or written.
+
+	\post `g` will be compressed.
+
+	\see \ref HF::SpatialStructures::Graph::SaveBinary for details on the file format.
+*/
+C_INTERFACE SaveGraph(
+	HF::SpatialStructures::Graph* g,
+	const char* path
+);
+
+/*!
+	\brief		Load a graph from a file written by SaveGraph.
+
+	\param	path		Path to the graph file.
+	\param	out_graph	Output parameter for the loaded graph.
+
+	\returns \link HF_STATUS::OK \endlink if the graph was loaded.
+	\returns \link HF_STATUS::NOT_FOUND \endlink if no file exists at `path`.
+	\returns \link HF_STATUS::GENERIC_ERROR \endlink if the file isn't a valid graph file.
+
+	\post If successful, `out_graph` points to a new graph that must be deallocated with DestroyGraph.
+*/
+C_INTERFACE LoadGraph(
+	const char* path,
+	HF::SpatialStructures::Graph** out_graph
+);
+
+/*!
+	\brief		Get direct access to the stored values of a node attribute.
+
+	\param	g				The graph containing the attribute.
+	\param	attribute		Name of the attribute to get.
+	\param	out_type		Output parameter for the attribute's type as a
+							\link HF::SpatialStructures::NODE_ATTRIBUTE_TYPE \endlink.
+	\param	out_values		Output parameter for a pointer to `out_size` values of `out_type` ordered by node ID.
+							Bools are one byte each. Set to null for string attributes, which must be read
+							with GetNodeAttributes instead.
+	\param	out_assigned	Output parameter for a pointer to `out_size` bytes that are 1 for every node that
+							has a value for this attribute and 0 for nodes that don't.
+	\param	out_size		Output parameter for the number of nodes in `out_values` and `out_assigned`.
+							This may be less than the number of nodes in the graph if nodes were added
+							after the attribute was last modified.
+
+	\returns \link HF_STATUS::OK \endlink on success.
+	\returns \link HF_STATUS::NOT_FOUND \endlink if the attribute doesn't exist in the graph.
+
+	\details
+	No values are copied, so the pointers are only valid until an attribute in the graph is
+	added, modified, or cleared, or the graph is destroyed.
+*/
+C_INTERFACE GetNodeAttributePointers(
+	const HF::SpatialStructures::Graph* g,
+	const char* attribute,
+	int* out_type,
+	const void** out_values,
+	const uint8_t** out_assigned,
+	int* out_size
+);
+
+/*!
+	\brief		Replace the values of a node attribute for every node in a graph at once.
+
+	\param	g				The graph to add the attribute to.
+	\param	attribute		Name of the attribute to set. Any existing values for this attribute will be replaced.
+	\param	type			Type of values in `values` as a \link HF::SpatialStructures::NODE_ATTRIBUTE_TYPE \endlink.
+	\param	values			Array of `num_values` values of `type` ordered by node ID. Bools must be one byte each,
+							and strings must be an array of null terminated char arrays.
+	\param	num_values		Number of values in `values`.
+
+	\returns \link HF_STATUS::OK \endlink on success.
+	\returns \link HF_STATUS::INVALID_PTR \endlink if `values` is null.
+	\returns \link HF_STATUS::OUT_OF_RANGE \endlink if `type` isn't a valid type, or `num_values` is
+	greater than the number of nodes in the graph.
+
+	\details
+	Numeric values are copied into the graph in a single block, making this much faster than
+	AddNodeAttributesFloat when every node in the graph has a value.
+
+	\post The nodes with IDs from 0 to `num_values` - 1 will have values for `attribute`.
+*/
+C_INTERFACE SetNodeAttributeColumn(
+	HF::SpatialStructures::Graph* g,
+	const char* attribute,
+	int type,
+	const void* values,
+	int num_values
+);
+
+/*!
+	\brief		Find the closest node in a graph to every point in an array of points.
+
+	\param	g				The graph to search.
+	\param	points			Points to search from. Each point contains one float for every axis
+							enabled by `use_x`, `use_y`, and `use_z`, in x, y, z order.
+	\param	num_points		Number of points in `points`.
+	\param	use_x			Include the x axis in distance calculations.
+	\param	use_y			Include the y axis in distance calculations.
+	\param	use_z			Include the z axis in distance calculations.
+	\param	out_ids			Output array of `num_points` ints for the ID of the closest node to each point.
+							Set to -1 if the graph has no nodes.
+	\param	out_distances	Output array of `num_points` floats for the distance to the closest node to each point.
+							May be null if distances aren't needed.
+
+	\returns \link HF_STATUS::OK \endlink on success.
+	\returns \link HF_STATUS::INVALID_PTR \endlink if `points` or `out_ids` are null, or if every axis is disabled.
+
+	\details
+	Uses a k-d tree built over the graph's nodes the first time it's needed for a combination of axes, and
+	reused by later calls until nodes are added to the graph.
+
+	\see \ref HF::SpatialStructures::Graph::GetNodeIndex
+*/
+C_INTERFACE GetClosestNodes(
+	const HF::SpatialStructures::Graph* g,
+	const float* points,
+	int num_points,
+	bool use_x,
+	bool use_y,
+	bool use_z,
+	int* out_ids,
+	float* out_distances
+);
+
+/*!
+	\brief		Find the `k` closest nodes in a graph to every point in an array of points.
+
+	\param	g				The graph to search.
+	\param	points			Points to search from. Each point contains one float for every axis
+							enabled by `use_x`, `use_y`, and `use_z`, in x, y, z order.
+	\param	num_points		Number of points in `points`.
+	\param	k				Number of nodes to find for every point.
+	\param	use_x			Include the x axis in distance calculations.
+	\param	use_y			Include the y axis in distance calculations.
+	\param	use_z			Include the z axis in distance calculations.
+	\param	out_ids			Output array of `num_points * k` ints. The closest nodes to the point at index `i`
+							start at `i * k` and are sorted from nearest to furthest. If the graph has fewer than `k`
+							nodes, remaining IDs are set to -1.
+	\param	out_distances	Output array of `num_points * k` floats for the distance to each node in `out_ids`,
+							or NaN where no node was found. May be null if distances aren't needed.
+
+	\returns \link HF_STATUS::OK \endlink on success.
+	\returns \link HF_STATUS::INVALID_PTR \endlink if `points` or `out_ids` are null, or if every axis is disabled.
+	\returns \link HF_STATUS::OUT_OF_RANGE \endlink if `k` is less than 1.
+*/
+C_INTERFACE GetKNearestNodes(
+	const HF::SpatialStructures::Graph* g,
+	const float* points,
+	int num_points,
+	int k,
+	bool use_x,
+	bool use_y,
+	bool use_z,
+	int* out_ids,
+	float* out_distances
+);
+
+/*!
+	\brief		Find every node in a graph within a radius of every point in an array of points.
+
+	\param	g						The graph to search.
+	\param	points					Points to search from. Each point contains one float for every axis
+									enabled by `use_x`, `use_y`, and `use_z`, in x, y, z order.
+	\param	num_points				Number of points in `points`.
+	\param	radius					Maximum distance from each point.
+	\param	use_x					Include the x axis in distance calculations.
+	\param	use_y					Include the y axis in distance calculations.
+	\param	use_z					Include the z axis in distance calculations.
+	\param	out_offsets_vector		Output parameter for a vector of `num_points + 1` offsets. The nodes in range
+									of the point at index `i` are stored between `offsets[i]` and `offsets[i + 1]`.
+	\param	out_offsets_data		Output parameter for the data of `out_offsets_vector`.
+	\param	out_ids_vector			Output parameter for a vector of the IDs of nodes in range of each point,
+									sorted from nearest to furthest.
+	\param	out_ids_data			Output parameter for the data of `out_ids_vector`.
+	\param	out_distances_vector	Output parameter for a vector of the distance to each node in `out_ids_vector`.
+	\param	out_distances_data		Output parameter for the data of `out_distances_vector`.
+	\param	out_size				Output parameter for the number of elements in `out_ids_vector` and `out_distances_vector`.
+
+	\returns \link HF_STATUS::OK \endlink on success.
+	\returns \link HF_STATUS::INVALID_PTR \endlink if `points` is null, or if every axis is disabled.
+
+	\post The caller is responsible for deleting the output vectors with DestroyIntVector and DestroyFloatVector.
+*/
+C_INTERFACE GetNodesWithinRadius(
+	const HF::SpatialStructures::Graph* g,
+	const float* points,
+	int num_points,
+	float radius,
+	bool use_x,
+	bool use_y,
+	bool use_z,
+	std::vector<int>** out_offsets_vector,
+	int** out_offsets_data,
+	std::vector<int>** out_ids_vector,
+	int** out_ids_data,
+	std::vector<float>** out_distances_vector,
+	float** out_distances_data,
+	int* out_size
+);
 /**@}*/
@@ -1,5 +1,7 @@
 #include <view_analysis_C.h>
 #include <robin_hood.h>
+#include <algorithm>
+#include <array>
 
 #include <HFExceptions.h>
 #include <view_analysis.h>
@@ -152,4 +154,86 @@ C_INTERFACE SphericalDistribute(
 	return OK;
 }
 
+/*!
+	\brief State of a view analysis that is calculated one chunk of nodes at a time.
+*/
+struct ViewAnalysisStream {
+	EmbreeRayTracer* ert;								///< Raytracer to cast rays at.
+	vector<std::array<float, 3>> nodes;				///< Every node to analyze.
+	vector<std::array<float, 3>> directions;			///< Directions to cast rays in from every node.
+	float height;										///< Height to offset nodes from the ground.
+	int chunk_size;										///< Maximum number of nodes to analyze at once.
+	int next_node = 0;									///< Index of the first node in the next chunk.
+	vector<RayResult> results;							///< Results of the last chunk.
+};
+
+C_INTERFACE CreateViewAnalysisStream(
+	EmbreeRayTracer* ERT,
+	const float* node_ptr,
+	int node_size,
+	int* max_rays,
+	float upward_fov,
+	float downward_fov,
+	float height,
+	int chunk_size,
+	ViewAnalysisStream** out_stream)
+{
+	if (!ERT || !node_ptr || !max_rays || !out_stream) return INVALID_PTR;
+	if (chunk_size < 1) return OUT_OF_RANGE;
+
+	auto stream = new ViewAnalysisStream();
+	stream->ert = ERT;
+	stream->nodes = ConvertRawFloatArrayToPoints(node_ptr, node_size);
+	stream->directions = ViewAnalysis::FibbonacciDistributePoints(*max_rays, upward_fov, downward_fov);
+	stream->height = height;
+	stream->chunk_size = chunk_size;
+
+	*max_rays = stream->directions.size();
+	*out_stream = stream;
+	return OK;
+}
+
+C_INTERFACE ViewAnalysisStreamNext(
+	ViewAnalysisStream* stream,
+	RayResult** out_results_ptr,
+	int* out_start,
+	int* out_count)
+{
+	if (!stream || !out_results_ptr || !out_start || !out_count) return INVALID_PTR;
+
+	const int num_nodes = stream->nodes.size();
+	const int start = stream->next_node;
+	const int count = std::min(stream->chunk_size, num_nodes - start);
+	const size_t num_directions = stream->directions.size();
+
+	*out_start = start;
+	*out_count = std::max(count, 0);
+	if (count <= 0) {
+		*out_results_ptr = nullptr;
+		return OK;
+	}
 
+	// Clear the results of the last chunk before casting rays for this one
+	stream->results.assign(num_directions * count, RayResult());
+
+#pragma omp parallel for schedule(dynamic)
+	for (int i = 0; i < count; i++) {
+		ViewAnalysis::CastViewRays(
+			*stream->ert,
+			stream->nodes[start + i],
+			stream->directions,
+			stream->height,
+			stream->results.data() + num_directions * i
+		);
+	}
+
+	stream->next_node += count;
+	*out_results_ptr = stream->results.data();
+	return OK;
+}
+
+C_INTERFACE DestroyViewAnalysisStream(ViewAnalysisStream* stream)
+{
+	if (stream) delete stream;
+	return OK;
+}
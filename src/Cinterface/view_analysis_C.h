@@ -26,6 +26,8 @@ namespace HF {
 	}
 }
 
+struct ViewAnalysisStream;
+
 /*!
 	\enum		AGGREGATE_TYPE
 	\brief		Determines how to aggregate edges from the results of view analysis
@@ -447,6 +449,79 @@ C_INTERFACE SphericalDistribute(
 	float downward_fov
 );
 
+/*!
+	\brief	Start a view analysis that returns the result of every ray in fixed size chunks of nodes.
+
+	\param	ERT				Raytracer containing the geometry to cast rays at.
+	\param	node_ptr		Array of floats where every three floats are the x, y, z coordinates of a node.
+	\param	node_size		Number of nodes in node_ptr.
+	\param	max_rays		Number of rays to cast from each node. This will be updated with the actual
+							number of rays cast from each node.
+	\param	upward_fov		Maximum degrees upward from the viewer's eye level to consider.
+	\param	downward_fov	Maximum degrees downward from the viewer's eye level to consider.
+	\param	height			Height to offset each node from the ground.
+	\param	chunk_size		Maximum number of nodes to analyze in each chunk.
+	\param	out_stream		Output parameter for the new stream.
+
+	\returns HF_STATUS::OK on completion.
+	\returns HF_STATUS::INVALID_PTR if ERT, node_ptr, max_rays, or out_stream were null.
+	\returns HF_STATUS::OUT_OF_RANGE if chunk_size was less than 1.
+
+	\details
+	No rays are cast until \link ViewAnalysisStreamNext \endlink is called. Only the results of a single chunk
+	are held in memory at a time, allowing the per-ray results of very large analyses to be written to disk
+	or summarized as they're calculated.
+
+	\par Caller's Responsibility
+	The caller must call \link DestroyViewAnalysisStream \endlink with out_stream when finished. The raytracer
+	must not be destroyed until then.
+
+	\see	\link HF::ViewAnalysis::SphericalViewAnalysisStream \endlink for the C++ equivalent of this function.
+*/
+C_INTERFACE CreateViewAnalysisStream(
+	HF::RayTracer::EmbreeRayTracer* ERT,
+	const float* node_ptr,
+	int node_size,
+	int* max_rays,
+	float upward_fov,
+	float downward_fov,
+	float height,
+	int chunk_size,
+	ViewAnalysisStream** out_stream
+);
+
+/*!
+	\brief	Analyze the next chunk of nodes in a view analysis stream.
+
+	\param	stream			Stream created by \link CreateViewAnalysisStream \endlink.
+	\param	out_results_ptr	Output parameter for the results of the chunk. Results are laid out in the same
+							way as \link SphericalViewAnalysisNoAggregateFlat \endlink, with max_rays results per node.
+	\param	out_start		Output parameter for the index of the first node in the chunk.
+	\param	out_count		Output parameter for the number of nodes in the chunk. This will be 0 once every
+							node has been analyzed.
+
+	\returns HF_STATUS::OK on completion.
+	\returns HF_STATUS::INVALID_PTR if stream or any of the output parameters were null.
+
+	\remarks The memory pointed to by out_results_ptr is owned by the stream, and is overwritten by the next
+	call to this function.
+*/
+C_INTERFACE ViewAnalysisStreamNext(
+	ViewAnalysisStream* stream,
+	RayResult** out_results_ptr,
+	int* out_start,
+	int* out_count
+);
+
+/*!
+	\brief	Delete a view analysis stream.
+
+	\param	stream	Stream created by \link CreateViewAnalysisStream \endlink.
+
+	\returns HF_STATUS::OK on completion.
+*/
+C_INTERFACE DestroyViewAnalysisStream(ViewAnalysisStream* stream);
+
 /**@}*/
 
 #endif /* VIEW_ANALYSIS_C_H */
@@ -1,6 +1,7 @@
 #include "visibility_graph_C.h"
 
 #include <vector>
+#include <array>
 #include <visibility_graph.h>
 #include <embree_raytracer.h>
 #include <graph.h>
@@ -97,3 +98,109 @@ C_INTERFACE CreateVisibilityGraphGroupToGroup(
 		return HF::Exceptions::HF_STATUS::NO_GRAPH;
 	}
 }
+
+/*!
+	\brief Convert a raw array of floats to a vector of nodes.
+
+	\param nodes Array of floats where every three floats are a node.
+	\param num_nodes Number of nodes in nodes.
+*/
+inline vector<Node> ConvertRawFloatArrayToNodes(const float* nodes, int num_nodes) {
+	vector<Node> out_nodes(num_nodes);
+	for (int i = 0; i < num_nodes; i++) {
+		auto& node = out_nodes[i];
+		node[0] = nodes[i * 3]; node[1] = nodes[i * 3 + 1]; node[2] = nodes[i * 3 + 2];
+	}
+	return out_nodes;
+}
+
+C_INTERFACE CreateVisibilityGraphAllToAllCulled(
+	EmbreeRayTracer* ert,
+	const float* nodes,
+	int num_nodes,
+	Graph** out_graph,
+	float height,
+	float max_distance,
+	float fov,
+	const float* view_directions,
+	int num_view_directions,
+	const int cores
+) {
+	const auto vector_of_nodes = ConvertRawFloatArrayToNodes(nodes, num_nodes);
+
+	vector<std::array<float, 3>> directions;
+	if (view_directions && num_view_directions > 0)
+		directions = ConvertRawFloatArrayToPoints(view_directions, num_view_directions);
+
+	Graph graph;
+	try {
+		graph = VisibilityGraph::AllToAllCulled(*ert, vector_of_nodes, height, max_distance, fov, directions, cores);
+	}
+	catch (const std::out_of_range&) {
+		return HF::Exceptions::HF_STATUS::OUT_OF_RANGE;
+	}
+
+	if (!graph.GetCSRPointers().AreValid())
+		return HF::Exceptions::HF_STATUS::NO_GRAPH;
+
+	*out_graph = new Graph();
+	**out_graph = graph;
+	return HF::Exceptions::HF_STATUS::OK;
+}
+
+C_INTERFACE CreateVisibilityGraphAllToAllUndirectedCulled(
+	EmbreeRayTracer* ert,
+	const float* nodes,
+	int num_nodes,
+	Graph** out_graph,
+	float height,
+	float max_distance,
+	const int cores
+) {
+	const auto vector_of_nodes = ConvertRawFloatArrayToNodes(nodes, num_nodes);
+
+	Graph* vg = new Graph();
+	*vg = VisibilityGraph::AllToAllUndirectedCulled(*ert, vector_of_nodes, height, max_distance, cores);
+
+	*out_graph = vg;
+	return HF::Exceptions::HF_STATUS::OK;
+}
+
+C_INTERFACE CreateVisibilityGraphGroupToGroupCulled(
+	EmbreeRayTracer* ert,
+	const float* group_a,
+	const int size_a,
+	const float* group_b,
+	const int size_b,
+	Graph** out_graph,
+	float height,
+	float max_distance,
+	float fov,
+	const float* view_directions,
+	int num_view_directions,
+	const int cores
+) {
+	const auto vector_a = ConvertRawFloatArrayToNodes(group_a, size_a);
+	const auto vector_b = ConvertRawFloatArrayToNodes(group_b, size_b);
+
+	vector<std::array<float, 3>> directions;
+	if (view_directions && num_view_directions > 0)
+		directions = ConvertRawFloatArrayToPoints(view_directions, num_view_directions);
+
+	Graph graph;
+	try {
+		graph = VisibilityGraph::GroupToGroupCulled(
+			*ert, vector_a, vector_b, height, max_distance, fov, directions, cores
+		);
+	}
+	catch (const std::out_of_range&) {
+		return HF::Exceptions::HF_STATUS::OUT_OF_RANGE;
+	}
+
+	if (!graph.GetCSRPointers().AreValid())
+		return HF::Exceptions::HF_STATUS::NO_GRAPH;
+
+	*out_graph = new Graph();
+	**out_graph = graph;
+	return HF::Exceptions::HF_STATUS::OK;
+}
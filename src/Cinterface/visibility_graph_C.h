@@ -226,6 +226,108 @@ C_INTERFACE CreateVisibilityGraphGroupToGroup(
 	float height
 );
 
+/*!
+	\brief		Create a new directed visibility graph between nodes that are within a maximum distance of each other.
+
+	\param		ert			The raytracer to cast rays from
+	\param		nodes		Coordinates of nodes to use in generating the visibility graph.
+							Every three floats should represent a single node (point) {x, y, z}
+	\param		num_nodes	Amount of nodes (points) in nodes.
+	\param		out_graph	Address of a pointer to a \link HF::SpatialStructures::Graph \endlink.
+							*(out_graph) will point to memory allocated by \link CreateVisibilityGraphAllToAllCulled \endlink.
+	\param		height		How far to offset nodes from the ground.
+	\param		max_distance	Maximum distance between connected nodes. Values less than or equal to zero disable this limit.
+	\param		fov			Field of view of every node in degrees. Values of 360 or greater disable the field of view check.
+	\param		view_directions	Directions that nodes are looking in. Every three floats represent a single direction.
+							May be null if fov is disabled.
+	\param		num_view_directions	Number of directions in view_directions. Must be 0, 1, or num_nodes.
+	\param		cores		CPU core count. A value of (-1) means to use all available cores on the system.
+
+	\returns	HF_STATUS::OK on completion.
+	\returns	HF_STATUS::NO_GRAPH if no edges were created.
+	\returns	HF_STATUS::OUT_OF_RANGE if num_view_directions was invalid, or 0 while fov was less than 360.
+
+	\see		\link HF::VisibilityGraph::AllToAllCulled \endlink for details on how pairs of nodes are culled.
+*/
+C_INTERFACE CreateVisibilityGraphAllToAllCulled(
+	HF::RayTracer::EmbreeRayTracer* ert,
+	const float* nodes,
+	int num_nodes,
+	HF::SpatialStructures::Graph** out_graph,
+	float height,
+	float max_distance,
+	float fov,
+	const float* view_directions,
+	int num_view_directions,
+	const int cores
+);
+
+/*!
+	\brief		Create a new undirected visibility graph between nodes that are within a maximum distance of each other.
+
+	\param		ert			The raytracer to cast rays from
+	\param		nodes		Coordinates of nodes to use in generating the visibility graph.
+							Every three floats should represent a single node (point) {x, y, z}
+	\param		num_nodes	Amount of nodes (points) in nodes.
+	\param		out_graph	Address of a pointer to a \link HF::SpatialStructures::Graph \endlink.
+							*(out_graph) will point to memory allocated by \link CreateVisibilityGraphAllToAllUndirectedCulled \endlink.
+	\param		height		How far to offset nodes from the ground.
+	\param		max_distance	Maximum distance between connected nodes. Values less than or equal to zero disable this limit.
+	\param		cores		CPU core count. A value of (-1) means to use all available cores on the system.
+
+	\returns	HF_STATUS::OK on completion.
+
+	\see		\link HF::VisibilityGraph::AllToAllUndirectedCulled \endlink
+*/
+C_INTERFACE CreateVisibilityGraphAllToAllUndirectedCulled(
+	HF::RayTracer::EmbreeRayTracer* ert,
+	const float* nodes,
+	int num_nodes,
+	HF::SpatialStructures::Graph** out_graph,
+	float height,
+	float max_distance,
+	const int cores
+);
+
+/*!
+	\brief		Create a new visibility graph from the nodes in group_a to the nodes of group_b within a maximum distance.
+
+	\param		ert			The raytracer to cast rays from
+	\param		group_a		Coordinates of nodes to cast rays from. Every three floats represent a single node.
+	\param		size_a		Amount of nodes (points) in group_a.
+	\param		group_b		Coordinates of nodes to cast rays at. Every three floats represent a single node.
+	\param		size_b		Amount of nodes (points) in group_b.
+	\param		out_graph	Address of a pointer to a \link HF::SpatialStructures::Graph \endlink.
+							*(out_graph) will point to memory allocated by \link CreateVisibilityGraphGroupToGroupCulled \endlink.
+	\param		height		How far to offset nodes from the ground.
+	\param		max_distance	Maximum distance between connected nodes. Values less than or equal to zero disable this limit.
+	\param		fov			Field of view of every node in group_a in degrees. Values of 360 or greater disable the field of view check.
+	\param		view_directions	Directions that nodes in group_a are looking in. Every three floats represent a single direction.
+							May be null if fov is disabled.
+	\param		num_view_directions	Number of directions in view_directions. Must be 0, 1, or size_a.
+	\param		cores		CPU core count. A value of (-1) means to use all available cores on the system.
+
+	\returns	HF_STATUS::OK on completion.
+	\returns	HF_STATUS::NO_GRAPH if no edges were created.
+	\returns	HF_STATUS::OUT_OF_RANGE if num_view_directions was invalid, or 0 while fov was less than 360.
+
+	\see		\link HF::VisibilityGraph::GroupToGroupCulled \endlink
+*/
+C_INTERFACE CreateVisibilityGraphGroupToGroupCulled(
+	HF::RayTracer::EmbreeRayTracer* ert,
+	const float* group_a,
+	const int size_a,
+	const float* group_b,
+	const int size_b,
+	HF::SpatialStructures::Graph** out_graph,
+	float height,
+	float max_distance,
+	float fov,
+	const float* view_directions,
+	int num_view_directions,
+	const int cores
+);
+
 /**@}*/
 
 #endif /* VISIBILITY_GRAPH_C_H */
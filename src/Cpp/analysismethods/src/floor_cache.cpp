@@ -0,0 +1,76 @@
+///
+/// \file		floor_cache.cpp
+/// \brief		Contains implementation for the <see cref="HF::GraphGenerator::FloorCache">FloorCache</see> class
+///
+///	\author		TBA
+///	\date		26 Jun 2020
+
+#include <floor_cache.h>
+
+namespace HF::GraphGenerator {
+
+	FloorCache::FloorCache(real_t spacing_precision, real_t z_precision)
+		: shards(new Shard[num_shards]), spacing_precision(spacing_precision), z_precision(z_precision) {}
+
+	CellKey FloorCache::KeyFor(const real3& pt) const
+	{
+		return ToCellKey(pt, spacing_precision, z_precision);
+	}
+
+	FloorCache::Shard& FloorCache::ShardFor(const CellKey& key)
+	{
+		return shards[CellKeyHash()(key) & (num_shards - 1)];
+	}
+
+	bool FloorCache::Find(const real3& origin, optional_real3& out_result)
+	{
+		const CellKey key = KeyFor(origin);
+		Shard& shard = ShardFor(key);
+
+		{
+			std::lock_guard<std::mutex> lock(shard.lock);
+			const auto it = shard.cells.find(key);
+			if (it != shard.cells.end()) {
+				out_result = it->second;
+				hits.fetch_add(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+
+		misses.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	void FloorCache::Insert(const real3& origin, const optional_real3& result)
+	{
+		const CellKey key = KeyFor(origin);
+		Shard& shard = ShardFor(key);
+
+		std::lock_guard<std::mutex> lock(shard.lock);
+		shard.cells[key] = result;
+	}
+
+	int64_t FloorCache::Hits() const { return hits.load(); }
+
+	int64_t FloorCache::Misses() const { return misses.load(); }
+
+	size_t FloorCache::size()
+	{
+		size_t total = 0;
+		for (int i = 0; i < num_shards; i++) {
+			std::lock_guard<std::mutex> lock(shards[i].lock);
+			total += shards[i].cells.size();
+		}
+		return total;
+	}
+
+	void FloorCache::Clear()
+	{
+		for (int i = 0; i < num_shards; i++) {
+			std::lock_guard<std::mutex> lock(shards[i].lock);
+			shards[i].cells.clear();
+		}
+		hits = 0;
+		misses = 0;
+	}
+}
@@ -0,0 +1,112 @@
+///
+/// \file		floor_cache.h
+/// \brief		Contains definitions for the <see cref="HF::GraphGenerator::FloorCache">FloorCache</see> class
+///
+///	\author		TBA
+///	\date		26 Jun 2020
+
+#include <robin_hood.h>
+#include <graph_generator.h>
+#include <lattice_index.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#ifndef FLOOR_CACHE_INCLUDE_GUARD
+#define FLOOR_CACHE_INCLUDE_GUARD
+
+namespace HF::GraphGenerator {
+
+	/*!
+		\brief A thread safe cache of downward ray results keyed on lattice cells.
+
+		\details
+		Neighbouring parents in the graph generator generate many of the same children, and every child
+		requires a downward ray to find the floor beneath it. Since the result of that ray only depends on
+		the child's position, it can be stored the first time it's cast and reused by every other parent
+		that generates the same child. Results are stored for both hits and misses.
+
+		The cache is split into several shards, each with its own lock, so multiple threads can
+		read and write to the cache at the same time without contending on a single mutex.
+
+		\remarks
+		If two threads miss on the same cell at the same time, both will cast the ray and the second
+		insert will overwrite the first with an identical result.
+
+		\see CheckChildren for how the cache is consulted.
+	*/
+	class FloorCache {
+	private:
+		/*! \brief A section of the cache guarded by its own lock. */
+		struct Shard {
+			std::mutex lock; ///< Lock for reading and writing to cells.
+			robin_hood::unordered_map<CellKey, optional_real3, CellKeyHash> cells; ///< Results of every cached ray.
+		};
+
+		static constexpr int num_shards = 64; ///< Number of shards the cache is split into. Must be a power of 2.
+
+		std::unique_ptr<Shard[]> shards; ///< Shards holding the cached results.
+		real_t spacing_precision; ///< Precision used to convert the x and y coordinates to integers.
+		real_t z_precision; ///< Precision used to convert the z coordinate to an integer.
+
+		std::atomic<int64_t> hits{ 0 }; ///< Number of lookups that found a cached result.
+		std::atomic<int64_t> misses{ 0 }; ///< Number of lookups that had no cached result.
+
+		/*! \brief Get the shard responsible for a key. */
+		Shard& ShardFor(const CellKey& key);
+
+	public:
+		/*!
+			\brief Construct an empty cache.
+
+			\param spacing_precision Precision that the x and y components of children are rounded to.
+			\param z_precision Precision that the z component of children are rounded to.
+		*/
+		FloorCache(real_t spacing_precision, real_t z_precision);
+
+		/*!
+			\brief Get the lattice cell of a point.
+
+			\param pt Point to get the cell of.
+
+			\returns The integer coordinates of the cell containing `pt`.
+		*/
+		CellKey KeyFor(const real3& pt) const;
+
+		/*!
+			\brief Look for the cached result of a downward ray cast from `origin`.
+
+			\param origin Origin of the downward ray.
+			\param out_result Set to the cached result if one was found.
+
+			\returns True if a result was found and `out_result` was updated, false otherwise.
+
+			\post Increments the hit or miss counter.
+		*/
+		bool Find(const real3& origin, optional_real3& out_result);
+
+		/*!
+			\brief Store the result of a downward ray cast from `origin`.
+
+			\param origin Origin of the downward ray.
+			\param result Result of the ray. May be an invalid optional_real3 if the ray missed.
+		*/
+		void Insert(const real3& origin, const optional_real3& result);
+
+		/*! \brief Number of lookups that found a cached result. */
+		int64_t Hits() const;
+
+		/*! \brief Number of lookups that didn't find a cached result. */
+		int64_t Misses() const;
+
+		/*! \brief Number of cells currently stored in the cache. */
+		size_t size();
+
+		/*! \brief Remove every cached result and reset the hit and miss counters. */
+		void Clear();
+	};
+}
+
+#endif
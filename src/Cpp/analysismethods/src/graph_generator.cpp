@@ -10,15 +10,22 @@
 #include <node.h>
 #include <edge.h>
 #include <graph.h>
+#include <graph_builder.h>
 #include <robin_hood.h>
 #include <omp.h>
 
 #include <unique_queue.h>
+#include <floor_cache.h>
+#include <lattice_index.h>
+#include <embree_raytracer.h>
+#include <ray_data.h>
 
+#include <algorithm>
 #include <iostream>
 #include <thread>
 
 using HF::SpatialStructures::Graph;
+using HF::SpatialStructures::GraphBuilder;
 using HF::SpatialStructures::Node;
 using HF::SpatialStructures::Edge;
 using HF::SpatialStructures::roundhf_tmp;
@@ -60,6 +67,10 @@ namespace HF::GraphGenerator{
 		setupRT<HF::RayTracer::NanoRTRayTracer> (this, rt, obstacle_ids, walkable_ids);
 	}
 
+	GraphGenerator::GraphGenerator(HF::RayTracer::NanoRTRayTracerFloat & rt, const vector<int> & obstacle_ids, const vector<int> & walkable_ids) {
+		setupRT<HF::RayTracer::NanoRTRayTracerFloat> (this, rt, obstacle_ids, walkable_ids);
+	}
+
 	GraphGenerator::GraphGenerator(HF::RayTracer::MultiRT & ray_tracer, const vector<int> & obstacle_ids, const vector<int> & walkable_ids)
 	{
 		this->ray_tracer = ray_tracer;
@@ -128,7 +139,10 @@ namespace HF::GraphGenerator{
 			if (this->core_count != 0 && this->core_count != 1)
 			{
 				SetupCoreCount(this->core_count);
-				return CrawlGeomParallel(to_do_list);
+				if (this->use_lattice_engine)
+					return CrawlGeomLattice(start);
+				else
+					return CrawlGeomParallel(to_do_list);
 			}
 			// Run the single core version of the graph generator
 			else
@@ -139,6 +153,13 @@ namespace HF::GraphGenerator{
 	}
 
 	Graph GraphGenerator::CrawlGeomParallel(UniqueQueue& todo)
+	{
+		// Resolve the raytracer's type once so every ray in the search is cast on it directly
+		return this->ray_tracer.Visit([&](auto& rt) { return CrawlGeomParallel(todo, rt); });
+	}
+
+	template <typename raytracer_type>
+	Graph GraphGenerator::CrawlGeomParallel(UniqueQueue& todo, raytracer_type& rt_ref)
 	{
 		// Generate the set of directions to use for each set of possible children
 		// Uses the maximum connection defined by the user
@@ -147,9 +168,13 @@ namespace HF::GraphGenerator{
 		// Initialize a tracker for the number of nodes that can be compared to the max nodes limit
 		int num_nodes = 0;
 
-		RayTracer & rt_ref = this->ray_tracer;
+		// Children shared between parents only need to have their floor checked once
+		FloorCache floor_cache(params.precision.node_spacing, params.precision.node_z);
+		FloorCache * cache_ptr = use_floor_cache ? &floor_cache : nullptr;
+
+		// Edges are collected in order and added to the graph all at once at the end
+		GraphBuilder builder(1);
 
-		Graph G;
 		// Iterate through every node int the todo-list while it does not reach the maximum number of nodes limit
 		while (!todo.empty() && (num_nodes < max_nodes || max_nodes < 0))
 		{
@@ -193,7 +218,8 @@ namespace HF::GraphGenerator{
 					real_parent,
 					children,
 					rt_ref,
-					params
+					params,
+					cache_ptr
 				);
 			}
 
@@ -207,7 +233,7 @@ namespace HF::GraphGenerator{
 					// Iterate through each edge and add it to the graph / todolist
 					for (const auto& e : OutEdges[i]) {
 						todo.push(e.child);
-						G.addEdge(to_be_done[i], e.child, e.score);
+						builder.AddEdge(0, to_be_done[i], e.child, e.score);
 					}
 					
 					// Increment max nodes
@@ -216,16 +242,173 @@ namespace HF::GraphGenerator{
 			}
 		}
 
+		floor_cache_hits = floor_cache.Hits();
+		floor_cache_misses = floor_cache.Misses();
+
+		// Nodes get the same IDs they would if the edges were added one at a time
+		Graph G;
+		G.BulkAddEdges(builder);
 		return G;
 	}
 
+	Graph GraphGenerator::CrawlGeomLattice(const real3& start)
+	{
+		return this->ray_tracer.Visit([&](auto& rt) { return CrawlGeomLattice(start, rt); });
+	}
+
+	template <typename raytracer_type>
+	Graph GraphGenerator::CrawlGeomLattice(const real3& start, raytracer_type& rt_ref)
+	{
+		// Generate the set of directions to use for each set of possible children
+		const auto directions = CreateDirecs(max_step_connection);
+
+		// Children shared between parents only need to have their floor checked once
+		FloorCache floor_cache(params.precision.node_spacing, params.precision.node_z);
+		FloorCache* cache_ptr = use_floor_cache ? &floor_cache : nullptr;
+
+		// Assigns IDs to nodes from their position on the lattice
+		LatticeIndex index(params.precision.node_spacing, params.precision.node_z);
+
+		// Give every thread its own buffers so they never need to lock to store results.
+		// Edges are stored by the IDs the index hands out, which depend on which thread found
+		// each node first, so they're renumbered before being added to the graph.
+		const int num_threads = omp_get_max_threads();
+		vector<vector<int>> thread_parents(num_threads);
+		vector<vector<int>> thread_children(num_threads);
+		vector<vector<float>> thread_costs(num_threads);
+		vector<vector<Node>> thread_frontiers(num_threads);
+
+		// Add the start point as the first node
+		bool inserted = false;
+		Node start_node(start[0], start[1], start[2], index.GetOrAssignID(start, inserted));
+		vector<Node> frontier{ start_node };
+		vector<Node> nodes{ start_node };
+
+		// Final ID of every node, indexed by the ID the index assigned it
+		vector<int> final_ids{ 0 };
+
+		// Order nodes by their lattice cell, since their positions are already rounded to it
+		const auto by_cell = [&](const Node& n1, const Node& n2) {
+			return ToCellKey(CastToReal3(n1), params.precision.node_spacing, params.precision.node_z)
+				< ToCellKey(CastToReal3(n2), params.precision.node_spacing, params.precision.node_z);
+		};
+
+		int num_nodes = 0;
+		while (!frontier.empty() && (num_nodes < max_nodes || max_nodes < 0))
+		{
+			// If max_nodes will be exceeded, then only evaluate as many nodes as are left
+			int to_do_count = frontier.size();
+			if (max_nodes > 0)
+				to_do_count = std::min(to_do_count, max_nodes - num_nodes);
+
+			int expanded = 0;
+
+			#pragma omp parallel for schedule(dynamic) reduction(+:expanded) if (to_do_count > 100)
+			for (int i = 0; i < to_do_count; i++)
+			{
+				const int thread = omp_get_thread_num();
+				const Node& parent = frontier[i];
+				const auto real_parent = CastToReal3(parent);
+
+				// Generate children around this parent then check which ones are valid
+				const std::vector<real3> children = GeneratePotentialChildren(
+					real_parent,
+					directions,
+					spacing,
+					params
+				);
+
+				const std::vector<graph_edge> out_edges = GetChildren(
+					real_parent,
+					children,
+					rt_ref,
+					params,
+					cache_ptr
+				);
+
+				// Only continue if there are edges for this node and the number of edges is the minimum desired
+				if (out_edges.empty() || out_edges.size() < this->min_connections) continue;
+
+				for (const auto& edge : out_edges) {
+
+					// If this child hasn't been seen before, this thread is responsible for adding
+					// it to the next frontier
+					bool is_new = false;
+					const int child_id = index.GetOrAssignID(CastToReal3(edge.child), is_new);
+					if (is_new) {
+						thread_frontiers[thread].push_back(edge.child);
+						thread_frontiers[thread].back().id = child_id;
+					}
+
+					thread_parents[thread].push_back(parent.id);
+					thread_children[thread].push_back(child_id);
+					thread_costs[thread].push_back(edge.score);
+				}
+
+				expanded++;
+			}
+			num_nodes += expanded;
+
+			// Gather every new node found by each thread, then sort them so the order of the
+			// next frontier and the IDs they're given don't depend on how the work was split
+			vector<Node> new_nodes;
+			for (auto& thread_frontier : thread_frontiers) {
+				new_nodes.insert(new_nodes.end(), thread_frontier.begin(), thread_frontier.end());
+				thread_frontier.clear();
+			}
+			std::sort(new_nodes.begin(), new_nodes.end(), by_cell);
+
+			// New nodes are numbered in the order they're added, after every node from earlier frontiers
+			final_ids.resize(index.size());
+			for (const Node& node : new_nodes) {
+				final_ids[node.id] = static_cast<int>(nodes.size());
+				nodes.push_back(node);
+			}
+
+			// Any nodes that couldn't be evaluated due to max_nodes are kept for the next frontier,
+			// followed by the new nodes.
+			vector<Node> next_frontier(frontier.begin() + to_do_count, frontier.end());
+			next_frontier.insert(next_frontier.end(), new_nodes.begin(), new_nodes.end());
+			frontier = std::move(next_frontier);
+		}
+
+		floor_cache_hits = floor_cache.Hits();
+		floor_cache_misses = floor_cache.Misses();
+
+		// Give every node its final ID, which is its index in nodes
+		for (int i = 0; i < static_cast<int>(nodes.size()); i++)
+			nodes[i].id = i;
+
+		// Move every thread's edges to their final IDs
+		GraphBuilder edges(num_threads);
+		#pragma omp parallel for schedule(static)
+		for (int thread = 0; thread < num_threads; thread++) {
+			vector<int>& parents = thread_parents[thread];
+			vector<int>& children = thread_children[thread];
+			for (int& id : parents) id = final_ids[id];
+			for (int& id : children) id = final_ids[id];
+
+			edges.AddEdges(thread, parents.data(), children.data(), thread_costs[thread].data(), static_cast<int>(parents.size()));
+		}
+
+		// Build the CSR from every thread's edges all at once
+		return Graph(nodes, edges);
+	}
+
 	Graph GraphGenerator::CrawlGeom(UniqueQueue& todo)
+	{
+		return this->ray_tracer.Visit([&](auto& rt) { return CrawlGeom(todo, rt); });
+	}
+
+	template <typename raytracer_type>
+	Graph GraphGenerator::CrawlGeom(UniqueQueue& todo, raytracer_type& rt_ref)
 	{
 		// Create directions
 		const auto directions = CreateDirecs(this->max_step_connection);
 
-		// Cast this to a reference to avoid dereferencing every time
-		RayTracer& rt_ref = this->ray_tracer;
+		// Children shared between parents only need to have their floor checked once
+		FloorCache floor_cache(params.precision.node_spacing, params.precision.node_z);
+		FloorCache* cache_ptr = use_floor_cache ? &floor_cache : nullptr;
 
 		int num_nodes = 0;
 		Graph G;
@@ -250,7 +433,8 @@ namespace HF::GraphGenerator{
 				real_parent,
 				children,
 				rt_ref,
-				params
+				params,
+				cache_ptr
 			);
 
 			// Make
@@ -271,6 +455,160 @@ namespace HF::GraphGenerator{
 				num_nodes++;
 			}
 		}
+
+		floor_cache_hits = floor_cache.Hits();
+		floor_cache_misses = floor_cache.Misses();
+
 		return G;
 	}
-}
\ No newline at end of file
+
+	/*! \brief Check if a node is within the box from `box_min` to `box_max`. */
+	inline bool InBox(const Node& node, const real3& box_min, const real3& box_max) {
+		for (int i = 0; i < 3; i++)
+			if (node[i] < box_min[i] || node[i] > box_max[i]) return false;
+		return true;
+	}
+
+	int GraphGenerator::RegenerateRegion(Graph& graph, const real3& region_min, const real3& region_max)
+	{
+		return this->ray_tracer.Visit([&](auto& rt) { return RegenerateRegion(graph, region_min, region_max, rt); });
+	}
+
+	template <typename raytracer_type>
+	int GraphGenerator::RegenerateRegion(Graph& graph, const real3& region_min, const real3& region_max, raytracer_type& rt_ref)
+	{
+		const auto directions = CreateDirecs(this->max_step_connection);
+
+		// A node's children are at most max_step_connection steps away from it. Every ray cast to
+		// check them is between down_step below the node and the highest offset above it, so only
+		// nodes within this distance of the region could have cast a ray through it.
+		const real_t reach_x = spacing[0] * max_step_connection + params.precision.node_spacing;
+		const real_t reach_y = spacing[1] * max_step_connection + params.precision.node_spacing;
+		const real_t reach_up = std::max({ spacing[2], params.up_step, params.down_step }) + params.precision.ground_offset;
+		const real3 affected_min{ region_min[0] - reach_x, region_min[1] - reach_y, region_min[2] - reach_up };
+		const real3 affected_max{ region_max[0] + reach_x, region_max[1] + reach_y, region_max[2] + params.down_step };
+
+		// Find every affected node, then remove all of their edges
+		graph.Compress();
+		const vector<Node> nodes = graph.Nodes();
+		vector<bool> affected(nodes.size(), false);
+		vector<int> affected_ids;
+		for (const Node& node : nodes) {
+			if (InBox(node, affected_min, affected_max)) {
+				affected[node.id] = true;
+				affected_ids.push_back(node.id);
+			}
+		}
+		if (affected_ids.empty()) return 0;
+
+		graph.RemoveOutgoingEdges(affected_ids);
+
+		// Edges from unaffected nodes never touched the region, so any affected node they lead to
+		// is still valid and is where the search starts from
+		vector<bool> visited(nodes.size(), false);
+		vector<Node> frontier;
+		for (const auto& edge_set : graph.GetEdges()) {
+			for (const auto& edge : edge_set.children) {
+				if (affected[edge.child] && !visited[edge.child]) {
+					visited[edge.child] = true;
+					frontier.push_back(nodes[edge.child]);
+				}
+			}
+		}
+
+		// If the start point was affected, check that it's still over the ground
+		if (affected[0] && !visited[0]) {
+			const optional_real3 start = ValidateStartPoint(rt_ref, CastToReal3(nodes[0]), params);
+			if (start) {
+				visited[0] = true;
+				frontier.push_back(Node(start.pt[0], start.pt[1], start.pt[2]));
+			}
+		}
+
+		// Children shared between parents only need to have their floor checked once
+		FloorCache floor_cache(params.precision.node_spacing, params.precision.node_z);
+		FloorCache* cache_ptr = use_floor_cache ? &floor_cache : nullptr;
+
+		// Inserting edges into the CSR one at a time would shift every edge after them, so store
+		// them all and add them at once. Nodes aren't added to the graph until then, so new nodes
+		// are tracked here to make sure each one is only crawled once.
+		GraphBuilder builder(1);
+		robin_hood::unordered_map<Node, bool> new_nodes;
+
+		int num_nodes = 0;
+		while (!frontier.empty() && (num_nodes < max_nodes || max_nodes < 0))
+		{
+			// If max_nodes will be exceeded, then only evaluate as many nodes as are left
+			int to_do_count = frontier.size();
+			if (max_nodes > 0)
+				to_do_count = std::min(to_do_count, max_nodes - num_nodes);
+
+			vector<vector<Edge>> OutEdges(to_do_count);
+
+			#pragma omp parallel for schedule(dynamic) if (to_do_count > 100)
+			for (int i = 0; i < to_do_count; i++)
+			{
+				const auto real_parent = CastToReal3(frontier[i]);
+
+				const std::vector<real3> children = GeneratePotentialChildren(
+					real_parent,
+					directions,
+					spacing,
+					params
+				);
+
+				OutEdges[i] = GetChildren(
+					real_parent,
+					children,
+					rt_ref,
+					params,
+					cache_ptr
+				);
+			}
+
+			// Store the edges in order. Children that are new to the graph, or were affected and
+			// haven't been found yet, have their own edges generated in the next frontier.
+			vector<Node> next_frontier;
+			for (int i = 0; i < to_do_count; i++) {
+				if (OutEdges[i].empty() || OutEdges[i].size() < this->min_connections) continue;
+
+				for (const auto& edge : OutEdges[i]) {
+					const int child_id = graph.getID(edge.child);
+					bool needs_visit = false;
+					if (child_id < 0)
+						needs_visit = new_nodes.emplace(edge.child, true).second;
+					else if (child_id < static_cast<int>(affected.size()) && affected[child_id] && !visited[child_id]) {
+						visited[child_id] = true;
+						needs_visit = true;
+					}
+
+					builder.AddEdge(0, frontier[i], edge.child, edge.score);
+					if (needs_visit)
+						next_frontier.push_back(edge.child);
+				}
+				num_nodes++;
+			}
+			frontier = std::move(next_frontier);
+		}
+
+		floor_cache_hits = floor_cache.Hits();
+		floor_cache_misses = floor_cache.Misses();
+
+		// Alternate costs of edges that weren't regenerated are moved along with them
+		graph.BulkAddEdges(builder);
+		return num_nodes;
+	}
+
+	template Graph GraphGenerator::CrawlGeom<HF::RayTracer::EmbreeRayTracer>(UniqueQueue&, HF::RayTracer::EmbreeRayTracer&);
+	template Graph GraphGenerator::CrawlGeom<HF::RayTracer::NanoRTRayTracer>(UniqueQueue&, HF::RayTracer::NanoRTRayTracer&);
+	template Graph GraphGenerator::CrawlGeom<HF::RayTracer::NanoRTRayTracerFloat>(UniqueQueue&, HF::RayTracer::NanoRTRayTracerFloat&);
+	template Graph GraphGenerator::CrawlGeomParallel<HF::RayTracer::EmbreeRayTracer>(UniqueQueue&, HF::RayTracer::EmbreeRayTracer&);
+	template Graph GraphGenerator::CrawlGeomParallel<HF::RayTracer::NanoRTRayTracer>(UniqueQueue&, HF::RayTracer::NanoRTRayTracer&);
+	template Graph GraphGenerator::CrawlGeomParallel<HF::RayTracer::NanoRTRayTracerFloat>(UniqueQueue&, HF::RayTracer::NanoRTRayTracerFloat&);
+	template Graph GraphGenerator::CrawlGeomLattice<HF::RayTracer::EmbreeRayTracer>(const real3&, HF::RayTracer::EmbreeRayTracer&);
+	template Graph GraphGenerator::CrawlGeomLattice<HF::RayTracer::NanoRTRayTracer>(const real3&, HF::RayTracer::NanoRTRayTracer&);
+	template Graph GraphGenerator::CrawlGeomLattice<HF::RayTracer::NanoRTRayTracerFloat>(const real3&, HF::RayTracer::NanoRTRayTracerFloat&);
+	template int GraphGenerator::RegenerateRegion<HF::RayTracer::EmbreeRayTracer>(Graph&, const real3&, const real3&, HF::RayTracer::EmbreeRayTracer&);
+	template int GraphGenerator::RegenerateRegion<HF::RayTracer::NanoRTRayTracer>(Graph&, const real3&, const real3&, HF::RayTracer::NanoRTRayTracer&);
+	template int GraphGenerator::RegenerateRegion<HF::RayTracer::NanoRTRayTracerFloat>(Graph&, const real3&, const real3&, HF::RayTracer::NanoRTRayTracerFloat&);
+}
@@ -8,20 +8,25 @@
 #define _USE_MATH_DEFINES
 
 #include <cmath>
+#include <cstdint>
 #include <set>
 #include <vector>
+#include <string>
 #include <array>
 #include <node.h>
 #include <graph.h>
 #include <cassert>
 #include <variant>
 #include <MultiRT.h>
+#include <MeshFilter.h>
 #include <unordered_map>
 
 // Forward declares for embree raytracer.
 namespace HF::RayTracer {
 	class EmbreeRayTracer;
-	class NanoRTRayTracer;
+	template <typename vertex_type> class BasicNanoRTRayTracer;
+	using NanoRTRayTracer = BasicNanoRTRayTracer<double>;
+	using NanoRTRayTracerFloat = BasicNanoRTRayTracer<float>;
 }
 namespace HF::SpatialStructures {
 	class Graph;
@@ -71,6 +76,7 @@ namespace HF::GraphGenerator {
 	*/
 
 	class UniqueQueue;
+	class FloorCache;
 	struct optional_real3;
 
 	using real_t = double;							  ///< Internal decimal type of the graph generator
@@ -81,7 +87,7 @@ namespace HF::GraphGenerator {
 	constexpr real_t default_ground_offset = 0.01;
 	constexpr real_t default_spacing_precision = 0.00001;
 
-	using RayTracer = HF::RayTracer::MultiRT; ///< Type of raytracer to be used internally.
+	using RayTracer = HF::RayTracer::MultiRT; ///< Type of raytracer stored by the graph generator. Functions that cast rays are templated on the concrete raytracer instead.
 	using pair = std::pair<int, int>; ///< Type for Directions to be stored as
 
 	/*! \brief Cast an input value to real_t using static cast.
@@ -161,6 +167,7 @@ namespace HF::GraphGenerator {
 
 	private:
 		hashmap internal_dictionary;
+		HF::RayTracer::MeshFilter flagged_filter = HF::RayTracer::MeshFilter::Only({}); ///< Accepts every mesh that has a flag.
 
 		/*! \brief Set the filter mode of this GeometryFlagMap based on the input types. 
 			
@@ -205,9 +212,9 @@ namespace HF::GraphGenerator {
 			const std::vector<int> & walkable_geometry)
 		{
 			for (auto id : obstacle_geometry)
-				this->Set(id, HIT_FLAG::OBSTACLES);
+				Set(id, HIT_FLAG::OBSTACLES);
 			for (auto id : walkable_geometry)
-				this->Set(id, HIT_FLAG::FLOORS);
+				Set(id, HIT_FLAG::FLOORS);
 
 			DetermineFilterMode(walkable_geometry, obstacle_geometry);
 		}
@@ -251,6 +258,26 @@ namespace HF::GraphGenerator {
 		*/
 		inline void Set(int id, HIT_FLAG flag) {
 			internal_dictionary[id] = flag;
+			flagged_filter.SetListed(id, flag != HIT_FLAG::NO_FLAG);
+		}
+
+		/*! \brief Get a filter for rays to skip geometry that can never pass CheckGeometryID.
+
+			\returns
+			In OBSTACLES_AND_FLOORS mode, a filter that only accepts meshes flagged as floors or
+			obstacles. In every other mode every mesh is either a floor or an obstacle, so this
+			returns nullptr.
+
+			\details
+			Rays cast with this filter pass through unflagged geometry, such as glass canopies, and
+			continue on to the floor or obstacle below them instead of being discarded. Obstacles
+			are still hit so they can block the floors beneath them.
+		*/
+		inline const HF::RayTracer::MeshFilter* GetFilter() const {
+			if (Mode == GeometryFilterMode::OBSTACLES_AND_FLOORS)
+				return &flagged_filter;
+			else
+				return nullptr;
 		}
 	};
 
@@ -357,6 +384,11 @@ namespace HF::GraphGenerator {
 		GraphParams params; ///< Parameters to run the graph generator. 
 
 		RayTracer ray_tracer; ///< A pointer to the raytracer to use for ray intersections.
+
+		bool use_floor_cache = true; ///< If true, reuse the results of downward rays for children shared by multiple parents.
+		int64_t floor_cache_hits = 0; ///< Number of downward rays skipped by the floor cache in the last generation.
+		int64_t floor_cache_misses = 0; ///< Number of downward rays cast after missing the floor cache in the last generation.
+		bool use_lattice_engine = false; ///< If true, multi-core generation will use CrawlGeomLattice instead of CrawlGeomParallel. Off by default since it numbers nodes differently than CrawlGeomParallel.
 	public:
 		
 		/*! 
@@ -386,6 +418,18 @@ namespace HF::GraphGenerator {
 			are mostly disposed of before this has a chance to become a problem.
 		*/
 		GraphGenerator(HF::RayTracer::NanoRTRayTracer& ray_tracer, const std::vector<int> & obstacle_ids = std::vector<int>(0), const std::vector<int>& walkable_ids = std::vector<int>(0));
+
+		/*!
+			\brief Construct a new graph generator with a NanoRT raytracer that stores its geometry as floats.
+
+			\param ray_tracer Raytracer to use for performing ray intersctions
+			\param walkable_id IDs of geometry to be considered as obstacles
+			\param obstacle_id IDs of geometry to be considered as walkable surfaces
+
+			\details
+			Stores a pointer to RT, with the same caveats as the other constructors.
+		*/
+		GraphGenerator(HF::RayTracer::NanoRTRayTracerFloat& ray_tracer, const std::vector<int> & obstacle_ids = std::vector<int>(0), const std::vector<int>& walkable_ids = std::vector<int>(0));
 		
 		/*!
 			\brief Construct a new graph generator with a specific raytracer.
@@ -573,6 +617,24 @@ namespace HF::GraphGenerator {
 
 		*/
 		SpatialStructures::Graph CrawlGeom(UniqueQueue& todo);
+
+		/*!
+			\brief Perform breadth first search to populate the graph with with nodes and edges using a specific raytracer.
+
+			\tparam raytracer_type EmbreeRayTracer, NanoRTRayTracer, or NanoRTRayTracerFloat.
+
+			\param todo Todo list to hold unchecked nodes. Must atleast contain a single start point.
+			\param rt Raytracer to use for every ray cast during the search.
+
+			\returns The Graph generated by performing the breadth first search.
+
+			\details
+			Every ray cast by the search is made directly on `rt`, so calls can be inlined without checking
+			the type of the raytracer for each one. CrawlGeom(UniqueQueue&) calls this with the raytracer
+			held by ray_tracer.
+		*/
+		template <typename raytracer_type>
+		SpatialStructures::Graph CrawlGeom(UniqueQueue& todo, raytracer_type& rt);
 		
 		/*!
 			\brief Perform breadth first search to populate the graph with nodes and edges using multiple cores.
@@ -592,11 +654,121 @@ namespace HF::GraphGenerator {
 			`[(0, 2, 0),(-1, 1, -0),(-1, 2, 0),(-1, 3, 0),(0, 1, -0),(0, 3, 0),(1, 1, -0),(1, 2, 0),(1, 3, 0),(1, 0, -0),(0, -1, -0),(0, 0, -0),(1, -1, -0),(2, -1, -0),(2, 0, -0),(2, 1, -0),(2, 2, 0),(2, 3, 0),(-2, -1, -0),(-3, -2, -0),(-3, -1, -0),(-3, 0, -0),(-2, -2, -0),(-2, 0, -0),(-1, -2, -0),(-1, -1, -0),(-1, 0, -0)]`
 		*/
 		SpatialStructures::Graph CrawlGeomParallel(UniqueQueue& todo);
+
+		/*!
+			\brief Perform breadth first search to populate the graph with nodes and edges using multiple cores and a specific raytracer.
+
+			\tparam raytracer_type EmbreeRayTracer, NanoRTRayTracer, or NanoRTRayTracerFloat.
+
+			\param todo Todo list to hold unchecked nodes. Must atleast contain a single start point.
+			\param rt Raytracer to use for every ray cast during the search.
+
+			\returns The Graph generated by performing the breadth first search.
+
+			\see CrawlGeom(UniqueQueue&, raytracer_type&) for details on how the raytracer is used.
+		*/
+		template <typename raytracer_type>
+		SpatialStructures::Graph CrawlGeomParallel(UniqueQueue& todo, raytracer_type& rt);
+
+		/*!
+			\brief Perform breadth first search to populate the graph with nodes and edges, assigning
+				   node IDs by their position on the lattice.
+
+			\param start The starting point of the graph. Must already be validated by ValidateStartPoint.
+
+			\returns The Graph generated by performing the breadth first search.
+
+			\details
+			Unlike CrawlGeomParallel, nothing in this version is serialized between frontiers. Node IDs are
+			assigned from the integer lattice coordinates of each node using a LatticeIndex, so threads can
+			add new nodes to the next frontier without going through a shared queue. Each thread stores the
+			edges it finds in its own buffer, and the graph's CSR is built once from these buffers after the
+			search is complete instead of adding every edge one at a time.
+
+			Once every thread is done with a frontier, the new nodes it found are sorted by their lattice
+			coordinates, and nodes are given their final IDs in this order. The IDs and the order of each
+			frontier are therefore the same on every run, no matter how many threads are used.
+
+			\remarks
+			The graph will contain the same nodes and edges as CrawlGeomParallel, but the nodes will be assigned
+			different IDs since nodes in the same frontier are numbered by position instead of by the order
+			their parents were evaluated in.
+
+			\see use_lattice_engine to use this from BuildNetwork.
+		*/
+		SpatialStructures::Graph CrawlGeomLattice(const real3& start);
+
+		/*!
+			\brief Perform a lattice indexed breadth first search using a specific raytracer.
+
+			\tparam raytracer_type EmbreeRayTracer, NanoRTRayTracer, or NanoRTRayTracerFloat.
+
+			\param start The starting point of the graph. Must already be validated by ValidateStartPoint.
+			\param rt Raytracer to use for every ray cast during the search.
+
+			\returns The Graph generated by performing the breadth first search.
+
+			\see CrawlGeom(UniqueQueue&, raytracer_type&) for details on how the raytracer is used.
+		*/
+		template <typename raytracer_type>
+		SpatialStructures::Graph CrawlGeomLattice(const real3& start, raytracer_type& rt);
+
+		/*!
+			\brief Update a graph after the geometry within a region has changed, without generating
+				   the rest of the graph again.
+
+			\param graph A graph previously generated by this graph generator. Will be updated in place.
+			\param region_min Minimum x,y,z corner of the axis-aligned box containing every change to the geometry.
+			\param region_max Maximum x,y,z corner of the axis-aligned box containing every change to the geometry.
+
+			\returns The number of nodes whose edges were generated again.
+
+			\pre BuildNetwork was called on this graph generator to create `graph`, so the same parameters
+				 will be used to update it. The raytracer of this graph generator already contains the changes.
+
+			\details
+			Only nodes close enough to the region to have cast a ray through it are affected. Every edge
+			leaving one of these nodes is removed from the graph. The search then starts again from the
+			affected nodes that are still connected to an unaffected node, or from the first node of the graph
+			if it was affected, and continues until it runs into nodes that weren't affected. Edges that
+			still exist are added back, and nodes that were never found before are crawled like they would be
+			in CrawlGeom.
+
+			\remarks
+			Nodes are never removed from the graph, so the IDs of existing nodes and their attributes remain
+			valid. Nodes that can no longer be reached are left without any outgoing edges. Edges of nodes that
+			weren't affected keep their costs in every alternate cost type. Edges that were generated again
+			have no cost in alternate cost types, since the geometry they were calculated from may have
+			changed, so any alternate cost types should be calculated again for them.
+
+			\par Example
+			\snippet tests\src\GraphGenerator.cpp EX_RegenerateRegion
+		*/
+		int RegenerateRegion(SpatialStructures::Graph& graph, const real3& region_min, const real3& region_max);
+
+		/*!
+			\brief Update a graph after the geometry within a region has changed using a specific raytracer.
+
+			\tparam raytracer_type EmbreeRayTracer, NanoRTRayTracer, or NanoRTRayTracerFloat.
+
+			\param graph A graph previously generated by this graph generator. Will be updated in place.
+			\param region_min Minimum x,y,z corner of the axis-aligned box containing every change to the geometry.
+			\param region_max Maximum x,y,z corner of the axis-aligned box containing every change to the geometry.
+			\param rt Raytracer containing the updated geometry.
+
+			\returns The number of nodes whose edges were generated again.
+
+			\see RegenerateRegion(SpatialStructures::Graph&, const real3&, const real3&) for details.
+		*/
+		template <typename raytracer_type>
+		int RegenerateRegion(SpatialStructures::Graph& graph, const real3& region_min, const real3& region_max, raytracer_type& rt);
 	};
 
 	/*! 
 		\brief Determine if the start point of the graph is over valid ground. 
 	
+		\tparam raytracer_type EmbreeRayTracer, NanoRTRayTracer, NanoRTRayTracerFloat, or MultiRT.
+
 		\param RT Raytracer to use for ray intersection
 		\param start_point the x,y,z coordinates of the starting point
 		\param Params parameters to use for precision.
@@ -611,11 +783,14 @@ namespace HF::GraphGenerator {
 		`(0, 0, 0)`
 	
 	*/
-	optional_real3 ValidateStartPoint(RayTracer& RT, const real3& start_point, const GraphParams & Params);
+	template <typename raytracer_type>
+	optional_real3 ValidateStartPoint(raytracer_type& RT, const real3& start_point, const GraphParams & Params);
 	
 	/*!
 		\brief Cast a ray and get the point of intersection if it connects.
 
+		\tparam raytracer_type EmbreeRayTracer, NanoRTRayTracer, NanoRTRayTracerFloat, or MultiRT.
+
 		\param RT Raytracer to use for intersection.
 		\param origin Origin point of the ray.
 		\param direction direction to cast the ray in.
@@ -624,7 +799,8 @@ namespace HF::GraphGenerator {
 					geometry other than this type will be discarded unless the type is BOTH, NONE, or the
 					geometry dictionary is empty. 
 		\param geometry_dict Dictionary containing rules for filtering ray intersections. If not specified,
-							 this will not filter any intersections.
+							 this will not filter any intersections. Rays pass through any geometry
+							 the dictionary's filter rejects in a single traversal.
 
 		\returns An invalid optional_real3 if the ray did not intersect any geometry, or a valid 
 				 optional_real3 containing the point of intesection if an intersection was found.
@@ -635,8 +811,9 @@ namespace HF::GraphGenerator {
 
 		`(1, 1, 0)`
 	*/
+	template <typename raytracer_type>
 	optional_real3 CheckRay(
-		RayTracer& RT,
+		raytracer_type& RT,
 		const real3& origin,
 		const real3& direction,
 		real_t node_z_tolerance,
@@ -664,6 +841,8 @@ namespace HF::GraphGenerator {
 	/*! 
 		\brief Calculate all possible edges between parent and possible_children
 		
+		\tparam raytracer_type EmbreeRayTracer, NanoRTRayTracer, NanoRTRayTracerFloat, or MultiRT.
+
 		\param parent Parent of all children in `possible_children`
 		\param possible_children Children that may have an edge with Parent
 		\param rt Raytracer to use for ray intersections
@@ -686,11 +865,13 @@ namespace HF::GraphGenerator {
 		\snippet tests\src\GraphGenerator.cpp EX_CreateChildren
 		`[((0, 2, 0), 2.23607, 1),((2, 0, -0), 2.23607, 1)]`
 	*/
+	template <typename raytracer_type>
 	std::vector<graph_edge> GetChildren(
 		const real3 & parent,
 		const std::vector<real3>& possible_children,
-		RayTracer  & rt,
-		const GraphParams & GP
+		raytracer_type & rt,
+		const GraphParams & GP,
+		FloorCache * cache = nullptr
 	);
 
 	/*! 
@@ -739,10 +920,15 @@ namespace HF::GraphGenerator {
 
 	/*! \brief Determine whether children are over valid ground, and and meet upstep/downstep requirements
 
+		\tparam raytracer_type EmbreeRayTracer, NanoRTRayTracer, NanoRTRayTracerFloat, or MultiRT.
+
 		\param parent Parent of all children in possible_children
 		\param possible_children Children of parent that may or may not be over valid ground
 		\param rt Raytracer to use for all ray intersections
 		\param params Parameters to use for upstep/downstep limits and rounding
+		\param cache Optional cache of downward ray results. If specified, children that have already
+					 been checked by another parent will reuse the stored result instead of casting a new ray,
+					 and any new results will be added to the cache.
 
 		\returns An array of children from `possible_children` that are over valid ground and meet the
 				 upstep/downstep requirements in `params`. Any child that didn't meet these requirements
@@ -755,16 +941,20 @@ namespace HF::GraphGenerator {
 		\snippet tests\src\GraphGenerator.cpp EX_CheckChildren
 		`[(0, 2, 0),(1, 0, -0),(0, 1, 0),(2, 0, -0)]`
 	*/
+	template <typename raytracer_type>
 	std::vector<real3> CheckChildren(
 		const real3& parent,
 		const std::vector<real3>& possible_children,
-		RayTracer& rt,
-		const GraphParams & params
+		raytracer_type& rt,
+		const GraphParams & params,
+		FloorCache * cache = nullptr
 	);
 	/*!
 		\brief Determine what kind of step (if any) is between parent and child, given
 			that a connection was verified using the graph generator. 
 
+		\tparam raytracer_type EmbreeRayTracer, NanoRTRayTracer, NanoRTRayTracerFloat, or MultiRT.
+
 		\param parent Node being traversed from
 		\param child  Node being traversed to
 		\param rt Raytracer to use for all ray intersections
@@ -776,14 +966,17 @@ namespace HF::GraphGenerator {
 		\snippet tests\src\GraphGenerator.cpp EX_CheckConnection
 		`[1,0,0,1]`
 	*/
+	template <typename raytracer_type>
 	HF::SpatialStructures::STEP CheckConnection(
 		const real3& parent,
 		const real3& child,
-		RayTracer& rt
+		raytracer_type& rt
 	);
 	/*! 
 		\brief Determine what kind of step (if any) is between parent and child.
 	
+		\tparam raytracer_type EmbreeRayTracer, NanoRTRayTracer, NanoRTRayTracerFloat, or MultiRT.
+
 		\param parent Node being traversed from
 		\param child  Node being traversed to
 		\param rt Raytracer to use for all ray intersections
@@ -797,10 +990,11 @@ namespace HF::GraphGenerator {
 		\snippet tests\src\GraphGenerator.cpp EX_CheckConnection
 		`[1,0,0,1]`
 	*/
+	template <typename raytracer_type>
 	HF::SpatialStructures::STEP CheckConnection(
 		const real3 & parent,
 		const real3 & child,
-		RayTracer& rt,
+		raytracer_type& rt,
 		const GraphParams & params
 	);
 
@@ -828,6 +1022,8 @@ namespace HF::GraphGenerator {
 	/*! 
 		\brief Determine if there is a valid line of sight between parent and child
 		
+		\tparam raytracer_type EmbreeRayTracer, NanoRTRayTracer, NanoRTRayTracerFloat, or MultiRT.
+
 		\param parent Node to perform the line of sight check from
 		\param child  Node to perform the line of sight check to
 		\param RT raytracer to use for the line of sight check
@@ -842,7 +1038,8 @@ namespace HF::GraphGenerator {
 		`Occlusion Check For Child 1 = True`\n
 		`Occlusion Check For Child 2 = False`
 	*/
-	bool OcclusionCheck(const real3 & parent, const real3 & child, RayTracer& RT);
+	template <typename raytracer_type>
+	bool OcclusionCheck(const real3 & parent, const real3 & child, raytracer_type& RT);
 
 	/*!
 		\brief Determine if the slope between parent and child is traversable according to the graph parameters.
@@ -865,5 +1062,52 @@ namespace HF::GraphGenerator {
 		const GraphParams & gp
 	);
 
+	/*!
+		\brief Calculate the distance from every node in a graph to the nearest wall or obstacle.
+
+		\param g Graph to calculate the clearance of.
+		\param rt Raytracer containing the geometry the graph was generated on.
+		\param height Height above each node to measure clearance from.
+		\param max_distance Maximum clearance to search for. Set to -1 for infinite distance.
+
+		\returns The clearance of every node in `g`, ordered by node ID. Nodes with no walls or obstacles
+				 within `max_distance` are given a clearance of `max_distance`, or -1 if it's infinite.
+
+		\details
+		Each node's clearance is found with a single closest point query from `height` above the node
+		instead of casting rays in every direction around it. Floors and ceilings are ignored so the
+		floor the node is on doesn't count against its clearance.
+
+		\see HF::RayTracer::EmbreeRayTracer::FindClosestPoints for details on the query.
+	*/
+	std::vector<float> CalculateClearance(
+		const HF::SpatialStructures::Graph& g,
+		HF::RayTracer::EmbreeRayTracer& rt,
+		float height = 0.5f,
+		float max_distance = -1.0f
+	);
+
+	/*!
+		\brief Calculate the clearance of every node in a graph and store it as a node attribute.
+
+		\param g Graph to calculate the clearance of. The clearance of every node will be stored in it.
+		\param rt Raytracer containing the geometry the graph was generated on.
+		\param attribute Name of the node attribute to store the clearance in.
+		\param height Height above each node to measure clearance from.
+		\param max_distance Maximum clearance to search for. Set to -1 for infinite distance.
+
+		\see CalculateClearance for details on how clearance is calculated.
+
+		\par Example
+		\snippet tests\src\GraphGenerator.cpp EX_CalculateAndStoreClearance
+	*/
+	void CalculateAndStoreClearance(
+		HF::SpatialStructures::Graph& g,
+		HF::RayTracer::EmbreeRayTracer& rt,
+		const std::string& attribute = "clearance",
+		float height = 0.5f,
+		float max_distance = -1.0f
+	);
+
 }
 
@@ -4,7 +4,9 @@
 #include <constants.h>
 #include <edge.h>
 #include <embree_raytracer.h>
+#include <floor_cache.h>
 #include <ray_data.h>
+#include <MultiRT.h>
 #include <cassert>
 
 namespace HF::GraphGenerator {
@@ -104,7 +106,8 @@ namespace HF::GraphGenerator {
 		pair(1, 0), pair(1, 1)
 	};
 
-	optional_real3 ValidateStartPoint(RayTracer& RT, const real3& start_point, const GraphParams& Params)
+	template <typename raytracer_type>
+	optional_real3 ValidateStartPoint(raytracer_type& RT, const real3& start_point, const GraphParams& Params)
 	{
 		return CheckRay(RT, start_point, down, Params.precision.node_z, HIT_FLAG::FLOORS, Params.geom_ids);
 	}
@@ -143,8 +146,30 @@ namespace HF::GraphGenerator {
 			return (goal == geom_dict[id]);
 	}
 
+	/*! \brief Cast a ray that passes through every mesh `filter` rejects. */
+	template <typename raytracer_type>
+	inline HitStruct<real_t> FilteredIntersect(
+		raytracer_type& ray_tracer,
+		const real3& origin,
+		const real3& direction,
+		const HF::RayTracer::MeshFilter* filter)
+	{
+		return ray_tracer.Intersect(origin, direction, -1.0f, -1, filter);
+	}
+
+	/*! \brief Cast a ray that passes through every mesh `filter` rejects with a MultiRT. */
+	inline HitStruct<real_t> FilteredIntersect(
+		HF::RayTracer::MultiRT& ray_tracer,
+		const real3& origin,
+		const real3& direction,
+		const HF::RayTracer::MeshFilter* filter)
+	{
+		return ray_tracer.Intersect(origin, direction, filter);
+	}
+
+	template <typename raytracer_type>
 	optional_real3 CheckRay(
-		RayTracer& ray_tracer,
+		raytracer_type& ray_tracer,
 		const real3& origin,
 		const real3& direction,
 		real_t node_z_tolerance,
@@ -154,8 +179,9 @@ namespace HF::GraphGenerator {
 		// Setup default params
 		HitStruct<real_t> res;
 
-		// Cast the ray. On success, this returns the ID and distance to intersection.
-		res = ray_tracer.Intersect(origin, direction);
+		// Cast the ray. On success, this returns the ID and distance to intersection. Geometry
+		// that can never pass CheckGeometryID is skipped during traversal.
+		res = FilteredIntersect(ray_tracer, origin, direction, geometry_dict.GetFilter());
 
 		// Check if it hit and the ID of the geometry matches what we were looking for. 
 		if (res.DidHit() && CheckGeometryID(flag, res.meshid, geometry_dict)) {
@@ -215,18 +241,20 @@ namespace HF::GraphGenerator {
 		return out_directions;
 	}
 
+	template <typename raytracer_type>
 	vector<graph_edge> GetChildren(
 		const real3& parent,
 		const vector<real3>& possible_children,
-		RayTracer& rt,
-		const GraphParams& GP
+		raytracer_type& rt,
+		const GraphParams& GP,
+		FloorCache* cache
 		)
 	{
 		std::vector<graph_edge> valid_edges;
 
 		// Call CheckChildren to get rid of all children that aren't over valid ground or don't meet our upstep
 		// and downstep requirements. This array of children will also be moved directly ontop of the ground their over.
-		const auto checked_children = CheckChildren(parent, possible_children, rt, GP);
+		const auto checked_children = CheckChildren(parent, possible_children, rt, GP, cache);
 
 		// Iterate through every child in the checked children
 		for (const auto& child : checked_children)
@@ -245,20 +273,30 @@ namespace HF::GraphGenerator {
 		return valid_edges;
 	}
 
+	template <typename raytracer_type>
 	std::vector<real3> CheckChildren(
 		const real3& parent,
 		const std::vector<real3>& possible_children,
-		RayTracer& rt,
-		const GraphParams& GP)
+		raytracer_type& rt,
+		const GraphParams& GP,
+		FloorCache* cache)
 	{
 		vector<real3> valid_children;
 
 		// Iterate through every child in the set of possible children
 		for (const auto& child : possible_children)
 		{
+			optional_real3 potential_child;
 
-			// Check if a ray intersects a mesh
-			optional_real3 potential_child = CheckRay(rt, child, down, GP.precision.node_z, HIT_FLAG::FLOORS, GP.geom_ids);
+			// Only cast a ray if another parent hasn't already cast one from this child
+			if (!cache || !cache->Find(child, potential_child))
+			{
+				// Check if a ray intersects a mesh
+				potential_child = CheckRay(rt, child, down, GP.precision.node_z, HIT_FLAG::FLOORS, GP.geom_ids);
+
+				// Store the result, even if it missed, so other parents can skip this ray
+				if (cache) cache->Insert(child, potential_child);
+			}
 			
 			if (potential_child)
 			{
@@ -280,7 +318,8 @@ namespace HF::GraphGenerator {
 		return valid_children;
 	}
 
-	bool OcclusionCheck(const real3& parent, const real3& child, RayTracer& RT)
+	template <typename raytracer_type>
+	bool OcclusionCheck(const real3& parent, const real3& child, raytracer_type& RT)
 	{
 		// Use the distance between parent and child
 		// as the maximum distance for the occlusion check
@@ -382,10 +421,48 @@ namespace HF::GraphGenerator {
 		g.AddEdges(result, "step_type");
 	}
 
+	vector<float> CalculateClearance(
+		const HF::SpatialStructures::Graph& g,
+		HF::RayTracer::EmbreeRayTracer& rt,
+		float height,
+		float max_distance)
+	{
+		// Raise every node off the floor
+		const auto nodes = g.Nodes();
+		vector<std::array<float, 3>> points(nodes.size());
+		for (int i = 0; i < nodes.size(); i++)
+			points[i] = std::array<float, 3>{ nodes[i].x, nodes[i].y, nodes[i].z + height };
+
+		const auto closest_points = rt.FindClosestPoints(points, max_distance, true);
+
+		vector<float> clearance(closest_points.size());
+		for (int i = 0; i < closest_points.size(); i++)
+			clearance[i] = closest_points[i].DidHit() ? closest_points[i].distance : max_distance;
+
+		return clearance;
+	}
+
+	void CalculateAndStoreClearance(
+		HF::SpatialStructures::Graph& g,
+		HF::RayTracer::EmbreeRayTracer& rt,
+		const std::string& attribute,
+		float height,
+		float max_distance)
+	{
+		const auto clearance = CalculateClearance(g, rt, height, max_distance);
+		g.SetNodeAttributeColumn(
+			attribute,
+			HF::SpatialStructures::NODE_ATTRIBUTE_TYPE::FLOAT,
+			clearance.data(),
+			static_cast<int>(clearance.size())
+		);
+	}
+
+	template <typename raytracer_type>
 	HF::SpatialStructures::STEP CheckConnection(
 		const real3& parent,
 		const real3& child,
-		RayTracer& rt)
+		raytracer_type& rt)
 	{
 		// Default graphh generator ground offset
 		const auto GROUND_OFFSET = 0.01;
@@ -427,10 +504,11 @@ namespace HF::GraphGenerator {
 
 	}
 
+	template <typename raytracer_type>
 	HF::SpatialStructures::STEP CheckConnection(
 		const real3& parent,
 		const real3& child,
-		RayTracer& rt,
+		raytracer_type& rt,
 		const GraphParams& params)
 	{
 		// Get groundoffset from graph parameters
@@ -572,4 +650,28 @@ namespace HF::GraphGenerator {
 
 		return out_children;
 	}
-}
\ No newline at end of file
+
+	/*! 
+		\brief Explicitly instantiate every function that casts rays for a raytracer type.
+
+		\details
+		These are defined here instead of in graph_generator.h so the header doesn't need to include
+		the raytracers. Each raytracer gets its own copy of the functions, so no calls need to check
+		the raytracer's type at runtime.
+	*/
+	#define INSTANTIATE_GRAPH_UTILS(raytracer_type) \
+		template optional_real3 ValidateStartPoint<raytracer_type>(raytracer_type&, const real3&, const GraphParams&); \
+		template optional_real3 CheckRay<raytracer_type>(raytracer_type&, const real3&, const real3&, real_t, HIT_FLAG, const GeometryFlagMap&); \
+		template vector<graph_edge> GetChildren<raytracer_type>(const real3&, const vector<real3>&, raytracer_type&, const GraphParams&, FloorCache*); \
+		template vector<real3> CheckChildren<raytracer_type>(const real3&, const vector<real3>&, raytracer_type&, const GraphParams&, FloorCache*); \
+		template bool OcclusionCheck<raytracer_type>(const real3&, const real3&, raytracer_type&); \
+		template STEP CheckConnection<raytracer_type>(const real3&, const real3&, raytracer_type&); \
+		template STEP CheckConnection<raytracer_type>(const real3&, const real3&, raytracer_type&, const GraphParams&);
+
+	INSTANTIATE_GRAPH_UTILS(HF::RayTracer::EmbreeRayTracer)
+	INSTANTIATE_GRAPH_UTILS(HF::RayTracer::NanoRTRayTracer)
+	INSTANTIATE_GRAPH_UTILS(HF::RayTracer::NanoRTRayTracerFloat)
+	INSTANTIATE_GRAPH_UTILS(HF::RayTracer::MultiRT)
+
+	#undef INSTANTIATE_GRAPH_UTILS
+}
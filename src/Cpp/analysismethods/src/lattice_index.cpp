@@ -0,0 +1,42 @@
+///
+/// \file		lattice_index.cpp
+/// \brief		Contains implementation for the <see cref="HF::GraphGenerator::LatticeIndex">LatticeIndex</see> class
+///
+///	\author		TBA
+///	\date		26 Jun 2020
+
+#include <lattice_index.h>
+#include <cmath>
+
+namespace HF::GraphGenerator {
+
+	CellKey ToCellKey(const real3& pt, real_t spacing_precision, real_t z_precision)
+	{
+		return CellKey{
+			std::llround(pt[0] / spacing_precision),
+			std::llround(pt[1] / spacing_precision),
+			std::llround(pt[2] / z_precision)
+		};
+	}
+
+	LatticeIndex::LatticeIndex(real_t spacing_precision, real_t z_precision)
+		: shards(new Shard[num_shards]), spacing_precision(spacing_precision), z_precision(z_precision) {}
+
+	int LatticeIndex::GetOrAssignID(const real3& pt, bool& out_inserted)
+	{
+		const CellKey key = ToCellKey(pt, spacing_precision, z_precision);
+		Shard& shard = shards[CellKeyHash()(key) & (num_shards - 1)];
+
+		std::lock_guard<std::mutex> lock(shard.lock);
+
+		// Only take an ID from the counter if this cell doesn't already have one
+		auto it = shard.ids.find(key);
+		out_inserted = (it == shard.ids.end());
+		if (out_inserted)
+			it = shard.ids.emplace(key, next_id.fetch_add(1)).first;
+
+		return it->second;
+	}
+
+	int LatticeIndex::size() const { return next_id.load(); }
+}
@@ -0,0 +1,123 @@
+///
+/// \file		lattice_index.h
+/// \brief		Contains definitions for the <see cref="HF::GraphGenerator::LatticeIndex">LatticeIndex</see> class
+///
+///	\author		TBA
+///	\date		26 Jun 2020
+
+#include <robin_hood.h>
+#include <graph_generator.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#ifndef LATTICE_INDEX_INCLUDE_GUARD
+#define LATTICE_INDEX_INCLUDE_GUARD
+
+namespace HF::GraphGenerator {
+
+	/*! \brief Integer coordinates of a point on the graph generator's lattice. */
+	struct CellKey {
+		int64_t x; ///< X coordinate divided by the spacing precision.
+		int64_t y; ///< Y coordinate divided by the spacing precision.
+		int64_t z; ///< Z coordinate divided by the z precision.
+
+		/*! \brief Check if two keys refer to the same cell. */
+		inline bool operator==(const CellKey& k2) const {
+			return x == k2.x && y == k2.y && z == k2.z;
+		}
+
+		/*! \brief Order keys by x, then y, then z. */
+		inline bool operator<(const CellKey& k2) const {
+			if (x != k2.x) return x < k2.x;
+			if (y != k2.y) return y < k2.y;
+			return z < k2.z;
+		}
+	};
+
+	/*! \brief Hash a CellKey by combining the hashes of its components. */
+	struct CellKeyHash {
+		inline std::size_t operator()(const CellKey& k) const noexcept {
+			size_t seed = robin_hood::hash_int(static_cast<uint64_t>(k.x));
+			seed ^= robin_hood::hash_int(static_cast<uint64_t>(k.y)) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+			seed ^= robin_hood::hash_int(static_cast<uint64_t>(k.z)) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+			return seed;
+		}
+	};
+
+	/*!
+		\brief Get the lattice cell of a point.
+
+		\param pt Point to get the cell of.
+		\param spacing_precision Precision that the x and y components of `pt` were rounded to.
+		\param z_precision Precision that the z component of `pt` was rounded to.
+
+		\returns The integer coordinates of the cell containing `pt`.
+
+		\details
+		Every node created by the graph generator has already been rounded to these precisions,
+		so dividing them out maps every node at the same position to the same integer coordinates
+		without needing to compare floating point numbers.
+	*/
+	CellKey ToCellKey(const real3& pt, real_t spacing_precision, real_t z_precision);
+
+	/*!
+		\brief Assigns unique IDs to nodes from multiple threads at once.
+
+		\details
+		Nodes are identified by their lattice cell rather than their floating point coordinates,
+		and IDs are handed out from an atomic counter so they're always contiguous from 0.
+		Since the counter is shared, the ID a cell gets depends on the order threads reach it in.
+		Like the FloorCache, the map is split into shards that each have their own lock
+		so threads only contend when they're looking up nodes in the same shard.
+
+		\invariant Every ID in [0, size()) has been assigned to exactly one cell.
+
+		\see GraphGenerator::CrawlGeomLattice for the intended usage of this class.
+	*/
+	class LatticeIndex {
+	private:
+		/*! \brief A section of the index guarded by its own lock. */
+		struct Shard {
+			std::mutex lock; ///< Lock for reading and writing to ids.
+			robin_hood::unordered_map<CellKey, int, CellKeyHash> ids; ///< ID of every cell in this shard.
+		};
+
+		static constexpr int num_shards = 64; ///< Number of shards the index is split into. Must be a power of 2.
+
+		std::unique_ptr<Shard[]> shards; ///< Shards holding the IDs of each cell.
+		real_t spacing_precision; ///< Precision used to convert the x and y coordinates to integers.
+		real_t z_precision; ///< Precision used to convert the z coordinate to an integer.
+		std::atomic<int> next_id{ 0 }; ///< ID to assign to the next new cell.
+
+	public:
+		/*!
+			\brief Construct an empty index.
+
+			\param spacing_precision Precision that the x and y components of nodes are rounded to.
+			\param z_precision Precision that the z component of nodes are rounded to.
+		*/
+		LatticeIndex(real_t spacing_precision, real_t z_precision);
+
+		/*!
+			\brief Get the ID of the cell containing `pt`, assigning it a new one if it doesn't have one.
+
+			\param pt Position of the node.
+			\param out_inserted Set to true if `pt` was assigned a new ID by this call, false otherwise.
+
+			\returns The ID of the cell containing `pt`.
+
+			\remarks
+			If multiple threads call this for the same cell at once, only one of them will have
+			`out_inserted` set to true.
+		*/
+		int GetOrAssignID(const real3& pt, bool& out_inserted);
+
+		/*! \brief Number of IDs that have been assigned. */
+		int size() const;
+	};
+}
+
+#endif
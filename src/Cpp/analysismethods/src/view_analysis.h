@@ -11,6 +11,8 @@
 #include <iostream>
 #include <assert.h>
 #include <limits>
+#include <algorithm>
+#include <stdexcept>
 
 #ifndef VIEW_ANALYSIS_G
 #define VIEW_ANALYSIS_G
@@ -59,6 +61,43 @@ namespace HF::ViewAnalysis {
 		MIN = 4
 	};
 
+	/*!
+		\brief Cast a ray in every direction from a single node and record every intersection.
+
+		\param ray_tracer A valid raytracer that already has the geometry loaded.
+		\param node Point to cast rays from. This will be offset by height before any rays are cast.
+		\param directions Directions to cast rays in.
+		\param height Height off the ground to cast from.
+		\param out_results Array of directions.size() results. SetHit will be called on the result
+		for every ray that intersects geometry.
+
+		\tparam RES A class or struct that has a .SetHit() function.
+		\tparam RT A Raytracer with IntersectOutputArguments defined for the type of N.
+		\tparam N A point that overloads [] for 0, 1 and 2.
+	*/
+	template <typename RES, typename RT, typename N>
+	inline void CastViewRays(
+		RT& ray_tracer,
+		N node,
+		const std::vector<std::array<float, 3>>& directions,
+		float height,
+		RES* out_results)
+	{
+		// Reset out values to temporarily store results. Kept private by defining here
+		float out_distance = 0;
+		int out_mid = 0;
+
+		node[2] += height;
+
+		// Iterate through every direction and cast a ray for it
+		for (int k = 0; k < static_cast<int>(directions.size()); k++)
+		{
+			// Call the result's SetHit if it intersected.
+			if (ray_tracer.IntersectOutputArguments(node, directions[k], out_distance, out_mid))
+				out_results[k].SetHit(node, directions[k], out_distance, out_mid);
+		}
+	}
+
 	/// <summary> Evenly distribute a set of points around a sphere centered at the origin. </summary>
 	/// <param name="num_points"> Maximum number of points to distribute. </param>
 	/// \param upward_limit Maximum angle in degrees to cast rays above the viewpoint.
@@ -362,30 +401,89 @@ namespace HF::ViewAnalysis {
 		#pragma omp for schedule(dynamic) 
 			for (int i = 0; i < Nodes.size(); i++)
 			{
-				// Reset out values to temporarily store results. Kept private by defining here
-				float out_distance = 0;
-				int out_mid = 0;
-
-				auto node = Nodes[i];
-				node[2] += height;
-				int os = directions.size() * i;
-
-				// Iterate through every direction and cast a ray for it
-				for (int k = 0; k < directions.size(); k++)
-				{
-					int idx = os + k;
-					// Call the result's SetHit if it intersected.
-					if (ray_tracer.IntersectOutputArguments(node, directions[k], out_distance, out_mid))
-					{
-						out_results[idx].SetHit(node, directions[k], out_distance, out_mid);
-					}
-				} // End direction loop
+				size_t os = directions.size() * i;
+				CastViewRays(ray_tracer, Nodes[i], directions, height, out_results.data() + os);
 			} // End node loop
 		} // End omp space
 
 		return out_results;
 	}
 
+	/// <summary>
+	/// Conduct view analysis in fixed size chunks of nodes, passing the results of each chunk to a sink.
+	/// </summary>
+	/*!
+		\ingroup ViewAnalysis
+		\param ray_tracer A valid raytracer that already has the geometry loaded.
+		\param Nodes Points to perform analysis from.
+		\param num_rays The number of rays to cast from each point in nodes. The actual amount of rays
+		cast may be less or more than this number.
+		\param sink Called once for every chunk in order, with the index of the first node in the chunk,
+		the number of nodes in the chunk, and a pointer to the results of the chunk.
+		\param chunk_size Maximum number of nodes to analyze before calling sink.
+		\param upward_limit Maximum angle in degrees to cast rays above the viewpoint.
+		\param downward_limit Maximum angle in degrees to cast rays below the viewpoint.
+		\param height Height off the ground to cast from.
+
+		\tparam RES A class or struct that has a .SetHit() function.
+		\tparam RT A Raytracer with IntersectOutputArguments defined for the type of N.
+		\tparam N A point that overloads [] for 0, 1 and 2.
+		\tparam SINK A callable with the signature `void(int start, int count, const RES* results)`.
+
+		\returns The number of rays cast from each node.
+
+		\details
+		The analysis performed is identical to SphericalViewAnalysis, but only chunk_size * num_rays results
+		are held in memory at a time. The results passed to sink are laid out in the same order as
+		SphericalViewAnalysis, and are only valid until sink returns since the same buffer is reused
+		for every chunk. Nodes within each chunk are analyzed in parallel, and sink is always called
+		from the calling thread.
+
+		\exception std::out_of_range chunk_size is less than 1.
+
+		\see SphericalViewAnalysis for more information on the results of the analysis.
+
+		\snippet tests\src\ViewAnalysis.cpp EX_SphericalViewAnalysisStream
+	*/
+	template <typename RES, typename RT, typename N, typename SINK>
+	int SphericalViewAnalysisStream(
+		RT& ray_tracer,
+		const std::vector<N>& Nodes,
+		int num_rays,
+		SINK&& sink,
+		int chunk_size = 1024,
+		float upward_limit = 50.0f,
+		float downward_limit = 70.0f,
+		float height = 1.7f)
+	{
+		if (chunk_size < 1)
+			throw std::out_of_range("Chunk size must be at least 1");
+
+		const auto directions = FibbonacciDistributePoints(num_rays, upward_limit, downward_limit);
+		const int num_nodes = static_cast<int>(Nodes.size());
+		const int num_directions = static_cast<int>(directions.size());
+
+		// Allocate a buffer large enough to hold the largest chunk
+		std::vector<RES> chunk_results(static_cast<size_t>(std::min(chunk_size, num_nodes)) * num_directions);
+
+		for (int start = 0; start < num_nodes; start += chunk_size) {
+			const int count = std::min(chunk_size, num_nodes - start);
+
+			// Clear the results of the last chunk
+			std::fill(chunk_results.begin(), chunk_results.begin() + static_cast<size_t>(count) * num_directions, RES());
+
+			#pragma omp parallel for schedule(dynamic)
+			for (int i = 0; i < count; i++) {
+				size_t os = static_cast<size_t>(num_directions) * i;
+				CastViewRays(ray_tracer, Nodes[start + i], directions, height, chunk_results.data() + os);
+			}
+
+			sink(start, count, static_cast<const RES*>(chunk_results.data()));
+		}
+
+		return num_directions;
+	}
+
 // To use numeric limits, need to undefine max
 #undef max
 
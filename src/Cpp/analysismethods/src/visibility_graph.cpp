@@ -10,7 +10,9 @@
 #include <array>
 #include <thread>
 #include <omp.h>
-#include<algorithm>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
 
 #include <robin_hood.h>
 #include <graph.h>
@@ -298,4 +300,335 @@ namespace HF::VisibilityGraph {
 		// Create and return a new graph from this information.
 		return Graph(edges, costs, nodes);
 	}
-}
\ No newline at end of file
+
+	/*!
+		\brief A uniform grid of cells used to find nodes that are close to a point.
+
+		\details
+		Cells are max_distance wide, so every node within max_distance of a point is in
+		the point's cell or one of the 26 cells surrounding it. Cell coordinates are packed into
+		a single key, and any keys that collide only add extra candidates which are then discarded
+		by the distance check.
+	*/
+	class NodeGrid {
+	private:
+		float cell_size;												///< Width of each cell. If <= 0, every node is in a single cell.
+		robin_hood::unordered_map<long long, vector<int>> cells;		///< Indexes of the nodes in every cell.
+
+		/*! \brief Get the coordinate of the cell containing `value` along a single axis. */
+		inline long long CellCoord(float value) const {
+			return static_cast<long long>(std::floor(value / cell_size));
+		}
+
+		/*! \brief Pack the coordinates of a cell into a single key. */
+		inline static long long CellKey(long long x, long long y, long long z) {
+			const long long mask = 0x1FFFFF;
+			return ((x & mask) << 42) | ((y & mask) << 21) | (z & mask);
+		}
+
+	public:
+		/*!
+			\brief Place the nodes at `indexes` in `nodes` into a grid of cells that are `cell_size` wide.
+
+			\param nodes Nodes to index.
+			\param indexes Indexes of the nodes in `nodes` to add to the grid.
+			\param cell_size Width of every cell. If less than or equal to zero, every node is placed in a single cell.
+		*/
+		NodeGrid(const vector<Node>& nodes, const vector<int>& indexes, float cell_size) : cell_size(cell_size) {
+			for (int index : indexes) {
+				const auto& node = nodes[index];
+				const long long key = (cell_size > 0) ?
+					CellKey(CellCoord(node.x), CellCoord(node.y), CellCoord(node.z)) : 0;
+				cells[key].push_back(index);
+			}
+		}
+
+		/*!
+			\brief Get the indexes of every node in the cells surrounding `node`.
+
+			\param node Node to get the candidates of.
+			\param out_candidates Output vector that indexes will be written to. Its previous contents are cleared.
+
+			\details Candidates are sorted so the edges of the resulting graph are always in the same order.
+		*/
+		void Candidates(const Node& node, vector<int>& out_candidates) const {
+			out_candidates.clear();
+
+			if (cell_size <= 0) {
+				if (!cells.empty())
+					out_candidates = cells.begin()->second;
+				return;
+			}
+
+			const long long x = CellCoord(node.x), y = CellCoord(node.y), z = CellCoord(node.z);
+			for (long long i = x - 1; i <= x + 1; i++)
+				for (long long j = y - 1; j <= y + 1; j++)
+					for (long long k = z - 1; k <= z + 1; k++) {
+						auto cell = cells.find(CellKey(i, j, k));
+						if (cell != cells.end())
+							out_candidates.insert(out_candidates.end(), cell->second.begin(), cell->second.end());
+					}
+
+			// Colliding keys can make the same cell appear more than once
+			std::sort(out_candidates.begin(), out_candidates.end());
+			out_candidates.erase(std::unique(out_candidates.begin(), out_candidates.end()), out_candidates.end());
+		}
+	};
+
+	/*!
+		\brief Check that view_directions has a valid size, and normalize every direction in it.
+
+		\param view_directions Directions to check.
+		\param num_nodes Number of nodes that view_directions is for.
+		\param fov Field of view in degrees.
+
+		\returns A normalized copy of view_directions.
+
+		\exception std::out_of_range view_directions isn't empty, a single direction, or one direction per node,
+		or is empty while the field of view is enabled.
+	*/
+	inline vector<array<float, 3>> NormalizeViewDirections(
+		const vector<array<float, 3>>& view_directions,
+		int num_nodes,
+		float fov
+	) {
+		if (view_directions.size() > 1 && view_directions.size() != num_nodes)
+			throw std::out_of_range("View directions must contain 0, 1, or one direction per node");
+		if (fov < 360.0f && view_directions.empty())
+			throw std::out_of_range("A view direction is required when the field of view is less than 360 degrees");
+
+		vector<array<float, 3>> normalized(view_directions);
+		for (auto& dir : normalized) {
+			const float length = std::sqrt(dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2]);
+			dir[0] /= length; dir[1] /= length; dir[2] /= length;
+		}
+		return normalized;
+	}
+
+	/*!
+		\brief Set the number of threads openmp should use.
+
+		\param cores Number of cores to use. If -1, every core on the machine will be used.
+	*/
+	inline void SetCores(int cores) {
+		if (cores < 0)
+			omp_set_num_threads(std::thread::hardware_concurrency());
+		else if (cores > 0)
+			omp_set_num_threads(cores);
+	}
+
+	/*!
+		\brief Find the candidates of a node that it has a line of sight to.
+
+		\param node_a Node to check occlusion from.
+		\param candidates Indexes of nodes in targets to check occlusion to.
+		\param targets Nodes that candidates index into.
+		\param ert Raytracer containing the geometry to use as obstacles.
+		\param height Distance to offset node_a in the z-direction before casting rays.
+		\param max_distance Candidates further than this from node_a are skipped. If <= 0 no candidates are skipped.
+		\param cos_half_fov Cosine of half the field of view. Candidates outside of this cone are skipped.
+		\param view_direction Normalized direction node_a is looking in. Ignored if null.
+		\param id_offset Value to add to the index of every candidate to get its ID in the graph.
+		\param edge_list Output array for the IDs of every visible candidate.
+		\param cost_list Output array for the distance to every visible candidate.
+
+		\details
+		Rays are cast with the same origin, direction and distance as IsOcclusionBetween, but are
+		cast together as a single ray stream.
+	*/
+	inline void AddVisibleCandidates(
+		const Node& node_a,
+		const vector<int>& candidates,
+		const vector<Node>& targets,
+		EmbreeRayTracer& ert,
+		float height,
+		float max_distance,
+		float cos_half_fov,
+		const array<float, 3>* view_direction,
+		int id_offset,
+		vector<int>& edge_list,
+		vector<float>& cost_list
+	) {
+		vector<array<float, 3>> directions;
+		vector<float> distances;
+		vector<int> ids;
+		directions.reserve(candidates.size());
+		distances.reserve(candidates.size());
+		ids.reserve(candidates.size());
+
+		for (int candidate : candidates) {
+			const Node& node_b = targets[candidate];
+			const float distance = node_a.distanceTo(node_b);
+			if (max_distance > 0 && distance > max_distance) continue;
+
+			const auto direction = node_a.directionTo(node_b);
+			if (view_direction) {
+				const auto& view = *view_direction;
+				const float cos_angle = direction[0] * view[0] + direction[1] * view[1] + direction[2] * view[2];
+				if (cos_angle < cos_half_fov) continue;
+			}
+
+			directions.push_back(direction);
+			distances.push_back(distance);
+			ids.push_back(candidate);
+		}
+		if (ids.empty()) return;
+
+		// Every ray starts at node_a, so this can be cast as a single coherent stream
+		const vector<array<float, 3>> origin{ { node_a.x, node_a.y, node_a.z + height } };
+		const auto occluded = ert.OccludedStream(origin, directions, distances, false);
+
+		for (int i = 0; i < ids.size(); i++) {
+			if (!occluded[i]) {
+				edge_list.push_back(ids[i] + id_offset);
+				cost_list.push_back(distances[i]);
+			}
+		}
+	}
+
+	Graph AllToAllCulled(
+		EmbreeRayTracer& ert,
+		const vector<Node>& nodes,
+		float height,
+		float max_distance,
+		float fov,
+		const vector<array<float, 3>>& view_directions,
+		int cores
+	) {
+		const int n = nodes.size();
+		vector<vector<int>> edges(n);
+		vector<vector<float>> costs(n);
+
+		const auto directions = NormalizeViewDirections(view_directions, n, fov);
+		const bool use_fov = fov < 360.0f;
+		const float cos_half_fov = std::cos(fov * static_cast<float>(M_PI) / 360.0f);
+
+		SetCores(cores);
+
+		// Discard nodes that don't pass the height check, then put the rest in the grid
+		const auto valid_nodes = HeightCheckAllNodes(nodes, height, ert);
+		const NodeGrid grid(nodes, valid_nodes, max_distance);
+
+#pragma omp parallel
+		{
+			vector<int> candidates;
+
+#pragma omp for schedule(dynamic)
+			for (int i = 0; i < valid_nodes.size(); i++) {
+				const int node_id = valid_nodes[i];
+				const Node& node_a = nodes[node_id];
+
+				// Don't check this node against itself
+				grid.Candidates(node_a, candidates);
+				candidates.erase(std::remove(candidates.begin(), candidates.end(), node_id), candidates.end());
+
+				const array<float, 3>* view_direction = nullptr;
+				if (use_fov)
+					view_direction = &directions[directions.size() == 1 ? 0 : node_id];
+
+				AddVisibleCandidates(
+					node_a, candidates, nodes, ert, height, max_distance,
+					cos_half_fov, view_direction, 0, edges[node_id], costs[node_id]
+				);
+			}
+		}
+		return Graph(edges, costs, nodes);
+	}
+
+	Graph AllToAllUndirectedCulled(
+		EmbreeRayTracer& ert,
+		const vector<Node>& nodes,
+		float height,
+		float max_distance,
+		int cores
+	) {
+		const int n = nodes.size();
+		vector<vector<int>> edges(n);
+		vector<vector<float>> costs(n);
+
+		SetCores(cores);
+
+		const auto valid_nodes = HeightCheckAllNodes(nodes, height, ert);
+		const NodeGrid grid(nodes, valid_nodes, max_distance);
+
+#pragma omp parallel
+		{
+			vector<int> candidates;
+
+#pragma omp for schedule(dynamic)
+			for (int i = 0; i < valid_nodes.size(); i++) {
+				const int node_id = valid_nodes[i];
+				const Node& node_a = nodes[node_id];
+
+				// Only check nodes with a higher ID than this one, so each pair is only checked once
+				grid.Candidates(node_a, candidates);
+				candidates.erase(
+					std::remove_if(candidates.begin(), candidates.end(), [node_id](int c) { return c <= node_id; }),
+					candidates.end()
+				);
+
+				AddVisibleCandidates(
+					node_a, candidates, nodes, ert, height, max_distance,
+					-1.0f, nullptr, 0, edges[node_id], costs[node_id]
+				);
+			}
+		}
+		return Graph(edges, costs, nodes);
+	}
+
+	Graph GroupToGroupCulled(
+		EmbreeRayTracer& ert,
+		const vector<Node>& from,
+		const vector<Node>& to,
+		float height,
+		float max_distance,
+		float fov,
+		const vector<array<float, 3>>& view_directions,
+		int cores
+	) {
+		const int from_count = from.size();
+		const int to_count = to.size();
+		vector<vector<int>> edges(from_count + to_count);
+		vector<vector<float>> costs(from_count + to_count);
+
+		const auto directions = NormalizeViewDirections(view_directions, from_count, fov);
+		const bool use_fov = fov < 360.0f;
+		const float cos_half_fov = std::cos(fov * static_cast<float>(M_PI) / 360.0f);
+
+		SetCores(cores);
+
+		// Only nodes in to need to be looked up, so only they go in the grid
+		const auto valid_nodes = HeightCheckAllNodes(from, height, ert);
+		const auto valid_to_nodes = HeightCheckAllNodes(to, height, ert);
+		const NodeGrid grid(to, valid_to_nodes, max_distance);
+
+#pragma omp parallel
+		{
+			vector<int> candidates;
+
+#pragma omp for schedule(dynamic)
+			for (int i = 0; i < valid_nodes.size(); i++) {
+				const int id = valid_nodes[i];
+				const Node& node_a = from[id];
+
+				grid.Candidates(node_a, candidates);
+
+				const array<float, 3>* view_direction = nullptr;
+				if (use_fov)
+					view_direction = &directions[directions.size() == 1 ? 0 : id];
+
+				AddVisibleCandidates(
+					node_a, candidates, to, ert, height, max_distance,
+					cos_half_fov, view_direction, from_count, edges[id], costs[id]
+				);
+			}
+		}
+
+		// Copy all nodes into a single array.
+		vector<Node> graph_nodes(from.size() + to.size());
+		std::copy(from.begin(), from.end(), graph_nodes.begin());
+		std::copy(to.begin(), to.end(), graph_nodes.begin() + from.size());
+
+		return Graph(edges, costs, graph_nodes);
+	}
+}
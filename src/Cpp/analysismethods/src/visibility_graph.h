@@ -5,6 +5,7 @@
 ///	\author		TBA
 ///	\date		17 Jun 2020
 
+#include <array>
 #include <vector>
 
 // Forward Declares
@@ -274,4 +275,106 @@ namespace HF::VisibilityGraph {
 		float height,
 		int cores = -1
 	);
+
+	/// <summary> Generate a Visibility Graph between nodes that are within a maximum distance of each other. </summary>
+	/*!
+		\param ert A Raytracer conatining the geometry to use as obstacles for occlusion checks.
+		\param nodes X,Y,Z locations of nodes for the Visibility Graph.
+		\param height Height to offset nodes in the z-direction before generating the VisibilityGraph.
+		\param max_distance Maximum distance a node can see. Nodes further apart than this will never be
+		connected. If less than or equal to zero, distance is unlimited.
+		\param fov Angle of the field of view cone in degrees. A node only has edges to nodes within
+		fov / 2 degrees of its view direction. Values of 360 or greater disable the cone.
+		\param view_directions Direction that each node is looking in. This may be empty if fov
+		is disabled, contain a single direction to use for every node, or contain one direction per node.
+		\param cores Number of cores to use for parallel processing. -1 will use all available cores.
+
+		\returns
+		A directed VisibilityGraph of every node in nodes. The cost of each edge in the graph is equal to the
+		distance between both nodes.
+
+		\pre view_directions must not contain any zero length vectors.
+
+		\details
+		Produces the same edges as AllToAll for the pairs of nodes that pass the distance and field of view
+		checks. Instead of checking every pair of nodes, nodes are first placed in a uniform grid with cells
+		max_distance wide, and only nodes in the cells surrounding each node are considered. The occlusion
+		rays for each node's candidates are then cast together with EmbreeRayTracer::OccludedStream.
+
+		\par Complexity
+		O(nk) where k is the average number of nodes within max_distance of a node, instead of O(n^2).
+
+		\exception std::out_of_range view_directions contained a number of directions other than 0, 1,
+		or the number of nodes, or was empty while fov was less than 360.
+
+		\snippet tests\src\VisibilityGraph.cpp EX_AllToAllCulled
+	*/
+	HF::SpatialStructures::Graph AllToAllCulled(
+		HF::RayTracer::EmbreeRayTracer& ert,
+		const std::vector<HF::SpatialStructures::Node>& nodes,
+		float height,
+		float max_distance,
+		float fov = 360.0f,
+		const std::vector<std::array<float, 3>>& view_directions = {},
+		int cores = -1
+	);
+
+	/// <summary> Generate an undirected Visibility Graph between nodes that are within a maximum distance of each other. </summary>
+	/*!
+		\param ert A Raytracer conatining the geometry to use as obstacles for occlusion checks.
+		\param nodes X,Y,Z locations of nodes for the Visibility Graph.
+		\param height Height to offset nodes in the z-direction before generating the VisibilityGraph.
+		\param max_distance Maximum distance a node can see. If less than or equal to zero, distance is unlimited.
+		\param cores Number of cores to use for parallel processing. -1 will use all available cores.
+
+		\returns
+		A VisibilityGraph of every node in nodes, where every edge is only stored in the node with the lower ID.
+
+		\details
+		The culled equivalent of AllToAllUndirected. Only a single occlusion ray is cast for each pair of nodes
+		within max_distance of each other. 
+
+		\see AllToAllCulled for details on how pairs of nodes are culled.
+	*/
+	HF::SpatialStructures::Graph AllToAllUndirectedCulled(
+		HF::RayTracer::EmbreeRayTracer& ert,
+		const std::vector<HF::SpatialStructures::Node>& nodes,
+		float height,
+		float max_distance,
+		int cores = -1
+	);
+
+	/// <summary> Generate a Visibility Graph from a set of nodes to nearby nodes in another set of nodes. </summary>
+	/*!
+		\param ert A Raytracer conatining the geometry to use as obstacles for occlusion checks.
+		\param from X,Y,Z locations of nodes to cast rays from.
+		\param to X,Y,Z locations of nodes to cast rays to.
+		\param height Height to offset nodes in the z-direction before generating the VisibilityGraph.
+		\param max_distance Maximum distance a node can see. If less than or equal to zero, distance is unlimited.
+		\param fov Angle of the field of view cone in degrees. Values of 360 or greater disable the cone.
+		\param view_directions Direction that each node in from is looking in. This may be empty if fov
+		is disabled, contain a single direction to use for every node, or contain one direction per node in from.
+		\param cores Number of cores to use for parallel processing. -1 will use all available cores.
+
+		\returns
+		A VisibilityGraph with the same layout as the graph returned by GroupToGroup.
+
+		\details
+		The culled equivalent of GroupToGroup. Only the nodes in to are placed in the grid.
+
+		\exception std::out_of_range view_directions contained a number of directions other than 0, 1,
+		or the number of nodes in from, or was empty while fov was less than 360.
+
+		\see AllToAllCulled for details on how pairs of nodes are culled.
+	*/
+	HF::SpatialStructures::Graph GroupToGroupCulled(
+		HF::RayTracer::EmbreeRayTracer& ert,
+		const std::vector<HF::SpatialStructures::Node>& from,
+		const std::vector<HF::SpatialStructures::Node>& to,
+		float height,
+		float max_distance,
+		float fov = 360.0f,
+		const std::vector<std::array<float, 3>>& view_directions = {},
+		int cores = -1
+	);
 }
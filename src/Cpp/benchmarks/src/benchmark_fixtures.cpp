@@ -0,0 +1,130 @@
+///
+/// \file		benchmark_fixtures.cpp
+/// \brief		Contains implementation for the models and cached state shared by every benchmark
+///
+///	\author		TBA
+///	\date		26 Jun 2020
+
+#include <benchmark_fixtures.h>
+
+#include <benchmark/benchmark.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+
+#include <embree_raytracer.h>
+#include <graph.h>
+#include <graph_generator.h>
+#include <meshinfo.h>
+#include <objloader.h>
+
+using HF::Geometry::MeshInfo;
+using HF::RayTracer::EmbreeRayTracer;
+using HF::SpatialStructures::Graph;
+using std::vector;
+
+namespace HF::Benchmarks {
+
+	/*! \brief Guards the caches below from benchmarks that run on multiple threads. */
+	static std::mutex cache_lock;
+
+	const vector<BenchmarkModel>& Models() {
+		// Start points match the ones used in tests/src/performance.cpp. Sponza and Sibenik use a
+		// coarser spacing than the trials there so their graphs cover more than a corner of the model
+		static const vector<BenchmarkModel> models = {
+			{ "sponza", "sponza.obj", true, {0.007f, -0.001f, 1.0f}, {0.25f, 0.25f, 1.0f}, 45, 45, 1, 1, 5000 },
+			{ "sibenik", "sibenik.obj", true, {-4.711f, 1.651f, -14.300f}, {0.25f, 0.25f, 1.0f}, 45, 45, 1, 1, 5000 },
+			{ "weston", "Weston_Analysis.obj", false, {833.093f, 546.809f, 288.125f}, {10.0f, 10.0f, 70.0f}, 45, 45, 40, 10, 5000 },
+		};
+		return models;
+	}
+
+	void ForEachModel(benchmark::internal::Benchmark* b) {
+		b->ArgName("model");
+		for (int i = 0; i < static_cast<int>(Models().size()); i++)
+			b->Arg(i);
+	}
+
+	vector<int64_t> ModelArgs() {
+		vector<int64_t> args(Models().size());
+		for (int i = 0; i < static_cast<int>(args.size()); i++)
+			args[i] = i;
+		return args;
+	}
+
+	vector<MeshInfo<float>>& GetMeshes(int model) {
+		static std::map<int, vector<MeshInfo<float>>> meshes;
+
+		std::lock_guard<std::mutex> lock(cache_lock);
+		auto it = meshes.find(model);
+		if (it == meshes.end()) {
+			const auto& settings = Models()[model];
+			it = meshes.emplace(
+				model,
+				HF::Geometry::LoadMeshObjects(settings.path, HF::Geometry::GROUP_METHOD::ONLY_FILE, settings.y_up)
+			).first;
+		}
+		return it->second;
+	}
+
+	EmbreeRayTracer& GetRayTracer(int model) {
+		static std::map<int, std::unique_ptr<EmbreeRayTracer>> raytracers;
+
+		// Loading the mesh takes the lock, so do it before taking it here
+		auto& meshes = GetMeshes(model);
+
+		std::lock_guard<std::mutex> lock(cache_lock);
+		auto& ert = raytracers[model];
+		if (!ert)
+			ert = std::make_unique<EmbreeRayTracer>(meshes);
+		return *ert;
+	}
+
+	const Graph& GetGraph(int model, int max_nodes) {
+		static std::map<std::pair<int, int>, std::unique_ptr<Graph>> graphs;
+
+		const auto& settings = Models()[model];
+		if (max_nodes < 0) max_nodes = settings.max_nodes;
+
+		auto& ert = GetRayTracer(model);
+
+		std::lock_guard<std::mutex> lock(cache_lock);
+		auto& graph = graphs[{model, max_nodes}];
+		if (!graph) {
+			HF::GraphGenerator::GraphGenerator GG(ert);
+			graph = std::make_unique<Graph>(GG.BuildNetwork(
+				settings.start,
+				settings.spacing,
+				max_nodes,
+				settings.up_step,
+				settings.up_slope,
+				settings.down_step,
+				settings.down_slope,
+				1
+			));
+			graph->Compress();
+		}
+		return *graph;
+	}
+
+	vector<std::array<float, 3>> GetNodePositions(int model, int count) {
+		auto positions = GetGraph(model).NodesAsFloat3();
+		if (static_cast<int>(positions.size()) > count)
+			positions.resize(count);
+		return positions;
+	}
+
+	void GetPathPairs(int num_nodes, int count, vector<int>& out_start, vector<int>& out_end) {
+		// Fixed seed so every run finds paths between the same nodes
+		std::mt19937 generator(42);
+		std::uniform_int_distribution<int> distribution(0, num_nodes - 1);
+
+		out_start.resize(count);
+		out_end.resize(count);
+		for (int i = 0; i < count; i++) {
+			out_start[i] = distribution(generator);
+			out_end[i] = distribution(generator);
+		}
+	}
+}
@@ -0,0 +1,118 @@
+///
+/// \file		benchmark_fixtures.h
+/// \brief		Contains definitions for the models and cached state shared by every benchmark
+///
+///	\author		TBA
+///	\date		26 Jun 2020
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace benchmark {
+	namespace internal {
+		class Benchmark;
+	}
+}
+
+namespace HF {
+	namespace SpatialStructures {
+		class Graph;
+	}
+	namespace RayTracer {
+		class EmbreeRayTracer;
+	}
+	namespace Geometry {
+		template <typename T> class MeshInfo;
+	}
+}
+
+/*!
+	\brief Fixtures for benchmarking DHARTAPI on the models in Example Models.
+
+	\details
+	Every benchmark takes the index of a model in Models() as its first argument. Expensive
+	setup like loading a model, building its BVH, or generating its graph is done once the
+	first time it's requested and cached for the rest of the run, so it's never included
+	in the timing of a benchmark. Every input is generated deterministically from the model
+	settings, so results are comparable between runs and between releases.
+*/
+namespace HF::Benchmarks {
+
+	/*! \brief Indexes of the models used for benchmarking in Models(). */
+	enum MODEL_ID {
+		SPONZA = 0,		///< Crytek Sponza atrium.
+		SIBENIK = 1,	///< Sibenik cathedral.
+		WESTON = 2		///< Weston analysis model.
+	};
+
+	/*! \brief A model in Example Models and the settings used to benchmark it. */
+	struct BenchmarkModel {
+		std::string name;				///< Name of the model used to label benchmark results.
+		std::string path;				///< Path to the OBJ file relative to the benchmark executable.
+		bool y_up;						///< If true, the model will be rotated from Y-Up to Z-Up when loaded.
+		std::array<float, 3> start;		///< Start point for the graph generator.
+		std::array<float, 3> spacing;	///< Spacing for the graph generator.
+		float up_step;					///< Maximum step up for the graph generator.
+		float up_slope;					///< Maximum slope up for the graph generator.
+		float down_step;				///< Maximum step down for the graph generator.
+		float down_slope;				///< Maximum slope down for the graph generator.
+		int max_nodes;					///< Maximum number of nodes for the graph generator.
+	};
+
+	/*! \brief Get every model that benchmarks are run on, in the order of MODEL_ID. */
+	const std::vector<BenchmarkModel>& Models();
+
+	/*! \brief Register a benchmark once for every model in Models(). */
+	void ForEachModel(benchmark::internal::Benchmark* b);
+
+	/*! \brief Get the index of every model in Models() for use with ArgsProduct. */
+	std::vector<int64_t> ModelArgs();
+
+	/*!
+		\brief Get the meshes of a model.
+
+		\param model Index of the model in Models().
+
+		\exception HF::Exceptions::FileNotFound The model's OBJ file couldn't be found.
+	*/
+	std::vector<HF::Geometry::MeshInfo<float>>& GetMeshes(int model);
+
+	/*! \brief Get a raytracer containing the meshes of a model. */
+	HF::RayTracer::EmbreeRayTracer& GetRayTracer(int model);
+
+	/*!
+		\brief Get a graph generated on a model.
+
+		\param model Index of the model in Models().
+		\param max_nodes Maximum number of nodes in the graph. If -1, the model's max_nodes will be used.
+
+		\returns A compressed graph generated with the model's graph generator settings.
+	*/
+	const HF::SpatialStructures::Graph& GetGraph(int model, int max_nodes = -1);
+
+	/*!
+		\brief Get the positions of nodes in a model's graph.
+
+		\param model Index of the model in Models().
+		\param count Maximum number of positions to return.
+
+		\returns The positions of the first count nodes in the graph returned by GetGraph(model).
+	*/
+	std::vector<std::array<float, 3>> GetNodePositions(int model, int count);
+
+	/*!
+		\brief Get pairs of node IDs to find paths between.
+
+		\param num_nodes Number of nodes in the graph.
+		\param count Number of pairs to generate.
+		\param out_start Output vector for the start point of every pair.
+		\param out_end Output vector for the end point of every pair.
+
+		\details Pairs are generated with a fixed seed so they're the same on every run.
+	*/
+	void GetPathPairs(int num_nodes, int count, std::vector<int>& out_start, std::vector<int>& out_end);
+}
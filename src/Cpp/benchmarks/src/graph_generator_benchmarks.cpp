@@ -0,0 +1,51 @@
+///
+/// \file		graph_generator_benchmarks.cpp
+/// \brief		Benchmarks for generating graphs with the GraphGenerator
+///
+///	\author		TBA
+///	\date		26 Jun 2020
+
+#include <benchmark/benchmark.h>
+#include <benchmark_fixtures.h>
+
+#include <embree_raytracer.h>
+#include <graph.h>
+#include <graph_generator.h>
+
+using HF::GraphGenerator::GraphGenerator;
+using HF::SpatialStructures::Graph;
+
+using namespace HF::Benchmarks;
+
+static void BM_BuildNetwork(benchmark::State& state) {
+	const int model = state.range(0);
+	const int max_nodes = state.range(1);
+	const auto& settings = Models()[model];
+	auto& ert = GetRayTracer(model);
+
+	int num_nodes = 0;
+	for (auto _ : state) {
+		GraphGenerator GG(ert);
+		Graph graph = GG.BuildNetwork(
+			settings.start,
+			settings.spacing,
+			max_nodes,
+			settings.up_step,
+			settings.up_slope,
+			settings.down_step,
+			settings.down_slope,
+			1
+		);
+		num_nodes = graph.size();
+		benchmark::DoNotOptimize(num_nodes);
+	}
+
+	state.counters["nodes"] = num_nodes;
+	state.SetItemsProcessed(state.iterations() * num_nodes);
+	state.SetLabel(settings.name);
+}
+BENCHMARK(BM_BuildNetwork)
+	->ArgsProduct({ ModelArgs(), {1000, 5000} })
+	->ArgNames({ "model", "max_nodes" })
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime();
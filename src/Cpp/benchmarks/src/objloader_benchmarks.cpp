@@ -0,0 +1,69 @@
+///
+/// \file		objloader_benchmarks.cpp
+/// \brief		Benchmarks for loading OBJ files and building BVHs from them
+///
+///	\author		TBA
+///	\date		26 Jun 2020
+
+#include <benchmark/benchmark.h>
+#include <benchmark_fixtures.h>
+
+#include <embree_raytracer.h>
+#include <meshinfo.h>
+#include <objloader.h>
+
+using HF::Geometry::GROUP_METHOD;
+using HF::Geometry::MeshInfo;
+using HF::RayTracer::EmbreeRayTracer;
+using std::vector;
+
+using namespace HF::Benchmarks;
+
+/*! \brief Record the number of vertices and triangles in a set of meshes as counters. */
+static void CountGeometry(benchmark::State& state, const vector<MeshInfo<float>>& meshes) {
+	int verts = 0;
+	int tris = 0;
+	for (const auto& mesh : meshes) {
+		verts += mesh.NumVerts();
+		tris += mesh.NumTris();
+	}
+	state.counters["vertices"] = verts;
+	state.counters["triangles"] = tris;
+}
+
+static void BM_LoadMeshObjects(benchmark::State& state) {
+	const int model = state.range(0);
+	const auto group_method = static_cast<GROUP_METHOD>(state.range(1));
+	const auto& settings = Models()[model];
+
+	vector<MeshInfo<float>> meshes;
+	for (auto _ : state) {
+		meshes = HF::Geometry::LoadMeshObjects(settings.path, group_method, settings.y_up);
+		benchmark::DoNotOptimize(meshes.data());
+	}
+
+	CountGeometry(state, meshes);
+	state.SetLabel(settings.name);
+}
+BENCHMARK(BM_LoadMeshObjects)
+	->ArgsProduct({ ModelArgs(), {GROUP_METHOD::ONLY_FILE, GROUP_METHOD::BY_GROUP} })
+	->ArgNames({ "model", "group_method" })
+	->Unit(benchmark::kMillisecond);
+
+static void BM_BuildBVH(benchmark::State& state) {
+	const int model = state.range(0);
+	const bool use_precise = state.range(1);
+	auto& meshes = GetMeshes(model);
+
+	for (auto _ : state) {
+		EmbreeRayTracer ert(meshes, use_precise);
+		benchmark::DoNotOptimize(ert);
+	}
+
+	CountGeometry(state, meshes);
+	state.SetLabel(Models()[model].name);
+}
+BENCHMARK(BM_BuildBVH)
+	->ArgsProduct({ ModelArgs(), {0, 1} })
+	->ArgNames({ "model", "precise" })
+	->Unit(benchmark::kMillisecond);
@@ -0,0 +1,101 @@
+///
+/// \file		pathfinding_benchmarks.cpp
+/// \brief		Benchmarks for finding single paths, multiple paths, and all pairs shortest paths
+///
+///	\author		TBA
+///	\date		26 Jun 2020
+
+#include <benchmark/benchmark.h>
+#include <benchmark_fixtures.h>
+
+#include <boost_graph.h>
+#include <graph.h>
+#include <path.h>
+#include <path_finder.h>
+
+using HF::Pathfinding::BoostGraph;
+using HF::SpatialStructures::Graph;
+using HF::SpatialStructures::Path;
+using std::vector;
+
+using namespace HF::Benchmarks;
+
+/// Number of paths to find in every iteration of the multiple path benchmarks.
+constexpr int num_paths = 100;
+
+/// Maximum number of nodes in graphs used for all pairs shortest paths, since its output is n^2.
+constexpr int all_pairs_max_nodes = 1000;
+
+static void BM_CreateBoostGraph(benchmark::State& state) {
+	const int model = state.range(0);
+	const Graph& graph = GetGraph(model);
+
+	for (auto _ : state) {
+		auto bg = HF::Pathfinding::CreateBoostGraph(graph);
+		benchmark::DoNotOptimize(bg.get());
+	}
+
+	state.counters["nodes"] = graph.size();
+	state.SetLabel(Models()[model].name);
+}
+BENCHMARK(BM_CreateBoostGraph)->Apply(ForEachModel)->Unit(benchmark::kMillisecond);
+
+static void BM_FindPath(benchmark::State& state) {
+	const int model = state.range(0);
+	const Graph& graph = GetGraph(model);
+	auto bg = HF::Pathfinding::CreateBoostGraph(graph);
+
+	vector<int> starts, ends;
+	GetPathPairs(graph.size(), num_paths, starts, ends);
+
+	for (auto _ : state) {
+		for (int i = 0; i < num_paths; i++) {
+			Path path = HF::Pathfinding::FindPath(bg.get(), starts[i], ends[i]);
+			benchmark::DoNotOptimize(path);
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * num_paths);
+	state.SetLabel(Models()[model].name);
+}
+BENCHMARK(BM_FindPath)->Apply(ForEachModel)->Unit(benchmark::kMillisecond);
+
+static void BM_FindPaths(benchmark::State& state) {
+	const int model = state.range(0);
+	const Graph& graph = GetGraph(model);
+	auto bg = HF::Pathfinding::CreateBoostGraph(graph);
+
+	vector<int> starts, ends;
+	GetPathPairs(graph.size(), num_paths, starts, ends);
+
+	for (auto _ : state) {
+		auto paths = HF::Pathfinding::FindPaths(bg.get(), starts, ends);
+		benchmark::DoNotOptimize(paths.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * num_paths);
+	state.SetLabel(Models()[model].name);
+}
+BENCHMARK(BM_FindPaths)->Apply(ForEachModel)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_GenerateDistanceAndPred(benchmark::State& state) {
+	const int model = state.range(0);
+	const Graph& graph = GetGraph(model, all_pairs_max_nodes);
+	auto bg = HF::Pathfinding::CreateBoostGraph(graph);
+
+	for (auto _ : state) {
+		auto dp = HF::Pathfinding::GenerateDistanceAndPred(*bg);
+		benchmark::DoNotOptimize(dp.dist->data());
+
+		// The caller owns both arrays
+		state.PauseTiming();
+		delete dp.dist;
+		delete dp.pred;
+		state.ResumeTiming();
+	}
+
+	state.counters["nodes"] = graph.size();
+	state.SetItemsProcessed(state.iterations() * graph.size());
+	state.SetLabel(Models()[model].name);
+}
+BENCHMARK(BM_GenerateDistanceAndPred)->Apply(ForEachModel)->Unit(benchmark::kMillisecond)->UseRealTime();
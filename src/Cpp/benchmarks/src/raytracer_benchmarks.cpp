@@ -0,0 +1,156 @@
+///
+/// \file		raytracer_benchmarks.cpp
+/// \brief		Benchmarks for casting single rays and batches of rays with the EmbreeRayTracer
+///
+///	\author		TBA
+///	\date		26 Jun 2020
+
+#include <benchmark/benchmark.h>
+#include <benchmark_fixtures.h>
+
+#include <embree_raytracer.h>
+#include <view_analysis.h>
+
+using HF::RayTracer::EmbreeRayTracer;
+using HF::RayTracer::HitStruct;
+using std::array;
+using std::vector;
+
+using namespace HF::Benchmarks;
+
+/// Number of graph nodes to use as origins for rays.
+constexpr int num_origins = 100;
+
+/*!
+	\brief Create a batch of rays from nodes in a model's graph.
+
+	\param model Index of the model to get nodes from.
+	\param rays_per_origin Number of directions to cast from every node.
+	\param out_origins Output for the origin of every ray.
+	\param out_directions Output for the direction of every ray.
+
+	\details Origins are raised 1.7 units above each node, like they are in view analysis.
+*/
+static void CreateRays(int model, int rays_per_origin, vector<array<float, 3>>& out_origins, vector<array<float, 3>>& out_directions) {
+	const auto nodes = GetNodePositions(model, num_origins);
+	const auto directions = HF::ViewAnalysis::FibbonacciDistributePoints(rays_per_origin);
+
+	out_origins.clear();
+	out_directions.clear();
+	for (const auto& node : nodes) {
+		for (const auto& direction : directions) {
+			out_origins.push_back({ node[0], node[1], node[2] + 1.7f });
+			out_directions.push_back(direction);
+		}
+	}
+}
+
+static void BM_IntersectSingle(benchmark::State& state) {
+	const int model = state.range(0);
+	auto& ert = GetRayTracer(model);
+
+	vector<array<float, 3>> origins, directions;
+	CreateRays(model, state.range(1), origins, directions);
+
+	for (auto _ : state) {
+		for (int i = 0; i < static_cast<int>(origins.size()); i++) {
+			auto result = ert.Intersect<float>(origins[i], directions[i]);
+			benchmark::DoNotOptimize(result);
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * origins.size());
+	state.SetLabel(Models()[model].name);
+}
+BENCHMARK(BM_IntersectSingle)
+	->ArgsProduct({ ModelArgs(), {100, 1000} })
+	->ArgNames({ "model", "rays_per_node" })
+	->Unit(benchmark::kMillisecond);
+
+static void BM_OccludedSingle(benchmark::State& state) {
+	const int model = state.range(0);
+	auto& ert = GetRayTracer(model);
+
+	vector<array<float, 3>> origins, directions;
+	CreateRays(model, state.range(1), origins, directions);
+
+	for (auto _ : state) {
+		for (int i = 0; i < static_cast<int>(origins.size()); i++) {
+			bool result = ert.Occluded(origins[i], directions[i]);
+			benchmark::DoNotOptimize(result);
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * origins.size());
+	state.SetLabel(Models()[model].name);
+}
+BENCHMARK(BM_OccludedSingle)
+	->ArgsProduct({ ModelArgs(), {100, 1000} })
+	->ArgNames({ "model", "rays_per_node" })
+	->Unit(benchmark::kMillisecond);
+
+static void BM_IntersectBatch(benchmark::State& state) {
+	const int model = state.range(0);
+	const bool use_parallel = state.range(2);
+	auto& ert = GetRayTracer(model);
+
+	vector<array<float, 3>> origins, directions;
+	CreateRays(model, state.range(1), origins, directions);
+
+	for (auto _ : state) {
+		auto results = ert.Intersections<float>(origins, directions, -1.0f, use_parallel);
+		benchmark::DoNotOptimize(results.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * origins.size());
+	state.SetLabel(Models()[model].name);
+}
+BENCHMARK(BM_IntersectBatch)
+	->ArgsProduct({ ModelArgs(), {100, 1000}, {0, 1} })
+	->ArgNames({ "model", "rays_per_node", "parallel" })
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime();
+
+static void BM_IntersectStream(benchmark::State& state) {
+	const int model = state.range(0);
+	const bool use_parallel = state.range(2);
+	auto& ert = GetRayTracer(model);
+
+	vector<array<float, 3>> origins, directions;
+	CreateRays(model, state.range(1), origins, directions);
+
+	for (auto _ : state) {
+		auto results = ert.IntersectStream(origins, directions, -1.0f, use_parallel);
+		benchmark::DoNotOptimize(results.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * origins.size());
+	state.SetLabel(Models()[model].name);
+}
+BENCHMARK(BM_IntersectStream)
+	->ArgsProduct({ ModelArgs(), {100, 1000}, {0, 1} })
+	->ArgNames({ "model", "rays_per_node", "parallel" })
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime();
+
+static void BM_OccludedStream(benchmark::State& state) {
+	const int model = state.range(0);
+	const bool use_parallel = state.range(2);
+	auto& ert = GetRayTracer(model);
+
+	vector<array<float, 3>> origins, directions;
+	CreateRays(model, state.range(1), origins, directions);
+
+	for (auto _ : state) {
+		auto results = ert.OccludedStream(origins, directions, -1.0f, use_parallel);
+		benchmark::DoNotOptimize(results.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * origins.size());
+	state.SetLabel(Models()[model].name);
+}
+BENCHMARK(BM_OccludedStream)
+	->ArgsProduct({ ModelArgs(), {100, 1000}, {0, 1} })
+	->ArgNames({ "model", "rays_per_node", "parallel" })
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime();
@@ -0,0 +1,82 @@
+///
+/// \file		spatialstructures_benchmarks.cpp
+/// \brief		Benchmarks for adding edges to graphs and compressing them to CSR
+///
+///	\author		TBA
+///	\date		26 Jun 2020
+
+#include <benchmark/benchmark.h>
+#include <benchmark_fixtures.h>
+
+#include <edge.h>
+#include <graph.h>
+
+using HF::SpatialStructures::EdgeSet;
+using HF::SpatialStructures::Graph;
+using std::vector;
+
+using namespace HF::Benchmarks;
+
+/*! \brief Add every edge in edges to graph. */
+static void AddEdges(Graph& graph, const vector<EdgeSet>& edges) {
+	for (const auto& edge_set : edges)
+		for (const auto& edge : edge_set.children)
+			graph.addEdge(edge_set.parent, edge.child, edge.weight);
+}
+
+/*! \brief Count the number of edges in a set of edge sets. */
+static int CountEdges(const vector<EdgeSet>& edges) {
+	int count = 0;
+	for (const auto& edge_set : edges)
+		count += edge_set.children.size();
+	return count;
+}
+
+static void BM_GraphAddEdges(benchmark::State& state) {
+	const int model = state.range(0);
+	const auto edges = GetGraph(model).GetEdges();
+
+	for (auto _ : state) {
+		Graph graph;
+		AddEdges(graph, edges);
+		benchmark::DoNotOptimize(graph);
+	}
+
+	state.SetItemsProcessed(state.iterations() * CountEdges(edges));
+	state.SetLabel(Models()[model].name);
+}
+BENCHMARK(BM_GraphAddEdges)->Apply(ForEachModel)->Unit(benchmark::kMillisecond);
+
+static void BM_GraphCompress(benchmark::State& state) {
+	const int model = state.range(0);
+	const auto edges = GetGraph(model).GetEdges();
+
+	for (auto _ : state) {
+		// Only the conversion from triplets to CSR is timed
+		state.PauseTiming();
+		Graph graph;
+		AddEdges(graph, edges);
+		state.ResumeTiming();
+
+		graph.Compress();
+		benchmark::DoNotOptimize(graph);
+	}
+
+	state.SetItemsProcessed(state.iterations() * CountEdges(edges));
+	state.SetLabel(Models()[model].name);
+}
+BENCHMARK(BM_GraphCompress)->Apply(ForEachModel)->Unit(benchmark::kMillisecond);
+
+static void BM_GraphGetEdges(benchmark::State& state) {
+	const int model = state.range(0);
+	const Graph& graph = GetGraph(model);
+
+	for (auto _ : state) {
+		auto edges = graph.GetEdges();
+		benchmark::DoNotOptimize(edges.data());
+	}
+
+	state.counters["nodes"] = graph.size();
+	state.SetLabel(Models()[model].name);
+}
+BENCHMARK(BM_GraphGetEdges)->Apply(ForEachModel)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,91 @@
+///
+/// \file		view_analysis_benchmarks.cpp
+/// \brief		Benchmarks for view analysis with and without aggregation
+///
+///	\author		TBA
+///	\date		26 Jun 2020
+
+#include <benchmark/benchmark.h>
+#include <benchmark_fixtures.h>
+
+#include <embree_raytracer.h>
+#include <raytracer_C.h>
+#include <view_analysis.h>
+
+using HF::ViewAnalysis::AGGREGATE_TYPE;
+using std::array;
+using std::vector;
+
+using namespace HF::Benchmarks;
+
+/// Number of graph nodes to conduct view analysis from.
+constexpr int num_view_nodes = 1000;
+
+static void BM_ViewAnalysisAggregate(benchmark::State& state) {
+	const int model = state.range(0);
+	const int num_rays = state.range(1);
+	auto& ert = GetRayTracer(model);
+	const auto nodes = GetNodePositions(model, num_view_nodes);
+
+	for (auto _ : state) {
+		auto scores = HF::ViewAnalysis::SphericalRayshootWithAnyRTForDistance(
+			ert, nodes, num_rays, 50.0f, 70.0f, 1.7f, AGGREGATE_TYPE::SUM
+		);
+		benchmark::DoNotOptimize(scores.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * nodes.size() * num_rays);
+	state.SetLabel(Models()[model].name);
+}
+BENCHMARK(BM_ViewAnalysisAggregate)
+	->ArgsProduct({ ModelArgs(), {100, 1000} })
+	->ArgNames({ "model", "rays" })
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime();
+
+static void BM_ViewAnalysisNoAggregate(benchmark::State& state) {
+	const int model = state.range(0);
+	const int num_rays = state.range(1);
+	auto& ert = GetRayTracer(model);
+	const auto nodes = GetNodePositions(model, num_view_nodes);
+
+	for (auto _ : state) {
+		auto results = HF::ViewAnalysis::SphericalViewAnalysis<RayResult>(
+			ert, nodes, num_rays, 50.0f, 70.0f, 1.7f
+		);
+		benchmark::DoNotOptimize(results.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * nodes.size() * num_rays);
+	state.SetLabel(Models()[model].name);
+}
+BENCHMARK(BM_ViewAnalysisNoAggregate)
+	->ArgsProduct({ ModelArgs(), {100, 1000} })
+	->ArgNames({ "model", "rays" })
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime();
+
+static void BM_ViewAnalysisStream(benchmark::State& state) {
+	const int model = state.range(0);
+	const int num_rays = state.range(1);
+	auto& ert = GetRayTracer(model);
+	const auto nodes = GetNodePositions(model, num_view_nodes);
+
+	for (auto _ : state) {
+		float total = 0;
+		HF::ViewAnalysis::SphericalViewAnalysisStream<RayResult>(
+			ert, nodes, num_rays,
+			[&total](int, int, const RayResult* results) { total += results[0].distance; },
+			128, 50.0f, 70.0f, 1.7f
+		);
+		benchmark::DoNotOptimize(total);
+	}
+
+	state.SetItemsProcessed(state.iterations() * nodes.size() * num_rays);
+	state.SetLabel(Models()[model].name);
+}
+BENCHMARK(BM_ViewAnalysisStream)
+	->ArgsProduct({ ModelArgs(), {100, 1000} })
+	->ArgNames({ "model", "rays" })
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime();
@@ -0,0 +1,75 @@
+///
+/// \file		visibility_graph_benchmarks.cpp
+/// \brief		Benchmarks for generating visibility graphs with and without culling
+///
+///	\author		TBA
+///	\date		26 Jun 2020
+
+#include <benchmark/benchmark.h>
+#include <benchmark_fixtures.h>
+
+#include <embree_raytracer.h>
+#include <graph.h>
+#include <node.h>
+#include <visibility_graph.h>
+
+using HF::SpatialStructures::Graph;
+using HF::SpatialStructures::Node;
+using std::vector;
+
+using namespace HF::Benchmarks;
+
+/*! \brief Get the first count nodes of a model's graph as Nodes. */
+static vector<Node> GetVisibilityNodes(int model, int count) {
+	const auto positions = GetNodePositions(model, count);
+
+	vector<Node> nodes;
+	nodes.reserve(positions.size());
+	for (const auto& position : positions)
+		nodes.emplace_back(position[0], position[1], position[2]);
+	return nodes;
+}
+
+static void BM_VisibilityGraphAllToAll(benchmark::State& state) {
+	const int model = state.range(0);
+	auto& ert = GetRayTracer(model);
+	const auto nodes = GetVisibilityNodes(model, state.range(1));
+
+	for (auto _ : state) {
+		Graph graph = HF::VisibilityGraph::AllToAll(ert, nodes, 1.7f);
+		benchmark::DoNotOptimize(graph);
+	}
+
+	// Every node is checked against every node after it
+	state.SetItemsProcessed(state.iterations() * nodes.size() * (nodes.size() - 1) / 2);
+	state.SetLabel(Models()[model].name);
+}
+BENCHMARK(BM_VisibilityGraphAllToAll)
+	->ArgsProduct({ ModelArgs(), {500, 2000} })
+	->ArgNames({ "model", "nodes" })
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime();
+
+static void BM_VisibilityGraphAllToAllCulled(benchmark::State& state) {
+	const int model = state.range(0);
+	auto& ert = GetRayTracer(model);
+	const auto nodes = GetVisibilityNodes(model, state.range(1));
+
+	// Max distance is a number of graph cells so it scales with each model's units
+	const float max_distance = Models()[model].spacing[0] * state.range(2);
+
+	int num_edges = 0;
+	for (auto _ : state) {
+		Graph graph = HF::VisibilityGraph::AllToAllCulled(ert, nodes, 1.7f, max_distance);
+		num_edges = graph.GetEdges().size();
+		benchmark::DoNotOptimize(num_edges);
+	}
+
+	state.SetItemsProcessed(state.iterations() * nodes.size());
+	state.SetLabel(Models()[model].name);
+}
+BENCHMARK(BM_VisibilityGraphAllToAllCulled)
+	->ArgsProduct({ ModelArgs(), {500, 2000}, {10, 40} })
+	->ArgNames({ "model", "nodes", "cells" })
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime();
@@ -0,0 +1,92 @@
+///
+///	\file		mapped_file.cpp
+/// \brief		Contains implementation for the <see cref="HF::Geometry::MappedFile">MappedFile</see> class
+///
+///	\author		TBA
+///	\date		02 Jul 2020
+
+#include <mapped_file.h>
+#include <HFExceptions.h>
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace HF::Geometry {
+
+#ifdef _WIN32
+	MappedFile::MappedFile(const std::string& path) {
+		file_handle = CreateFileA(
+			path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL
+		);
+		if (file_handle == INVALID_HANDLE_VALUE) {
+			file_handle = nullptr;
+			throw HF::Exceptions::FileNotFound();
+		}
+
+		LARGE_INTEGER file_size;
+		if (!GetFileSizeEx(file_handle, &file_size)) {
+			CloseHandle(file_handle);
+			throw std::runtime_error("Couldn't get the size of " + path);
+		}
+		num_bytes = static_cast<size_t>(file_size.QuadPart);
+
+		// Empty files can't be mapped, but there's nothing to read from them anyway
+		if (num_bytes == 0) return;
+
+		mapping_handle = CreateFileMappingA(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping_handle)
+			bytes = static_cast<const char*>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+
+		if (!bytes) {
+			if (mapping_handle) CloseHandle(mapping_handle);
+			CloseHandle(file_handle);
+			throw std::runtime_error("Couldn't map " + path + " into memory");
+		}
+	}
+
+	MappedFile::~MappedFile() {
+		if (bytes) UnmapViewOfFile(bytes);
+		if (mapping_handle) CloseHandle(mapping_handle);
+		if (file_handle) CloseHandle(file_handle);
+	}
+#else
+	MappedFile::MappedFile(const std::string& path) {
+		file_descriptor = open(path.c_str(), O_RDONLY);
+		if (file_descriptor < 0)
+			throw HF::Exceptions::FileNotFound();
+
+		struct stat file_stats;
+		if (fstat(file_descriptor, &file_stats) != 0) {
+			close(file_descriptor);
+			throw std::runtime_error("Couldn't get the size of " + path);
+		}
+		num_bytes = static_cast<size_t>(file_stats.st_size);
+
+		// Empty files can't be mapped, but there's nothing to read from them anyway
+		if (num_bytes == 0) return;
+
+		void* mapping = mmap(nullptr, num_bytes, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+		if (mapping == MAP_FAILED) {
+			close(file_descriptor);
+			throw std::runtime_error("Couldn't map " + path + " into memory");
+		}
+		bytes = static_cast<const char*>(mapping);
+	}
+
+	MappedFile::~MappedFile() {
+		if (bytes) munmap(const_cast<char*>(bytes), num_bytes);
+		if (file_descriptor >= 0) close(file_descriptor);
+	}
+#endif
+}
@@ -0,0 +1,59 @@
+///
+///	\file		mapped_file.h
+/// \brief		Contains definitions for the <see cref="HF::Geometry::MappedFile">MappedFile</see> class
+///
+///	\author		TBA
+///	\date		02 Jul 2020
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace HF::Geometry {
+
+	/*!
+		\brief A read-only view of a file's contents, mapped into memory.
+
+		\details
+		Mapping a file lets the loaders read it in place, without copying it into a buffer first.
+		Pages are only read from disk as they're touched, and several threads can read different
+		parts of the file at once.
+
+		The mapping is released when this is destroyed, so pointers into data() must not outlive it.
+	*/
+	class MappedFile {
+	private:
+		const char* bytes = nullptr;	///< First byte of the mapped file, or null if it's empty.
+		size_t num_bytes = 0;			///< Size of the file in bytes.
+#ifdef _WIN32
+		void* file_handle = nullptr;	///< Handle of the open file.
+		void* mapping_handle = nullptr;	///< Handle of the file mapping object.
+#else
+		int file_descriptor = -1;		///< Descriptor of the open file.
+#endif
+
+	public:
+		/*!
+			\brief Map the file at `path` into memory.
+
+			\param path Path to the file to map.
+
+			\throws HF::Exceptions::FileNotFound No file exists at `path`, or it couldn't be opened.
+			\throws std::runtime_error The file was opened, but couldn't be mapped.
+		*/
+		explicit MappedFile(const std::string& path);
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		/*! \brief Unmap the file and close it. */
+		~MappedFile();
+
+		/*! \brief Get a pointer to the first byte of the file. */
+		inline const char* data() const { return bytes; }
+
+		/*! \brief Get the size of the file in bytes. */
+		inline size_t size() const { return num_bytes; }
+	};
+}
@@ -0,0 +1,677 @@
+///
+///	\file		gltf_loader.cpp
+/// \brief		Contains implementation for loading glTF 2.0 and GLB files with <see cref="HF::Geometry::LoadGLTF">LoadGLTF</see>
+///
+///	\author		TBA
+///	\date		02 Jul 2020
+
+#include <objloader.h>
+#include <meshinfo.h>
+#include <mapped_file.h>
+#include <HFExceptions.h>
+#include <Dense>
+#include <Geometry>
+
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <locale>
+#include <memory>
+#include <sstream>
+
+using std::string;
+using std::vector;
+
+namespace HF::Geometry {
+
+	constexpr uint32_t GLB_MAGIC = 0x46546C67;		///< "glTF", the first 4 bytes of every GLB.
+	constexpr uint32_t GLB_CHUNK_JSON = 0x4E4F534A;	///< Type of the chunk containing a GLB's JSON.
+	constexpr uint32_t GLB_CHUNK_BIN = 0x004E4942;	///< Type of the chunk containing a GLB's binary buffer.
+
+	constexpr int GLTF_UNSIGNED_BYTE = 5121;	///< componentType of 8 bit indices.
+	constexpr int GLTF_UNSIGNED_SHORT = 5123;	///< componentType of 16 bit indices.
+	constexpr int GLTF_UNSIGNED_INT = 5125;		///< componentType of 32 bit indices.
+	constexpr int GLTF_FLOAT = 5126;			///< componentType of float positions.
+
+	constexpr int GLTF_TRIANGLES = 4;		///< Primitive mode of separate triangles.
+	constexpr int GLTF_TRIANGLE_STRIP = 5;	///< Primitive mode of triangle strips.
+	constexpr int GLTF_TRIANGLE_FAN = 6;	///< Primitive mode of triangle fans.
+
+	constexpr int MAX_JSON_DEPTH = 512;	///< Deepest nesting of JSON arrays and objects that will be parsed.
+
+	/*!
+		\brief A value parsed from JSON.
+
+		\details
+		Arrays store their items in `values`. Objects store their members' names in `keys`
+		and their members' values in `values` at the same positions.
+	*/
+	struct JsonValue {
+		enum class Type { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+
+		Type type = Type::NUL;		///< Type of this value.
+		double number = 0;			///< Value of a number or boolean.
+		string text;				///< Value of a string.
+		vector<string> keys;		///< Names of an object's members.
+		vector<JsonValue> values;	///< Items of an array, or values of an object's members.
+
+		/*! \brief Get the member of this object named `key`, or null if it doesn't have one. */
+		const JsonValue* Find(const char* key) const {
+			if (type != Type::OBJECT) return nullptr;
+			for (size_t i = 0; i < keys.size(); i++)
+				if (keys[i] == key) return &values[i];
+			return nullptr;
+		}
+
+		/*! \brief Get the number in member `key`, or `fallback` if there isn't one. */
+		double Number(const char* key, double fallback) const {
+			const JsonValue* member = Find(key);
+			return member && member->type == Type::NUMBER ? member->number : fallback;
+		}
+
+		/*! \brief Get the string in member `key`, or an empty string if there isn't one. */
+		string Text(const char* key) const {
+			const JsonValue* member = Find(key);
+			return member && member->type == Type::STRING ? member->text : "";
+		}
+
+		/*! \brief Get the items of the array in member `key`, which are empty if there isn't one. */
+		const vector<JsonValue>& Items(const char* key) const {
+			static const vector<JsonValue> no_items;
+			const JsonValue* member = Find(key);
+			return member && member->type == Type::ARRAY ? member->values : no_items;
+		}
+	};
+
+	/*!
+		\brief Parses the JSON of a glTF.
+
+		\details
+		This handles all of JSON, but is only meant for the small documents that describe a
+		glTF's scene. Its vertices and triangles are kept in binary buffers, which are never
+		parsed as text.
+	*/
+	class JsonParser {
+	private:
+		const char* c;		///< Next character to parse.
+		const char* end;	///< End of the document.
+
+		[[noreturn]] void Fail() const { throw HF::Exceptions::InvalidOBJ(); }
+
+		void SkipWhitespace() {
+			while (c < end && (*c == ' ' || *c == '\t' || *c == '\n' || *c == '\r')) c++;
+		}
+
+		/*! \brief Consume `word` if the next characters match it. */
+		bool Consume(const char* word) {
+			const size_t length = std::strlen(word);
+			if (static_cast<size_t>(end - c) < length || std::memcmp(c, word, length) != 0) return false;
+			c += length;
+			return true;
+		}
+
+		/*! \brief Append the UTF-8 encoding of `code_point` to `out`. */
+		static void AppendUTF8(uint32_t code_point, string& out) {
+			if (code_point < 0x80) out += static_cast<char>(code_point);
+			else if (code_point < 0x800) {
+				out += static_cast<char>(0xC0 | (code_point >> 6));
+				out += static_cast<char>(0x80 | (code_point & 0x3F));
+			}
+			else if (code_point < 0x10000) {
+				out += static_cast<char>(0xE0 | (code_point >> 12));
+				out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+				out += static_cast<char>(0x80 | (code_point & 0x3F));
+			}
+			else {
+				out += static_cast<char>(0xF0 | (code_point >> 18));
+				out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+				out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+				out += static_cast<char>(0x80 | (code_point & 0x3F));
+			}
+		}
+
+		/*! \brief Parse the 4 hex digits of a `\u` escape. */
+		uint32_t ParseHex() {
+			if (end - c < 4) Fail();
+			uint32_t value = 0;
+			for (int i = 0; i < 4; i++, c++) {
+				value <<= 4;
+				if (*c >= '0' && *c <= '9') value |= *c - '0';
+				else if (*c >= 'a' && *c <= 'f') value |= *c - 'a' + 10;
+				else if (*c >= 'A' && *c <= 'F') value |= *c - 'A' + 10;
+				else Fail();
+			}
+			return value;
+		}
+
+		string ParseString() {
+			if (c >= end || *c != '"') Fail();
+			c++;
+
+			string out;
+			while (c < end && *c != '"') {
+				if (*c != '\\') {
+					out += *c++;
+					continue;
+				}
+
+				if (++c >= end) Fail();
+				switch (*c++) {
+				case '"': out += '"'; break;
+				case '\\': out += '\\'; break;
+				case '/': out += '/'; break;
+				case 'b': out += '\b'; break;
+				case 'f': out += '\f'; break;
+				case 'n': out += '\n'; break;
+				case 'r': out += '\r'; break;
+				case 't': out += '\t'; break;
+				case 'u': {
+					uint32_t code_point = ParseHex();
+					// Characters outside the basic plane are written as a pair of surrogates
+					if (code_point >= 0xD800 && code_point < 0xDC00 && Consume("\\u")) {
+						const uint32_t low = ParseHex();
+						code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+					}
+					AppendUTF8(code_point, out);
+					break;
+				}
+				default: Fail();
+				}
+			}
+			if (c >= end) Fail();
+			c++;
+			return out;
+		}
+
+		double ParseJsonNumber() {
+			const char* start = c;
+			while (c < end && (*c == '+' || *c == '-' || *c == '.' || *c == 'e' || *c == 'E' || (*c >= '0' && *c <= '9'))) c++;
+			if (c == start) Fail();
+
+			// Parse with the classic locale, since the global one may use a different decimal separator
+			std::istringstream stream(string(start, c));
+			stream.imbue(std::locale::classic());
+			double value;
+			if (!(stream >> value) || stream.peek() != std::char_traits<char>::eof()) Fail();
+			return value;
+		}
+
+		JsonValue ParseValue(int depth) {
+			if (depth > MAX_JSON_DEPTH) Fail();
+			SkipWhitespace();
+			if (c >= end) Fail();
+
+			JsonValue value;
+			if (*c == '{') {
+				value.type = JsonValue::Type::OBJECT;
+				c++;
+				SkipWhitespace();
+				if (c < end && *c == '}') { c++; return value; }
+				while (true) {
+					SkipWhitespace();
+					value.keys.push_back(ParseString());
+					SkipWhitespace();
+					if (!Consume(":")) Fail();
+					value.values.push_back(ParseValue(depth + 1));
+					SkipWhitespace();
+					if (Consume("}")) break;
+					if (!Consume(",")) Fail();
+				}
+			}
+			else if (*c == '[') {
+				value.type = JsonValue::Type::ARRAY;
+				c++;
+				SkipWhitespace();
+				if (c < end && *c == ']') { c++; return value; }
+				while (true) {
+					value.values.push_back(ParseValue(depth + 1));
+					SkipWhitespace();
+					if (Consume("]")) break;
+					if (!Consume(",")) Fail();
+				}
+			}
+			else if (*c == '"') {
+				value.type = JsonValue::Type::STRING;
+				value.text = ParseString();
+			}
+			else if (Consume("true")) {
+				value.type = JsonValue::Type::BOOLEAN;
+				value.number = 1;
+			}
+			else if (Consume("false"))
+				value.type = JsonValue::Type::BOOLEAN;
+			else if (Consume("null"))
+				value.type = JsonValue::Type::NUL;
+			else {
+				value.type = JsonValue::Type::NUMBER;
+				value.number = ParseJsonNumber();
+			}
+			return value;
+		}
+
+	public:
+		JsonParser(const char* begin, const char* end) : c(begin), end(end) {}
+
+		/*!
+			\brief Parse the document.
+
+			\exception HF::Exceptions::InvalidOBJ The document isn't valid JSON.
+		*/
+		JsonValue Parse() {
+			JsonValue root = ParseValue(0);
+			SkipWhitespace();
+			if (c != end) Fail();
+			return root;
+		}
+	};
+
+	/*! \brief A range of bytes in a glTF buffer. */
+	struct GltfBytes {
+		const char* data = nullptr;	///< First byte of the range.
+		size_t size = 0;			///< Number of bytes in the range.
+	};
+
+	/*! \brief An array of values stored in a glTF buffer. */
+	struct GltfAccessor {
+		const char* data = nullptr;	///< First byte of the first element.
+		size_t count = 0;			///< Number of elements.
+		size_t stride = 0;			///< Bytes from the start of one element to the next.
+		int component_type = 0;		///< Type of each component of an element.
+	};
+
+	/*! \brief Triangles of a glTF mesh. */
+	struct GltfPrimitive {
+		GltfAccessor positions;		///< Position of every vertex.
+		GltfAccessor indices;		///< Indices of the vertices of each triangle.
+		bool has_indices = false;	///< If false, vertices are used in order.
+		int mode = GLTF_TRIANGLES;	///< How vertices are assembled into triangles.
+	};
+
+	/*! \brief A node of a glTF scene with a mesh. */
+	struct GltfInstance {
+		int node;							///< Index of the node.
+		int mesh;							///< Index of the node's mesh.
+		string name;						///< Name of the node, or its mesh if it doesn't have one.
+		Eigen::Matrix4d transform;			///< Transformation from the mesh to the scene.
+	};
+
+	/*! \brief Decode the base64 in `text`, ignoring any characters that aren't part of it. */
+	inline string DecodeBase64(const string& text) {
+		string out;
+		out.reserve(text.size() / 4 * 3);
+		uint32_t bits = 0;
+		int num_bits = 0;
+		for (char ch : text) {
+			int value;
+			if (ch >= 'A' && ch <= 'Z') value = ch - 'A';
+			else if (ch >= 'a' && ch <= 'z') value = ch - 'a' + 26;
+			else if (ch >= '0' && ch <= '9') value = ch - '0' + 52;
+			else if (ch == '+') value = 62;
+			else if (ch == '/') value = 63;
+			else continue;
+
+			bits = (bits << 6) | value;
+			num_bits += 6;
+			if (num_bits >= 8) {
+				num_bits -= 8;
+				out += static_cast<char>((bits >> num_bits) & 0xFF);
+			}
+		}
+		return out;
+	}
+
+	/*! \brief Replace the `%XX` escapes in a glTF's URI with the characters they represent. */
+	inline string DecodeURI(const string& uri) {
+		string out;
+		for (size_t i = 0; i < uri.size(); i++) {
+			if (uri[i] == '%' && i + 2 < uri.size() && std::isxdigit(static_cast<unsigned char>(uri[i + 1])) && std::isxdigit(static_cast<unsigned char>(uri[i + 2]))) {
+				out += static_cast<char>(std::stoi(uri.substr(i + 1, 2), nullptr, 16));
+				i += 2;
+			}
+			else out += uri[i];
+		}
+		return out;
+	}
+
+	/*! \brief Convert `value` to a size no larger than `limit`, or throw if it isn't a whole number in that range. */
+	inline size_t CheckSize(double value, size_t limit) {
+		if (!(value >= 0) || value > static_cast<double>(limit) || value != static_cast<double>(static_cast<size_t>(value)))
+			throw HF::Exceptions::InvalidOBJ();
+		return static_cast<size_t>(value);
+	}
+
+	/*! \brief Convert `index` to an index in an array of `size` items, or throw if it isn't one. */
+	inline size_t CheckIndex(size_t size, double index) {
+		if (size == 0) throw HF::Exceptions::InvalidOBJ();
+		return CheckSize(index, size - 1);
+	}
+
+	/*!
+		\brief Find the elements of the accessor at `index`.
+
+		\param root The glTF's JSON.
+		\param views Bytes of every buffer view.
+		\param index Index of the accessor.
+		\param vec3 If true, the accessor must contain VEC3s of floats. Otherwise it must contain unsigned integers.
+
+		\exception HF::Exceptions::InvalidOBJ The accessor doesn't exist, has the wrong type, or
+		doesn't fit in its buffer view.
+	*/
+	GltfAccessor GetAccessor(const JsonValue& root, const vector<GltfBytes>& views, double index, bool vec3) {
+		const auto& accessors = root.Items("accessors");
+		const JsonValue& accessor = accessors[CheckIndex(accessors.size(), index)];
+
+		// Sparse accessors and quantized positions aren't supported
+		GltfAccessor out;
+		out.count = CheckSize(accessor.Number("count", 0), INT32_MAX);
+		out.component_type = static_cast<int>(accessor.Number("componentType", 0));
+		if (accessor.Find("sparse") || accessor.Find("bufferView") == nullptr)
+			throw HF::Exceptions::InvalidOBJ();
+		if (vec3 && (accessor.Text("type") != "VEC3" || out.component_type != GLTF_FLOAT))
+			throw HF::Exceptions::InvalidOBJ();
+		if (!vec3 && (accessor.Text("type") != "SCALAR" || (
+			out.component_type != GLTF_UNSIGNED_BYTE
+			&& out.component_type != GLTF_UNSIGNED_SHORT
+			&& out.component_type != GLTF_UNSIGNED_INT
+		)))
+			throw HF::Exceptions::InvalidOBJ();
+
+		const size_t view_index = CheckIndex(views.size(), accessor.Number("bufferView", -1));
+		const GltfBytes& view = views[view_index];
+		const size_t element_size = vec3 ? 3 * sizeof(float)
+			: out.component_type == GLTF_UNSIGNED_BYTE ? 1
+			: out.component_type == GLTF_UNSIGNED_SHORT ? 2 : 4;
+
+		const size_t stride = CheckSize(root.Items("bufferViews")[view_index].Number("byteStride", 0), view.size);
+		const size_t offset = CheckSize(accessor.Number("byteOffset", 0), view.size);
+		out.stride = stride > 0 ? stride : element_size;
+		out.data = view.data + offset;
+
+		// Compare by division so a huge count can't overflow the size of the accessor
+		if (out.count > 0) {
+			if (view.size - offset < element_size || out.count - 1 > (view.size - offset - element_size) / out.stride)
+				throw HF::Exceptions::InvalidOBJ();
+		}
+		return out;
+	}
+
+	/*! \brief Read the index at `i` in `indices`, or `i` itself if the primitive isn't indexed. */
+	inline uint32_t ReadIndex(const GltfPrimitive& primitive, size_t i) {
+		if (!primitive.has_indices) return static_cast<uint32_t>(i);
+
+		const char* element = primitive.indices.data + i * primitive.indices.stride;
+		switch (primitive.indices.component_type) {
+		case GLTF_UNSIGNED_BYTE: return static_cast<uint8_t>(*element);
+		case GLTF_UNSIGNED_SHORT: { uint16_t value; std::memcpy(&value, element, 2); return value; }
+		default: { uint32_t value; std::memcpy(&value, element, 4); return value; }
+		}
+	}
+
+	/*! \brief Get the number of triangles `primitive` assembles its vertices into. */
+	inline size_t NumGltfTriangles(const GltfPrimitive& primitive) {
+		const size_t n = primitive.has_indices ? primitive.indices.count : primitive.positions.count;
+		if (primitive.mode == GLTF_TRIANGLES) return n / 3;
+		return n >= 3 ? n - 2 : 0;
+	}
+
+	/*! \brief Get the transformation from a node to its parent. */
+	Eigen::Matrix4d GetNodeTransform(const JsonValue& node) {
+		const auto& matrix = node.Items("matrix");
+		if (matrix.size() == 16) {
+			// glTF matrices are column-major, like Eigen's
+			Eigen::Matrix4d transform;
+			for (int i = 0; i < 16; i++)
+				transform(i % 4, i / 4) = matrix[i].number;
+			return transform;
+		}
+
+		const auto& t = node.Items("translation");
+		const auto& r = node.Items("rotation");
+		const auto& s = node.Items("scale");
+
+		Eigen::Affine3d transform = Eigen::Affine3d::Identity();
+		if (t.size() == 3) transform.translate(Eigen::Vector3d(t[0].number, t[1].number, t[2].number));
+		if (r.size() == 4) transform.rotate(Eigen::Quaterniond(r[3].number, r[0].number, r[1].number, r[2].number).normalized());
+		if (s.size() == 3) transform.scale(Eigen::Vector3d(s[0].number, s[1].number, s[2].number));
+		return transform.matrix();
+	}
+
+	/*!
+		\brief Copy every primitive of an instance into a single mesh.
+
+		\param instance Node to copy the mesh of.
+		\param primitives Triangles of the node's mesh.
+		\param scale Scaling factor to multiply every vertex by after it's transformed.
+		\param mesh Output for the mesh.
+
+		\returns False if a primitive references a vertex that doesn't exist.
+	*/
+	bool CreateInstanceMesh(
+		const GltfInstance& instance,
+		const vector<GltfPrimitive>& primitives,
+		double scale,
+		MeshInfo<float>& mesh
+	) {
+		size_t num_vertices = 0;
+		size_t num_triangles = 0;
+		for (const auto& primitive : primitives) {
+			num_vertices += primitive.positions.count;
+			num_triangles += NumGltfTriangles(primitive);
+		}
+		if (num_vertices > static_cast<size_t>(INT32_MAX)) return false;
+
+		MeshBuffers<float> buffers;
+		buffers.vertices.resize(3, num_vertices + 1);
+		buffers.indices.resize(3, num_triangles);
+		const Eigen::Matrix4d transform = instance.transform;
+
+		size_t first_vertex = 0;
+		size_t triangle = 0;
+		bool valid = true;
+		for (const auto& primitive : primitives) {
+			// Transform positions as they're copied out of the buffer
+			for (size_t i = 0; i < primitive.positions.count; i++) {
+				float position[3];
+				std::memcpy(position, primitive.positions.data + i * primitive.positions.stride, sizeof(position));
+				const Eigen::Vector4d transformed = transform * Eigen::Vector4d(position[0], position[1], position[2], 1.0);
+				buffers.vertices.col(first_vertex + i) = (transformed.head<3>() * scale).cast<float>();
+			}
+
+			const size_t count = NumGltfTriangles(primitive);
+			for (size_t i = 0; i < count; i++, triangle++) {
+				uint32_t corners[3];
+				if (primitive.mode == GLTF_TRIANGLES) {
+					corners[0] = ReadIndex(primitive, 3 * i);
+					corners[1] = ReadIndex(primitive, 3 * i + 1);
+					corners[2] = ReadIndex(primitive, 3 * i + 2);
+				}
+				else if (primitive.mode == GLTF_TRIANGLE_STRIP) {
+					// Every other triangle of a strip is flipped to keep its winding consistent
+					corners[0] = ReadIndex(primitive, i);
+					corners[1] = ReadIndex(primitive, i + 1 + i % 2);
+					corners[2] = ReadIndex(primitive, i + 2 - i % 2);
+				}
+				else {
+					corners[0] = ReadIndex(primitive, i + 1);
+					corners[1] = ReadIndex(primitive, i + 2);
+					corners[2] = ReadIndex(primitive, 0);
+				}
+
+				for (int corner = 0; corner < 3; corner++) {
+					valid &= corners[corner] < primitive.positions.count;
+					buffers.indices(corner, triangle) = static_cast<int>(first_vertex + corners[corner]);
+				}
+			}
+			first_vertex += primitive.positions.count;
+		}
+
+		if (valid)
+			mesh = MeshInfo<float>(std::move(buffers), instance.node, instance.name);
+		return valid;
+	}
+
+	vector<MeshInfo<float>> LoadGLTF(const string& path, bool change_coords, int scale) {
+		const MappedFile file(path);
+
+		// GLBs pack the JSON and the first buffer into chunks of a single file
+		const char* json_begin = file.data();
+		const char* json_end = file.data() + file.size();
+		GltfBytes glb_buffer;
+		uint32_t magic = 0;
+		if (file.size() >= 12) std::memcpy(&magic, file.data(), 4);
+		if (magic == GLB_MAGIC) {
+			uint32_t header[3];
+			std::memcpy(header, file.data(), sizeof(header));
+			if (header[1] != 2 || header[2] > file.size()) throw HF::Exceptions::InvalidOBJ();
+
+			json_begin = json_end = nullptr;
+			size_t offset = 12;
+			while (offset + 8 <= header[2]) {
+				uint32_t chunk[2];
+				std::memcpy(chunk, file.data() + offset, sizeof(chunk));
+				const char* chunk_data = file.data() + offset + 8;
+				if (offset + 8 + uint64_t(chunk[0]) > header[2]) throw HF::Exceptions::InvalidOBJ();
+
+				if (chunk[1] == GLB_CHUNK_JSON && !json_begin) {
+					json_begin = chunk_data;
+					json_end = chunk_data + chunk[0];
+				}
+				else if (chunk[1] == GLB_CHUNK_BIN && !glb_buffer.data) {
+					glb_buffer.data = chunk_data;
+					glb_buffer.size = chunk[0];
+				}
+				offset += 8 + static_cast<size_t>(chunk[0]);
+			}
+			if (!json_begin) throw HF::Exceptions::InvalidOBJ();
+		}
+
+		const JsonValue root = JsonParser(json_begin, json_end).Parse();
+		if (root.type != JsonValue::Type::OBJECT) throw HF::Exceptions::InvalidOBJ();
+
+		// Find every buffer. External files are mapped, and only data URIs have to be copied
+		const auto& buffer_items = root.Items("buffers");
+		vector<GltfBytes> buffers(buffer_items.size());
+		vector<std::unique_ptr<MappedFile>> external_files;
+		vector<std::unique_ptr<string>> decoded_buffers;
+		const std::filesystem::path directory = std::filesystem::path(path).parent_path();
+		for (size_t i = 0; i < buffer_items.size(); i++) {
+			const string uri = buffer_items[i].Text("uri");
+			if (uri.empty()) {
+				if (i != 0 || !glb_buffer.data) throw HF::Exceptions::InvalidOBJ();
+				buffers[i] = glb_buffer;
+			}
+			else if (uri.compare(0, 5, "data:") == 0) {
+				const size_t data_start = uri.find(";base64,");
+				if (data_start == string::npos) throw HF::Exceptions::InvalidOBJ();
+				decoded_buffers.emplace_back(new string(DecodeBase64(uri.substr(data_start + 8))));
+				buffers[i] = { decoded_buffers.back()->data(), decoded_buffers.back()->size() };
+			}
+			else {
+				external_files.emplace_back(new MappedFile((directory / DecodeURI(uri)).string()));
+				buffers[i] = { external_files.back()->data(), external_files.back()->size() };
+			}
+
+			if (buffers[i].size < buffer_items[i].Number("byteLength", 0))
+				throw HF::Exceptions::InvalidOBJ();
+		}
+
+		const auto& view_items = root.Items("bufferViews");
+		vector<GltfBytes> views(view_items.size());
+		for (size_t i = 0; i < view_items.size(); i++) {
+			const GltfBytes& buffer = buffers[CheckIndex(buffers.size(), view_items[i].Number("buffer", -1))];
+			const size_t offset = CheckSize(view_items[i].Number("byteOffset", 0), buffer.size);
+			const size_t length = CheckSize(view_items[i].Number("byteLength", 0), buffer.size - offset);
+			views[i] = { buffer.data + offset, length };
+		}
+
+		// Find the triangles of every mesh. Points and lines are skipped
+		const auto& mesh_items = root.Items("meshes");
+		vector<vector<GltfPrimitive>> mesh_primitives(mesh_items.size());
+		for (size_t i = 0; i < mesh_items.size(); i++) {
+			for (const auto& primitive_item : mesh_items[i].Items("primitives")) {
+				GltfPrimitive primitive;
+				primitive.mode = static_cast<int>(primitive_item.Number("mode", GLTF_TRIANGLES));
+				if (primitive.mode != GLTF_TRIANGLES && primitive.mode != GLTF_TRIANGLE_STRIP && primitive.mode != GLTF_TRIANGLE_FAN)
+					continue;
+
+				const JsonValue* attributes = primitive_item.Find("attributes");
+				if (!attributes || !attributes->Find("POSITION")) throw HF::Exceptions::InvalidOBJ();
+				primitive.positions = GetAccessor(root, views, attributes->Number("POSITION", -1), true);
+
+				primitive.has_indices = primitive_item.Find("indices") != nullptr;
+				if (primitive.has_indices)
+					primitive.indices = GetAccessor(root, views, primitive_item.Number("indices", -1), false);
+
+				if (NumGltfTriangles(primitive) > 0)
+					mesh_primitives[i].push_back(primitive);
+			}
+		}
+
+		// Walk the scene to find the transformation of every node with a mesh
+		const auto& node_items = root.Items("nodes");
+		vector<double> roots;
+		const auto& scenes = root.Items("scenes");
+		if (!scenes.empty()) {
+			for (const auto& node : scenes[CheckIndex(scenes.size(), root.Number("scene", 0))].Items("nodes"))
+				roots.push_back(node.number);
+		}
+		else {
+			// Without a scene, every node that isn't a child of another is drawn
+			vector<bool> is_child(node_items.size(), false);
+			for (const auto& node : node_items)
+				for (const auto& child : node.Items("children"))
+					is_child[CheckIndex(node_items.size(), child.number)] = true;
+			for (size_t i = 0; i < node_items.size(); i++)
+				if (!is_child[i]) roots.push_back(static_cast<double>(i));
+		}
+
+		vector<GltfInstance> instances;
+		vector<bool> visited(node_items.size(), false);
+		vector<std::pair<double, Eigen::Matrix4d>> stack;
+		for (auto it = roots.rbegin(); it != roots.rend(); ++it)
+			stack.emplace_back(*it, Eigen::Matrix4d::Identity());
+
+		while (!stack.empty()) {
+			const auto [node_index, parent_transform] = stack.back();
+			stack.pop_back();
+
+			// Nodes form trees, so reaching one twice means the file is corrupt
+			const int index = static_cast<int>(CheckIndex(node_items.size(), node_index));
+			const JsonValue& node = node_items[index];
+			if (visited[index]) throw HF::Exceptions::InvalidOBJ();
+			visited[index] = true;
+
+			const Eigen::Matrix4d transform = parent_transform * GetNodeTransform(node);
+			if (node.Find("mesh")) {
+				const int mesh_index = static_cast<int>(CheckIndex(mesh_items.size(), node.Number("mesh", -1)));
+				const JsonValue& mesh = mesh_items[mesh_index];
+				if (!mesh_primitives[mesh_index].empty()) {
+					const string name = node.Text("name");
+					instances.push_back({ index, mesh_index, name.empty() ? mesh.Text("name") : name, transform });
+				}
+			}
+
+			const auto& children = node.Items("children");
+			for (auto it = children.rbegin(); it != children.rend(); ++it)
+				stack.emplace_back(it->number, transform);
+		}
+		if (instances.empty()) throw HF::Exceptions::InvalidOBJ();
+
+		// Copy every instance into its own mesh in parallel
+		const int num_instances = static_cast<int>(instances.size());
+		vector<MeshInfo<float>> meshes(num_instances);
+		bool valid = true;
+#pragma omp parallel for schedule(dynamic) reduction(&&:valid)
+		for (int i = 0; i < num_instances; i++)
+			valid = CreateInstanceMesh(instances[i], mesh_primitives[instances[i].mesh], scale, meshes[i]) && valid;
+
+		if (!valid) throw HF::Exceptions::InvalidOBJ();
+
+		if (change_coords)
+			for (auto& mesh : meshes)
+				mesh.ConvertToRhinoCoordinates();
+
+		return meshes;
+	}
+}
@@ -0,0 +1,171 @@
+///
+///	\file		mesh_cache.cpp
+/// \brief		Contains implementation for saving and loading binary caches of <see cref="HF::Geometry::MeshInfo">MeshInfo</see>
+///
+///	\author		TBA
+///	\date		02 Jul 2020
+
+#include <objloader.h>
+#include <meshinfo.h>
+#include <HFExceptions.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+using std::string;
+using std::vector;
+
+namespace HF::Geometry {
+
+	constexpr char MESH_FILE_MAGIC[8] = { 'D', 'H', 'A', 'R', 'T', 'M', 'C', '\0' }; ///< First bytes of every mesh cache.
+	constexpr uint32_t MESH_FILE_VERSION = 1; ///< Version of the mesh cache format written by SaveMeshCache.
+
+	constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull; ///< Starting value of a 64-bit FNV-1a hash.
+	constexpr uint64_t FNV_PRIME = 1099511628211ull; ///< Multiplier of a 64-bit FNV-1a hash.
+
+	/*!
+		\brief The first section of every mesh cache.
+
+		\details
+		The header is followed by `num_meshes` meshes. Each is made of a MeshFileMesh, then
+		`name_length` characters of its name, then `num_vertices` x,y,z triplets of floats,
+		then `num_triangles` triplets of vertex indices.
+	*/
+	struct MeshFileHeader {
+		char magic[8];			///< Must match MESH_FILE_MAGIC.
+		uint32_t version;		///< Version of the format this file was written with.
+		uint32_t num_meshes;	///< Number of meshes in the file.
+		uint64_t key;			///< Key the meshes were saved with.
+	};
+
+	/*! \brief Describes a single mesh in a mesh cache. */
+	struct MeshFileMesh {
+		int32_t id;				///< ID of the mesh.
+		uint32_t name_length;	///< Number of characters in the mesh's name.
+		uint32_t num_vertices;	///< Number of vertices in the mesh.
+		uint32_t num_triangles;	///< Number of triangles in the mesh.
+	};
+
+	/*! \brief Add the bytes of `value` to the FNV-1a hash `hash`. */
+	template <typename T>
+	inline uint64_t HashValue(uint64_t hash, const T& value) {
+		const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+		for (size_t i = 0; i < sizeof(T); i++) {
+			hash ^= bytes[i];
+			hash *= FNV_PRIME;
+		}
+		return hash;
+	}
+
+	string MeshCachePath(const string& path) {
+		return path + ".meshcache";
+	}
+
+	uint64_t MeshCacheKey(const string& path, GROUP_METHOD gm, bool change_coords, int scale) {
+		std::error_code error;
+		const uint64_t file_size = static_cast<uint64_t>(std::filesystem::file_size(path, error));
+		if (error)
+			throw HF::Exceptions::FileNotFound();
+
+		const int64_t write_time = static_cast<int64_t>(
+			std::filesystem::last_write_time(path, error).time_since_epoch().count()
+		);
+
+		uint64_t hash = FNV_OFFSET_BASIS;
+		hash = HashValue(hash, MESH_FILE_VERSION);
+		hash = HashValue(hash, file_size);
+		hash = HashValue(hash, write_time);
+		hash = HashValue(hash, static_cast<int32_t>(gm));
+		hash = HashValue(hash, static_cast<int32_t>(change_coords));
+		hash = HashValue(hash, static_cast<int32_t>(scale));
+		return hash;
+	}
+
+	bool SaveMeshCache(const vector<MeshInfo<float>>& meshes, const string& path, uint64_t key) {
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		if (!out.good()) return false;
+
+		MeshFileHeader header;
+		std::memcpy(header.magic, MESH_FILE_MAGIC, sizeof(header.magic));
+		header.version = MESH_FILE_VERSION;
+		header.num_meshes = static_cast<uint32_t>(meshes.size());
+		header.key = key;
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		for (const auto& mesh : meshes) {
+			const MeshFileMesh mesh_header{
+				mesh.meshid,
+				static_cast<uint32_t>(mesh.name.size()),
+				static_cast<uint32_t>(mesh.NumVerts()),
+				static_cast<uint32_t>(mesh.NumTris())
+			};
+			out.write(reinterpret_cast<const char*>(&mesh_header), sizeof(mesh_header));
+			out.write(mesh.name.data(), mesh.name.size());
+
+			// Write straight from the mesh's buffers
+			const auto vertices = mesh.GetVertexPointer();
+			const auto indices = mesh.GetIndexPointer();
+			out.write(reinterpret_cast<const char*>(vertices.data), sizeof(float) * static_cast<size_t>(vertices.size));
+			out.write(reinterpret_cast<const char*>(indices.data), sizeof(int) * static_cast<size_t>(indices.size));
+		}
+
+		return out.good();
+	}
+
+	vector<MeshInfo<float>> LoadMeshCache(const string& path, uint64_t key) {
+		std::ifstream in(path, std::ios::binary | std::ios::ate);
+		if (!in.good())
+			throw HF::Exceptions::FileNotFound();
+
+		const uint64_t file_size = static_cast<uint64_t>(in.tellg());
+		in.seekg(0);
+
+		MeshFileHeader header;
+		if (file_size < sizeof(header) || !in.read(reinterpret_cast<char*>(&header), sizeof(header)))
+			throw std::runtime_error("Mesh cache is truncated");
+		if (std::memcmp(header.magic, MESH_FILE_MAGIC, sizeof(header.magic)) != 0)
+			throw std::runtime_error("File is not a mesh cache");
+		if (header.version != MESH_FILE_VERSION)
+			throw std::runtime_error("Mesh cache was written with an unsupported version of the format");
+		if (key != 0 && header.key != key)
+			throw std::runtime_error("Mesh cache was saved from a different file");
+
+		vector<MeshInfo<float>> meshes;
+		uint64_t offset = sizeof(header);
+		for (uint32_t i = 0; i < header.num_meshes; i++) {
+			MeshFileMesh mesh;
+			if (!in.read(reinterpret_cast<char*>(&mesh), sizeof(mesh)))
+				throw std::runtime_error("Mesh cache is truncated");
+
+			// Check sizes before allocating anything so a corrupt count can't trigger a huge allocation
+			const uint64_t vertex_bytes = sizeof(float) * 3 * uint64_t(mesh.num_vertices);
+			const uint64_t triangle_bytes = sizeof(int) * 3 * uint64_t(mesh.num_triangles);
+			offset += sizeof(mesh) + mesh.name_length + vertex_bytes + triangle_bytes;
+			if (offset > file_size)
+				throw std::runtime_error("Mesh cache is truncated");
+
+			string name(mesh.name_length, '\0');
+			in.read(&name[0], mesh.name_length);
+
+			// Read straight into the buffers of the new mesh
+			MeshBuffers<float> buffers;
+			buffers.vertices.resize(3, static_cast<Eigen::Index>(mesh.num_vertices) + 1);
+			buffers.indices.resize(3, mesh.num_triangles);
+			in.read(reinterpret_cast<char*>(buffers.vertices.data()), vertex_bytes);
+			in.read(reinterpret_cast<char*>(buffers.indices.data()), triangle_bytes);
+
+			const bool has_triangles = buffers.indices.size() > 0;
+			if (has_triangles && (buffers.indices.minCoeff() < 0 || buffers.indices.maxCoeff() >= static_cast<int64_t>(mesh.num_vertices)))
+				throw std::runtime_error("Mesh cache contains a triangle with a vertex that doesn't exist");
+
+			meshes.emplace_back(std::move(buffers), mesh.id, name);
+		}
+
+		if (!in)
+			throw std::runtime_error("Mesh cache is truncated");
+
+		return meshes;
+	}
+}
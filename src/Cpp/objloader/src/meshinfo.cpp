@@ -37,6 +37,13 @@ namespace HF::Geometry {
 		this->name = name;
 	}
 
+	template <typename T>
+	void MeshInfo<T>::ResizeVerts(int num_verts)
+	{
+		verts.resize(3, static_cast<Eigen::Index>(num_verts) + 1);
+		verts.col(num_verts).setZero();
+	}
+
 	template <typename T>
 	inline void MeshInfo<T>::SetVert(int index, T x, T y, T z)
 	{
@@ -131,7 +138,7 @@ namespace HF::Geometry {
 			throw HF::Exceptions::InvalidOBJ();
 
 		// Copy contents into index and vertex vectors into matrices.
-		verts.resize(3, mapped_vertices.size() / 3);
+		ResizeVerts(static_cast<int>(mapped_vertices.size() / 3));
 		indices.resize(3, mapped_indexes.size() / 3);
 		std::move(mapped_vertices.begin(), mapped_vertices.end(), verts.data());
 		std::move(mapped_indexes.begin(), mapped_indexes.end(), indices.data());
@@ -150,7 +157,7 @@ namespace HF::Geometry {
 			throw HF::Exceptions::InvalidOBJ();
 
 		// Resize verts and indices, then std::move valuees into them.
-		verts.resize(3, in_vertices.size() / 3);
+		ResizeVerts(static_cast<int>(in_vertices.size() / 3));
 		indices.resize(3, in_indexes.size() / 3);
 		std::move(in_vertices.begin(), in_vertices.end(), verts.data());
 		std::move(in_indexes.begin(), in_indexes.end(), indices.data());
@@ -159,12 +166,26 @@ namespace HF::Geometry {
 		this->name = name;
 	}
 
+	template <typename T>
+	MeshInfo<T>::MeshInfo(MeshBuffers<T>&& buffers, int id, std::string name)
+	{
+		if (buffers.vertices.cols() < 1)
+			throw HF::Exceptions::InvalidOBJ();
+
+		verts = std::move(buffers.vertices);
+		indices = std::move(buffers.indices);
+		verts.col(verts.cols() - 1).setZero();
+
+		meshid = id;
+		this->name = name;
+	}
+
 	template <typename T>
 	void MeshInfo<T>::AddVerts(const vector<array<T, 3>>& in_vertices)
 	{
 		if (in_vertices.size() % 3 != 0) throw HF::Exceptions::InvalidOBJ(); // Incomplete triangle
 
-		verts.resize(3, (static_cast<size_t>(verts.cols()) + in_vertices.size()));
+		ResizeVerts(NumVerts() + static_cast<int>(in_vertices.size()));
 
 		for (int i = 0; i < in_vertices.size(); i++) {
 			auto& vertex = in_vertices[i];
@@ -176,7 +197,7 @@ namespace HF::Geometry {
 	}
 
 	template <typename T>
-	int MeshInfo<T>::NumVerts() const { return static_cast<int>(verts.cols()); }
+	int MeshInfo<T>::NumVerts() const { return static_cast<int>(verts.cols()) - 1; }
 
 	template <typename T>
 	int MeshInfo<T>::NumTris() const { return static_cast<int>(indices.cols()); }
@@ -244,11 +265,12 @@ namespace HF::Geometry {
 	template <typename T>
 	vector<T> MeshInfo<T>::GetIndexedVertices() const
 	{
-		// Preallocate space for all vertices
-		vector<T> out_array(verts.size());
+		// Preallocate space for all vertices, leaving out the padding
+		const size_t num_values = 3 * static_cast<size_t>(NumVerts());
+		vector<T> out_array(num_values);
 		
 		// Copy verts into it
-		std::copy(verts.data(), verts.data() + verts.size(), out_array.begin());
+		std::copy(verts.data(), verts.data() + num_values, out_array.begin());
 		
 		return out_array;
 	}
@@ -337,11 +359,22 @@ namespace HF::Geometry {
 	const array_and_size<T> MeshInfo<T>::GetVertexPointer() const {
 		array_and_size<T> ret_array;
 
-		ret_array.size = verts.size();
+		ret_array.size = 3 * NumVerts();
 		ret_array.data = const_cast<T*>(verts.data());
 
 		return ret_array;
 	}
+
+	template <typename T>
+	MeshBuffers<T> MeshInfo<T>::ReleaseBuffers() {
+		MeshBuffers<T> buffers{ std::move(verts), std::move(indices) };
+
+		// Leave this mesh empty, but still padded
+		ResizeVerts(0);
+		indices.resize(3, 0);
+
+		return buffers;
+	}
 }
 template class HF::Geometry::MeshInfo<double>;
 
@@ -105,6 +105,29 @@ namespace HF::Geometry {
 		}
 	};
 
+	/*!
+		\brief Vertex and index buffers released from a MeshInfo.
+
+		\details
+		Vertices are stored as consecutive x, y, z triplets followed by one extra vertex of zeros,
+		so the last vertex can be read with a single 16 byte load. Indices are stored as consecutive
+		triplets, one for every triangle. This is the layout Embree requires of buffers that it shares
+		with the application, so these can be handed to Embree without being copied.
+
+		\see MeshInfo::ReleaseBuffers
+	*/
+	template <typename numeric_type>
+	struct MeshBuffers {
+		Eigen::Matrix3X<numeric_type> vertices;	///< 3 by X matrix of vertices, including the padding vertex.
+		Eigen::Matrix3X<int> indices;			///< 3 by X matrix of indices for triangles.
+
+		/*! \brief Get the number of vertices in these buffers, not counting padding. */
+		inline int NumVerts() const { return static_cast<int>(vertices.cols()) - 1; }
+
+		/*! \brief Get the number of triangles in these buffers. */
+		inline int NumTris() const { return static_cast<int>(indices.cols()); }
+	};
+
 	/*!
 		\brief A collection of vertices and indices representing geometry.
 		
@@ -114,6 +137,9 @@ namespace HF::Geometry {
 		as RotateMesh. More details on Eigen are available here:
 		https://eigen.tuxfamily.org/dox/group__Geometry__Module.html
 
+		The vertex matrix always has one extra column of zeros after the last vertex. This padding
+		lets ReleaseBuffers hand the mesh's storage to Embree as is.
+
 		\invariant
 			Will always hold a valid mesh with finite members.
 
@@ -128,9 +154,12 @@ namespace HF::Geometry {
 	private:
 
 		using VertMatrix = Eigen::Matrix3X<numeric_type>;
-		VertMatrix verts;	///< 3 by X matrix of vertices
+		VertMatrix verts;	///< 3 by X matrix of vertices, followed by one column of padding.
 		Eigen::Matrix3X<int> indices;	///< 3 by X matrix of indices for triangles.
 
+		/*! \brief Resize verts to hold `num_verts` vertices plus padding, and zero the padding. */
+		void ResizeVerts(int num_verts);
+
 
 		/// <summary> Change the position of the vertex at index. </summary>
 		/// <param name="index"> Index of the vertex to change, </param>
@@ -174,7 +203,7 @@ namespace HF::Geometry {
 				HF::Geometry::MeshInfo mesh;	// meshid == 0; verts is given 3 rows, 0 cols; name == "INVALID"
 			\endcode
 		*/
-		MeshInfo() { meshid = 0; verts.resize(3, 0); name = "INVALID"; };
+		MeshInfo() { meshid = 0; ResizeVerts(0); name = "INVALID"; };
 
 		/// <summary>
 		/// Construct a new MeshInfo object from an unindexed vector of vertices, an ID, and a name.
@@ -269,6 +298,20 @@ namespace HF::Geometry {
 			std::string name = ""
 		);
 
+		/*!
+			\brief Construct a mesh that takes ownership of `buffers` without copying them.
+
+			\param buffers Vertices and indices of the mesh. The last column of `buffers.vertices`
+			is padding, and is overwritten with zeros.
+			\param id The ID of this mesh.
+			\param name The name of this mesh.
+
+			\exception HF::Exceptions::InvalidOBJ `buffers.vertices` doesn't have a column for padding.
+
+			\remarks Used by loaders that parse geometry straight into a mesh's final buffers.
+		*/
+		MeshInfo(MeshBuffers<numeric_type>&& buffers, int id, std::string name = "");
+
 		/*!
 			\brief Add more vertices to this mesh. 
 			
@@ -821,6 +864,17 @@ namespace HF::Geometry {
 			\returns A pointer to the index array of this mesh, and the number of elements it contains
 		*/
 		const array_and_size<int> GetIndexPointer() const;
+
+		/*!
+			\brief Move this mesh's vertex and index buffers out of it without copying them.
+
+			\returns This mesh's vertices and indices, padded for Embree.
+
+			\post This mesh has no vertices or triangles, but keeps its ID and name.
+
+			\see EmbreeRayTracer::AddMesh(MeshInfo<float>&&, bool) for adding a mesh to a raytracer this way.
+		*/
+		MeshBuffers<numeric_type> ReleaseBuffers();
 	};
 
 	template <typename T> MeshInfo()->MeshInfo<float>;
@@ -0,0 +1,481 @@
+///
+///	\file		obj_parser.cpp
+/// \brief		Contains implementation for loading OBJ files in parallel with <see cref="HF::Geometry::LoadMeshObjectsParallel">LoadMeshObjectsParallel</see>
+///
+///	\author		TBA
+///	\date		02 Jul 2020
+
+#include <objloader.h>
+#include <meshinfo.h>
+#include <mapped_file.h>
+#include <HFExceptions.h>
+#include <robin_hood.h>
+
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+using std::string;
+using std::vector;
+
+namespace HF::Geometry {
+
+	constexpr size_t MIN_CHUNK_BYTES = 1 << 20;	///< Smallest chunk of a file worth giving its own thread.
+	constexpr int CHUNKS_PER_THREAD = 4;		///< Chunks created per thread, so threads that finish early can pick up more work.
+
+	/*! \brief A `g`, `o` or `usemtl` line in an OBJ. */
+	struct ObjMarker {
+		size_t triangle;	///< Number of triangles in the chunk before this line.
+		bool material;		///< True for `usemtl` lines, false for `g` and `o` lines.
+		string name;		///< Name given on the line.
+	};
+
+	/*! \brief Everything parsed from one chunk of an OBJ. */
+	struct ObjChunk {
+		vector<float> vertices;		///< x, y, z of every vertex in the chunk.
+		vector<int> indices;		///< Indices of every triangle in the chunk.
+		vector<size_t> relative;	///< Positions in `indices` that are relative to the chunk's first vertex.
+		vector<ObjMarker> markers;	///< Groups and materials started in this chunk.
+		bool valid = true;			///< False if a line in the chunk couldn't be parsed.
+	};
+
+	/*! \brief A vertex of a face, as an index into every vertex in the file or in its chunk. */
+	struct FaceVertex {
+		int index;		///< Index of the vertex.
+		bool relative;	///< If true, `index` is relative to the first vertex of the chunk.
+	};
+
+	/*! \brief Powers of ten that can be represented exactly by a double. */
+	constexpr double EXACT_POWERS_OF_TEN[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	inline bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+	inline bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+	/*! \brief Advance `c` past any spaces or tabs. */
+	inline void SkipSpaces(const char*& c, const char* end) {
+		while (c < end && IsSpace(*c)) c++;
+	}
+
+	/*!
+		\brief Parse a decimal number starting at `c`.
+
+		\param c Start of the number. Advanced past the number if one was parsed.
+		\param end End of the line.
+		\param out Output for the parsed number.
+
+		\returns True if a number was parsed, false if `c` doesn't start with a number.
+
+		\details
+		Up to 19 significant digits are gathered into an integer, which is then scaled by a power
+		of ten. When the power can be represented exactly this is as accurate as strtod, and much
+		faster since it skips locale handling. Other exponents lose at most a few bits of the
+		double, which are lost anyway when the result is converted to a float.
+	*/
+	inline bool ParseNumber(const char*& c, const char* end, double& out) {
+		const char* p = c;
+		bool negative = false;
+		if (p < end && (*p == '-' || *p == '+')) {
+			negative = *p == '-';
+			p++;
+		}
+
+		uint64_t mantissa = 0;
+		int exponent = 0;
+		int significant_digits = 0;
+		bool has_digits = false;
+
+		for (; p < end && IsDigit(*p); p++) {
+			has_digits = true;
+			if (significant_digits < 19) {
+				mantissa = mantissa * 10 + (*p - '0');
+				if (mantissa != 0) significant_digits++;
+			}
+			else exponent++;
+		}
+		if (p < end && *p == '.') {
+			for (p++; p < end && IsDigit(*p); p++) {
+				has_digits = true;
+				if (significant_digits < 19) {
+					mantissa = mantissa * 10 + (*p - '0');
+					if (mantissa != 0) significant_digits++;
+					exponent--;
+				}
+			}
+		}
+		if (!has_digits) return false;
+
+		// Only consume the exponent if it has digits, otherwise the 'e' isn't part of this number
+		if (p < end && (*p == 'e' || *p == 'E')) {
+			const char* e = p + 1;
+			bool negative_exponent = false;
+			if (e < end && (*e == '-' || *e == '+')) {
+				negative_exponent = *e == '-';
+				e++;
+			}
+			if (e < end && IsDigit(*e)) {
+				int written_exponent = 0;
+				for (; e < end && IsDigit(*e); e++)
+					if (written_exponent < 100000)
+						written_exponent = written_exponent * 10 + (*e - '0');
+				exponent += negative_exponent ? -written_exponent : written_exponent;
+				p = e;
+			}
+		}
+
+		double value = static_cast<double>(mantissa);
+		if (mantissa != 0) {
+			if (exponent >= 0 && exponent <= 22)
+				value *= EXACT_POWERS_OF_TEN[exponent];
+			else if (exponent < 0 && exponent >= -22)
+				value /= EXACT_POWERS_OF_TEN[-exponent];
+			else
+				value *= std::pow(10.0, exponent);
+		}
+
+		out = negative ? -value : value;
+		c = p;
+		return true;
+	}
+
+	/*! \brief Parse an integer starting at `c`, advancing `c` past it. Returns false if there isn't one. */
+	inline bool ParseInt(const char*& c, const char* end, int& out) {
+		const char* p = c;
+		bool negative = false;
+		if (p < end && (*p == '-' || *p == '+')) {
+			negative = *p == '-';
+			p++;
+		}
+		if (p >= end || !IsDigit(*p)) return false;
+
+		int64_t value = 0;
+		for (; p < end && IsDigit(*p); p++)
+			if (value <= INT32_MAX)
+				value = value * 10 + (*p - '0');
+
+		if (value > INT32_MAX) return false;
+		out = static_cast<int>(negative ? -value : value);
+		c = p;
+		return true;
+	}
+
+	/*! \brief Check if the line at `c` starts with `keyword` followed by whitespace or the end of the line. */
+	inline bool StartsWith(const char* c, const char* end, const char* keyword, size_t length) {
+		return static_cast<size_t>(end - c) >= length
+			&& std::memcmp(c, keyword, length) == 0
+			&& (c + length == end || IsSpace(c[length]));
+	}
+
+	/*! \brief Get the rest of the line after `c` without surrounding whitespace. */
+	inline string ParseName(const char* c, const char* end) {
+		SkipSpaces(c, end);
+		while (end > c && IsSpace(end[-1])) end--;
+		return string(c, end);
+	}
+
+	/*! \brief Parse a `v` line, starting after the `v`. */
+	inline bool ParseVertex(const char* c, const char* end, double scale, ObjChunk& chunk) {
+		for (int axis = 0; axis < 3; axis++) {
+			double value;
+			SkipSpaces(c, end);
+			if (!ParseNumber(c, end, value)) return false;
+			chunk.vertices.push_back(static_cast<float>(value * scale));
+		}
+		return true;
+	}
+
+	/*! \brief Parse an `f` line, starting after the `f`, and split it into a fan of triangles. */
+	inline bool ParseFace(const char* c, const char* end, ObjChunk& chunk) {
+		const int chunk_vertices = static_cast<int>(chunk.vertices.size() / 3);
+
+		FaceVertex first{ 0, false }, previous{ 0, false };
+		int num_face_vertices = 0;
+
+		while (true) {
+			SkipSpaces(c, end);
+			if (c >= end) break;
+
+			int index;
+			if (!ParseInt(c, end, index) || index == 0) return false;
+
+			// Skip texture coordinate and normal indices
+			while (c < end && !IsSpace(*c)) c++;
+
+			// Positive indices count from the first vertex in the file, and negative
+			// ones count back from the last vertex before this line
+			const FaceVertex vertex = index > 0
+				? FaceVertex{ index - 1, false }
+				: FaceVertex{ chunk_vertices + index, true };
+
+			if (num_face_vertices >= 2) {
+				for (const FaceVertex& v : { first, previous, vertex }) {
+					if (v.relative) chunk.relative.push_back(chunk.indices.size());
+					chunk.indices.push_back(v.index);
+				}
+			}
+
+			if (num_face_vertices == 0) first = vertex;
+			previous = vertex;
+			num_face_vertices++;
+		}
+		return true;
+	}
+
+	/*! \brief Parse every line between `begin` and `end` into `chunk`. */
+	void ParseChunk(const char* begin, const char* end, double scale, ObjChunk& chunk) {
+		// Vertex and face lines are usually 25 to 40 bytes, and each adds three values
+		chunk.vertices.reserve((end - begin) / 40);
+		chunk.indices.reserve((end - begin) / 40);
+
+		const char* line = begin;
+		while (line < end && chunk.valid) {
+			const char* line_end = static_cast<const char*>(std::memchr(line, '\n', end - line));
+			if (!line_end) line_end = end;
+
+			const char* c = line;
+			SkipSpaces(c, line_end);
+
+			if (StartsWith(c, line_end, "v", 1))
+				chunk.valid = ParseVertex(c + 1, line_end, scale, chunk);
+			else if (StartsWith(c, line_end, "f", 1))
+				chunk.valid = ParseFace(c + 1, line_end, chunk);
+			else if (StartsWith(c, line_end, "g", 1) || StartsWith(c, line_end, "o", 1))
+				chunk.markers.push_back(ObjMarker{ chunk.indices.size() / 3, false, ParseName(c + 1, line_end) });
+			else if (StartsWith(c, line_end, "usemtl", 6))
+				chunk.markers.push_back(ObjMarker{ chunk.indices.size() / 3, true, ParseName(c + 6, line_end) });
+
+			line = line_end + 1;
+		}
+	}
+
+	/*! \brief Split `file` into chunks of whole lines, returning the offset every chunk starts at, followed by the size of the file. */
+	vector<size_t> SplitIntoChunks(const MappedFile& file) {
+		const size_t size = file.size();
+		const size_t max_chunks = static_cast<size_t>(omp_get_max_threads()) * CHUNKS_PER_THREAD;
+		const size_t num_chunks = std::max<size_t>(1, std::min(max_chunks, size / MIN_CHUNK_BYTES));
+
+		vector<size_t> offsets{ 0 };
+		for (size_t i = 1; i < num_chunks; i++) {
+			// Move every split forward to the start of the next line
+			size_t offset = std::max(offsets.back(), size * i / num_chunks);
+			const void* newline = std::memchr(file.data() + offset, '\n', size - offset);
+			if (!newline) break;
+
+			offset = static_cast<const char*>(newline) - file.data() + 1;
+			if (offset > offsets.back() && offset < size)
+				offsets.push_back(offset);
+		}
+		offsets.push_back(size);
+		return offsets;
+	}
+
+	/*! \brief A range of triangles in the file that belong to the same mesh. */
+	struct TriangleRange {
+		size_t first;	///< First triangle in the range.
+		size_t last;	///< One past the last triangle in the range.
+	};
+
+	/*!
+		\brief Create a mesh from the triangles in `ranges`, containing only the vertices they use.
+
+		\param vertices Every vertex in the file.
+		\param indices Every triangle in the file.
+		\param ranges Triangles that belong to this mesh.
+		\param id ID of the mesh.
+		\param name Name of the mesh.
+	*/
+	MeshInfo<float> CreateSubmesh(
+		const vector<float>& vertices,
+		const vector<int>& indices,
+		const vector<TriangleRange>& ranges,
+		int id,
+		const string& name
+	) {
+		size_t num_triangles = 0;
+		for (const auto& range : ranges)
+			num_triangles += range.last - range.first;
+
+		// Give every vertex a new index in the order it's first used
+		MeshBuffers<float> buffers;
+		buffers.indices.resize(3, num_triangles);
+		robin_hood::unordered_map<int, int> new_index;
+		vector<int> used_vertices;
+
+		int* out_index = buffers.indices.data();
+		for (const auto& range : ranges) {
+			for (size_t i = 3 * range.first; i < 3 * range.last; i++) {
+				const auto inserted = new_index.emplace(indices[i], static_cast<int>(used_vertices.size()));
+				if (inserted.second) used_vertices.push_back(indices[i]);
+				*out_index++ = inserted.first->second;
+			}
+		}
+
+		buffers.vertices.resize(3, used_vertices.size() + 1);
+		for (size_t i = 0; i < used_vertices.size(); i++) {
+			const float* vertex = vertices.data() + 3 * static_cast<size_t>(used_vertices[i]);
+			buffers.vertices.col(i) << vertex[0], vertex[1], vertex[2];
+		}
+
+		return MeshInfo<float>(std::move(buffers), id, name);
+	}
+
+	vector<MeshInfo<float>> LoadMeshObjectsParallel(
+		const string& path,
+		GROUP_METHOD gm,
+		bool change_coords,
+		int scale,
+		bool use_cache
+	) {
+		if (gm != ONLY_FILE && gm != BY_GROUP && gm != BY_MATERIAL)
+			throw std::out_of_range("Mesh group mode " + std::to_string(gm) + " doesn't exist!");
+
+		// Use the cache if it's up to date
+		uint64_t cache_key = 0;
+		if (use_cache) {
+			cache_key = MeshCacheKey(path, gm, change_coords, scale);
+			try {
+				return LoadMeshCache(MeshCachePath(path), cache_key);
+			}
+			catch (const HF::Exceptions::FileNotFound&) {}
+			catch (const std::runtime_error&) {}
+		}
+
+		const MappedFile file(path);
+
+		// Parse every chunk of the file in parallel
+		const vector<size_t> offsets = SplitIntoChunks(file);
+		const int num_chunks = static_cast<int>(offsets.size()) - 1;
+		vector<ObjChunk> chunks(num_chunks);
+
+#pragma omp parallel for schedule(dynamic)
+		for (int i = 0; i < num_chunks; i++)
+			ParseChunk(file.data() + offsets[i], file.data() + offsets[i + 1], scale, chunks[i]);
+
+		for (const auto& chunk : chunks)
+			if (!chunk.valid) throw HF::Exceptions::InvalidOBJ();
+
+		// Find where every chunk's vertices and triangles start in the whole file
+		vector<size_t> vertex_offsets(num_chunks + 1, 0);
+		vector<size_t> triangle_offsets(num_chunks + 1, 0);
+		for (int i = 0; i < num_chunks; i++) {
+			vertex_offsets[i + 1] = vertex_offsets[i] + chunks[i].vertices.size() / 3;
+			triangle_offsets[i + 1] = triangle_offsets[i] + chunks[i].indices.size() / 3;
+		}
+		const size_t num_vertices = vertex_offsets.back();
+		const size_t num_triangles = triangle_offsets.back();
+		if (num_triangles == 0 || num_vertices > INT32_MAX)
+			throw HF::Exceptions::InvalidOBJ();
+
+		// Make relative indices absolute and check that every index refers to a vertex
+		bool indices_valid = true;
+#pragma omp parallel for schedule(dynamic) reduction(&&:indices_valid)
+		for (int i = 0; i < num_chunks; i++) {
+			auto& chunk = chunks[i];
+			for (size_t position : chunk.relative)
+				chunk.indices[position] += static_cast<int>(vertex_offsets[i]);
+			for (int index : chunk.indices)
+				indices_valid = indices_valid && index >= 0 && static_cast<size_t>(index) < num_vertices;
+		}
+		if (!indices_valid)
+			throw HF::Exceptions::InvalidOBJ();
+
+		vector<MeshInfo<float>> meshes;
+
+		// Find which mesh every range of triangles belongs to
+		bool has_materials = false;
+		for (const auto& chunk : chunks)
+			for (const auto& marker : chunk.markers)
+				has_materials = has_materials || marker.material;
+
+		// Like LoadMeshObjects, fall back to grouping by group if there are no materials
+		if (gm == BY_MATERIAL && !has_materials)
+			gm = BY_GROUP;
+
+		if (gm == ONLY_FILE) {
+			// Gather every chunk straight into the buffers of a single mesh
+			MeshBuffers<float> buffers;
+			buffers.vertices.resize(3, num_vertices + 1);
+			buffers.indices.resize(3, num_triangles);
+
+#pragma omp parallel for schedule(dynamic)
+			for (int i = 0; i < num_chunks; i++) {
+				auto& chunk = chunks[i];
+				std::copy(chunk.vertices.begin(), chunk.vertices.end(), buffers.vertices.data() + 3 * vertex_offsets[i]);
+				std::copy(chunk.indices.begin(), chunk.indices.end(), buffers.indices.data() + 3 * triangle_offsets[i]);
+				chunk = ObjChunk();
+			}
+
+			meshes.emplace_back(std::move(buffers), 0, "EntireFile");
+		}
+		else {
+			// Every group starts a new mesh, but materials with the same name share one
+			vector<string> names{ "" };
+			vector<vector<TriangleRange>> ranges(1);
+			robin_hood::unordered_map<string, int> material_ids{ { "", 0 } };
+			int current = 0;
+			size_t range_start = 0;
+
+			for (int i = 0; i < num_chunks; i++) {
+				for (const auto& marker : chunks[i].markers) {
+					if (marker.material != (gm == BY_MATERIAL)) continue;
+
+					const size_t triangle = triangle_offsets[i] + marker.triangle;
+					if (triangle > range_start)
+						ranges[current].push_back(TriangleRange{ range_start, triangle });
+					range_start = triangle;
+
+					if (gm == BY_MATERIAL) {
+						const auto inserted = material_ids.emplace(marker.name, static_cast<int>(names.size()));
+						current = inserted.first->second;
+						if (!inserted.second) continue;
+					}
+					else current = static_cast<int>(names.size());
+
+					names.push_back(marker.name);
+					ranges.emplace_back();
+				}
+			}
+			ranges[current].push_back(TriangleRange{ range_start, num_triangles });
+
+			// Gather every chunk into single arrays of vertices and triangles
+			vector<float> vertices(3 * num_vertices);
+			vector<int> indices(3 * num_triangles);
+
+#pragma omp parallel for schedule(dynamic)
+			for (int i = 0; i < num_chunks; i++) {
+				auto& chunk = chunks[i];
+				std::copy(chunk.vertices.begin(), chunk.vertices.end(), vertices.begin() + 3 * vertex_offsets[i]);
+				std::copy(chunk.indices.begin(), chunk.indices.end(), indices.begin() + 3 * triangle_offsets[i]);
+				chunk = ObjChunk();
+			}
+
+			// Drop groups that didn't end up with any faces, then build every mesh in parallel
+			vector<int> used_groups;
+			for (int i = 0; i < static_cast<int>(ranges.size()); i++)
+				if (!ranges[i].empty()) used_groups.push_back(i);
+
+			const string name_prefix = gm == BY_MATERIAL ? path + "/" : "";
+			const int num_meshes = static_cast<int>(used_groups.size());
+			meshes.resize(num_meshes);
+
+#pragma omp parallel for schedule(dynamic)
+			for (int i = 0; i < num_meshes; i++) {
+				const int group = used_groups[i];
+				meshes[i] = CreateSubmesh(vertices, indices, ranges[group], i, name_prefix + names[group]);
+			}
+		}
+
+		if (change_coords)
+			for (auto& mesh : meshes)
+				mesh.ConvertToRhinoCoordinates();
+
+		if (use_cache)
+			SaveMeshCache(meshes, MeshCachePath(path), cache_key);
+
+		return meshes;
+	}
+}
@@ -16,6 +16,8 @@
 #include <iostream>
 #include <vector>
 #include <filesystem>
+#include <algorithm>
+#include <cctype>
 
 using std::vector;
 using std::array;
@@ -428,4 +430,17 @@ namespace HF::Geometry {
 
 		return MI;
 	}
+
+	vector<MeshInfo<float>> LoadMeshFile(const std::string& path, GROUP_METHOD gm, bool change_coords, int scale)
+	{
+		std::string extension = std::filesystem::path(path).extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(),
+			[](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+		if (extension == ".obj") return LoadMeshObjectsParallel(path, gm, change_coords, scale);
+		else if (extension == ".ply") return LoadPLY(path, change_coords, scale);
+		else if (extension == ".stl") return LoadSTL(path, change_coords, scale);
+		else if (extension == ".gltf" || extension == ".glb") return LoadGLTF(path, change_coords, scale);
+		else throw HF::Exceptions::InvalidOBJ();
+	}
 }
\ No newline at end of file
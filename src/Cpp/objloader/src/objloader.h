@@ -11,6 +11,7 @@
 
 #include <vector>
 #include <string>
+#include <cstdint>
 #include "meshinfo.h"
 
 /*!
@@ -212,6 +213,201 @@ namespace HF::Geometry{
 		int scale = 1
 	);
 
+	/*!
+		\brief Create MeshInfo instances from the OBJ at `path` by parsing it on every thread.
+
+		\param path Path to the OBJ to load.
+		\param gm Method for dividing the mesh into subobjects.
+		\param change_coords Rotate the mesh from Y-up to Z-up.
+		\param scale Scaling factor to multiply every vertex by.
+		\param use_cache If true, load the meshes from the cache at MeshCachePath(path) if it was written
+		from the current version of the file with the same arguments. Otherwise parse the OBJ, then write
+		the cache so the next call can skip parsing.
+
+		\returns A vector of meshinfo from the file at `path`.
+
+		\exception HF::Exceptions::InvalidOBJ The file at `path` doesn't contain any triangles, or contains
+		a line that can't be parsed or a face that references a vertex that doesn't exist.
+		\exception HF::Exceptions::FileNotFound No file could be found at `path`.
+		\exception std::out_of_range gm did not match any valid GROUP_METHOD.
+
+		\details
+		The file is memory mapped and split into chunks of whole lines that are parsed in parallel,
+		straight into the buffers of the resulting meshes. Only `v`, `f`, `g`, `o` and `usemtl`
+		lines are read. Material libraries are never opened, and texture coordinates and normals
+		are skipped.
+
+		Meshes are grouped the same way as LoadMeshObjects, with a few differences:
+		- Polygons are split into fans of triangles, which is correct for convex faces.
+		- Meshes are given IDs in the order they first appear in the file, starting from 0.
+		- With BY_MATERIAL, materials are identified by the name given to `usemtl`. Faces that come
+		before the first `usemtl` are grouped into a material with an empty name.
+		- With BY_GROUP and BY_MATERIAL, each mesh only contains the vertices its faces use.
+
+		\remarks
+		This is meant for very large models, where LoadMeshObjects spends most of its time parsing
+		on a single thread and copying tinyobj's results.
+
+		\par Example
+		\snippet tests\src\OBJLoader.cpp EX_LoadMeshObjectsParallel
+	*/
+	std::vector<MeshInfo<float>> LoadMeshObjectsParallel(
+		const std::string& path,
+		GROUP_METHOD gm = ONLY_FILE,
+		bool change_coords = false,
+		int scale = 1,
+		bool use_cache = false
+	);
+
+	/*!
+		\brief Get the path LoadMeshObjectsParallel caches the meshes of the file at `path` to.
+
+		\returns `path` followed by `.meshcache`, so the cache sits next to the file it was created from.
+	*/
+	std::string MeshCachePath(const std::string& path);
+
+	/*!
+		\brief Create a key that identifies the current version of the file at `path` loaded with the given arguments.
+
+		\details
+		The key is a hash of the file's size and last write time along with every argument, so
+		it changes whenever the file is saved again or loaded differently.
+
+		\exception HF::Exceptions::FileNotFound No file could be found at `path`.
+	*/
+	uint64_t MeshCacheKey(const std::string& path, GROUP_METHOD gm, bool change_coords, int scale);
+
+	/*!
+		\brief Write the vertices, triangles, IDs and names of `meshes` to a binary file.
+
+		\param meshes Meshes to write.
+		\param path Path to write the cache to. Any existing file at this path will be overwritten.
+		\param key Value identifying what the meshes were loaded from, such as the result of MeshCacheKey.
+		LoadMeshCache can be given this key to reject files that were saved from something else.
+
+		\returns True if the file was written successfully, false if it couldn't be opened or written to.
+
+		\see LoadMeshCache to read the meshes back.
+	*/
+	bool SaveMeshCache(const std::vector<MeshInfo<float>>& meshes, const std::string& path, uint64_t key = 0);
+
+	/*!
+		\brief Read meshes from a file written by SaveMeshCache.
+
+		\param path Path to the cache.
+		\param key If not 0, only accept a file that was saved with this same key.
+
+		\returns Every mesh in the cache, with the IDs and names they were saved with.
+
+		\exception HF::Exceptions::FileNotFound No file exists at `path`.
+		\exception std::runtime_error The file isn't a mesh cache, was written with an unsupported
+		version of the format, is truncated or corrupt, or doesn't match `key`.
+
+		\details
+		Each mesh's vertices and indices are read straight into its buffers, so loading a cache
+		costs little more than reading it from disk.
+	*/
+	std::vector<MeshInfo<float>> LoadMeshCache(const std::string& path, uint64_t key = 0);
+
+	/*!
+		\brief Create a MeshInfo from the binary PLY at `path`.
+
+		\param path Path to the PLY to load.
+		\param change_coords Rotate the mesh from Y-up to Z-up.
+		\param scale Scaling factor to multiply every vertex by.
+
+		\returns A vector containing a single mesh named `EntireFile` with an ID of 0.
+
+		\exception HF::Exceptions::InvalidOBJ The file isn't a binary PLY, has no faces, or has a face
+		that references a vertex that doesn't exist.
+		\exception HF::Exceptions::FileNotFound No file could be found at `path`.
+
+		\details
+		Both binary byte orders are supported. The `x`, `y` and `z` properties of the `vertex` element
+		are read as floats no matter what type they're stored as, along with the `vertex_indices`
+		list of the `face` element. Polygons are split into fans of triangles, and every other
+		element is skipped. ASCII PLYs aren't supported.
+
+		\par Example
+		\snippet tests\src\OBJLoader.cpp EX_LoadPLY
+	*/
+	std::vector<MeshInfo<float>> LoadPLY(const std::string& path, bool change_coords = false, int scale = 1);
+
+	/*!
+		\brief Create a MeshInfo from the binary STL at `path`.
+
+		\param path Path to the STL to load.
+		\param change_coords Rotate the mesh from Y-up to Z-up.
+		\param scale Scaling factor to multiply every vertex by.
+
+		\returns A vector containing a single mesh named `EntireFile` with an ID of 0.
+
+		\exception HF::Exceptions::InvalidOBJ The file isn't a binary STL, or doesn't contain any triangles.
+		\exception HF::Exceptions::FileNotFound No file could be found at `path`.
+
+		\details
+		STLs store every corner of every triangle separately, so corners at exactly the same
+		position are merged into a single vertex. Normals and attributes are skipped. ASCII STLs
+		aren't supported.
+
+		\par Example
+		\snippet tests\src\OBJLoader.cpp EX_LoadSTL
+	*/
+	std::vector<MeshInfo<float>> LoadSTL(const std::string& path, bool change_coords = false, int scale = 1);
+
+	/*!
+		\brief Create a MeshInfo for every node with a mesh in the glTF 2.0 or GLB at `path`.
+
+		\param path Path to the `.gltf` or `.glb` to load.
+		\param change_coords Rotate the meshes from Y-up to Z-up. glTF is always Y-up, so this
+		should be true unless the file is known to have been exported otherwise.
+		\param scale Scaling factor to multiply every vertex by.
+
+		\returns A mesh for every node of the scene that has triangles, in the order they appear in
+		the scene. Each mesh's ID is the index of its node in the file, and its name is the name of
+		its node, or the name of the node's mesh if the node doesn't have one.
+
+		\exception HF::Exceptions::InvalidOBJ The file isn't a valid glTF, doesn't contain any
+		triangles, or uses a feature that isn't supported.
+		\exception HF::Exceptions::FileNotFound No file could be found at `path` or at the path of
+		one of its buffers.
+
+		\details
+		The nodes of the file's default scene are walked, and each node's mesh is transformed by the
+		node and its parents. Every triangle primitive of the mesh is combined into a single mesh, so
+		nodes that appear several times in a scene through instancing each get their own copy.
+		Since mesh IDs come from the file, nodes can be tagged as obstacles or walkable surfaces by
+		their index.
+
+		GLBs are memory mapped and read in place, as are buffers stored in external files. Buffers
+		in data URIs are decoded first. Positions must be floats and indices must be unsigned
+		integers. Sparse accessors and quantized positions aren't supported.
+
+		\par Example
+		\snippet tests\src\OBJLoader.cpp EX_LoadGLTF
+	*/
+	std::vector<MeshInfo<float>> LoadGLTF(const std::string& path, bool change_coords = false, int scale = 1);
+
+	/*!
+		\brief Load the meshes in the file at `path` with the loader for its extension.
+
+		\param path Path to an `.obj`, `.ply`, `.stl`, `.gltf` or `.glb` file. Extensions are case insensitive.
+		\param gm Method for dividing an OBJ into subobjects. Ignored for other formats.
+		\param change_coords Rotate the meshes from Y-up to Z-up.
+		\param scale Scaling factor to multiply every vertex by.
+
+		\returns The result of LoadMeshObjectsParallel, LoadPLY, LoadSTL or LoadGLTF.
+
+		\exception HF::Exceptions::InvalidOBJ The extension isn't supported, or the file couldn't be loaded.
+		\exception HF::Exceptions::FileNotFound No file could be found at `path`.
+	*/
+	std::vector<MeshInfo<float>> LoadMeshFile(
+		const std::string& path,
+		GROUP_METHOD gm = ONLY_FILE,
+		bool change_coords = false,
+		int scale = 1
+	);
+
 	/*!
 		\brief Load a list of vertices directly from an OBJ file.
 		
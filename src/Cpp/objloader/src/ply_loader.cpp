@@ -0,0 +1,415 @@
+///
+///	\file		ply_loader.cpp
+/// \brief		Contains implementation for loading binary PLY files with <see cref="HF::Geometry::LoadPLY">LoadPLY</see>
+///
+///	\author		TBA
+///	\date		02 Jul 2020
+
+#include <objloader.h>
+#include <meshinfo.h>
+#include <mapped_file.h>
+#include <HFExceptions.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+namespace HF::Geometry {
+
+	/*! \brief Types a property of a PLY element can have. */
+	enum class PlyType { INT8, UINT8, INT16, UINT16, INT32, UINT32, FLOAT32, FLOAT64 };
+
+	/*! \brief A property of an element declared in the header of a PLY. */
+	struct PlyProperty {
+		string name;				///< Name of the property.
+		PlyType type;				///< Type of the property, or of each item if this is a list.
+		bool is_list = false;		///< If true, this is a list of values prefixed by their count.
+		PlyType count_type;			///< Type of the list's count.
+	};
+
+	/*! \brief An element declared in the header of a PLY. */
+	struct PlyElement {
+		string name;					///< Name of the element.
+		size_t count = 0;				///< Number of items in the element.
+		vector<PlyProperty> properties;	///< Properties of every item, in the order they're stored.
+	};
+
+	/*! \brief Get the size of a value of `type` in bytes. */
+	inline size_t PlyTypeSize(PlyType type) {
+		switch (type) {
+		case PlyType::INT8: case PlyType::UINT8: return 1;
+		case PlyType::INT16: case PlyType::UINT16: return 2;
+		case PlyType::FLOAT64: return 8;
+		default: return 4;
+		}
+	}
+
+	/*! \brief Get the type named `name` in the header of a PLY. */
+	inline PlyType ParsePlyType(const string& name) {
+		if (name == "char" || name == "int8") return PlyType::INT8;
+		if (name == "uchar" || name == "uint8") return PlyType::UINT8;
+		if (name == "short" || name == "int16") return PlyType::INT16;
+		if (name == "ushort" || name == "uint16") return PlyType::UINT16;
+		if (name == "int" || name == "int32") return PlyType::INT32;
+		if (name == "uint" || name == "uint32") return PlyType::UINT32;
+		if (name == "float" || name == "float32") return PlyType::FLOAT32;
+		if (name == "double" || name == "float64") return PlyType::FLOAT64;
+		throw HF::Exceptions::InvalidOBJ();
+	}
+
+	/*! \brief Copy a `T` from `bytes`, reversing its byte order if `swap` is true. */
+	template <typename T>
+	inline T ReadSwapped(const char* bytes, bool swap) {
+		char copy[sizeof(T)];
+		std::memcpy(copy, bytes, sizeof(T));
+		if (swap)
+			for (size_t i = 0; i < sizeof(T) / 2; i++)
+				std::swap(copy[i], copy[sizeof(T) - 1 - i]);
+
+		T value;
+		std::memcpy(&value, copy, sizeof(T));
+		return value;
+	}
+
+	/*! \brief Read a value of `type` from `bytes` as a double. */
+	inline double ReadPlyValue(const char* bytes, PlyType type, bool swap) {
+		switch (type) {
+		case PlyType::INT8: return ReadSwapped<int8_t>(bytes, swap);
+		case PlyType::UINT8: return ReadSwapped<uint8_t>(bytes, swap);
+		case PlyType::INT16: return ReadSwapped<int16_t>(bytes, swap);
+		case PlyType::UINT16: return ReadSwapped<uint16_t>(bytes, swap);
+		case PlyType::INT32: return ReadSwapped<int32_t>(bytes, swap);
+		case PlyType::UINT32: return ReadSwapped<uint32_t>(bytes, swap);
+		case PlyType::FLOAT32: return ReadSwapped<float>(bytes, swap);
+		default: return ReadSwapped<double>(bytes, swap);
+		}
+	}
+
+	/*! \brief Determine if this machine stores values with their least significant byte first. */
+	inline bool IsLittleEndian() {
+		const uint16_t one = 1;
+		char first_byte;
+		std::memcpy(&first_byte, &one, 1);
+		return first_byte == 1;
+	}
+
+	/*!
+		\brief Find the size of the item starting at `item` in bytes.
+
+		\param item First byte of the item.
+		\param end End of the file.
+		\param element Element the item belongs to.
+		\param swap If true, lists' counts are stored in the opposite byte order of this machine.
+
+		\returns The size of the item, or 0 if it runs past `end`.
+	*/
+	inline size_t PlyItemSize(const char* item, const char* end, const PlyElement& element, bool swap) {
+		size_t size = 0;
+		for (const auto& property : element.properties) {
+			if (!property.is_list) {
+				size += PlyTypeSize(property.type);
+				continue;
+			}
+
+			const size_t count_size = PlyTypeSize(property.count_type);
+			if (item + size + count_size > end) return 0;
+			const double count = ReadPlyValue(item + size, property.count_type, swap);
+			if (count < 0) return 0;
+			size += count_size + static_cast<size_t>(count) * PlyTypeSize(property.type);
+		}
+		return item + size > end ? 0 : size;
+	}
+
+	/*!
+		\brief Check that `element` can fit in the bytes between `c` and `end` before anything is allocated for it.
+
+		\details
+		Every item is at least as large as its scalar properties and the counts of its lists, so
+		a header that declares more items than the file could hold is rejected here instead of
+		causing a huge allocation.
+
+		\exception HF::Exceptions::InvalidOBJ The element has more than INT32_MAX items, or more
+		items than could fit in the rest of the file.
+	*/
+	inline void CheckPlyCount(const char* c, const char* end, const PlyElement& element) {
+		if (element.count > static_cast<size_t>(INT32_MAX)) throw HF::Exceptions::InvalidOBJ();
+
+		size_t min_item_size = 0;
+		for (const auto& property : element.properties)
+			min_item_size += PlyTypeSize(property.is_list ? property.count_type : property.type);
+
+		if (min_item_size > 0 && element.count > static_cast<size_t>(end - c) / min_item_size)
+			throw HF::Exceptions::InvalidOBJ();
+	}
+
+	/*! \brief Read the header of a PLY up to `end_header`, leaving `c` at the first byte of data. */
+	vector<PlyElement> ParsePlyHeader(const char*& c, const char* end, bool& little_endian) {
+		auto next_line = [&]() {
+			const char* line_end = static_cast<const char*>(std::memchr(c, '\n', end - c));
+			if (!line_end) throw HF::Exceptions::InvalidOBJ();
+
+			string line(c, line_end);
+			if (!line.empty() && line.back() == '\r') line.pop_back();
+			c = line_end + 1;
+			return line;
+		};
+		auto split = [](const string& line) {
+			vector<string> words;
+			size_t start = 0;
+			while (start < line.size()) {
+				const size_t space = line.find(' ', start);
+				const size_t word_end = space == string::npos ? line.size() : space;
+				if (word_end > start) words.push_back(line.substr(start, word_end - start));
+				start = word_end + 1;
+			}
+			return words;
+		};
+
+		if (next_line() != "ply") throw HF::Exceptions::InvalidOBJ();
+
+		vector<PlyElement> elements;
+		bool has_format = false;
+		while (true) {
+			const auto words = split(next_line());
+			if (words.empty() || words[0] == "comment" || words[0] == "obj_info") continue;
+
+			if (words[0] == "end_header") break;
+			else if (words[0] == "format" && words.size() >= 2) {
+				// Only the binary formats are supported, since they can be read without parsing text
+				if (words[1] == "binary_little_endian") little_endian = true;
+				else if (words[1] == "binary_big_endian") little_endian = false;
+				else throw HF::Exceptions::InvalidOBJ();
+				has_format = true;
+			}
+			else if (words[0] == "element" && words.size() == 3) {
+				PlyElement element;
+				element.name = words[1];
+				try { element.count = std::stoull(words[2]); }
+				catch (const std::exception&) { throw HF::Exceptions::InvalidOBJ(); }
+				elements.push_back(element);
+			}
+			else if (words[0] == "property" && !elements.empty()) {
+				PlyProperty property;
+				if (words.size() == 5 && words[1] == "list") {
+					property.is_list = true;
+					property.count_type = ParsePlyType(words[2]);
+					property.type = ParsePlyType(words[3]);
+					property.name = words[4];
+				}
+				else if (words.size() == 3) {
+					property.type = ParsePlyType(words[1]);
+					property.name = words[2];
+				}
+				else throw HF::Exceptions::InvalidOBJ();
+				elements.back().properties.push_back(property);
+			}
+			else throw HF::Exceptions::InvalidOBJ();
+		}
+
+		if (!has_format) throw HF::Exceptions::InvalidOBJ();
+		return elements;
+	}
+
+	/*!
+		\brief Copy the x, y, z properties of every vertex in `element` into `vertices`.
+
+		\returns A pointer past the last vertex.
+	*/
+	const char* ReadPlyVertices(
+		const char* c,
+		const char* end,
+		const PlyElement& element,
+		bool swap,
+		double scale,
+		Eigen::Matrix3X<float>& vertices
+	) {
+		CheckPlyCount(c, end, element);
+
+		// Find where x, y and z are in each vertex
+		int axis_property[3] = { -1, -1, -1 };
+		size_t axis_offset[3] = { 0, 0, 0 };
+		size_t stride = 0;
+		bool fixed_size = true;
+		for (int i = 0; i < static_cast<int>(element.properties.size()); i++) {
+			const auto& property = element.properties[i];
+			for (int axis = 0; axis < 3; axis++) {
+				if (property.name == string(1, static_cast<char>('x' + axis)) && !property.is_list) {
+					axis_property[axis] = i;
+					axis_offset[axis] = stride;
+				}
+			}
+			fixed_size &= !property.is_list;
+			stride += PlyTypeSize(property.type);
+		}
+		if (axis_property[0] < 0 || axis_property[1] < 0 || axis_property[2] < 0)
+			throw HF::Exceptions::InvalidOBJ();
+
+		const PlyType types[3] = {
+			element.properties[axis_property[0]].type,
+			element.properties[axis_property[1]].type,
+			element.properties[axis_property[2]].type
+		};
+		const int num_vertices = static_cast<int>(element.count);
+		vertices.resize(3, static_cast<Eigen::Index>(num_vertices) + 1);
+
+		if (fixed_size) {
+			// Every vertex is the same size, so they can be read in parallel
+#pragma omp parallel for schedule(static)
+			for (int i = 0; i < num_vertices; i++) {
+				const char* vertex = c + static_cast<size_t>(i) * stride;
+				for (int axis = 0; axis < 3; axis++)
+					vertices(axis, i) = static_cast<float>(ReadPlyValue(vertex + axis_offset[axis], types[axis], swap) * scale);
+			}
+			return c + element.count * stride;
+		}
+
+		// Lists in the vertices make their size vary, so find each one in turn
+		for (int i = 0; i < num_vertices; i++) {
+			size_t offset = 0;
+			for (int p = 0; p < static_cast<int>(element.properties.size()); p++) {
+				const auto& property = element.properties[p];
+				size_t size = PlyTypeSize(property.type);
+				if (property.is_list) {
+					if (c + offset + PlyTypeSize(property.count_type) > end) throw HF::Exceptions::InvalidOBJ();
+					const double count = ReadPlyValue(c + offset, property.count_type, swap);
+					if (count < 0) throw HF::Exceptions::InvalidOBJ();
+					size = PlyTypeSize(property.count_type) + static_cast<size_t>(count) * size;
+				}
+				else if (c + offset + size > end) throw HF::Exceptions::InvalidOBJ();
+
+				for (int axis = 0; axis < 3; axis++)
+					if (p == axis_property[axis])
+						vertices(axis, i) = static_cast<float>(ReadPlyValue(c + offset, property.type, swap) * scale);
+				offset += size;
+			}
+			c += offset;
+		}
+		return c;
+	}
+
+	/*!
+		\brief Read the vertex indices of every face in `element`, splitting polygons into fans of triangles.
+
+		\returns A pointer past the last face.
+	*/
+	const char* ReadPlyFaces(
+		const char* c,
+		const char* end,
+		const PlyElement& element,
+		bool swap,
+		int num_vertices,
+		Eigen::Matrix3X<int>& indices
+	) {
+		CheckPlyCount(c, end, element);
+
+		int index_property = -1;
+		for (int i = 0; i < static_cast<int>(element.properties.size()); i++) {
+			const auto& property = element.properties[i];
+			if (property.is_list && (property.name == "vertex_indices" || property.name == "vertex_index"))
+				index_property = i;
+		}
+		if (index_property < 0) throw HF::Exceptions::InvalidOBJ();
+
+		const PlyProperty& index_list = element.properties[index_property];
+		const size_t count_size = PlyTypeSize(index_list.count_type);
+		const size_t index_size = PlyTypeSize(index_list.type);
+
+		// Find every face's list of indices and count its triangles first, so indices only has to be allocated once
+		vector<const char*> lists(element.count);
+		size_t num_triangles = 0;
+		for (size_t i = 0; i < element.count; i++) {
+			size_t offset = 0;
+			for (int p = 0; p < static_cast<int>(element.properties.size()); p++) {
+				const auto& property = element.properties[p];
+				size_t size = PlyTypeSize(property.type);
+				if (property.is_list) {
+					if (c + offset + PlyTypeSize(property.count_type) > end) throw HF::Exceptions::InvalidOBJ();
+					const double count = ReadPlyValue(c + offset, property.count_type, swap);
+					if (count < 0) throw HF::Exceptions::InvalidOBJ();
+					size = PlyTypeSize(property.count_type) + static_cast<size_t>(count) * size;
+
+					if (p == index_property) {
+						lists[i] = c + offset;
+						if (count > 2) num_triangles += static_cast<size_t>(count) - 2;
+					}
+				}
+				offset += size;
+			}
+			if (c + offset > end) throw HF::Exceptions::InvalidOBJ();
+			c += offset;
+		}
+
+		indices.resize(3, num_triangles);
+		int* out = indices.data();
+		bool valid = true;
+		for (size_t i = 0; i < element.count; i++) {
+			const char* list = lists[i];
+			const int count = static_cast<int>(ReadPlyValue(list, index_list.count_type, swap));
+			const char* items = list + count_size;
+			if (count < 3) continue;
+
+			const int first = static_cast<int>(ReadPlyValue(items, index_list.type, swap));
+			int previous = static_cast<int>(ReadPlyValue(items + index_size, index_list.type, swap));
+			valid &= first >= 0 && first < num_vertices && previous >= 0 && previous < num_vertices;
+			for (int j = 2; j < count; j++) {
+				const int current = static_cast<int>(ReadPlyValue(items + j * index_size, index_list.type, swap));
+				valid &= current >= 0 && current < num_vertices;
+				*out++ = first;
+				*out++ = previous;
+				*out++ = current;
+				previous = current;
+			}
+		}
+
+		if (!valid) throw HF::Exceptions::InvalidOBJ();
+		return c;
+	}
+
+	vector<MeshInfo<float>> LoadPLY(const string& path, bool change_coords, int scale) {
+		const MappedFile file(path);
+		const char* c = file.data();
+		const char* end = file.data() + file.size();
+		if (file.size() == 0) throw HF::Exceptions::InvalidOBJ();
+
+		bool little_endian = true;
+		const auto elements = ParsePlyHeader(c, end, little_endian);
+		const bool swap = little_endian != IsLittleEndian();
+
+		MeshBuffers<float> buffers;
+		bool has_vertices = false;
+		bool has_faces = false;
+		for (const auto& element : elements) {
+			if (element.name == "vertex" && !has_vertices) {
+				c = ReadPlyVertices(c, end, element, swap, scale, buffers.vertices);
+				has_vertices = true;
+			}
+			else if (element.name == "face" && !has_faces) {
+				// Faces can only be checked against vertices that were declared before them
+				if (!has_vertices) throw HF::Exceptions::InvalidOBJ();
+				c = ReadPlyFaces(c, end, element, swap, buffers.NumVerts(), buffers.indices);
+				has_faces = true;
+			}
+			else {
+				// Skip anything else, such as edges or materials
+				CheckPlyCount(c, end, element);
+				for (size_t i = 0; i < element.count; i++) {
+					const size_t size = PlyItemSize(c, end, element, swap);
+					if (size == 0) throw HF::Exceptions::InvalidOBJ();
+					c += size;
+				}
+			}
+		}
+
+		if (!has_faces || buffers.NumTris() == 0) throw HF::Exceptions::InvalidOBJ();
+
+		vector<MeshInfo<float>> meshes;
+		meshes.emplace_back(std::move(buffers), 0, "EntireFile");
+		if (change_coords)
+			meshes[0].ConvertToRhinoCoordinates();
+		return meshes;
+	}
+}
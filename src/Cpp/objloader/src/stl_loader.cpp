@@ -0,0 +1,68 @@
+///
+///	\file		stl_loader.cpp
+/// \brief		Contains implementation for loading binary STL files with <see cref="HF::Geometry::LoadSTL">LoadSTL</see>
+///
+///	\author		TBA
+///	\date		02 Jul 2020
+
+#include <objloader.h>
+#include <meshinfo.h>
+#include <mapped_file.h>
+#include <HFExceptions.h>
+#include <robin_hood.h>
+
+#include <array>
+#include <cstring>
+
+using std::string;
+using std::vector;
+
+namespace HF::Geometry {
+
+	constexpr size_t STL_HEADER_BYTES = 84;		///< An 80 byte comment followed by the number of triangles.
+	constexpr size_t STL_TRIANGLE_BYTES = 50;	///< A normal, three vertices and a 2 byte attribute.
+
+	vector<MeshInfo<float>> LoadSTL(const string& path, bool change_coords, int scale) {
+		const MappedFile file(path);
+
+		// Binary STLs are exactly as large as the number of triangles in their header says. ASCII
+		// STLs start with "solid", but so do some binary ones, so the size is the only reliable test
+		if (file.size() < STL_HEADER_BYTES) throw HF::Exceptions::InvalidOBJ();
+		uint32_t num_triangles;
+		std::memcpy(&num_triangles, file.data() + 80, sizeof(num_triangles));
+		if (num_triangles == 0 || file.size() != STL_HEADER_BYTES + STL_TRIANGLE_BYTES * uint64_t(num_triangles))
+			throw HF::Exceptions::InvalidOBJ();
+
+		// STLs repeat every vertex for each triangle it's in, so merge vertices with the same position
+		MeshBuffers<float> buffers;
+		buffers.indices.resize(3, num_triangles);
+		robin_hood::unordered_flat_map<std::array<float, 3>, int, std::hash<std::array<float, 3>>> vertex_index;
+		vertex_index.reserve(num_triangles / 2 + 3);
+		vector<std::array<float, 3>> vertices;
+		vertices.reserve(num_triangles / 2 + 3);
+
+		int* out_index = buffers.indices.data();
+		const char* triangle = file.data() + STL_HEADER_BYTES;
+		for (uint32_t i = 0; i < num_triangles; i++, triangle += STL_TRIANGLE_BYTES) {
+			// Skip the normal, since it's recalculated by anything that needs it
+			for (int corner = 0; corner < 3; corner++) {
+				std::array<float, 3> vertex;
+				std::memcpy(vertex.data(), triangle + 12 * (corner + 1), sizeof(vertex));
+
+				const auto inserted = vertex_index.emplace(vertex, static_cast<int>(vertices.size()));
+				if (inserted.second) vertices.push_back(vertex);
+				*out_index++ = inserted.first->second;
+			}
+		}
+
+		buffers.vertices.resize(3, vertices.size() + 1);
+		for (size_t i = 0; i < vertices.size(); i++)
+			buffers.vertices.col(i) << vertices[i][0] * scale, vertices[i][1] * scale, vertices[i][2] * scale;
+
+		vector<MeshInfo<float>> meshes;
+		meshes.emplace_back(std::move(buffers), 0, "EntireFile");
+		if (change_coords)
+			meshes[0].ConvertToRhinoCoordinates();
+		return meshes;
+	}
+}
@@ -11,6 +11,9 @@
 #include <node.h>
 #include <edge.h>
 #include <assert.h>
+#include <cmath>
+
+#include <boost/range/iterator_range.hpp>
 
 using HF::SpatialStructures::Graph;
 using HF::SpatialStructures::Node;
@@ -64,6 +67,34 @@ namespace HF::Pathfinding {
 		// Resize predecessor and distance arrays to maximum size.
 		p.resize(n);
 		d.resize(n);
+
+		// Store the position of every node by its ID so searches like A* can
+		// estimate the remaining distance to their goal
+		positions.resize(n, std::array<float, 3>{NAN, NAN, NAN});
+		for (const Node& node : graph.Nodes())
+			if (node.id >= 0 && node.id < n)
+				positions[node.id] = node.getArray();
+	}
+
+	const graph_t& BoostGraph::Reverse()
+	{
+		if (has_reverse) return g_reverse;
+
+		// Flip the parent and child of every edge in g
+		std::vector<pair> edges;
+		std::vector<Edge_Cost> weights;
+		edges.reserve(num_edges(g));
+		weights.reserve(num_edges(g));
+
+		for (const auto& edge : boost::make_iterator_range(boost::edges(g))) {
+			edges.emplace_back(pair{ static_cast<int>(target(edge, g)), static_cast<int>(source(edge, g)) });
+			weights.emplace_back(g[edge]);
+		}
+
+		g_reverse = graph_t(boost::edges_are_unsorted, edges.begin(), edges.end(), weights.begin(), num_vertices(g));
+		has_reverse = true;
+
+		return g_reverse;
 	}
 
 	BoostGraph::~BoostGraph() = default;
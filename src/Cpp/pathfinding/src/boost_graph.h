@@ -12,6 +12,9 @@
 #include <boost/graph/compressed_sparse_row_graph.hpp>
 #include <boost/graph/adjacency_list.hpp>
 
+#include <array>
+#include <vector>
+
 
 // Define a hash function for arrays of 3 floats.
 namespace std {
@@ -168,6 +171,7 @@ namespace HF {
 			graph_t g;							///< The underlying graph in boost.
 			std::vector<vertex_descriptor> p;	///< Vertex array preallocated to the number of nodes in the graph.
 			std::vector<double> d;				///< Distance array preallocated to the number of nodes in the graph.
+			std::vector<std::array<float, 3>> positions; ///< Position of every node indexed by ID. NaN for nodes without a position.
 
 			/// <summary> Create a boost graph from a HF::SpatialStructures::Graph. </summary>
 			/*!
@@ -262,6 +266,25 @@ namespace HF {
 				\endcode
 			*/
 			~BoostGraph();
+
+			/*!
+				\brief Get a copy of this graph with the direction of every edge flipped.
+
+				\returns A reference to the reversed graph. The reversed graph is only built the first
+						 time this is called, so later calls are free.
+
+				\details
+				Boost's compressed sparse row graph can only iterate over the out edges of a vertex.
+				Searches that need to walk the graph backwards from a goal, such as bidirectional
+				Dijkstra, can use the out edges of this graph as the in edges of the original.
+
+				\warning Not thread safe on the first call.
+			*/
+			const graph_t& Reverse();
+
+		private:
+			graph_t g_reverse;					///< Lazily built reverse of g. See Reverse().
+			bool has_reverse = false;			///< Whether or not g_reverse has been built.
 		};
 	}
 }
@@ -0,0 +1,675 @@
+///
+///	\file		contraction_hierarchy.cpp
+/// \brief		Contains implementation for the <see cref="HF::Pathfinding::ContractionHierarchy">ContractionHierarchy</see> class
+///
+///	\author		TBA
+///	\date		17 Jun 2020
+///
+
+#include <contraction_hierarchy.h>
+
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+
+#include <graph.h>
+#include <path.h>
+#include <HFExceptions.h>
+
+using std::vector;
+using HF::SpatialStructures::Graph;
+using HF::SpatialStructures::Path;
+using HF::SpatialStructures::PathMember;
+using HF::SpatialStructures::CSRPtrs;
+
+namespace HF::Pathfinding {
+
+	constexpr float UNREACHED = std::numeric_limits<float>::infinity(); ///< Distance of nodes a search hasn't reached.
+	constexpr int WITNESS_SETTLE_LIMIT = 500; ///< Maximum number of nodes a witness search may settle before giving up.
+	constexpr int PRIORITY_SETTLE_LIMIT = 50; ///< Settle limit of the witness searches used only to estimate a node's priority.
+
+	constexpr char CH_FILE_MAGIC[8] = { 'D', 'H', 'A', 'R', 'T', 'C', 'H', '\0' }; ///< First bytes of every hierarchy file.
+	constexpr uint32_t CH_FILE_VERSION = 1; ///< Version of the hierarchy format written by SaveBinary.
+
+	/*!
+		\brief The first section of every contraction hierarchy file.
+
+		\details
+		It's followed by the rank of every node, then the offsets, targets, costs and middles
+		of the upward edges, then the same arrays for the downward edges.
+	*/
+	struct CHFileHeader {
+		char magic[8];			///< Must match CH_FILE_MAGIC.
+		uint32_t version;		///< Version of the format this file was written with.
+		int32_t num_nodes;		///< Number of nodes in the graph.
+		int32_t num_up;			///< Number of upward edges.
+		int32_t num_down;		///< Number of downward edges.
+	};
+
+	/*! \brief An edge of a node in the graph being contracted. */
+	struct Arc {
+		int node;		///< The node on the other end of this edge.
+		float cost;		///< Cost of traversing this edge.
+		int middle;		///< Node this shortcut skips over, or -1 for an original edge.
+	};
+
+	/*! \brief A priority queue of (cost, node) that always has the lowest cost on top. */
+	using CostQueue = std::priority_queue<std::pair<float, int>, vector<std::pair<float, int>>, std::greater<std::pair<float, int>>>;
+
+	/*!
+		\brief Add an edge from parent to child, or lower the cost of the existing one.
+
+		\param out Outgoing edges of every node.
+		\param in Incoming edges of every node.
+		\param parent Parent of the edge.
+		\param child Child of the edge.
+		\param cost Cost of the edge.
+		\param middle Node the edge skips over, or -1 for an original edge.
+
+		\details Only the cheapest of any parallel edges is kept.
+	*/
+	inline void AddOrImproveArc(vector<vector<Arc>>& out, vector<vector<Arc>>& in, int parent, int child, float cost, int middle) {
+		for (Arc& arc : out[parent]) {
+			if (arc.node != child) continue;
+
+			if (cost < arc.cost) {
+				arc.cost = cost;
+				arc.middle = middle;
+				for (Arc& in_arc : in[child]) {
+					if (in_arc.node == parent) {
+						in_arc.cost = cost;
+						in_arc.middle = middle;
+						break;
+					}
+				}
+			}
+			return;
+		}
+
+		out[parent].push_back({ child, cost, middle });
+		in[child].push_back({ parent, cost, middle });
+	}
+
+	/*! \brief Remove the edge to `node` from `arcs`. */
+	inline void RemoveArc(vector<Arc>& arcs, int node) {
+		for (int i = 0; i < static_cast<int>(arcs.size()); i++) {
+			if (arcs[i].node == node) {
+				arcs[i] = arcs.back();
+				arcs.pop_back();
+				return;
+			}
+		}
+	}
+
+	/*!
+		\brief Dijkstra searches that check for paths around a node before it's contracted.
+
+		\details
+		The distances found are only upper bounds, since the search gives up after
+		a fixed number of nodes, but every distance is the cost of a real path. If one isn't
+		lower than a shortcut's cost, the shortcut is added, so stopping early only adds shortcuts
+		and never breaks the hierarchy.
+	*/
+	class WitnessSearch {
+	private:
+		vector<float> dist;		///< Distance from the source to every node.
+		vector<int> touched;	///< Every node whose distance was set by the last search.
+		vector<std::pair<float, int>> heap;	///< Storage for the search's queue, kept between searches.
+
+	public:
+		/*! \brief Allocate space for `n` nodes. */
+		WitnessSearch(int n) : dist(n, UNREACHED) {}
+
+		/*!
+			\brief Find distances from `source` in `out` without passing through `ignore`.
+
+			\param out Outgoing edges of every node that hasn't been contracted.
+			\param source Node to start from.
+			\param ignore Node being contracted.
+			\param max_cost Stop once every node within this cost is settled.
+			\param settle_limit Stop after settling this many nodes.
+		*/
+		void Run(const vector<vector<Arc>>& out, int source, int ignore, float max_cost, int settle_limit) {
+			for (int node : touched) dist[node] = UNREACHED;
+			touched.clear();
+
+			// Reuse the heap's memory instead of allocating a new queue for every search
+			const auto greater = std::greater<std::pair<float, int>>();
+			heap.clear();
+			dist[source] = 0;
+			touched.push_back(source);
+			heap.push_back({ 0.0f, source });
+
+			int settled = 0;
+			while (!heap.empty()) {
+				std::pop_heap(heap.begin(), heap.end(), greater);
+				const auto [cost, node] = heap.back();
+				heap.pop_back();
+
+				if (cost > dist[node]) continue;
+				if (cost > max_cost || ++settled > settle_limit) break;
+
+				for (const Arc& arc : out[node]) {
+					if (arc.node == ignore) continue;
+
+					const float child_cost = cost + arc.cost;
+					if (child_cost < dist[arc.node]) {
+						if (dist[arc.node] == UNREACHED) touched.push_back(arc.node);
+						dist[arc.node] = child_cost;
+						heap.push_back({ child_cost, arc.node });
+						std::push_heap(heap.begin(), heap.end(), greater);
+					}
+				}
+			}
+		}
+
+		/*! \brief Get the distance of `node` found by the last search. */
+		inline float Distance(int node) const { return dist[node]; }
+	};
+
+	/*! \brief A shortcut that contracting a node requires. */
+	struct Shortcut {
+		int parent;		///< Parent of the shortcut.
+		int child;		///< Child of the shortcut.
+		float cost;		///< Cost of the path the shortcut replaces.
+	};
+
+	/*!
+		\brief Find the shortcuts needed to contract `node`.
+
+		\param out Outgoing edges of every node that hasn't been contracted.
+		\param in Incoming edges of every node that hasn't been contracted.
+		\param node Node to contract.
+		\param witness Witness search to reuse.
+		\param settle_limit Maximum number of nodes each witness search may settle.
+		\param out_shortcuts Shortcuts are appended to this.
+	*/
+	inline void FindShortcuts(
+		const vector<vector<Arc>>& out,
+		const vector<vector<Arc>>& in,
+		int node,
+		WitnessSearch& witness,
+		int settle_limit,
+		vector<Shortcut>& out_shortcuts
+	) {
+		for (const Arc& in_arc : in[node]) {
+			const int parent = in_arc.node;
+
+			// Only search as far as the most expensive shortcut from this parent
+			float max_cost = -1;
+			for (const Arc& out_arc : out[node])
+				if (out_arc.node != parent)
+					max_cost = std::max(max_cost, in_arc.cost + out_arc.cost);
+			if (max_cost < 0) continue;
+
+			witness.Run(out, parent, node, max_cost, settle_limit);
+
+			for (const Arc& out_arc : out[node]) {
+				if (out_arc.node == parent) continue;
+
+				const float cost = in_arc.cost + out_arc.cost;
+				if (witness.Distance(out_arc.node) > cost)
+					out_shortcuts.push_back({ parent, out_arc.node, cost });
+			}
+		}
+	}
+
+	/*!
+		\brief Flatten the edges of every node into CSR arrays.
+
+		\param arcs Edges of every node.
+		\param offsets Set to the index of the first edge of every node, plus the total.
+		\param targets Set to the node on the other end of every edge.
+		\param costs Set to the cost of every edge.
+		\param middles Set to the node every edge skips over.
+	*/
+	inline void FlattenArcs(
+		const vector<vector<Arc>>& arcs,
+		vector<int>& offsets,
+		vector<int>& targets,
+		vector<float>& costs,
+		vector<int>& middles
+	) {
+		offsets.resize(arcs.size() + 1);
+		offsets[0] = 0;
+		for (int node = 0; node < static_cast<int>(arcs.size()); node++)
+			offsets[node + 1] = offsets[node] + static_cast<int>(arcs[node].size());
+
+		targets.resize(offsets.back());
+		costs.resize(offsets.back());
+		middles.resize(offsets.back());
+		for (int node = 0; node < static_cast<int>(arcs.size()); node++) {
+			for (int i = 0; i < static_cast<int>(arcs[node].size()); i++) {
+				const Arc& arc = arcs[node][i];
+				targets[offsets[node] + i] = arc.node;
+				costs[offsets[node] + i] = arc.cost;
+				middles[offsets[node] + i] = arc.middle;
+			}
+		}
+	}
+
+	ContractionHierarchy::ContractionHierarchy(const Graph& graph, const std::string& cost_type) {
+		// Throws if the graph isn't compressed or the cost doesn't exist
+		const CSRPtrs csr = graph.GetCSRPointers(cost_type);
+		const int n = std::max(csr.rows, csr.cols);
+		this->num_nodes = n;
+
+		// Copy the graph into adjacency lists that can be contracted
+		vector<vector<Arc>> out(n), in(n);
+		for (int parent = 0; parent < csr.rows; parent++) {
+			for (int edge = csr.outer_indices[parent]; edge < csr.outer_indices[parent + 1]; edge++) {
+				const int child = csr.inner_indices[edge];
+				const float cost = csr.data[edge];
+
+				if (std::isnan(cost) || child == parent) continue;
+				if (cost < 0)
+					throw std::invalid_argument("Contraction hierarchies can't be built from graphs with negative costs");
+
+				AddOrImproveArc(out, in, parent, child, cost, -1);
+			}
+		}
+
+		WitnessSearch witness(n);
+		vector<Shortcut> shortcuts;
+		vector<int> contracted_neighbors(n, 0);
+		vector<int> level(n, 0);
+
+		// Priority of a node is its edge difference plus how many of its neighbors were contracted,
+		// plus its level, which keeps the hierarchy shallow by spreading contraction across the graph
+		auto priority = [&](int node) {
+			shortcuts.clear();
+			FindShortcuts(out, in, node, witness, PRIORITY_SETTLE_LIMIT, shortcuts);
+			return static_cast<int>(shortcuts.size())
+				- static_cast<int>(in[node].size() + out[node].size())
+				+ contracted_neighbors[node]
+				+ level[node];
+		};
+
+		using PriorityQueue = std::priority_queue<std::pair<int, int>, vector<std::pair<int, int>>, std::greater<std::pair<int, int>>>;
+		PriorityQueue queue;
+		for (int node = 0; node < n; node++)
+			queue.push({ priority(node), node });
+
+		// Every node's edges to higher ranked nodes, stored when it's contracted
+		vector<vector<Arc>> up(n), down(n);
+		this->rank.assign(n, -1);
+
+		int next_rank = 0;
+		while (!queue.empty()) {
+			const int node = queue.top().second;
+			queue.pop();
+
+			// Priorities are updated lazily, so put this back if it's no longer the lowest
+			const int current_priority = priority(node);
+			if (!queue.empty() && current_priority > queue.top().first) {
+				queue.push({ current_priority, node });
+				continue;
+			}
+
+			// Search for witnesses more thoroughly now that the node is actually being contracted
+			shortcuts.clear();
+			FindShortcuts(out, in, node, witness, WITNESS_SETTLE_LIMIT, shortcuts);
+
+			// Every remaining neighbor will be ranked higher than this node
+			this->rank[node] = next_rank++;
+			up[node] = out[node];
+			down[node] = in[node];
+
+			// Disconnect this node from the rest of the graph
+			for (const Arc& arc : out[node]) {
+				RemoveArc(in[arc.node], node);
+				contracted_neighbors[arc.node]++;
+				level[arc.node] = std::max(level[arc.node], level[node] + 1);
+			}
+			for (const Arc& arc : in[node]) {
+				RemoveArc(out[arc.node], node);
+				contracted_neighbors[arc.node]++;
+				level[arc.node] = std::max(level[arc.node], level[node] + 1);
+			}
+			out[node].clear();
+			in[node].clear();
+
+			// Replace paths through it with shortcuts
+			for (const Shortcut& shortcut : shortcuts)
+				AddOrImproveArc(out, in, shortcut.parent, shortcut.child, shortcut.cost, node);
+		}
+
+		FlattenArcs(up, this->up_offsets, this->up_targets, this->up_costs, this->up_middles);
+		FlattenArcs(down, this->down_offsets, this->down_targets, this->down_costs, this->down_middles);
+	}
+
+	int ContractionHierarchy::size() const { return this->num_nodes; }
+
+	int ContractionHierarchy::NumEdges() const {
+		return static_cast<int>(this->up_targets.size() + this->down_targets.size());
+	}
+
+	/*! \brief Find the edge at `node` that leads to `target`. */
+	inline int FindArc(const vector<int>& offsets, const vector<int>& targets, int node, int target) {
+		for (int arc = offsets[node]; arc < offsets[node + 1]; arc++)
+			if (targets[arc] == target) return arc;
+
+		throw std::logic_error("A shortcut in the contraction hierarchy skips over a missing edge");
+	}
+
+	void ContractionHierarchy::Unpack(
+		int parent,
+		int child,
+		float cost,
+		int middle,
+		vector<int>& out_nodes,
+		vector<float>& out_costs
+	) const {
+		// Shortcuts can nest deeply, so unpack them with a stack instead of recursion
+		vector<Arc> stack;
+		stack.push_back({ child, cost, middle });
+		vector<int> parents = { parent };
+
+		while (!stack.empty()) {
+			const Arc arc = stack.back();
+			const int arc_parent = parents.back();
+			stack.pop_back();
+			parents.pop_back();
+
+			if (arc.middle < 0) {
+				out_nodes.push_back(arc.node);
+				out_costs.push_back(arc.cost);
+				continue;
+			}
+
+			// The middle node is ranked lower than both ends, so the first half is one of its
+			// downward edges and the second half is one of its upward edges
+			const int first = FindArc(this->down_offsets, this->down_targets, arc.middle, arc_parent);
+			const int second = FindArc(this->up_offsets, this->up_targets, arc.middle, arc.node);
+
+			// Push the second half first so the first half is unpacked first
+			stack.push_back({ arc.node, this->up_costs[second], this->up_middles[second] });
+			parents.push_back(arc.middle);
+			stack.push_back({ arc.middle, this->down_costs[first], this->down_middles[first] });
+			parents.push_back(arc_parent);
+		}
+	}
+
+	/*! \brief Arrays reused by every query on a thread. Index 0 is the forward search, 1 is the backward search. */
+	struct QueryScratch {
+		vector<float> dist[2];		///< Distance of every node from the start (forward) or to the end (backward).
+		vector<int> pred[2];		///< Node every node was reached from.
+		vector<int> pred_arc[2];	///< Edge every node was reached through.
+		vector<int> touched[2];		///< Every node whose entries were set by the last query.
+
+		/*! \brief Grow the arrays to hold at least `n` nodes and clear the last query. */
+		inline void Prepare(int n) {
+			for (int dir = 0; dir < 2; dir++) {
+				for (int node : touched[dir]) dist[dir][node] = UNREACHED;
+				touched[dir].clear();
+
+				if (dist[dir].size() < static_cast<size_t>(n)) {
+					dist[dir].resize(n, UNREACHED);
+					pred[dir].resize(n, -1);
+					pred_arc[dir].resize(n, -1);
+				}
+			}
+		}
+	};
+
+	Path ContractionHierarchy::FindPath(int start_id, int end_id) const
+	{
+		if (start_id < 0 || start_id >= this->num_nodes || end_id < 0 || end_id >= this->num_nodes || start_id == end_id)
+			return Path{};
+
+		thread_local QueryScratch s;
+		s.Prepare(this->num_nodes);
+
+		const vector<int>* offsets[2] = { &this->up_offsets, &this->down_offsets };
+		const vector<int>* targets[2] = { &this->up_targets, &this->down_targets };
+		const vector<float>* costs[2] = { &this->up_costs, &this->down_costs };
+
+		CostQueue queues[2];
+		const int sources[2] = { start_id, end_id };
+		for (int dir = 0; dir < 2; dir++) {
+			s.dist[dir][sources[dir]] = 0;
+			s.touched[dir].push_back(sources[dir]);
+			queues[dir].push({ 0.0f, sources[dir] });
+		}
+
+		// Both searches only move up the hierarchy, and meet at the highest ranked node of the path
+		float best = UNREACHED;
+		int meeting_node = -1;
+		while (true) {
+			const float forward_min = queues[0].empty() ? UNREACHED : queues[0].top().first;
+			const float backward_min = queues[1].empty() ? UNREACHED : queues[1].top().first;
+			if (std::min(forward_min, backward_min) >= best) break;
+
+			const int dir = (forward_min <= backward_min) ? 0 : 1;
+			const auto [cost, node] = queues[dir].top();
+			queues[dir].pop();
+			if (cost > s.dist[dir][node]) continue;
+
+			// Check for a better path through this node
+			const float other_cost = s.dist[1 - dir][node];
+			if (cost + other_cost < best) {
+				best = cost + other_cost;
+				meeting_node = node;
+			}
+
+			// Stall on demand. If a higher ranked node already reached by this search has a
+			// cheaper edge into this node, this node can't be on a shortest path up the
+			// hierarchy, so there's no need to expand it.
+			bool stalled = false;
+			const int other_dir = 1 - dir;
+			for (int arc = (*offsets[other_dir])[node]; arc < (*offsets[other_dir])[node + 1]; arc++) {
+				if (s.dist[dir][(*targets[other_dir])[arc]] + (*costs[other_dir])[arc] < cost) {
+					stalled = true;
+					break;
+				}
+			}
+			if (stalled) continue;
+
+			for (int arc = (*offsets[dir])[node]; arc < (*offsets[dir])[node + 1]; arc++) {
+				const int child = (*targets[dir])[arc];
+				const float child_cost = cost + (*costs[dir])[arc];
+
+				if (child_cost < s.dist[dir][child]) {
+					if (s.dist[dir][child] == UNREACHED) s.touched[dir].push_back(child);
+					s.dist[dir][child] = child_cost;
+					s.pred[dir][child] = node;
+					s.pred_arc[dir][child] = arc;
+					queues[dir].push({ child_cost, child });
+				}
+			}
+		}
+
+		if (meeting_node < 0) return Path{};
+
+		// Collect the forward search's edges from the meeting node back to the start
+		vector<int> forward_arcs;
+		for (int node = meeting_node; node != start_id; node = s.pred[0][node])
+			forward_arcs.push_back(s.pred_arc[0][node]);
+		std::reverse(forward_arcs.begin(), forward_arcs.end());
+
+		// Unpack every edge of the path into the graph's original edges
+		vector<int> nodes = { start_id };
+		vector<float> edge_costs;
+		int parent = start_id;
+		for (int arc : forward_arcs) {
+			Unpack(parent, this->up_targets[arc], this->up_costs[arc], this->up_middles[arc], nodes, edge_costs);
+			parent = this->up_targets[arc];
+		}
+
+		// The backward search's edges point from the meeting node towards the end
+		for (int node = meeting_node; node != end_id; node = s.pred[1][node]) {
+			const int arc = s.pred_arc[1][node];
+			Unpack(node, s.pred[1][node], this->down_costs[arc], this->down_middles[arc], nodes, edge_costs);
+		}
+
+		// Accumulate costs the same way dijkstra does so the costs of each member match FindPath
+		Path p;
+		float last_cost = 0;
+		for (int i = 0; i < static_cast<int>(edge_costs.size()); i++) {
+			const float current_cost = last_cost + edge_costs[i];
+			p.AddNode(nodes[i], current_cost - last_cost);
+			last_cost = current_cost;
+		}
+		p.AddNode(nodes.back(), 0);
+
+		return p;
+	}
+
+	vector<Path> ContractionHierarchy::FindPaths(const vector<int>& start_ids, const vector<int>& end_ids) const
+	{
+		if (start_ids.size() != end_ids.size())
+			throw std::invalid_argument("Tried to find paths with different numbers of start and end points");
+
+		vector<Path> paths(start_ids.size());
+
+	#pragma omp parallel for schedule(dynamic)
+		for (int i = 0; i < static_cast<int>(start_ids.size()); i++)
+			paths[i] = this->FindPath(start_ids[i], end_ids[i]);
+
+		return paths;
+	}
+
+	void ContractionHierarchy::InsertPathsIntoArray(
+		const vector<int>& start_ids,
+		const vector<int>& end_ids,
+		Path** out_paths,
+		PathMember** out_path_members,
+		int* out_sizes
+	) const {
+		vector<Path> paths = this->FindPaths(start_ids, end_ids);
+
+		for (int i = 0; i < static_cast<int>(paths.size()); i++) {
+			// Paths that couldn't be found are represented by null pointers
+			if (paths[i].empty()) {
+				out_paths[i] = nullptr;
+				out_path_members[i] = nullptr;
+				out_sizes[i] = 0;
+			}
+			else {
+				out_paths[i] = new Path(std::move(paths[i]));
+				out_path_members[i] = out_paths[i]->GetPMPointer();
+				out_sizes[i] = out_paths[i]->size();
+			}
+		}
+	}
+
+	/*! \brief Write every element of `values` to `out`. */
+	template <typename T>
+	inline void WriteArray(std::ofstream& out, const vector<T>& values) {
+		out.write(reinterpret_cast<const char*>(values.data()), sizeof(T) * values.size());
+	}
+
+	/*! \brief Read `count` elements from `in` into `values`. */
+	template <typename T>
+	inline void ReadArray(std::ifstream& in, vector<T>& values, size_t count) {
+		values.resize(count);
+		in.read(reinterpret_cast<char*>(values.data()), sizeof(T) * count);
+	}
+
+	/*!
+		\brief Check that one direction of a loaded hierarchy only references nodes that exist.
+
+		\param offsets Index of the first edge of every node. Must have `num_nodes + 1` elements.
+		\param targets Node at the other end of every edge.
+		\param middles Node every shortcut skips over, or -1 for original edges.
+		\param num_nodes Number of nodes in the hierarchy.
+
+		\returns True if every offset, target and middle node is in range, false otherwise.
+	*/
+	inline bool ValidArcs(const vector<int>& offsets, const vector<int>& targets, const vector<int>& middles, int num_nodes) {
+		if (offsets.front() != 0 || offsets.back() != static_cast<int>(targets.size()))
+			return false;
+		for (int node = 0; node < num_nodes; node++)
+			if (offsets[node] > offsets[node + 1]) return false;
+
+		for (size_t i = 0; i < targets.size(); i++) {
+			if (targets[i] < 0 || targets[i] >= num_nodes) return false;
+			if (middles[i] < -1 || middles[i] >= num_nodes) return false;
+		}
+		return true;
+	}
+
+	bool ContractionHierarchy::SaveBinary(const std::string& path) const
+	{
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		if (!out.good()) return false;
+
+		CHFileHeader header;
+		std::memcpy(header.magic, CH_FILE_MAGIC, sizeof(header.magic));
+		header.version = CH_FILE_VERSION;
+		header.num_nodes = this->num_nodes;
+		header.num_up = static_cast<int32_t>(this->up_targets.size());
+		header.num_down = static_cast<int32_t>(this->down_targets.size());
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		WriteArray(out, this->rank);
+		WriteArray(out, this->up_offsets);
+		WriteArray(out, this->up_targets);
+		WriteArray(out, this->up_costs);
+		WriteArray(out, this->up_middles);
+		WriteArray(out, this->down_offsets);
+		WriteArray(out, this->down_targets);
+		WriteArray(out, this->down_costs);
+		WriteArray(out, this->down_middles);
+
+		return out.good();
+	}
+
+	ContractionHierarchy ContractionHierarchy::LoadBinary(const std::string& path)
+	{
+		std::ifstream in(path, std::ios::binary);
+		if (!in.good()) throw HF::Exceptions::FileNotFound();
+
+		// Check that this is actually a hierarchy file that we can read
+		CHFileHeader header;
+		in.read(reinterpret_cast<char*>(&header), sizeof(header));
+		if (!in.good() || std::memcmp(header.magic, CH_FILE_MAGIC, sizeof(header.magic)) != 0)
+			throw std::runtime_error(path + " is not a contraction hierarchy file");
+		if (header.version != CH_FILE_VERSION)
+			throw std::runtime_error(path + " was written with an unsupported version of the contraction hierarchy format");
+		if (header.num_nodes < 0 || header.num_up < 0 || header.num_down < 0)
+			throw std::runtime_error(path + " has an invalid header");
+
+		// Check the counts against the size of the file before allocating anything,
+		// so a corrupt header can't trigger a huge allocation
+		const uint64_t node_bytes = sizeof(int) * (3 * uint64_t(header.num_nodes) + 2);
+		const uint64_t arc_bytes = (2 * sizeof(int) + sizeof(float)) * (uint64_t(header.num_up) + uint64_t(header.num_down));
+		in.seekg(0, std::ios::end);
+		const uint64_t file_size = static_cast<uint64_t>(in.tellg());
+		in.seekg(sizeof(header), std::ios::beg);
+		if (file_size < sizeof(header) + node_bytes + arc_bytes)
+			throw std::runtime_error(path + " is truncated");
+
+		ContractionHierarchy ch;
+		ch.num_nodes = header.num_nodes;
+		ReadArray(in, ch.rank, header.num_nodes);
+		ReadArray(in, ch.up_offsets, header.num_nodes + 1);
+		ReadArray(in, ch.up_targets, header.num_up);
+		ReadArray(in, ch.up_costs, header.num_up);
+		ReadArray(in, ch.up_middles, header.num_up);
+		ReadArray(in, ch.down_offsets, header.num_nodes + 1);
+		ReadArray(in, ch.down_targets, header.num_down);
+		ReadArray(in, ch.down_costs, header.num_down);
+		ReadArray(in, ch.down_middles, header.num_down);
+
+		if (!in.good())
+			throw std::runtime_error(path + " is truncated");
+
+		// Queries index arrays with these without checking them, so make sure they're in range
+		for (int r : ch.rank)
+			if (r < 0 || r >= ch.num_nodes)
+				throw std::runtime_error(path + " contains an invalid rank");
+		if (!ValidArcs(ch.up_offsets, ch.up_targets, ch.up_middles, ch.num_nodes)
+			|| !ValidArcs(ch.down_offsets, ch.down_targets, ch.down_middles, ch.num_nodes))
+			throw std::runtime_error(path + " contains an edge to a node that doesn't exist");
+
+		return ch;
+	}
+}
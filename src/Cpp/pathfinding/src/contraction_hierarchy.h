@@ -0,0 +1,181 @@
+///
+///	\file		contraction_hierarchy.h
+/// \brief		Contains definition for the <see cref="HF::Pathfinding::ContractionHierarchy">ContractionHierarchy</see> class
+///
+///	\author		TBA
+///	\date		17 Jun 2020
+///
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace HF {
+	namespace SpatialStructures {
+		class Graph;
+		class Path;
+		class PathMember;
+	}
+
+	namespace Pathfinding {
+
+		/*!
+			\brief A contraction hierarchy built from one cost type of a graph for fast repeated path queries.
+
+			\details
+			Building the hierarchy contracts every node of the graph in order of importance, adding
+			shortcut edges between the node's neighbors wherever the node was on the only shortest
+			path between them. Every node is given a rank by the order it was contracted in.
+
+			Queries then run a bidirectional Dijkstra that only follows edges towards higher ranked
+			nodes from both ends, which settles a tiny fraction of the nodes a plain Dijkstra would.
+			Shortcuts in the result are unpacked back into the graph's original edges.
+
+			The hierarchy is a snapshot of the graph. It doesn't reference the graph after it's
+			built, and it must be rebuilt if the graph's edges or costs change. SaveBinary and
+			LoadBinary can be used to avoid rebuilding it every time the program starts.
+
+			Edges with a NaN cost (such as edges that don't have a value for an alternate cost type)
+			are ignored.
+
+			\remarks
+			Paths found by this have the same nodes and costs as those found by FindPath on a
+			BoostGraph of the same graph, though ties between equally short paths may be broken
+			differently.
+
+			\snippet tests\src\PathFinding.cpp EX_ContractionHierarchy
+		*/
+		class ContractionHierarchy {
+		private:
+			int num_nodes = 0;				///< Number of nodes in the graph this was built from.
+			std::vector<int> rank;			///< Order every node was contracted in.
+
+			std::vector<int> up_offsets;	///< Index of the first upward edge of every node.
+			std::vector<int> up_targets;	///< Higher ranked child of every upward edge.
+			std::vector<float> up_costs;	///< Cost of every upward edge.
+			std::vector<int> up_middles;	///< Node every upward shortcut skips over, or -1 for original edges.
+
+			std::vector<int> down_offsets;	///< Index of the first downward edge of every node.
+			std::vector<int> down_targets;	///< Higher ranked parent of every downward edge.
+			std::vector<float> down_costs;	///< Cost of every downward edge.
+			std::vector<int> down_middles;	///< Node every downward shortcut skips over, or -1 for original edges.
+
+			/*! \brief Create an empty hierarchy to be filled by LoadBinary. */
+			ContractionHierarchy() = default;
+
+			/*!
+				\brief Append the original edges that make up an edge of the hierarchy.
+
+				\param parent Parent of the edge.
+				\param child Child of the edge.
+				\param cost Cost of the edge.
+				\param middle Node the edge skips over, or -1 if it's an original edge.
+				\param out_nodes Child of every original edge is appended to this.
+				\param out_costs Cost of every original edge is appended to this.
+			*/
+			void Unpack(
+				int parent,
+				int child,
+				float cost,
+				int middle,
+				std::vector<int>& out_nodes,
+				std::vector<float>& out_costs
+			) const;
+
+		public:
+			/*!
+				\brief Build a contraction hierarchy for `cost_type` in `graph`.
+
+				\param graph Graph to build the hierarchy from. Must be compressed.
+				\param cost_type Cost type to use as edge weights. Leave blank for the graph's default cost.
+
+				\throws std::runtime_error `graph` isn't compressed.
+				\throws HF::Exceptions::NoCost `cost_type` doesn't exist in `graph`.
+				\throws std::invalid_argument An edge in `graph` has a negative cost.
+
+				\details
+				Nodes are contracted in order of their edge difference: the number of shortcuts
+				contracting them would add minus the number of edges they have, plus the number
+				of their neighbors that were already contracted. Shortcuts are only added if a
+				bounded witness search can't find another path that's as short.
+			*/
+			ContractionHierarchy(const HF::SpatialStructures::Graph& graph, const std::string& cost_type = "");
+
+			/*! \brief Get the number of nodes in the graph this was built from. */
+			int size() const;
+
+			/*! \brief Get the number of edges in the hierarchy, including shortcuts. */
+			int NumEdges() const;
+
+			/*!
+				\brief Find the shortest path from `start_id` to `end_id`.
+
+				\returns The shortest path from `start_id` to `end_id`, or an empty path if
+				no path exists or either id isn't in the graph.
+			*/
+			HF::SpatialStructures::Path FindPath(int start_id, int end_id) const;
+
+			/*!
+				\brief Find a path from every id in start_ids to the matching end node in end_ids in parallel.
+
+				\param start_ids Ordered list of starting points.
+				\param end_ids Ordered list of ending points.
+
+				\returns
+				An ordered array of paths matching the order of the pairs of start_id and end_id.
+				Paths that could not be generated will be returned as paths with no nodes.
+
+				\throws std::invalid_argument The lengths of `start_ids` and `end_ids` don't match.
+			*/
+			std::vector<HF::SpatialStructures::Path> FindPaths(
+				const std::vector<int>& start_ids,
+				const std::vector<int>& end_ids
+			) const;
+
+			/*!
+				\brief Find paths and write pointers to them into the output arrays.
+
+				\param start_ids Ordered list of starting points.
+				\param end_ids Ordered list of ending points.
+				\param out_paths Output array of pointers to paths. Paths that couldn't be found are nullptr.
+				\param out_path_members Output array of pointers to the members of each path.
+				\param out_sizes Output array for the size of each path. 0 for paths that couldn't be found.
+
+				\pre Every output array must be large enough to hold a value for every pair.
+			*/
+			void InsertPathsIntoArray(
+				const std::vector<int>& start_ids,
+				const std::vector<int>& end_ids,
+				HF::SpatialStructures::Path** out_paths,
+				HF::SpatialStructures::PathMember** out_path_members,
+				int* out_sizes
+			) const;
+
+			/*!
+				\brief Save this hierarchy to a binary file.
+
+				\param path Path to write the hierarchy to. Any existing file will be overwritten.
+
+				\returns True if the hierarchy was written successfully, false if the file couldn't be written.
+
+				\see LoadBinary to read a hierarchy written by this function.
+			*/
+			bool SaveBinary(const std::string& path) const;
+
+			/*!
+				\brief Load a hierarchy from a file written by SaveBinary.
+
+				\param path Path to the hierarchy file.
+
+				\returns The hierarchy stored in the file at `path`.
+
+				\throws HF::Exceptions::FileNotFound No file exists at `path`.
+				\throws std::runtime_error The file at `path` isn't a contraction hierarchy file, was
+				written with an unsupported version of the format, is truncated, or references
+				nodes that don't exist.
+			*/
+			static ContractionHierarchy LoadBinary(const std::string& path);
+		};
+	}
+}
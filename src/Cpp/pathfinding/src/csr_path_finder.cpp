@@ -0,0 +1,332 @@
+///
+///	\file		csr_path_finder.cpp
+/// \brief		Contains implementation for the <see cref="HF::Pathfinding::CSRPathFinder">CSRPathFinder</see> class
+///
+///	\author		TBA
+///	\date		17 Jun 2020
+///
+
+#include <csr_path_finder.h>
+
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+#include <graph.h>
+#include <path.h>
+
+using std::vector;
+using HF::SpatialStructures::Graph;
+using HF::SpatialStructures::Path;
+using HF::SpatialStructures::PathMember;
+using HF::SpatialStructures::CSRPtrs;
+
+namespace HF::Pathfinding {
+
+	constexpr float UNREACHED = std::numeric_limits<float>::infinity(); ///< Distance of nodes a search hasn't reached.
+	constexpr int NOT_IN_HEAP = -1;	///< Heap index of nodes that haven't been reached.
+	constexpr int SETTLED = -2;		///< Heap index of nodes whose shortest distance is known.
+	constexpr int HEAP_ARITY = 4;	///< Number of children of every node in the heap.
+
+	/*!
+		\brief Arrays reused by every search on a thread.
+
+		\details
+		The arrays only grow, and every search records the nodes it touched so only those entries
+		have to be reset before the next search. This keeps searches that stop early cheap on
+		large graphs.
+	*/
+	struct SearchScratch {
+		vector<float> dist;			///< Distance from the start to every node.
+		vector<int> pred;			///< Predecessor of every node. -1 if the node hasn't been reached.
+		vector<int> heap_index;		///< Index of every node in heap, NOT_IN_HEAP, or SETTLED.
+		vector<int> heap;			///< Nodes in the heap, ordered by dist.
+		vector<int> touched;		///< Every node whose entries were changed by the last search.
+
+		/*! \brief Grow the arrays to hold at least `n` nodes and clear the last search. */
+		inline void Prepare(int n) {
+			for (int node : touched) {
+				dist[node] = UNREACHED;
+				pred[node] = -1;
+				heap_index[node] = NOT_IN_HEAP;
+			}
+			touched.clear();
+			heap.clear();
+
+			if (dist.size() < static_cast<size_t>(n)) {
+				dist.resize(n, UNREACHED);
+				pred.resize(n, -1);
+				heap_index.resize(n, NOT_IN_HEAP);
+			}
+		}
+
+		/*! \brief Move the node at `pos` towards the root until its parent is closer than it. */
+		inline void SiftUp(int pos) {
+			const int node = heap[pos];
+			const float node_dist = dist[node];
+			while (pos > 0) {
+				const int parent_pos = (pos - 1) / HEAP_ARITY;
+				const int parent = heap[parent_pos];
+				if (dist[parent] <= node_dist) break;
+
+				heap[pos] = parent;
+				heap_index[parent] = pos;
+				pos = parent_pos;
+			}
+			heap[pos] = node;
+			heap_index[node] = pos;
+		}
+
+		/*! \brief Move the node at `pos` away from the root until all of its children are further than it. */
+		inline void SiftDown(int pos) {
+			const int size = static_cast<int>(heap.size());
+			const int node = heap[pos];
+			const float node_dist = dist[node];
+			while (true) {
+				const int first_child = pos * HEAP_ARITY + 1;
+				if (first_child >= size) break;
+
+				// Find the closest child
+				const int last_child = std::min(first_child + HEAP_ARITY, size);
+				int best_pos = first_child;
+				for (int child_pos = first_child + 1; child_pos < last_child; child_pos++)
+					if (dist[heap[child_pos]] < dist[heap[best_pos]])
+						best_pos = child_pos;
+
+				if (node_dist <= dist[heap[best_pos]]) break;
+
+				heap[pos] = heap[best_pos];
+				heap_index[heap[pos]] = pos;
+				pos = best_pos;
+			}
+			heap[pos] = node;
+			heap_index[node] = pos;
+		}
+
+		/*! \brief Add `node` to the heap. */
+		inline void Push(int node) {
+			heap.push_back(node);
+			SiftUp(static_cast<int>(heap.size()) - 1);
+		}
+
+		/*! \brief Remove the closest node from the heap and mark it as settled. */
+		inline int PopMin() {
+			const int node = heap[0];
+			heap_index[node] = SETTLED;
+
+			const int last = heap.back();
+			heap.pop_back();
+			if (!heap.empty()) {
+				heap[0] = last;
+				SiftDown(0);
+			}
+			return node;
+		}
+	};
+
+	/*! \brief Get this thread's scratch arrays. */
+	inline SearchScratch& ThreadScratch() {
+		thread_local SearchScratch scratch;
+		return scratch;
+	}
+
+	/*!
+		\brief Construct the shortest path from start to end from the arrays of a search.
+
+		\param start ID of the starting point.
+		\param end ID of the end point.
+		\param dist Distance array of the search.
+		\param pred Predecessor array of the search.
+
+		\returns The path from start to end, or an empty path if end wasn't reached or is start.
+
+		\remarks Costs are calculated the same way as ConstructShortestPathFromPred so paths
+		match those of a BoostGraph exactly.
+	*/
+	inline Path ConstructPathFromScratch(int start, int end, const vector<float>& dist, const vector<int>& pred) {
+		if (start == end || pred[end] == -1) return Path{};
+
+		Path p;
+		p.AddNode(end, 0);
+
+		int current_node = end;
+		float last_cost = dist[end];
+		while (current_node != start) {
+			const int next_node = pred[current_node];
+			const float current_cost = dist[next_node];
+
+			p.AddNode(next_node, last_cost - current_cost);
+
+			last_cost = current_cost;
+			current_node = next_node;
+		}
+
+		p.Reverse();
+		return p;
+	}
+
+	CSRPathFinder::CSRPathFinder(const Graph& graph, const std::string& cost_type) {
+		// Throws if the graph isn't compressed or the cost doesn't exist
+		const CSRPtrs csr = graph.GetCSRPointers(cost_type);
+
+		this->num_nodes = csr.rows;
+		this->outer_indices = csr.outer_indices;
+		this->inner_indices = csr.inner_indices;
+		this->costs = csr.data;
+	}
+
+	int CSRPathFinder::size() const { return this->num_nodes; }
+
+	template <typename visit_func>
+	void CSRPathFinder::Search(int start, const vector<int>& targets, visit_func& visit) const
+	{
+		SearchScratch& s = ThreadScratch();
+		s.Prepare(this->num_nodes);
+
+		s.dist[start] = 0;
+		s.pred[start] = start;
+		s.touched.push_back(start);
+		s.Push(start);
+
+		int remaining_targets = static_cast<int>(targets.size());
+		while (!s.heap.empty()) {
+			const int parent = s.PopMin();
+
+			// Stop once every target is settled
+			if (!targets.empty() && std::binary_search(targets.begin(), targets.end(), parent))
+				if (--remaining_targets == 0) break;
+
+			const float parent_dist = s.dist[parent];
+			for (int edge = this->outer_indices[parent]; edge < this->outer_indices[parent + 1]; edge++) {
+				const int child = this->inner_indices[edge];
+				const float cost = this->costs[edge];
+
+				// Skip settled nodes and edges that don't exist for this cost type
+				if (s.heap_index[child] == SETTLED || std::isnan(cost)) continue;
+
+				const float child_dist = parent_dist + cost;
+				if (child_dist < s.dist[child]) {
+					s.dist[child] = child_dist;
+					s.pred[child] = parent;
+
+					if (s.heap_index[child] == NOT_IN_HEAP) {
+						s.touched.push_back(child);
+						s.Push(child);
+					}
+					else
+						s.SiftUp(s.heap_index[child]);
+				}
+			}
+		}
+
+		visit(s.dist, s.pred);
+	}
+
+	Path CSRPathFinder::FindPath(int start_id, int end_id) const
+	{
+		if (start_id < 0 || start_id >= this->num_nodes || end_id < 0 || end_id >= this->num_nodes)
+			return Path{};
+
+		Path out_path;
+		auto build_path = [&](const vector<float>& dist, const vector<int>& pred) {
+			out_path = ConstructPathFromScratch(start_id, end_id, dist, pred);
+		};
+		this->Search(start_id, vector<int>{ end_id }, build_path);
+
+		return out_path;
+	}
+
+	vector<Path> CSRPathFinder::FindPaths(const vector<int>& start_ids, const vector<int>& end_ids) const
+	{
+		if (start_ids.size() != end_ids.size())
+			throw std::invalid_argument("Tried to find paths with different numbers of start and end points");
+
+		vector<Path> paths(start_ids.size());
+
+		// Sort the pairs by their start point so every unique start is searched once
+		vector<int> order(start_ids.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [&start_ids](int a, int b) {
+			return start_ids[a] < start_ids[b];
+		});
+
+		// Mark where each group of pairs with the same start point begins
+		vector<int> group_begin;
+		for (int i = 0; i < static_cast<int>(order.size()); i++)
+			if (i == 0 || start_ids[order[i]] != start_ids[order[i - 1]])
+				group_begin.push_back(i);
+		group_begin.push_back(static_cast<int>(order.size()));
+
+		const int num_groups = static_cast<int>(group_begin.size()) - 1;
+
+	#pragma omp parallel for schedule(dynamic)
+		for (int group = 0; group < num_groups; group++) {
+			const int start = start_ids[order[group_begin[group]]];
+			if (start < 0 || start >= this->num_nodes) continue;
+
+			// Every end point of this start that's in the graph, sorted for the search
+			vector<int> targets;
+			for (int i = group_begin[group]; i < group_begin[group + 1]; i++) {
+				const int end = end_ids[order[i]];
+				if (end >= 0 && end < this->num_nodes)
+					targets.push_back(end);
+			}
+			std::sort(targets.begin(), targets.end());
+			targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+			if (targets.empty()) continue;
+
+			auto build_paths = [&](const vector<float>& dist, const vector<int>& pred) {
+				for (int i = group_begin[group]; i < group_begin[group + 1]; i++) {
+					const int end = end_ids[order[i]];
+					if (end >= 0 && end < this->num_nodes)
+						paths[order[i]] = ConstructPathFromScratch(start, end, dist, pred);
+				}
+			};
+			this->Search(start, targets, build_paths);
+		}
+
+		return paths;
+	}
+
+	void CSRPathFinder::InsertPathsIntoArray(
+		const vector<int>& start_ids,
+		const vector<int>& end_ids,
+		Path** out_paths,
+		PathMember** out_path_members,
+		int* out_sizes
+	) const {
+		vector<Path> paths = this->FindPaths(start_ids, end_ids);
+
+		for (int i = 0; i < static_cast<int>(paths.size()); i++) {
+			// Paths that couldn't be found are represented by null pointers
+			if (paths[i].empty()) {
+				out_paths[i] = nullptr;
+				out_path_members[i] = nullptr;
+				out_sizes[i] = 0;
+			}
+			else {
+				out_paths[i] = new Path(std::move(paths[i]));
+				out_path_members[i] = out_paths[i]->GetPMPointer();
+				out_sizes[i] = out_paths[i]->size();
+			}
+		}
+	}
+
+	void CSRPathFinder::DistanceAndPredecessorRow(int start_id, float* out_dist, int* out_pred) const
+	{
+		if (start_id < 0 || start_id >= this->num_nodes)
+			throw std::out_of_range("Start node " + std::to_string(start_id) + " isn't in the graph");
+
+		auto copy_row = [&](const vector<float>& dist, const vector<int>& pred) {
+			for (int node = 0; node < this->num_nodes; node++) {
+				const bool reached = pred[node] != -1;
+				out_dist[node] = reached ? dist[node] : -1.0f;
+				out_pred[node] = (reached && node != start_id) ? pred[node] : -1;
+			}
+		};
+		this->Search(start_id, vector<int>{}, copy_row);
+	}
+}
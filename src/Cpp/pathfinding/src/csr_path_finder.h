@@ -0,0 +1,154 @@
+///
+///	\file		csr_path_finder.h
+/// \brief		Contains definition for the <see cref="HF::Pathfinding::CSRPathFinder">CSRPathFinder</see> class
+///
+///	\author		TBA
+///	\date		17 Jun 2020
+///
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace HF {
+	namespace SpatialStructures {
+		class Graph;
+		class Path;
+		class PathMember;
+	}
+
+	namespace Pathfinding {
+
+		/*!
+			\brief Finds shortest paths directly in the CSR of a HF::SpatialStructures::Graph.
+
+			\details
+			Unlike BoostGraph, this doesn't copy the graph. It only holds pointers to the graph's
+			compressed outer index, inner index, and cost arrays, so constructing one is free and
+			no memory is needed beyond the scratch space of each search. Searches use Dijkstra's
+			algorithm with an indexed 4-ary heap. Each thread keeps its own scratch arrays between
+			searches, and only the entries a search touched are reset afterwards, so a query that
+			settles k nodes costs O(k log k) instead of O(N).
+
+			Edges with a NaN cost (such as edges that don't have a value for an alternate cost type)
+			are ignored.
+
+			\warning
+			The pathfinder reads the graph's memory directly, so the graph must outlive it and must
+			not be modified while it's in use. Create a new CSRPathFinder after the graph is changed.
+
+			\remarks
+			Paths found by this have the same cost as those found by FindPath and FindPaths on a
+			BoostGraph of the same graph, though ties between equally short paths may be broken
+			differently.
+
+			\snippet tests\src\PathFinding.cpp EX_CSRPathFinder
+		*/
+		class CSRPathFinder {
+		private:
+			int num_nodes = 0;						///< Number of rows in the CSR.
+			const int* outer_indices = nullptr;		///< Index of the first edge of every node in inner_indices.
+			const int* inner_indices = nullptr;		///< Child of every edge.
+			const float* costs = nullptr;			///< Cost of every edge.
+
+			/*!
+				\brief Run dijkstra from `start` until every node in `targets` is settled.
+
+				\param start Node to start the search from.
+				\param targets Nodes to stop at. If empty, the search continues until every
+				reachable node is settled.
+				\param visit Called with the distance and predecessor arrays of the search before
+				they're reset.
+			*/
+			template <typename visit_func>
+			void Search(int start, const std::vector<int>& targets, visit_func& visit) const;
+
+		public:
+			/*!
+				\brief Create a pathfinder for `cost_type` in `graph`.
+
+				\param graph Graph to find paths in. Must be compressed.
+				\param cost_type Cost type to use as edge weights. Leave blank for the graph's default cost.
+
+				\throws std::runtime_error `graph` isn't compressed.
+				\throws HF::Exceptions::NoCost `cost_type` doesn't exist in `graph`.
+			*/
+			CSRPathFinder(const HF::SpatialStructures::Graph& graph, const std::string& cost_type = "");
+
+			/*!
+				\brief Get the number of rows in the CSR this searches.
+
+				\details
+				The graph keeps one more row than it has nodes, so this is at least Graph::size() + 1.
+				The extra row has no edges and is never reached by a search.
+			*/
+			int size() const;
+
+			/*!
+				\brief Find the shortest path from `start_id` to `end_id`.
+
+				\returns The shortest path from `start_id` to `end_id`, or an empty path if
+				no path exists or either id isn't in the graph.
+
+				\details The search stops as soon as `end_id` is settled.
+			*/
+			HF::SpatialStructures::Path FindPath(int start_id, int end_id) const;
+
+			/*!
+				\brief Find a path from every id in start_ids to the matching end node in end_ids.
+
+				\param start_ids Ordered list of starting points.
+				\param end_ids Ordered list of ending points.
+
+				\returns
+				An ordered array of paths matching the order of the pairs of start_id and end_id.
+				Paths that could not be generated will be returned as paths with no nodes.
+
+				\details
+				Runs one search for every unique start point in parallel. Each search stops once
+				every end point paired with its start point is settled.
+
+				\throws std::invalid_argument The lengths of `start_ids` and `end_ids` don't match.
+			*/
+			std::vector<HF::SpatialStructures::Path> FindPaths(
+				const std::vector<int>& start_ids,
+				const std::vector<int>& end_ids
+			) const;
+
+			/*!
+				\brief Find paths and write pointers to them into the output arrays.
+
+				\param start_ids Ordered list of starting points.
+				\param end_ids Ordered list of ending points.
+				\param out_paths Output array of pointers to paths. Paths that couldn't be found are nullptr.
+				\param out_path_members Output array of pointers to the members of each path.
+				\param out_sizes Output array for the size of each path. 0 for paths that couldn't be found.
+
+				\pre Every output array must be large enough to hold a value for every pair.
+
+				\see InsertPathsIntoArray for the BoostGraph equivalent.
+			*/
+			void InsertPathsIntoArray(
+				const std::vector<int>& start_ids,
+				const std::vector<int>& end_ids,
+				HF::SpatialStructures::Path** out_paths,
+				HF::SpatialStructures::PathMember** out_path_members,
+				int* out_sizes
+			) const;
+
+			/*!
+				\brief Calculate the distance and predecessor of every node from `start_id`.
+
+				\param start_id Node to start from.
+				\param out_dist Output array of size() distances, including the graph's extra
+				row. Unreachable nodes are set to -1.
+				\param out_pred Output array of size() predecessors. Unreachable nodes and
+				`start_id` are set to -1.
+
+				\throws std::out_of_range `start_id` isn't in the graph.
+			*/
+			void DistanceAndPredecessorRow(int start_id, float* out_dist, int* out_pred) const;
+		};
+	}
+}
@@ -0,0 +1,171 @@
+///
+///	\file		distance_matrix.cpp
+/// \brief		Contains implementation for generating all-pairs distance matrices in tiles
+///
+///	\author		TBA
+///	\date		17 Jun 2020
+///
+
+#include <path_finder.h>
+
+#include <omp.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+#include <boost/graph/dijkstra_shortest_paths_no_color_map.hpp>
+
+#include <boost_graph.h>
+
+using std::vector;
+
+namespace HF::Pathfinding {
+
+	constexpr char DISTANCE_FILE_MAGIC[8] = { 'D', 'H', 'A', 'R', 'T', 'D', 'M', '\0' }; ///< First bytes of every distance matrix file.
+	constexpr uint32_t DISTANCE_FILE_VERSION = 1; ///< Version of the distance matrix format written by WriteDistanceMatrix.
+
+	/*! \brief The first section of every distance matrix file. It's followed by every row of the matrix. */
+	struct DistanceFileHeader {
+		char magic[8];			///< Must match DISTANCE_FILE_MAGIC.
+		uint32_t version;		///< Version of the format this file was written with.
+		uint32_t format;		///< DISTANCE_FORMAT of every value in the file.
+		uint32_t num_nodes;		///< Number of nodes in the graph.
+		uint32_t upper_triangle;///< 1 if only the upper triangle of the matrix is stored.
+		float scale;			///< Distance represented by 1 in the UINT16 format.
+		uint32_t reserved;		///< Unused. Keeps the header a multiple of 8 bytes.
+	};
+
+	/*!
+		\brief Convert a distance calculated by boost to the type it will be stored as.
+
+		\param distance Distance calculated by boost. Unreachable nodes are set to the maximum float.
+		\param inv_scale 1 divided by the scale of the UINT16 format.
+		\param out Location to store the converted distance.
+	*/
+	inline void StoreDistance(float distance, float /*inv_scale*/, float& out) {
+		out = (distance == std::numeric_limits<float>::max()) ? -1.0f : distance;
+	}
+
+	/*! \copydoc StoreDistance(float, float, float&) */
+	inline void StoreDistance(float distance, float inv_scale, uint16_t& out) {
+		if (distance == std::numeric_limits<float>::max())
+			out = UNREACHABLE_UINT16;
+		else
+			out = static_cast<uint16_t>(std::min(std::round(distance * inv_scale), static_cast<float>(MAX_UINT16_DISTANCE)));
+	}
+
+	/*!
+		\brief Generate distances in tiles stored as `value_type`.
+
+		\tparam value_type float for FLOAT32 or uint16_t for UINT16.
+
+		\see GenerateDistanceTiles for details on the parameters.
+	*/
+	template <typename value_type>
+	void GenerateTypedDistanceTiles(
+		const BoostGraph& bg,
+		const std::function<void(const DistanceTile&)>& sink,
+		DISTANCE_FORMAT format,
+		float scale,
+		bool upper_triangle,
+		int tile_rows)
+	{
+		const auto& g = bg.g;
+		const int num_nodes = bg.p.size();
+		const float inv_scale = 1.0f / scale;
+
+		// The largest tile is the first one, so it never has to be reallocated
+		vector<value_type> tile_values(size_t(std::min(tile_rows, num_nodes)) * num_nodes);
+
+		for (int first_row = 0; first_row < num_nodes; first_row += tile_rows) {
+			DistanceTile tile;
+			tile.first_row = first_row;
+			tile.num_rows = std::min(tile_rows, num_nodes - first_row);
+			tile.num_nodes = num_nodes;
+			tile.upper_triangle = upper_triangle;
+			tile.format = format;
+			tile.scale = scale;
+			tile.data = tile_values.data();
+			tile.num_values = tile.num_rows > 0 ? tile.RowOffset(first_row + tile.num_rows - 1) + tile.RowLength(first_row + tile.num_rows - 1) : 0;
+
+			#pragma omp parallel
+			{
+				// Each thread gets its own row for boost to write distances into
+				vector<float> distances(num_nodes);
+
+				#pragma omp for schedule(dynamic)
+				for (int row = first_row; row < first_row + tile.num_rows; row++) {
+
+					// Only distances are needed, so boost can discard predecessors
+					dijkstra_shortest_paths_no_color_map(
+						g,
+						vertex(row, g),
+						boost::distance_map(distances.data()).weight_map(boost::get(&Edge_Cost::weight, g))
+					);
+
+					// Copy this row's columns into its place in the tile
+					const int first_col = upper_triangle ? row + 1 : 0;
+					value_type* out_row = tile_values.data() + tile.RowOffset(row);
+					for (int col = first_col; col < num_nodes; col++)
+						StoreDistance(distances[col], inv_scale, out_row[col - first_col]);
+				}
+			}
+
+			sink(tile);
+		}
+	}
+
+	void GenerateDistanceTiles(
+		const BoostGraph& bg,
+		const std::function<void(const DistanceTile&)>& sink,
+		DISTANCE_FORMAT format,
+		float scale,
+		bool upper_triangle,
+		int tile_rows)
+	{
+		if (tile_rows < 1)
+			throw std::out_of_range("Distance tiles must contain at least one row");
+		if (format == UINT16 && !(scale > 0))
+			throw std::out_of_range("Scale of quantized distances must be greater than zero");
+
+		if (format == UINT16)
+			GenerateTypedDistanceTiles<uint16_t>(bg, sink, format, scale, upper_triangle, tile_rows);
+		else
+			GenerateTypedDistanceTiles<float>(bg, sink, format, scale, upper_triangle, tile_rows);
+	}
+
+	bool WriteDistanceMatrix(
+		const BoostGraph& bg,
+		const std::string& path,
+		DISTANCE_FORMAT format,
+		float scale,
+		bool upper_triangle,
+		int tile_rows)
+	{
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		if (!out.good()) return false;
+
+		DistanceFileHeader header;
+		std::memcpy(header.magic, DISTANCE_FILE_MAGIC, sizeof(header.magic));
+		header.version = DISTANCE_FILE_VERSION;
+		header.format = static_cast<uint32_t>(format);
+		header.num_nodes = static_cast<uint32_t>(bg.p.size());
+		header.upper_triangle = upper_triangle ? 1 : 0;
+		header.scale = scale;
+		header.reserved = 0;
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		const size_t value_size = (format == UINT16) ? sizeof(uint16_t) : sizeof(float);
+		GenerateDistanceTiles(
+			bg,
+			[&out, value_size](const DistanceTile& tile) {
+				out.write(static_cast<const char*>(tile.data), tile.num_values * value_size);
+			},
+			format, scale, upper_triangle, tile_rows
+		);
+
+		return out.good();
+	}
+}
@@ -15,12 +15,17 @@
 #include<math.h>
 #include<execution>
 #include <memory>
+#include <queue>
+#include <numeric>
+#include <limits>
+#include <functional>
 
 #include <boost/graph/dijkstra_shortest_paths.hpp>
 #include <boost/graph/breadth_first_search.hpp>
 #include <boost/graph/dijkstra_shortest_paths_no_color_map.hpp>
 #include <boost/exception/exception.hpp>
 #include <boost/math/special_functions/fpclassify.hpp>
+#include <boost/range/iterator_range.hpp>
 
 #include <boost_graph.h>
 #include <path.h>
@@ -175,6 +180,295 @@ namespace HF::Pathfinding {
 		return ConstructShortestPathFromPred(start_id, end_id, dist_pred.predecessor, dist_pred.distance);
 	}
 
+	/*!
+		\brief An entry in the open set of a point to point search.
+
+		\details
+		Ordered by cost so a std::priority_queue using std::greater will always pop the
+		entry with the lowest cost first. Entries are never updated in place, instead
+		a new entry is pushed whenever a node's cost decreases and any stale entries
+		are skipped when popped.
+	*/
+	struct QueueEntry {
+		float cost;					///< Cost used to order this entry in the queue.
+		vertex_descriptor node;		///< Node this entry is for.
+
+		/*! \brief Compare the cost of two entries. */
+		inline bool operator>(const QueueEntry& e2) const { return cost > e2.cost; }
+	};
+
+	/*! \brief A priority queue that always pops the QueueEntry with the lowest cost. */
+	using MinQueue = std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>>;
+
+	/*!
+		\brief Create a DistPred for a point to point search.
+
+		\param n Number of nodes in the graph.
+
+		\returns A DistPred with every distance set to infinity, and every node set as its own
+				 predecessor, matching the output of boost for nodes that weren't reached.
+	*/
+	inline DistPred CreateUnreachedDistPred(int n) {
+		DistPred dist_pred(n);
+		std::fill(dist_pred.distance.begin(), dist_pred.distance.end(), std::numeric_limits<float>::infinity());
+		std::iota(dist_pred.predecessor.begin(), dist_pred.predecessor.end(), 0);
+		return dist_pred;
+	}
+
+	/*!
+		\brief Get the straight line distance between two nodes.
+
+		\returns The distance between `a` and `b`, or 0 if either node doesn't have a position.
+	*/
+	inline float StraightLineDistance(const std::array<float, 3>& a, const std::array<float, 3>& b) {
+		const float dist = sqrtf(powf(a[0] - b[0], 2) + powf(a[1] - b[1], 2) + powf(a[2] - b[2], 2));
+		return std::isfinite(dist) ? dist : 0.0f;
+	}
+
+	/*! \brief Check that an ID is within the range of vertices in g. */
+	inline bool IsInGraph(const graph_t& g, int id) {
+		return id >= 0 && id < static_cast<int>(num_vertices(g));
+	}
+
+	Path FindPathAStar(BoostGraph* bg, int start_id, int end_id)
+	{
+		const graph_t& graph = bg->g;
+		if (!IsInGraph(graph, start_id) || !IsInGraph(graph, end_id)) return Path{};
+
+		// Set every node to unreached
+		const int n = num_vertices(graph);
+		DistPred dist_pred = CreateUnreachedDistPred(n);
+		auto& dist = dist_pred.distance;
+		auto& pred = dist_pred.predecessor;
+		std::vector<char> closed(n, 0);
+
+		// Estimate the remaining cost from a node using its distance to the goal
+		const auto& positions = bg->positions;
+		const auto& goal = positions[end_id];
+		const auto heuristic = [&positions, &goal](vertex_descriptor node) {
+			return StraightLineDistance(positions[node], goal);
+		};
+
+		MinQueue open;
+		dist[start_id] = 0;
+		open.push(QueueEntry{ heuristic(start_id), static_cast<vertex_descriptor>(start_id) });
+
+		while (!open.empty()) {
+			const vertex_descriptor current = open.top().node;
+			open.pop();
+
+			// Skip stale entries for nodes that were already settled
+			if (closed[current]) continue;
+			closed[current] = 1;
+
+			// Once the goal is settled its cost can't get any lower
+			if (current == end_id) break;
+
+			for (const auto& edge : boost::make_iterator_range(out_edges(current, graph))) {
+				const vertex_descriptor child = target(edge, graph);
+				if (closed[child]) continue;
+
+				// Only push the child if this is cheaper than any other way we've found to reach it
+				const float cost = dist[current] + graph[edge].weight;
+				if (cost < dist[child]) {
+					dist[child] = cost;
+					pred[child] = current;
+					open.push(QueueEntry{ cost + heuristic(child), child });
+				}
+			}
+		}
+
+		return ConstructShortestPathFromPred(start_id, end_id, dist_pred);
+	}
+
+	Path FindPathBidirectional(BoostGraph* bg, int start_id, int end_id)
+	{
+		const graph_t& forward_graph = bg->g;
+		if (!IsInGraph(forward_graph, start_id) || !IsInGraph(forward_graph, end_id) || start_id == end_id)
+			return Path{};
+
+		// The backward search walks the in edges of every node, which are the out edges of the reversed graph
+		const graph_t& backward_graph = bg->Reverse();
+
+		// The backward search's predecessor array holds the next node on the path to end_id
+		const int n = num_vertices(forward_graph);
+		DistPred forward = CreateUnreachedDistPred(n);
+		DistPred backward = CreateUnreachedDistPred(n);
+		std::vector<char> forward_closed(n, 0);
+		std::vector<char> backward_closed(n, 0);
+		MinQueue forward_open, backward_open;
+
+		forward.distance[start_id] = 0;
+		backward.distance[end_id] = 0;
+		forward_open.push(QueueEntry{ 0, static_cast<vertex_descriptor>(start_id) });
+		backward_open.push(QueueEntry{ 0, static_cast<vertex_descriptor>(end_id) });
+
+		// Cost of the best path found so far, and the edge in the original graph where
+		// the forward and backward halves of that path meet
+		float best_cost = std::numeric_limits<float>::infinity();
+		vertex_descriptor meet_parent = 0, meet_child = 0;
+		float meet_weight = 0;
+
+		// Settle the cheapest node from one direction and relax all of its edges
+		const auto step = [&](const graph_t& g, MinQueue& open, DistPred& this_side, std::vector<char>& closed, const DistPred& other_side, bool is_forward) {
+			const vertex_descriptor current = open.top().node;
+			open.pop();
+
+			if (closed[current]) return;
+			closed[current] = 1;
+
+			for (const auto& edge : boost::make_iterator_range(out_edges(current, g))) {
+				const vertex_descriptor child = target(edge, g);
+				const float weight = g[edge].weight;
+				const float cost = this_side.distance[current] + weight;
+
+				if (cost < this_side.distance[child]) {
+					this_side.distance[child] = cost;
+					this_side.predecessor[child] = current;
+					open.push(QueueEntry{ cost, child });
+				}
+
+				// If the other search has reached the child, check if the path through this edge
+				// is better than the best one found so far
+				const float through_cost = cost + other_side.distance[child];
+				if (through_cost < best_cost) {
+					best_cost = through_cost;
+					meet_parent = is_forward ? current : child;
+					meet_child = is_forward ? child : current;
+					meet_weight = weight;
+				}
+			}
+		};
+
+		// Stop once the cheapest unsettled nodes of both searches can't form a better path
+		while (!forward_open.empty() && !backward_open.empty()
+			&& forward_open.top().cost + backward_open.top().cost < best_cost)
+		{
+			if (forward_open.top().cost <= backward_open.top().cost)
+				step(forward_graph, forward_open, forward, forward_closed, backward, true);
+			else
+				step(backward_graph, backward_open, backward, backward_closed, forward, false);
+		}
+
+		if (!std::isfinite(best_cost)) return Path{};
+
+		// Connect the backward half of the path onto the end of the forward half, then
+		// follow the backward search's predecessors to the end
+		forward.predecessor[meet_child] = meet_parent;
+		forward.distance[meet_child] = forward.distance[meet_parent] + meet_weight;
+		for (vertex_descriptor current = meet_child; current != end_id;) {
+			const vertex_descriptor next = backward.predecessor[current];
+			forward.predecessor[next] = current;
+			forward.distance[next] = forward.distance[current] + (backward.distance[current] - backward.distance[next]);
+			current = next;
+		}
+
+		return ConstructShortestPathFromPred(start_id, end_id, forward);
+	}
+
+	/*!
+		\brief Run Dijkstra's algorithm from several sources at once.
+
+		\param g Graph to search.
+		\param source_ids IDs of every source. IDs that aren't in g are ignored.
+		\param max_cost Stop once the cheapest node left costs more than this. Ignored if negative.
+		\param on_settle Called with the ID of every node once its cost is final, in order of increasing cost.
+
+		\returns A NearestSources with every node that wasn't reached set to infinity.
+	*/
+	template <typename settle_func>
+	inline NearestSources SearchFromSources(const graph_t& g, const vector<int>& source_ids, float max_cost, settle_func&& on_settle)
+	{
+		const int n = num_vertices(g);
+		NearestSources result;
+		result.distance.resize(n, std::numeric_limits<float>::infinity());
+		result.source.resize(n, -1);
+		result.predecessor.resize(n, -1);
+		std::vector<char> closed(n, 0);
+
+		// Every source starts with a cost of zero and is labeled as its own source
+		MinQueue open;
+		for (int id : source_ids) {
+			if (!IsInGraph(g, id)) continue;
+			result.distance[id] = 0;
+			result.source[id] = id;
+			result.predecessor[id] = id;
+			open.push(QueueEntry{ 0, static_cast<vertex_descriptor>(id) });
+		}
+
+		const bool has_cutoff = max_cost >= 0;
+		while (!open.empty()) {
+			const QueueEntry entry = open.top();
+			open.pop();
+
+			// Every node left is farther than the cutoff
+			if (has_cutoff && entry.cost > max_cost) break;
+
+			const vertex_descriptor current = entry.node;
+			if (closed[current]) continue;
+			closed[current] = 1;
+			on_settle(current);
+
+			for (const auto& edge : boost::make_iterator_range(out_edges(current, g))) {
+				const vertex_descriptor child = target(edge, g);
+				if (closed[child]) continue;
+
+				// Children inherit the source of the cheapest parent that reaches them
+				const float cost = result.distance[current] + g[edge].weight;
+				if (cost < result.distance[child]) {
+					result.distance[child] = cost;
+					result.source[child] = result.source[current];
+					result.predecessor[child] = current;
+					open.push(QueueEntry{ cost, child });
+				}
+			}
+		}
+
+		return result;
+	}
+
+	NearestSources FindNearestSources(BoostGraph* bg, const vector<int>& source_ids, float max_cost, bool reverse)
+	{
+		const graph_t& graph = reverse ? bg->Reverse() : bg->g;
+
+		// Keep track of which nodes were settled, since nodes past the cutoff may still have been given a cost
+		std::vector<char> settled(num_vertices(graph), 0);
+		NearestSources result = SearchFromSources(graph, source_ids, max_cost, [&settled](vertex_descriptor node) {
+			settled[node] = 1;
+		});
+
+		// Clear every node that wasn't reached within the cutoff
+		for (int i = 0; i < settled.size(); i++) {
+			if (!settled[i]) {
+				result.distance[i] = -1;
+				result.source[i] = -1;
+				result.predecessor[i] = -1;
+			}
+		}
+
+		return result;
+	}
+
+	vector<ReachableNode> FindReachable(BoostGraph* bg, const vector<int>& source_ids, float max_cost, bool reverse)
+	{
+		const graph_t& graph = reverse ? bg->Reverse() : bg->g;
+
+		// Nodes are settled in order of cost, so they can be stored in order as they're found. Costs
+		// and sources are filled in once the search is complete, since they're final once settled.
+		vector<int> settled;
+		const NearestSources result = SearchFromSources(graph, source_ids, max_cost, [&settled](vertex_descriptor node) {
+			settled.push_back(node);
+		});
+
+		vector<ReachableNode> reachable(settled.size());
+		for (int i = 0; i < settled.size(); i++) {
+			const int node = settled[i];
+			reachable[i] = ReachableNode{ node, result.distance[node], result.source[node] };
+		}
+
+		return reachable;
+	}
+
 	vector<Path> FindPaths( BoostGraph * bg, const vector<int> & start_points, const vector<int> & end_points)
 	{
 		// Get the graph from bg
@@ -12,6 +12,8 @@
 #include <cassert>
 #include <iostream>
 #include <cmath>
+#include <cstdint>
+#include <functional>
 
 namespace HF {
 	// Forward declares so we don't need to include these in the header.
@@ -211,6 +213,129 @@ namespace HF {
 			\endcode
 		*/
 		HF::SpatialStructures::Path FindPath(BoostGraph * bg, int start_id, int end_id);
+
+		/*!
+			\brief Find a path between points A and B using A* with a straight line heuristic.
+
+			\param bg The boost graph containing edges/nodes.
+			\param start_id ID of the starting node.
+			\param end_id ID of the ending node.
+
+			\returns The shortest path between A and B. If no path could be found, the path will be empty.
+
+			\details
+			Unlike FindPath, this stops as soon as the end node is settled rather than building a full
+			predecessor array for the start node, and explores nodes in the direction of the end node
+			first by using the straight line distance from each node to the end node as a lower bound
+			on the remaining cost. On large graphs this only visits a small fraction of the nodes that
+			FindPath would.
+
+			\pre The cost of every edge in `bg` must be greater than or equal to the straight line distance
+			between its parent and child, such as the default "Distance" cost of a generated graph. If this
+			isn't the case the returned path may not be the shortest path. Use FindPathBidirectional for
+			any other cost type.
+
+			\remarks
+			Nodes without a position (such as those added to the graph by ID only) are given a heuristic of 0,
+			and are searched the same way Dijkstra's algorithm would.
+
+			\see FindPathBidirectional for an alternative that works with any cost type.
+
+			\par Example
+			\snippet tests\src\Pathfinding.cpp EX_FindPathAStar
+		*/
+		HF::SpatialStructures::Path FindPathAStar(BoostGraph * bg, int start_id, int end_id);
+
+		/*!
+			\brief Find a path between points A and B using bidirectional Dijkstra.
+
+			\param bg The boost graph containing edges/nodes.
+			\param start_id ID of the starting node.
+			\param end_id ID of the ending node.
+
+			\returns The shortest path between A and B. If no path could be found, the path will be empty.
+
+			\details
+			Runs a forward search from the start node and a backward search from the end node at the same
+			time, stopping once the best path found through a node settled by both searches can no longer
+			be improved. Unlike FindPathAStar this has no requirements on the cost type of `bg`, other than
+			that edge costs must not be negative.
+
+			\remarks
+			The backward search uses BoostGraph::Reverse, which is built on the first call and then reused
+			by all future calls on the same BoostGraph.
+
+			\par Example
+			\snippet tests\src\Pathfinding.cpp EX_FindPathBidirectional
+		*/
+		HF::SpatialStructures::Path FindPathBidirectional(BoostGraph * bg, int start_id, int end_id);
+
+		/*!
+			\brief The cost from the nearest of several sources to every node in a graph.
+
+			\details
+			Every array has an element for every node in the graph, indexed by ID.
+		*/
+		struct NearestSources {
+			std::vector<float> distance;	///< Cost to reach each node from its nearest source. -1 for nodes that weren't reached.
+			std::vector<int> source;		///< ID of the nearest source to each node. -1 for nodes that weren't reached.
+			std::vector<int> predecessor;	///< ID of the node before each node on the path from its nearest source. Sources are their own predecessor, and nodes that weren't reached are -1.
+		};
+
+		/*! \brief A node reached by FindReachable. */
+		struct ReachableNode {
+			int node;		///< ID of the node.
+			float cost;		///< Cost to reach the node from its nearest source.
+			int source;		///< ID of the nearest source to the node.
+		};
+
+		/*!
+			\brief Find the cost from the nearest of several sources to every node using a single search.
+
+			\param bg The boost graph containing edges/nodes.
+			\param source_ids IDs of every source. IDs that aren't in the graph are ignored.
+			\param max_cost Stop searching once every node within this cost of a source has been found. If
+							negative, every reachable node will be found.
+			\param reverse If true, find the cost from every node to its nearest source instead, by searching
+						   the in edges of each node. This only differs from the default for directed graphs.
+
+			\returns The cost from the nearest source to every node, along with the source and predecessor of each node.
+
+			\details
+			Every source is added to the search with a cost of zero, so this is equivalent to a single run
+			of Dijkstra's algorithm from a node connected to every source with edges of cost zero. This
+			costs the same as one search from a single node, no matter how many sources there are.
+
+			\remarks
+			When reverse is true, predecessor holds the next node on the path from each node to its
+			nearest source. The reversed graph is built by BoostGraph::Reverse on the first call.
+
+			\par Example
+			\snippet tests\src\Pathfinding.cpp EX_FindNearestSources
+		*/
+		NearestSources FindNearestSources(BoostGraph * bg, const std::vector<int>& source_ids, float max_cost = -1, bool reverse = false);
+
+		/*!
+			\brief Find every node that can be reached from a set of sources within a maximum cost.
+
+			\param bg The boost graph containing edges/nodes.
+			\param source_ids IDs of every source. IDs that aren't in the graph are ignored.
+			\param max_cost Maximum cost to reach a node from its nearest source.
+			\param reverse If true, find every node that can reach a source within max_cost instead.
+
+			\returns Every node within max_cost of a source, in order of increasing cost.
+
+			\details
+			The search stops as soon as the next cheapest node costs more than max_cost, so only the nodes
+			within max_cost and their neighbors are visited. This is meant for queries such as the area
+			that can be walked to from an entrance within a set amount of time.
+
+			\see FindNearestSources for details on how multiple sources are searched.
+
+			\par Example
+			\snippet tests\src\Pathfinding.cpp EX_FindReachable
+		*/
+		std::vector<ReachableNode> FindReachable(BoostGraph * bg, const std::vector<int>& source_ids, float max_cost, bool reverse = false);
 		
 		/*! 
 			\brief Find a path from every id in start_ids to the matching end node in end_ids. 
@@ -478,6 +603,123 @@ namespace HF {
 		DistanceAndPredecessor GenerateDistanceAndPred(const BoostGraph& bg);
 
 		inline DistanceAndPredecessor GenerateDistanceAndPredFast(const BoostGraph& bg);
+
+		/*! \brief Ways to store the distances generated by GenerateDistanceTiles. */
+		enum DISTANCE_FORMAT {
+			FLOAT32 = 0,	///< Every distance is stored as a float. Distances to unreachable nodes are -1.
+			UINT16 = 1		///< Every distance is divided by a scale and rounded to a uint16_t. Distances to unreachable nodes are UNREACHABLE_UINT16.
+		};
+
+		constexpr uint16_t UNREACHABLE_UINT16 = 65535;	///< Distance stored for unreachable nodes in the UINT16 format.
+		constexpr uint16_t MAX_UINT16_DISTANCE = 65534;	///< Largest distance that can be stored in the UINT16 format. Longer distances are clamped to this.
+
+		/*!
+			\brief A block of consecutive rows of a distance matrix.
+
+			\details
+			Rows are stored one after another in `data`, in the type specified by `format`. If `upper_triangle`
+			is true, each row only contains the distances to nodes with a higher ID than the row, so row `i`
+			starts at column `i + 1` and contains `num_nodes - i - 1` values.
+		*/
+		struct DistanceTile {
+			int first_row;			///< ID of the node the first row of this tile was generated from.
+			int num_rows;			///< Number of rows in this tile.
+			int num_nodes;			///< Number of nodes in the graph. This is the length of a full row.
+			bool upper_triangle;	///< If true, rows only contain the distances to nodes with a higher ID.
+			DISTANCE_FORMAT format;	///< Type of the values in data.
+			float scale;			///< Distance represented by 1 in the UINT16 format.
+			const void* data;		///< Every row of this tile.
+			size_t num_values;		///< Total number of values in data.
+
+			/*! \brief Get the number of values in a row of this tile.
+
+				\param row ID of the node the row was generated from.
+			*/
+			inline int RowLength(int row) const {
+				return upper_triangle ? num_nodes - row - 1 : num_nodes;
+			}
+
+			/*! \brief Get the index in data of the first value of a row of this tile.
+
+				\param row ID of the node the row was generated from.
+			*/
+			inline size_t RowOffset(int row) const {
+				assert(row >= first_row && row < first_row + num_rows);
+
+				const size_t rows_before = row - first_row;
+				if (!upper_triangle) return rows_before * num_nodes;
+
+				// Each row is one shorter than the row before it
+				const size_t first_length = num_nodes - first_row - 1;
+				return rows_before * first_length - (rows_before * (rows_before - 1)) / 2;
+			}
+		};
+
+		/*!
+			\brief Generate the distance from every node to every other node, one block of rows at a time.
+
+			\param bg Boost graph to generate the distances in.
+			\param sink Called once for every tile of rows in order. Tiles are only valid until sink returns.
+			\param format Type to store the distances as.
+			\param scale Distance represented by 1 when format is UINT16. Ignored for FLOAT32.
+			\param upper_triangle If true, only store the distance from each node to the nodes with higher IDs.
+			\param tile_rows Maximum number of rows to generate before calling sink.
+
+			\details
+			Only distances are generated, and only `tile_rows` rows of the matrix are held in memory at a
+			time, so the full matrix never has to fit in memory. The rows of each tile are generated in
+			parallel, and sink is always called from the calling thread.
+
+			\remarks
+			upper_triangle is only meaningful for undirected graphs, where the distance from i to j is the
+			same as the distance from j to i. This isn't checked.
+
+			\exception std::out_of_range tile_rows is less than 1, or format is UINT16 and scale isn't greater than 0.
+
+			\see WriteDistanceMatrix to write the tiles to a file.
+
+			\par Example
+			\snippet tests\src\Pathfinding.cpp EX_DistanceTiles
+		*/
+		void GenerateDistanceTiles(
+			const BoostGraph& bg,
+			const std::function<void(const DistanceTile&)>& sink,
+			DISTANCE_FORMAT format = FLOAT32,
+			float scale = 1.0f,
+			bool upper_triangle = false,
+			int tile_rows = 256
+		);
+
+		/*!
+			\brief Write the distance from every node to every other node to a file.
+
+			\param bg Boost graph to generate the distances in.
+			\param path Path of the file to create. Any existing file will be replaced.
+			\param format Type to store the distances as.
+			\param scale Distance represented by 1 when format is UINT16. Ignored for FLOAT32.
+			\param upper_triangle If true, only store the distance from each node to the nodes with higher IDs.
+			\param tile_rows Maximum number of rows to hold in memory before writing them to the file.
+
+			\returns True if the file was written successfully, false if it couldn't be opened or written to.
+
+			\details
+			The file begins with a 32 byte header containing the characters `DHARTDM`, the version of
+			the format, the DISTANCE_FORMAT, the number of nodes, 1 if only the upper triangle is stored,
+			and the scale. It's followed by every row of the matrix in order, laid out the same way as the
+			rows of a DistanceTile.
+
+			\exception std::out_of_range tile_rows is less than 1, or format is UINT16 and scale isn't greater than 0.
+
+			\see GenerateDistanceTiles for details on how the distances are generated.
+		*/
+		bool WriteDistanceMatrix(
+			const BoostGraph& bg,
+			const std::string& path,
+			DISTANCE_FORMAT format = FLOAT32,
+			float scale = 1.0f,
+			bool upper_triangle = false,
+			int tile_rows = 256
+		);
 		
 		/*!
 			\brief A special version of FindPaths optimized for the C_Interface, such that all paths possible
@@ -0,0 +1,72 @@
+///
+///	\file		MeshFilter.h
+/// \brief		Contains definitions for the <see cref="HF::RayTracer::MeshFilter">MeshFilter</see> class
+///
+///	\author		TBA
+///	\date		02 Jul 2020
+
+#pragma once
+
+#include <vector>
+
+namespace HF::RayTracer {
+
+	/*! \brief A set of mesh IDs that rays are allowed to hit.
+
+		\details
+		Filters are checked by the raytracers while rays traverse their BVH, so a ray that passes
+		through a mesh the filter rejects continues on to the next mesh behind it instead of
+		stopping. Casting a filtered ray costs a single traversal, no matter how many rejected meshes
+		are in its way.
+
+		A filter either accepts only the meshes listed in it, or every mesh except the ones listed in it.
+		A default constructed filter accepts every mesh.
+
+		\remarks
+		IDs are stored in a flat array indexed by mesh ID, since they're checked for every triangle a
+		ray hits.
+	*/
+	class MeshFilter {
+	private:
+		std::vector<char> listed;		///< Set to 1 at the index of every listed mesh ID.
+		bool accept_listed = false;		///< If true only listed meshes are accepted, otherwise only unlisted ones are.
+
+		/*! \brief Create a filter that accepts or rejects every mesh in `mesh_ids`. */
+		inline MeshFilter(const std::vector<int>& mesh_ids, bool accept_listed) : accept_listed(accept_listed) {
+			for (int id : mesh_ids) {
+				if (id < 0) continue;
+				if (id >= static_cast<int>(listed.size())) listed.resize(id + 1, 0);
+				listed[id] = 1;
+			}
+		}
+
+	public:
+		/*! \brief Create a filter that accepts every mesh. */
+		inline MeshFilter() = default;
+
+		/*! \brief Create a filter that only accepts the meshes in `mesh_ids`. */
+		static inline MeshFilter Only(const std::vector<int>& mesh_ids) { return MeshFilter(mesh_ids, true); }
+
+		/*! \brief Create a filter that accepts every mesh except the meshes in `mesh_ids`. */
+		static inline MeshFilter Except(const std::vector<int>& mesh_ids) { return MeshFilter(mesh_ids, false); }
+
+		/*! \brief Add `mesh_id` to this filter's list if `is_listed` is true, otherwise remove it. */
+		inline void SetListed(int mesh_id, bool is_listed) {
+			if (mesh_id < 0) return;
+			if (mesh_id >= static_cast<int>(listed.size())) {
+				if (!is_listed) return;
+				listed.resize(mesh_id + 1, 0);
+			}
+			listed[mesh_id] = is_listed ? 1 : 0;
+		}
+
+		/*! \brief Determine if a ray may hit the mesh with ID `mesh_id`. */
+		inline bool Accepts(unsigned int mesh_id) const {
+			const bool is_listed = mesh_id < listed.size() && listed[mesh_id];
+			return is_listed == accept_listed;
+		}
+
+		/*! \brief Determine if this filter accepts every mesh, in which case it doesn't need to be checked. */
+		inline bool AcceptsAll() const { return !accept_listed && listed.empty(); }
+	};
+}
@@ -1,7 +1,9 @@
 #include <MultiRT.h>
 #include <embree_raytracer.h>
 #include <ray_data.h>
+#include <RayStream.h>
 #include <cassert>
+#include <algorithm>
 
 #include <stdio.h>
 namespace HF::RayTracer {
@@ -16,6 +18,9 @@ namespace HF::RayTracer {
 		case(MultiRT::NANO_RT):
 			name = "nano_rt";
 			break;
+		case(MultiRT::NANO_RT_FLOAT):
+			name = "nano_rt_float";
+			break;
 		default:
 			"NoType!";
 			break;
@@ -37,21 +42,103 @@ namespace HF::RayTracer {
 		this->type = NANO_RT;
 	}
 
-	HitStruct<MultiRT::real_t> MultiRT::Intersect(const MultiRT::real3& origin, const MultiRT::real3& direction) {
+	MultiRT::MultiRT(HF::RayTracer::NanoRTRayTracerFloat* nrt) {
+		assert(nrt != NULL);
+		this->RayTracer = nrt;
+		this->type = NANO_RT_FLOAT;
+	}
+
+	HitStruct<MultiRT::real_t> MultiRT::Intersect(const MultiRT::real3& origin, const MultiRT::real3& direction, const MeshFilter* filter) {
 		if (this->type == EMBREE)
-			return reinterpret_cast<HF::RayTracer::EmbreeRayTracer*>(this->RayTracer)->Intersect(origin, direction);
+			return reinterpret_cast<HF::RayTracer::EmbreeRayTracer*>(this->RayTracer)->Intersect(origin, direction, -1.0f, -1, filter);
 		else if (this->type == NANO_RT)
-			return reinterpret_cast<HF::RayTracer::NanoRTRayTracer*>(this->RayTracer)->Intersect(origin, direction);
+			return reinterpret_cast<HF::RayTracer::NanoRTRayTracer*>(this->RayTracer)->Intersect(origin, direction, -1.0, -1, filter);
+		else if (this->type == NANO_RT_FLOAT)
+			return reinterpret_cast<HF::RayTracer::NanoRTRayTracerFloat*>(this->RayTracer)->Intersect(origin, direction, -1.0, -1, filter);
 		else
 			assert(false);
 	}
 
-	bool MultiRT::Occluded(const MultiRT::real3& origin, const MultiRT::real3& direction, MultiRT::real_t distance) {
+	bool MultiRT::Occluded(const MultiRT::real3& origin, const MultiRT::real3& direction, MultiRT::real_t distance, const MeshFilter* filter) {
 		if (this->type == EMBREE)
-			return reinterpret_cast<HF::RayTracer::EmbreeRayTracer*>(this->RayTracer)->Occluded(origin, direction, distance);
+			return reinterpret_cast<HF::RayTracer::EmbreeRayTracer*>(this->RayTracer)->Occluded(origin, direction, distance, -1, filter);
 		else if (this->type == NANO_RT)
-			return reinterpret_cast<HF::RayTracer::NanoRTRayTracer*>(this->RayTracer)->Occluded(origin, direction, distance);
+			return reinterpret_cast<HF::RayTracer::NanoRTRayTracer*>(this->RayTracer)->Occluded(origin, direction, distance, -1, filter);
+		else if (this->type == NANO_RT_FLOAT)
+			return reinterpret_cast<HF::RayTracer::NanoRTRayTracerFloat*>(this->RayTracer)->Occluded(origin, direction, distance, -1, filter);
 		else
 			assert(false);
 	}
+
+	/*! \brief Convert an array of real3 to an array of float arrays for the embree raytracer. */
+	inline std::vector<std::array<float, 3>> ToFloatPoints(const std::vector<MultiRT::real3>& points) {
+		std::vector<std::array<float, 3>> out_points(points.size());
+		for (size_t i = 0; i < points.size(); i++)
+			out_points[i] = std::array<float, 3>{
+				static_cast<float>(points[i][0]),
+				static_cast<float>(points[i][1]),
+				static_cast<float>(points[i][2])
+			};
+		return out_points;
+	}
+
+	std::vector<HitStruct<MultiRT::real_t>> MultiRT::Intersections(
+		const std::vector<MultiRT::real3>& origins,
+		const std::vector<MultiRT::real3>& directions,
+		MultiRT::real_t max_distance,
+		bool use_parallel)
+	{
+		// Reject invalid sizes the same way for every raytracer
+		StreamRayCount(origins.size(), directions.size());
+
+		std::vector<HitStruct<real_t>> out_results;
+
+		if (this->type == EMBREE) {
+			const auto results = reinterpret_cast<HF::RayTracer::EmbreeRayTracer*>(this->RayTracer)->IntersectStream(
+				ToFloatPoints(origins), ToFloatPoints(directions), static_cast<float>(max_distance), use_parallel
+			);
+
+			out_results.resize(results.size());
+			for (size_t i = 0; i < results.size(); i++)
+				out_results[i] = HitStruct<real_t>(results[i].distance, results[i].meshid);
+		}
+		else if (this->type == NANO_RT)
+			out_results = reinterpret_cast<HF::RayTracer::NanoRTRayTracer*>(this->RayTracer)->Intersections(
+				origins, directions, max_distance, use_parallel
+			);
+		else if (this->type == NANO_RT_FLOAT)
+			out_results = reinterpret_cast<HF::RayTracer::NanoRTRayTracerFloat*>(this->RayTracer)->Intersections(
+				origins, directions, max_distance, use_parallel
+			);
+		else
+			assert(false);
+
+		return out_results;
+	}
+
+	std::vector<char> MultiRT::Occlusions(
+		const std::vector<MultiRT::real3>& origins,
+		const std::vector<MultiRT::real3>& directions,
+		MultiRT::real_t max_distance,
+		bool use_parallel)
+	{
+		StreamRayCount(origins.size(), directions.size());
+
+		if (this->type == EMBREE)
+			return reinterpret_cast<HF::RayTracer::EmbreeRayTracer*>(this->RayTracer)->OccludedStream(
+				ToFloatPoints(origins), ToFloatPoints(directions), static_cast<float>(max_distance), use_parallel
+			);
+		else if (this->type == NANO_RT)
+			return reinterpret_cast<HF::RayTracer::NanoRTRayTracer*>(this->RayTracer)->Occlusions(
+				origins, directions, max_distance, use_parallel
+			);
+		else if (this->type == NANO_RT_FLOAT)
+			return reinterpret_cast<HF::RayTracer::NanoRTRayTracerFloat*>(this->RayTracer)->Occlusions(
+				origins, directions, max_distance, use_parallel
+			);
+		else
+			assert(false);
+
+		return std::vector<char>();
+	}
 }
@@ -1,12 +1,24 @@
 #pragma once
 
 #include <array>
+#include <cassert>
+#include <vector>
 #include <HitStruct.h>
 
 namespace HF::RayTracer {
 	class EmbreeRayTracer;
-	class NanoRTRayTracer;
+	class MeshFilter;
+	template <typename vertex_type> class BasicNanoRTRayTracer;
+	using NanoRTRayTracer = BasicNanoRTRayTracer<double>;
+	using NanoRTRayTracerFloat = BasicNanoRTRayTracer<float>;
 
+	/*! \brief A wrapper that can hold an EmbreeRayTracer, a NanoRTRayTracer, or a NanoRTRayTracerFloat.
+
+		\details
+		Every call to Intersect or Occluded checks which type of raytracer is held before casting the ray.
+		Code that casts a large number of rays should be templated on the raytracer type instead, and use
+		Visit to resolve the type of the held raytracer only once.
+	*/
 	struct MultiRT {
 		using real_t = double;
 		using real3 = std::array<real_t, 3>;
@@ -14,7 +26,8 @@ namespace HF::RayTracer {
 		enum RT_Type{
 			NONE,
 			EMBREE,
-			NANO_RT
+			NANO_RT,
+			NANO_RT_FLOAT
 		};
 
 		void* RayTracer;
@@ -25,9 +38,86 @@ namespace HF::RayTracer {
 
 		MultiRT(HF::RayTracer::NanoRTRayTracer* nrt);
 
-		bool Occluded(const real3 & origin, const real3& direction, real_t distance);
+		MultiRT(HF::RayTracer::NanoRTRayTracerFloat* nrt);
+
+		/*! \brief Call a function with a reference to the held raytracer as its concrete type.
+
+			\tparam F A callable that accepts an `EmbreeRayTracer&`, a `NanoRTRayTracer&`, and a
+					   `NanoRTRayTracerFloat&`, such as a generic lambda. Every call must return the same type.
+
+			\param func Function to call with the held raytracer.
+
+			\returns The result of calling `func` with the held raytracer.
+
+			\pre A raytracer must have been assigned to this MultiRT.
+
+			\par Example
+			\code
+				MultiRT multi_rt(&ert);
+				auto hit = multi_rt.Visit([&](auto& rt) { return rt.Intersect(origin, direction); });
+			\endcode
+		*/
+		template <typename F>
+		inline auto Visit(F&& func) {
+			assert(this->type != RT_Type::NONE);
+
+			if (this->type == RT_Type::NANO_RT)
+				return func(*static_cast<HF::RayTracer::NanoRTRayTracer*>(this->RayTracer));
+			else if (this->type == RT_Type::NANO_RT_FLOAT)
+				return func(*static_cast<HF::RayTracer::NanoRTRayTracerFloat*>(this->RayTracer));
+			else
+				return func(*static_cast<HF::RayTracer::EmbreeRayTracer*>(this->RayTracer));
+		}
+
+		bool Occluded(const real3 & origin, const real3& direction, real_t distance, const MeshFilter* filter = nullptr);
+
+		/*! \brief Cast a ray and get the distance and meshid of the first mesh it hits.
+
+			\param filter If not null, the ray will pass through any mesh this filter doesn't accept
+						  and return the first hit on a mesh it does accept.
+		*/
+		HitStruct<real_t> Intersect(const real3& origin, const real3& direction, const MeshFilter* filter = nullptr);
+
+		/*! \brief Cast a batch of rays and get the distance and meshid of every hit.
+
+			\param origins Origin points of every ray. If only one is supplied, it will be used for every direction.
+			\param directions Directions of every ray. If only one is supplied, it will be used for every origin.
+			\param max_distance Maximum distance of every ray. Set to -1 for infinite distance.
+			\param use_parallel Whether or not to cast the rays in parallel.
+
+			\returns An ordered array with one HitStruct for every ray cast.
+
+			\exception std::runtime_error origins and directions are different sizes and neither contains
+										  exactly one element. This is checked the same way for every raytracer type.
+
+			\remarks The raytracer type is only checked once for the entire batch. Embree raytracers will
+					 cast the rays as ray streams.
+		*/
+		std::vector<HitStruct<real_t>> Intersections(
+			const std::vector<real3>& origins,
+			const std::vector<real3>& directions,
+			real_t max_distance = -1,
+			bool use_parallel = false
+		);
+
+		/*! \brief Cast a batch of occlusion rays.
+
+			\param origins Origin points of every ray. If only one is supplied, it will be used for every direction.
+			\param directions Directions of every ray. If only one is supplied, it will be used for every origin.
+			\param max_distance Maximum distance of every ray. Set to -1 for infinite distance.
+			\param use_parallel Whether or not to cast the rays in parallel.
+
+			\returns An ordered array of chars set to true for every ray that was occluded.
 
-		HitStruct<real_t> Intersect(const real3& origin, const real3& direction);
+			\exception std::runtime_error origins and directions are different sizes and neither contains
+										  exactly one element. This is checked the same way for every raytracer type.
+		*/
+		std::vector<char> Occlusions(
+			const std::vector<real3>& origins,
+			const std::vector<real3>& directions,
+			real_t max_distance = -1,
+			bool use_parallel = false
+		);
 	};
 }
 
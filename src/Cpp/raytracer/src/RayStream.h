@@ -0,0 +1,36 @@
+///
+///	\file		RayStream.h
+/// \brief		Contains helpers shared by every raytracer for casting batches of rays
+///
+///	\author		TBA
+///	\date		02 Jul 2020
+
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+
+namespace HF::RayTracer {
+
+	/*! \brief Determine how many rays will be cast for a set of origins and directions.
+
+		\param num_origins Number of origin points.
+		\param num_directions Number of directions.
+
+		\returns The number of rays to cast.
+
+		\details
+		Origins and directions must either be the same size, or one of them must contain a single
+		element that will be used for every ray.
+
+		\exception std::runtime_error The sizes didn't match any of the valid configurations.
+	*/
+	inline int StreamRayCount(size_t num_origins, size_t num_directions) {
+		if (num_origins == num_directions || (num_origins > 1 && num_directions == 1))
+			return static_cast<int>(num_origins);
+		else if (num_origins == 1 && num_directions > 1)
+			return static_cast<int>(num_directions);
+		else
+			throw std::runtime_error("Incorrect usage of castrays");
+	}
+}
@@ -10,12 +10,15 @@
 #include <corecrt_math_defines.h>
 #endif
 #include <functional>
+#include <algorithm>
 #include <iostream>
 #include <thread>
 #include <robin_hood.h>
+#include <stdexcept>
 
 #include <meshinfo.h>
 #include <RayRequest.h>
+#include <RayStream.h>
 #include <HFExceptions.h>
 
 using std::vector;
@@ -39,8 +42,11 @@ namespace HF::RayTracer {
 		hit.ray.tnear = 0.00000001f; // The start of the ray segment
 		hit.ray.tfar = distance > 0 ? distance : INFINITY; // The end of the ray segment
 		hit.ray.time = 0.0f; // Time of ray for motion blur, unrelated to our package
+		hit.ray.mask = -1; // Intersect with geometry of every mask
+		hit.ray.flags = 0;
 
 		hit.hit.geomID = RTC_INVALID_GEOMETRY_ID;
+		hit.hit.instID[0] = RTC_INVALID_GEOMETRY_ID;
 		hit.hit.primID = -1;
 
 		return hit;
@@ -59,10 +65,69 @@ namespace HF::RayTracer {
 		ray.tnear = 0.0000001f;
 		ray.tfar = (distance > 0) ? distance : INFINITY;
 		ray.time = 0.0f;
+		ray.mask = -1;
 		ray.flags = 0;
 			
 		return ray;
 	}
+	/*! \brief Report a hit on an instance's geometry as a hit on the instance itself.
+
+		\details
+		Embree sets geomID to the ID of the mesh within the instanced scene, which is the same for
+		every instance, and instID to the ID of the instance that was hit.
+	*/
+	inline void ResolveInstanceHit(RTCRayHit& hit) {
+		if (hit.hit.instID[0] != RTC_INVALID_GEOMETRY_ID)
+			hit.hit.geomID = hit.hit.instID[0];
+	}
+
+	/*! \brief Setup a context for casting a single ray stream.
+
+		\param stream_context Context to initialize.
+		\param coherent Whether the rays in the stream share an origin or direction.
+	*/
+	inline void InitStreamContext(RTCIntersectContext& stream_context, bool coherent) {
+		rtcInitIntersectContext(&stream_context);
+		stream_context.flags = coherent ? RTC_INTERSECT_CONTEXT_FLAG_COHERENT : RTC_INTERSECT_CONTEXT_FLAG_INCOHERENT;
+	}
+
+	/*! \brief An intersect context that also holds the filter of the ray being cast.
+
+		\details
+		Embree passes the context to FilterHit, which casts it back to this to read the filter.
+		`context` must be the first member so both have the same address.
+	*/
+	struct FilteredContext {
+		RTCIntersectContext context;	///< Context passed to embree.
+		const MeshFilter* filter;		///< Filter of the ray being cast.
+
+		/*! \brief Copy `base_context`, and have embree call FilterHit if `mesh_filter` rejects any meshes. */
+		inline FilteredContext(const RTCIntersectContext& base_context, const MeshFilter* mesh_filter)
+			: context(base_context), filter(mesh_filter)
+		{
+			if (filter && !filter->AcceptsAll())
+				context.filter = FilterHit;
+		}
+
+		/*! \brief Reject every hit on a mesh the context's filter doesn't accept so the ray continues past it. */
+		static void FilterHit(const RTCFilterFunctionNArguments* args) {
+			const MeshFilter* filter = reinterpret_cast<const FilteredContext*>(args->context)->filter;
+
+			for (unsigned int i = 0; i < args->N; i++) {
+				if (args->valid[i] == 0) continue;
+
+				// Hits on an instance's geometry are filtered by the ID of the instance, the same ID
+				// ResolveInstanceHit reports
+				unsigned int mesh_id = RTCHitN_instID(args->hit, args->N, i, 0);
+				if (mesh_id == RTC_INVALID_GEOMETRY_ID)
+					mesh_id = RTCHitN_geomID(args->hit, args->N, i);
+
+				if (!filter->Accepts(mesh_id))
+					args->valid[i] = 0;
+			}
+		}
+	};
+
 	/// <summary>
 	/// Check an embree device for errors.
 	/// </summary>
@@ -83,6 +148,132 @@ namespace HF::RayTracer {
 	/// </summary>
 	struct Triangle { int v0, v1, v2; };
 	
+	using float3 = std::array<float, 3>;
+
+	inline float3 Sub(const float3& a, const float3& b) { return float3{ a[0] - b[0], a[1] - b[1], a[2] - b[2] }; }
+	inline float Dot(const float3& a, const float3& b) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; }
+	inline float3 Cross(const float3& a, const float3& b) {
+		return float3{ a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+	}
+
+	/*! \brief Get a point on the triangle `a`, `b`, `c` from barycentric weights of `b` and `c`. */
+	inline float3 Barycentric(const float3& a, const float3& b, const float3& c, float v, float w) {
+		const float u = 1.0f - v - w;
+		return float3{
+			u * a[0] + v * b[0] + w * c[0],
+			u * a[1] + v * b[1] + w * c[1],
+			u * a[2] + v * b[2] + w * c[2]
+		};
+	}
+
+	/*! \brief Find the closest point to `p` on the triangle `a`, `b`, `c`.
+
+		\remarks
+		Checks which of the triangle's vertex, edge, or face regions `p` projects into, as described
+		in Real-Time Collision Detection by Christer Ericson, section 5.1.5.
+	*/
+	float3 ClosestPointOnTriangle(const float3& p, const float3& a, const float3& b, const float3& c) {
+		const float3 ab = Sub(b, a), ac = Sub(c, a), ap = Sub(p, a);
+		const float d1 = Dot(ab, ap), d2 = Dot(ac, ap);
+		if (d1 <= 0 && d2 <= 0) return a;
+
+		const float3 bp = Sub(p, b);
+		const float d3 = Dot(ab, bp), d4 = Dot(ac, bp);
+		if (d3 >= 0 && d4 <= d3) return b;
+
+		const float vc = d1 * d4 - d3 * d2;
+		if (vc <= 0 && d1 >= 0 && d3 <= 0)
+			return Barycentric(a, b, c, d1 / (d1 - d3), 0);
+
+		const float3 cp = Sub(p, c);
+		const float d5 = Dot(ab, cp), d6 = Dot(ac, cp);
+		if (d6 >= 0 && d5 <= d6) return c;
+
+		const float vb = d5 * d2 - d1 * d6;
+		if (vb <= 0 && d2 >= 0 && d6 <= 0)
+			return Barycentric(a, b, c, 0, d2 / (d2 - d6));
+
+		const float va = d3 * d6 - d5 * d4;
+		if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) {
+			const float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+			return Barycentric(a, b, c, 1.0f - w, w);
+		}
+
+		const float denom = 1.0f / (va + vb + vc);
+		return Barycentric(a, b, c, vb * denom, vc * denom);
+	}
+
+	/*! \brief Transform a point by a 4x4 column major matrix from an embree point query context. */
+	inline float3 TransformPoint(const float* m, const float3& p) {
+		return float3{
+			m[0] * p[0] + m[4] * p[1] + m[8] * p[2] + m[12],
+			m[1] * p[0] + m[5] * p[1] + m[9] * p[2] + m[13],
+			m[2] * p[0] + m[6] * p[1] + m[10] * p[2] + m[14]
+		};
+	}
+
+	/*! \brief Inputs and result of a single point query, passed to ClosestPointOnMesh through embree. */
+	struct PointQueryData {
+		const std::vector<RTCGeometry>* meshes;	///< Triangle mesh of every mesh and instance, indexed by ID.
+		const MeshFilter* filter;				///< If not null, only meshes this accepts are considered.
+		bool ignore_horizontal;					///< If true, triangles facing mostly up or down are skipped.
+		ClosestPoint result;					///< Closest point found so far.
+	};
+
+	/*! \brief Check a triangle found by a point query, and shrink the query to its distance if it's closer.
+
+		\details
+		Triangles of instances are transformed into world space before they're checked, so the query
+		works with any instance transform.
+
+		\returns True if the query's radius was shrunk, so embree can cull the rest of the BVH against it.
+	*/
+	bool ClosestPointOnMesh(RTCPointQueryFunctionArguments* args) {
+		PointQueryData& data = *static_cast<PointQueryData*>(args->userPtr);
+		const RTCPointQueryContext* query_context = args->context;
+		const bool instanced = query_context->instStackSize > 0;
+
+		// Instances are reported with their own ID, the same as ray hits on them
+		const unsigned int mesh_id = instanced ? query_context->instID[0] : args->geomID;
+		if (data.filter && !data.filter->Accepts(mesh_id))
+			return false;
+
+		const RTCGeometry geom = (*data.meshes)[mesh_id];
+		const Triangle& tri = static_cast<const Triangle*>(rtcGetGeometryBufferData(geom, RTC_BUFFER_TYPE_INDEX, 0))[args->primID];
+		const Vertex* vertices = static_cast<const Vertex*>(rtcGetGeometryBufferData(geom, RTC_BUFFER_TYPE_VERTEX, 0));
+
+		float3 a{ vertices[tri.v0].x, vertices[tri.v0].y, vertices[tri.v0].z };
+		float3 b{ vertices[tri.v1].x, vertices[tri.v1].y, vertices[tri.v1].z };
+		float3 c{ vertices[tri.v2].x, vertices[tri.v2].y, vertices[tri.v2].z };
+		if (instanced) {
+			const float* inst2world = query_context->inst2world[query_context->instStackSize - 1];
+			a = TransformPoint(inst2world, a);
+			b = TransformPoint(inst2world, b);
+			c = TransformPoint(inst2world, c);
+		}
+
+		// Skip floors and ceilings by checking if the normal is within 45 degrees of vertical
+		if (data.ignore_horizontal) {
+			const float3 normal = Cross(Sub(b, a), Sub(c, a));
+			if (2.0f * normal[2] * normal[2] >= Dot(normal, normal))
+				return false;
+		}
+
+		const float3 query_point{ args->query->x, args->query->y, args->query->z };
+		const float3 closest = ClosestPointOnTriangle(query_point, a, b, c);
+		const float3 offset = Sub(closest, query_point);
+		const float distance = sqrtf(Dot(offset, offset));
+
+		if (distance >= args->query->radius)
+			return false;
+
+		args->query->radius = distance;
+		data.result.distance = distance;
+		data.result.meshid = static_cast<int>(mesh_id);
+		data.result.point = closest;
+		return true;
+	}
+
 	/// <summary>
 	/// Index a list of verticies and place them into a triangle and vertex buffer.
 	/// </summary>
@@ -128,72 +319,53 @@ namespace HF::RayTracer {
 		}
 	}
 
-	/// <summary>
-	/// Package raw arrays of floats and indices in buffers to the required Embree types.
-	/// </summary>
-	/// <param name="in_vertices">
-	/// An array of floats in which every 3 floats represents a vertex.
-	/// </param>
-	/// <param name="in_indices">
-	/// An array of integers in which every 3 integers represents a triangle.
-	/// </param>
-	/// <param name="out_vertices"> Output array for vertexes.</param>
-	/// <param name="out_triangles"> Output array for triangles.</param>
-	/// \todo May be faster as a std::move or std::copy.
-	inline void buffersToStructs(
-		std::vector<float>& in_vertices,
-		std::vector<int>& in_indices,
-		std::vector<Vertex>& out_vertices,
-		std::vector<Triangle>& out_triangles
-	) {
-		out_vertices.resize(in_vertices.size() / 3);
-		for (int i = 0; i < in_vertices.size(); i += 3) {
-			out_vertices[i / 3] = Vertex{
-				in_vertices[i],
-				in_vertices[i + 1],
-				in_vertices[i + 2]
-			};
-		}
-
-		out_triangles.resize(in_indices.size() / 3);
-		for (int i = 0; i < in_indices.size(); i += 3) {
-			out_triangles[i / 3] = Triangle{
-				in_indices[i],
-				in_indices[i + 1],
-				in_indices[i + 2]
-			};
-		}
-	}
-
-	EmbreeRayTracer::EmbreeRayTracer(bool use_precise)
+	EmbreeRayTracer::EmbreeRayTracer(bool use_precise, BUILD_QUALITY quality)
 	{
 		this->use_precise = false;
-		SetupScene();
+		SetupScene(quality);
 	}
 
-	EmbreeRayTracer::EmbreeRayTracer(std::vector<HF::Geometry::MeshInfo<float>>& MI, bool use_precise) {
+	EmbreeRayTracer::EmbreeRayTracer(std::vector<HF::Geometry::MeshInfo<float>>& MI, bool use_precise, BUILD_QUALITY quality) {
 		// Throw if MI's size is less than 0
 		this->use_precise = true;
 
 		if (MI.empty())
 			throw std::logic_error("Embree Ray Tracer was passed an empty vector of mesh info!");
 
-		SetupScene();
+		SetupScene(quality);
 
 		AddMesh(MI, true);
 	}
 
-	EmbreeRayTracer::EmbreeRayTracer(HF::Geometry::MeshInfo<float>& MI, bool use_precise) {
-		SetupScene();
+	EmbreeRayTracer::EmbreeRayTracer(std::vector<HF::Geometry::MeshInfo<float>>&& MI, bool use_precise, BUILD_QUALITY quality) {
+		this->use_precise = use_precise;
+
+		if (MI.empty())
+			throw std::logic_error("Embree Ray Tracer was passed an empty vector of mesh info!");
+
+		SetupScene(quality);
+
+		AddMesh(std::move(MI), true);
+	}
+
+	EmbreeRayTracer::EmbreeRayTracer(HF::Geometry::MeshInfo<float>& MI, bool use_precise, BUILD_QUALITY quality) {
+		SetupScene(quality);
 		this->use_precise = use_precise;
 		AddMesh(MI, true);
 	}
 
-	void EmbreeRayTracer::SetupScene() {
+	void EmbreeRayTracer::SetupScene(BUILD_QUALITY quality) {
 		device = rtcNewDevice("");
 		scene = rtcNewScene(device);
-		rtcSetSceneBuildQuality(scene, RTC_BUILD_QUALITY_HIGH);
-		rtcSetSceneFlags(scene, RTC_SCENE_FLAG_ROBUST);
+		build_quality = quality;
+		rtcSetSceneBuildQuality(scene, static_cast<RTCBuildQuality>(quality));
+
+		// Scenes that are built quickly are expected to be edited, so let embree optimize for that.
+		// Every scene accepts filters from the intersect context so rays can skip meshes during traversal.
+		if (quality == BUILD_QUALITY::LOW)
+			rtcSetSceneFlags(scene, RTC_SCENE_FLAG_ROBUST | RTC_SCENE_FLAG_DYNAMIC | RTC_SCENE_FLAG_CONTEXT_FILTER_FUNCTION);
+		else
+			rtcSetSceneFlags(scene, RTC_SCENE_FLAG_ROBUST | RTC_SCENE_FLAG_CONTEXT_FILTER_FUNCTION);
 		// Initialize the intersect context, which should later allow RTC_INTERSECT_CONTEXT_FLAG_COHERENT
 		rtcInitIntersectContext(&context);
 	}
@@ -204,15 +376,19 @@ namespace HF::RayTracer {
 		device = ERT2.device;
 		context = ERT2.context;
 		scene = ERT2.scene;
-		geometry = ERT2.geometry;
+		contents = ERT2.contents;
+		use_precise = ERT2.use_precise;
+		build_quality = ERT2.build_quality;
 
-		// Increment embree's internal refrence counter.
+		// Increment embree's internal refrence counter. The meshes in the scene
+		// are kept alive by sharing contents.
 		rtcRetainScene(scene);
 		rtcRetainDevice(device);
 	}
 
 	int EmbreeRayTracer::InsertGeom(RTCGeometry& geom, int id)
 	{
+		int added_id = -1;
 		if (id >= 0) {
 			rtcAttachGeometryByID(scene, geom, id);
 
@@ -221,11 +397,18 @@ namespace HF::RayTracer {
 			RTCError error = CheckState(device);
 
 			// Don't know the specific error that will be raised here (Documentation just states some error code)
-			if (error != RTCError::RTC_ERROR_NONE)
-				return InsertGeom(geom);
+			if (error == RTCError::RTC_ERROR_NONE)
+				added_id = id;
 		}
-	
-		return static_cast<int>(rtcAttachGeometry(scene, geom));
+		if (added_id < 0)
+			added_id = static_cast<int>(rtcAttachGeometry(scene, geom));
+
+		// Record the ID this geometry ended up with
+		for (auto& mesh : contents->geometry)
+			if (mesh.geom == geom)
+				mesh.id = added_id;
+
+		return added_id;
 	}
 
 	inline Vector3D cross(const Vector3D& x, const Vector3D& y) {
@@ -300,8 +483,8 @@ namespace HF::RayTracer {
 		);
 	}
 
-	EmbreeRayTracer::EmbreeRayTracer(const std::vector<std::array<float, 3>>& geometry) {
-		SetupScene();
+	EmbreeRayTracer::EmbreeRayTracer(const std::vector<std::array<float, 3>>& geometry, BUILD_QUALITY quality) {
+		SetupScene(quality);
 
 		// Set Setup buffers
 		std::vector<Triangle> tris;
@@ -336,6 +519,12 @@ namespace HF::RayTracer {
 	}
 
 	RTCGeometry EmbreeRayTracer::ConstructGeometryFromBuffers(vector<Triangle>& tris, vector<Vertex>& verts) {
+		// Add a reference to this geometry to internal array of geometry. It won't have an ID until it's attached.
+		contents->geometry.push_back(NewMesh(tris, verts));
+		return contents->geometry.back().geom;
+	}
+
+	EmbreeRayTracer::SceneMesh EmbreeRayTracer::NewMesh(vector<Triangle>& tris, vector<Vertex>& verts) {
 		// Create new geometry object
 		RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_TRIANGLE);
 
@@ -365,30 +554,77 @@ namespace HF::RayTracer {
 		std::move(tris.begin(), tris.end(), triangles);
 		std::move(verts.begin(), verts.end(), Vertices);
 
-		// Add a reference to this geometry to internal array of geometry.
-		geometry.push_back(geom);
-		
+		rtcSetGeometryBuildQuality(geom, static_cast<RTCBuildQuality>(build_quality));
+
 		// Commit this geometry to finalize the process then return
 		rtcCommitGeometry(geom);
 
-		return geom;
+		return SceneMesh{
+			-1, geom,
+			static_cast<unsigned int>(verts.size()),
+			static_cast<unsigned int>(tris.size())
+		};
+	}
+
+	EmbreeRayTracer::SceneMesh EmbreeRayTracer::NewMesh(const HF::Geometry::MeshInfo<float>& mesh) {
+		const auto indices = mesh.GetIndexPointer();
+		const auto vertices = mesh.GetVertexPointer();
+		const unsigned int num_triangles = static_cast<unsigned int>(mesh.NumTris());
+		const unsigned int num_vertices = static_cast<unsigned int>(mesh.NumVerts());
+
+		RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_TRIANGLE);
+
+		// Both matrices are already laid out the way embree expects, so copy them straight in
+		int* index_buffer = static_cast<int*>(
+			rtcSetNewGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3, sizeof(Triangle), num_triangles + 1)
+		);
+		float* vertex_buffer = static_cast<float*>(
+			rtcSetNewGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, sizeof(Vertex), num_vertices + 1)
+		);
+		std::copy(indices.data, indices.data + indices.size, index_buffer);
+		std::copy(vertices.data, vertices.data + vertices.size, vertex_buffer);
+
+		rtcSetGeometryBuildQuality(geom, static_cast<RTCBuildQuality>(build_quality));
+		rtcCommitGeometry(geom);
+
+		return SceneMesh{ -1, geom, num_vertices, num_triangles };
+	}
+
+	EmbreeRayTracer::SceneMesh EmbreeRayTracer::NewMesh(std::shared_ptr<HF::Geometry::MeshBuffers<float>> buffers) {
+		const unsigned int num_triangles = static_cast<unsigned int>(buffers->NumTris());
+		const unsigned int num_vertices = static_cast<unsigned int>(buffers->NumVerts());
+
+		RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_TRIANGLE);
+
+		// Embree reads these in place. The vertex matrix ends with a padding vertex, so
+		// embree's 16 byte loads of the last vertex stay inside the allocation.
+		rtcSetSharedGeometryBuffer(
+			geom, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3,
+			buffers->indices.data(), 0, sizeof(Triangle), num_triangles
+		);
+		rtcSetSharedGeometryBuffer(
+			geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3,
+			buffers->vertices.data(), 0, sizeof(Vertex), num_vertices
+		);
+
+		rtcSetGeometryBuildQuality(geom, static_cast<RTCBuildQuality>(build_quality));
+		rtcCommitGeometry(geom);
+
+		SceneMesh scene_mesh{ -1, geom, num_vertices, num_triangles };
+		scene_mesh.shared_buffers = std::move(buffers);
+		return scene_mesh;
 	}
 
 	bool EmbreeRayTracer::AddMesh(HF::Geometry::MeshInfo<float>& Mesh, bool Commit) {
 
 		if (Mesh.NumTris() < 1 || Mesh.NumVerts() < 1) 
 			throw HF::Exceptions::InvalidOBJ();
-		// Get vertex and triangle data from the mesh
-
-		std::vector<Triangle> tris;	std::vector<Vertex> verts;
-		auto indices = Mesh.getRawIndices(); auto vertices = Mesh.GetIndexedVertices();
-		buffersToStructs(vertices, indices, verts, tris);
 
 		// Construct geometry using embree
-		auto geom = ConstructGeometryFromBuffers(tris, verts);
+		contents->geometry.push_back(NewMesh(Mesh));
 
 		// Add the Mesh to the scene and update it's ID
-		Mesh.meshid = InsertGeom(geom, Mesh.meshid);
+		Mesh.meshid = InsertGeom(contents->geometry.back().geom, Mesh.meshid);
 
 		// commit if specified
 		if (Commit)
@@ -397,6 +633,22 @@ namespace HF::RayTracer {
 		return true;
 	}
 
+	bool EmbreeRayTracer::AddMesh(HF::Geometry::MeshInfo<float>&& Mesh, bool Commit) {
+		if (Mesh.NumTris() < 1 || Mesh.NumVerts() < 1)
+			throw HF::Exceptions::InvalidOBJ();
+
+		// Take the mesh's buffers and let embree use them directly
+		auto buffers = std::make_shared<HF::Geometry::MeshBuffers<float>>(Mesh.ReleaseBuffers());
+		contents->geometry.push_back(NewMesh(std::move(buffers)));
+
+		Mesh.meshid = InsertGeom(contents->geometry.back().geom, Mesh.meshid);
+
+		if (Commit)
+			rtcCommitScene(scene);
+
+		return true;
+	}
+
 	bool EmbreeRayTracer::AddMesh(std::vector<HF::Geometry::MeshInfo<float>>& Meshes, bool Commit)
 	{
 		// Add every mesh in a loop
@@ -410,6 +662,176 @@ namespace HF::RayTracer {
 		return true;
 	}
 
+	bool EmbreeRayTracer::AddMesh(std::vector<HF::Geometry::MeshInfo<float>>&& Meshes, bool Commit)
+	{
+		// Check every mesh before taking any of their buffers, so an invalid mesh
+		// leaves both the meshes and the scene untouched
+		for (const auto& mesh : Meshes)
+			if (mesh.NumTris() < 1 || mesh.NumVerts() < 1)
+				throw HF::Exceptions::InvalidOBJ();
+
+		for (auto& mesh : Meshes)
+			AddMesh(std::move(mesh), false);
+
+		if (Commit)
+			rtcCommitScene(scene);
+
+		return true;
+	}
+
+	EmbreeRayTracer::SceneMesh* EmbreeRayTracer::FindMesh(int id) {
+		for (auto& mesh : contents->geometry)
+			if (mesh.id == id)
+				return &mesh;
+		return nullptr;
+	}
+
+	void EmbreeRayTracer::CommitScene() {
+		rtcCommitScene(scene);
+	}
+
+	bool EmbreeRayTracer::RemoveMesh(int id, bool Commit) {
+		SceneMesh* mesh = FindMesh(id);
+		if (!mesh) return false;
+
+		rtcDetachGeometry(scene, static_cast<unsigned int>(id));
+		rtcReleaseGeometry(mesh->geom);
+		contents->geometry.erase(contents->geometry.begin() + (mesh - contents->geometry.data()));
+
+		if (Commit)
+			rtcCommitScene(scene);
+
+		return true;
+	}
+
+	void EmbreeRayTracer::RefitMesh(SceneMesh& mesh, bool Commit) {
+		// Embree will refit the existing BVH instead of building a new one
+		rtcSetGeometryBuildQuality(mesh.geom, RTC_BUILD_QUALITY_REFIT);
+		rtcUpdateGeometryBuffer(mesh.geom, RTC_BUFFER_TYPE_VERTEX, 0);
+		rtcCommitGeometry(mesh.geom);
+
+		if (Commit)
+			rtcCommitScene(scene);
+	}
+
+	bool EmbreeRayTracer::UpdateMeshVertices(int id, const vector<float>& vertices, bool Commit) {
+		SceneMesh* mesh = FindMesh(id);
+		if (!mesh || mesh->prototype >= 0 || vertices.size() != 3 * static_cast<size_t>(mesh->num_vertices))
+			return false;
+
+		float* vertex_buffer = static_cast<float*>(rtcGetGeometryBufferData(mesh->geom, RTC_BUFFER_TYPE_VERTEX, 0));
+		std::copy(vertices.begin(), vertices.end(), vertex_buffer);
+
+		RefitMesh(*mesh, Commit);
+		return true;
+	}
+
+	bool EmbreeRayTracer::TransformMesh(int id, const InstanceTransform& t, bool Commit) {
+		SceneMesh* mesh = FindMesh(id);
+		if (!mesh || mesh->prototype >= 0) return false;
+
+		Vertex* vertex_buffer = static_cast<Vertex*>(rtcGetGeometryBufferData(mesh->geom, RTC_BUFFER_TYPE_VERTEX, 0));
+		for (unsigned int i = 0; i < mesh->num_vertices; i++) {
+			const Vertex v = vertex_buffer[i];
+			vertex_buffer[i] = Vertex{
+				t[0] * v.x + t[3] * v.y + t[6] * v.z + t[9],
+				t[1] * v.x + t[4] * v.y + t[7] * v.z + t[10],
+				t[2] * v.x + t[5] * v.y + t[8] * v.z + t[11]
+			};
+		}
+
+		RefitMesh(*mesh, Commit);
+		return true;
+	}
+
+	bool EmbreeRayTracer::ReplaceMesh(HF::Geometry::MeshInfo<float>& Mesh, bool Commit) {
+		if (Mesh.NumTris() < 1 || Mesh.NumVerts() < 1)
+			throw HF::Exceptions::InvalidOBJ();
+
+		SceneMesh* mesh = FindMesh(Mesh.meshid);
+		if (!mesh || mesh->prototype >= 0) {
+			if (mesh) RemoveMesh(Mesh.meshid, false);
+			return AddMesh(Mesh, Commit);
+		}
+
+		// If the topology changed, the buffers can't be reused, so swap in new geometry under the same ID
+		if (static_cast<unsigned int>(Mesh.NumVerts()) != mesh->num_vertices || static_cast<unsigned int>(Mesh.NumTris()) != mesh->num_triangles) {
+			RemoveMesh(Mesh.meshid, false);
+			return AddMesh(Mesh, Commit);
+		}
+
+		const auto indices = Mesh.GetIndexPointer();
+		const auto vertices = Mesh.GetVertexPointer();
+		int* index_buffer = static_cast<int*>(rtcGetGeometryBufferData(mesh->geom, RTC_BUFFER_TYPE_INDEX, 0));
+		float* vertex_buffer = static_cast<float*>(rtcGetGeometryBufferData(mesh->geom, RTC_BUFFER_TYPE_VERTEX, 0));
+		std::copy(vertices.data, vertices.data + vertices.size, vertex_buffer);
+
+		// Refitting only moves the bounds of the existing BVH, so it's only valid if every
+		// triangle still uses the same vertices. Otherwise build a new BVH for the buffers.
+		if (std::equal(indices.data, indices.data + indices.size, index_buffer)) {
+			RefitMesh(*mesh, Commit);
+			return true;
+		}
+
+		std::copy(indices.data, indices.data + indices.size, index_buffer);
+		rtcSetGeometryBuildQuality(mesh->geom, static_cast<RTCBuildQuality>(build_quality));
+		rtcUpdateGeometryBuffer(mesh->geom, RTC_BUFFER_TYPE_INDEX, 0);
+		rtcUpdateGeometryBuffer(mesh->geom, RTC_BUFFER_TYPE_VERTEX, 0);
+		rtcCommitGeometry(mesh->geom);
+
+		if (Commit)
+			rtcCommitScene(scene);
+		return true;
+	}
+
+	int EmbreeRayTracer::AddPrototype(HF::Geometry::MeshInfo<float>& Mesh) {
+		if (Mesh.NumTris() < 1 || Mesh.NumVerts() < 1)
+			throw HF::Exceptions::InvalidOBJ();
+
+		// The prototype's BVH is only built once no matter how many times it's instanced, so
+		// it's always worth building at the highest quality
+		Prototype prototype{ rtcNewScene(device), NewMesh(Mesh) };
+		rtcSetSceneBuildQuality(prototype.scene, RTC_BUILD_QUALITY_HIGH);
+		rtcSetSceneFlags(prototype.scene, RTC_SCENE_FLAG_ROBUST | RTC_SCENE_FLAG_CONTEXT_FILTER_FUNCTION);
+		prototype.mesh.id = static_cast<int>(rtcAttachGeometry(prototype.scene, prototype.mesh.geom));
+		rtcCommitScene(prototype.scene);
+
+		contents->prototypes.push_back(prototype);
+		return static_cast<int>(contents->prototypes.size()) - 1;
+	}
+
+	int EmbreeRayTracer::AddInstance(int prototype, const InstanceTransform& transform, int id, bool Commit) {
+		if (prototype < 0 || prototype >= static_cast<int>(contents->prototypes.size()))
+			throw std::out_of_range("No prototype exists at index " + std::to_string(prototype));
+
+		RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_INSTANCE);
+		rtcSetGeometryInstancedScene(geom, contents->prototypes[prototype].scene);
+		rtcSetGeometryTransform(geom, 0, RTC_FORMAT_FLOAT3X4_COLUMN_MAJOR, transform.data());
+		rtcCommitGeometry(geom);
+
+		contents->geometry.push_back(SceneMesh{ -1, geom, 0, 0, prototype, transform });
+		const int added_id = InsertGeom(geom, id);
+
+		if (Commit)
+			rtcCommitScene(scene);
+
+		return added_id;
+	}
+
+	bool EmbreeRayTracer::SetInstanceTransform(int id, const InstanceTransform& transform, bool Commit) {
+		SceneMesh* instance = FindMesh(id);
+		if (!instance || instance->prototype < 0) return false;
+
+		instance->transform = transform;
+		rtcSetGeometryTransform(instance->geom, 0, RTC_FORMAT_FLOAT3X4_COLUMN_MAJOR, transform.data());
+		rtcCommitGeometry(instance->geom);
+
+		if (Commit)
+			rtcCommitScene(scene);
+
+		return true;
+	}
+
 	bool EmbreeRayTracer::PointIntersection(
 		std::array<float, 3>& origin,
 		const std::array<float, 3>& dir,
@@ -545,11 +967,14 @@ namespace HF::RayTracer {
 	RTCRayHit EmbreeRayTracer::Intersect_IMPL(
 		float x, float y, float z,
 		float dx, float dy, float dz,
-		float max_distance, int mesh_id)
+		float max_distance, int mesh_id,
+		const MeshFilter* filter)
 	{
 		RTCRayHit hit = ConstructHit(x, y, z, dx, dy, dz);
 
-		rtcIntersect1(scene, &context, &hit);
+		FilteredContext filtered_context(context, filter);
+		rtcIntersect1(scene, &filtered_context.context, &hit);
+		ResolveInstanceHit(hit);
 
 		return hit;
 	}
@@ -623,10 +1048,159 @@ namespace HF::RayTracer {
 		return out_array;
 	}
 
-	bool EmbreeRayTracer::Occluded_IMPL(float x, float y, float z, float dx, float dy, float dz, float distance, int mesh_id)
+	std::vector<HitStruct<float>> EmbreeRayTracer::IntersectStream(
+		const std::vector<std::array<float, 3>>& origins,
+		const std::vector<std::array<float, 3>>& directions,
+		float max_distance, bool use_parallel)
+	{
+		const int num_rays = StreamRayCount(origins.size(), directions.size());
+		const bool one_origin = origins.size() == 1;
+		const bool one_direction = directions.size() == 1;
+		const int num_streams = (num_rays + RAY_STREAM_SIZE - 1) / RAY_STREAM_SIZE;
+
+		std::vector<HitStruct<float>> out_results(num_rays);
+
+#pragma omp parallel for if(use_parallel) schedule(dynamic)
+		for (int s = 0; s < num_streams; s++) {
+			const int start = s * RAY_STREAM_SIZE;
+			const int count = std::min(RAY_STREAM_SIZE, num_rays - start);
+
+			RTCIntersectContext stream_context;
+			InitStreamContext(stream_context, one_origin || one_direction);
+
+			// Pack this block of rays into a stream
+			std::array<RTCRayHit, RAY_STREAM_SIZE> stream;
+			for (int k = 0; k < count; k++) {
+				const auto& org = origins[one_origin ? 0 : start + k];
+				const auto& dir = directions[one_direction ? 0 : start + k];
+				stream[k] = ConstructHit(org[0], org[1], org[2], dir[0], dir[1], dir[2], max_distance);
+			}
+
+			rtcIntersect1M(scene, &stream_context, stream.data(), count, sizeof(RTCRayHit));
+
+			// Unpack the results into the output array
+			for (int k = 0; k < count; k++) {
+				RTCRayHit& result = stream[k];
+				if (!DidIntersect(result.hit.geomID)) continue;
+				ResolveInstanceHit(result);
+
+				auto& out_struct = out_results[start + k];
+				if (!(this->use_precise) || result.hit.instID[0] != RTC_INVALID_GEOMETRY_ID)
+					out_struct.distance = result.ray.tfar;
+				else
+					out_struct.distance = CalculatePreciseDistance(
+						result.hit.geomID,
+						result.hit.primID,
+						Vector3D(result.ray.org_x, result.ray.org_y, result.ray.org_z),
+						Vector3D(result.ray.dir_x, result.ray.dir_y, result.ray.dir_z)
+					);
+				out_struct.meshid = result.hit.geomID;
+			}
+		}
+		return out_results;
+	}
+
+	std::vector<char> EmbreeRayTracer::OccludedStream(
+		const std::vector<std::array<float, 3>>& origins,
+		const std::vector<std::array<float, 3>>& directions,
+		float max_distance, bool use_parallel)
+	{
+		return OccludedStream(origins, directions, std::vector<float>{ max_distance }, use_parallel);
+	}
+
+	std::vector<char> EmbreeRayTracer::OccludedStream(
+		const std::vector<std::array<float, 3>>& origins,
+		const std::vector<std::array<float, 3>>& directions,
+		const std::vector<float>& max_distances, bool use_parallel)
+	{
+		const int num_rays = StreamRayCount(origins.size(), directions.size());
+		const bool one_distance = max_distances.size() == 1;
+		if (!one_distance && max_distances.size() != num_rays)
+			throw std::runtime_error("Incorrect usage of castrays");
+
+		const bool one_origin = origins.size() == 1;
+		const bool one_direction = directions.size() == 1;
+		const int num_streams = (num_rays + RAY_STREAM_SIZE - 1) / RAY_STREAM_SIZE;
+
+		std::vector<char> out_results(num_rays);
+
+#pragma omp parallel for if(use_parallel) schedule(dynamic)
+		for (int s = 0; s < num_streams; s++) {
+			const int start = s * RAY_STREAM_SIZE;
+			const int count = std::min(RAY_STREAM_SIZE, num_rays - start);
+
+			RTCIntersectContext stream_context;
+			InitStreamContext(stream_context, one_origin || one_direction);
+
+			std::array<RTCRay, RAY_STREAM_SIZE> stream;
+			for (int k = 0; k < count; k++) {
+				const auto& org = origins[one_origin ? 0 : start + k];
+				const auto& dir = directions[one_direction ? 0 : start + k];
+				const float max_distance = max_distances[one_distance ? 0 : start + k];
+				stream[k] = ConstructRay(org[0], org[1], org[2], dir[0], dir[1], dir[2], max_distance);
+			}
+
+			rtcOccluded1M(scene, &stream_context, stream.data(), count, sizeof(RTCRay));
+
+			// Embree sets tfar to -inf for every ray that was occluded
+			for (int k = 0; k < count; k++)
+				out_results[start + k] = stream[k].tfar == -INFINITY;
+		}
+		return out_results;
+	}
+
+	ClosestPoint EmbreeRayTracer::FindClosestPoint(
+		const std::array<float, 3>& point,
+		float max_distance,
+		bool ignore_horizontal,
+		const MeshFilter* filter) const
+	{
+		return FindClosestPoints(vector<std::array<float, 3>>{ point }, max_distance, ignore_horizontal, filter, false)[0];
+	}
+
+	std::vector<ClosestPoint> EmbreeRayTracer::FindClosestPoints(
+		const std::vector<std::array<float, 3>>& points,
+		float max_distance,
+		bool ignore_horizontal,
+		const MeshFilter* filter,
+		bool use_parallel) const
+	{
+		// Map the ID of every mesh to the geometry holding its triangles. Instances use the
+		// geometry of their prototype.
+		int max_id = -1;
+		for (const auto& mesh : contents->geometry)
+			max_id = std::max(max_id, mesh.id);
+
+		vector<RTCGeometry> meshes(max_id + 1, nullptr);
+		for (const auto& mesh : contents->geometry)
+			meshes[mesh.id] = mesh.prototype >= 0 ? contents->prototypes[mesh.prototype].mesh.geom : mesh.geom;
+
+		const int num_points = static_cast<int>(points.size());
+		vector<ClosestPoint> out_results(num_points);
+
+#pragma omp parallel for if(use_parallel) schedule(dynamic, 64)
+		for (int i = 0; i < num_points; i++) {
+			RTCPointQuery query;
+			query.x = points[i][0]; query.y = points[i][1]; query.z = points[i][2];
+			query.time = 0.0f;
+			query.radius = max_distance > 0 ? max_distance : INFINITY;
+
+			RTCPointQueryContext query_context;
+			rtcInitPointQueryContext(&query_context);
+
+			PointQueryData data{ &meshes, filter, ignore_horizontal, ClosestPoint() };
+			rtcPointQuery(scene, &query, &query_context, ClosestPointOnMesh, &data);
+			out_results[i] = data.result;
+		}
+		return out_results;
+	}
+
+	bool EmbreeRayTracer::Occluded_IMPL(float x, float y, float z, float dx, float dy, float dz, float distance, int mesh_id, const MeshFilter* filter)
 	{
 		auto ray = ConstructRay(x, y, z, dx, dy, dz, distance);
-		rtcOccluded1(scene, &context, &ray);
+
+		FilteredContext filtered_context(context, filter);
+		rtcOccluded1(scene, &filtered_context.context, &ray);
 		return ray.tfar == -INFINITY;
 	}
 
@@ -634,15 +1208,26 @@ namespace HF::RayTracer {
 	void EmbreeRayTracer::operator=(const EmbreeRayTracer& ERT2) {
 
 		this->use_precise = ERT2.use_precise;
+		build_quality = ERT2.build_quality;
 		device = ERT2.device;
 		context = ERT2.context;
 		scene = ERT2.scene;
-		geometry = ERT2.geometry;
+		contents = ERT2.contents;
 
 		rtcRetainScene(scene);
 		rtcRetainDevice(device);
 	}
 
+	EmbreeRayTracer::SceneContents::~SceneContents() {
+		// Instances reference their prototype's scene, so release them first
+		for (auto& mesh : geometry)
+			rtcReleaseGeometry(mesh.geom);
+		for (auto& prototype : prototypes) {
+			rtcReleaseGeometry(prototype.mesh.geom);
+			rtcReleaseScene(prototype.scene);
+		}
+	}
+
 	EmbreeRayTracer::~EmbreeRayTracer() {
 		rtcReleaseScene(scene);
 		rtcReleaseDevice(device);
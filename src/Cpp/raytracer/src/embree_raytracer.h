@@ -16,13 +16,18 @@
 #endif
 #include <vector>
 #include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <HitStruct.h>
+#include <MeshFilter.h>
 #include <omp.h>
 
 #define _USE_MATH_DEFINES
 
 namespace HF::Geometry {
 	template <typename T> class MeshInfo;
+	template <typename T> struct MeshBuffers;
 }
 
 /*!
@@ -68,10 +73,45 @@ namespace HF::RayTracer {
 	//*! \brief Determine whether this mesh did or did not intersect */
 	bool DidIntersect(int mesh_id);
 
+	/*! \brief Maximum number of rays submitted to Embree in a single ray stream. */
+	constexpr int RAY_STREAM_SIZE = 256;
+
 	struct RayRequest;
 	struct Vertex;
 	struct Triangle;
 
+	/*!
+		\brief A 3x4 affine transform in column major order.
+
+		\details
+		The first 9 values are the columns of the rotation and scale, and the last 3 are the translation.
+		A point p is transformed to (t[0]*p.x + t[3]*p.y + t[6]*p.z + t[9], t[1]*p.x + ..., t[2]*p.x + ...).
+	*/
+	using InstanceTransform = std::array<float, 12>;
+
+	/*! \brief The closest point on any geometry to a query point.
+
+		\see EmbreeRayTracer::FindClosestPoint
+	*/
+	struct ClosestPoint {
+		float distance = -1;	///< Distance from the query point to `point`, or -1 if nothing was found.
+		int meshid = -1;		///< ID of the mesh `point` is on, or -1 if nothing was found.
+		std::array<float, 3> point{ 0, 0, 0 }; ///< Closest point on the mesh.
+
+		/*! \brief Determine if any geometry was found within the query's maximum distance. */
+		inline bool DidHit() const { return meshid >= 0; }
+	};
+
+	/*! \brief Tradeoff between the time taken to build a BVH and the speed of casting rays at it.
+
+		\see https://www.embree.org/api.html#rtcsetscenebuildquality for details on each quality level.
+	*/
+	enum class BUILD_QUALITY {
+		LOW = 0, ///< Build as fast as possible. Best for scenes that are edited interactively.
+		MEDIUM = 1, ///< Balance between build time and ray performance.
+		HIGH = 2 ///< Build the highest quality BVH. Best for scenes that will have many rays cast at them.
+	};
+
 	/// <summary> A wrapper for Intel's Embree Library. </summary>
 	/// <remarks>
 	/// Provides several functions to quickly and simply perform ray intersections using Embree.
@@ -93,8 +133,42 @@ namespace HF::RayTracer {
 		Vertex* Vertices;
 
 		bool use_precise = false; ///< If true, use custom triangle intersection intersection instead of embree's
+		BUILD_QUALITY build_quality = BUILD_QUALITY::HIGH; ///< Quality of the BVH built for this scene and its geometry
+
+		/*! \brief A triangle mesh or instance attached to the scene. */
+		struct SceneMesh {
+			int id;						///< ID the mesh was attached to the scene with.
+			RTCGeometry geom;			///< The mesh's Embree geometry.
+			unsigned int num_vertices;	///< Number of vertices in the geometry's vertex buffer.
+			unsigned int num_triangles;	///< Number of triangles in the geometry's index buffer.
+			int prototype = -1;			///< Index of the prototype this instances, or -1 if this is a triangle mesh.
+			InstanceTransform transform = {}; ///< Transform of this instance. Unused for triangle meshes.
+			std::shared_ptr<HF::Geometry::MeshBuffers<float>> shared_buffers = nullptr; ///< Buffers embree shares with this mesh, or null if embree owns them.
+		};
 
-		std::vector<RTCGeometry> geometry; //> A list of the geometry being used by RTCScene.
+		/*! \brief A mesh in its own scene, whose BVH is shared by every instance of it. */
+		struct Prototype {
+			RTCScene scene;		///< Scene containing only `mesh`.
+			SceneMesh mesh;		///< The mesh being instanced.
+		};
+
+		/*!
+			\brief Every mesh and prototype attached to the scene.
+
+			\details
+			Copies of an EmbreeRayTracer share its scene, so they share this record of what's in it
+			too. Meshes added or removed through one copy are seen by all of them, and their
+			geometry is only released once the last copy is destroyed.
+		*/
+		struct SceneContents {
+			std::vector<SceneMesh> geometry; ///< Every mesh attached to the scene, in the order they were added.
+			std::vector<Prototype> prototypes; ///< Every mesh that can be instanced, indexed by AddPrototype's return value.
+
+			/*! \brief Release the geometry of every mesh and the scene of every prototype. */
+			~SceneContents();
+		};
+
+		std::shared_ptr<SceneContents> contents = std::make_shared<SceneContents>(); ///< Meshes attached to the scene, shared with every copy.
 
 	private:
 		/*! \brief Performs all the necessary operations to set up the scene.
@@ -107,12 +181,14 @@ namespace HF::RayTracer {
 			5) Inits Intersect_IMPL context
 
 
+			\param quality Quality of the BVH to build for this scene.
+
 			\remarks
 			Any changes to the internal settings of embree should be handled here. I.E. Enforcing
 			That all bvh's used be of robust quality, assigning a custom context, etc.
 
 		*/
-		void SetupScene();
+		void SetupScene(BUILD_QUALITY quality = BUILD_QUALITY::HIGH);
 
 		/*! 
 			\brief Get the vertices for a specific triangle in a mesh.
@@ -235,7 +311,8 @@ namespace HF::RayTracer {
 			float dy,
 			float dz,
 			float max_distance = -1,
-			int mesh_id = -1
+			int mesh_id = -1,
+			const MeshFilter* filter = nullptr
 		);
 
 		/// <summary> Implementation for fundamental occlusion ray intersection. </summary>
@@ -301,7 +378,8 @@ namespace HF::RayTracer {
 			float dy,
 			float dz,
 			float distance = -1,
-			int mesh_id = -1
+			int mesh_id = -1,
+			const MeshFilter* filter = nullptr
 		);
 		
 
@@ -381,12 +459,52 @@ namespace HF::RayTracer {
 		*/
 		RTCGeometry ConstructGeometryFromBuffers(std::vector<Triangle>& tris, std::vector<Vertex>& verts);
 
+		/*!
+			\brief Create and commit a triangle mesh without adding it to this raytracer's list of geometry.
+
+			\param tris Triangle buffer to construct new geometry with
+			\param verts Vertex buffer to construct geometry with
+
+			\returns A record of the new geometry with an ID of -1.
+		*/
+		SceneMesh NewMesh(std::vector<Triangle>& tris, std::vector<Vertex>& verts);
+
+		/*!
+			\brief Create and commit a triangle mesh by copying the buffers of `mesh` straight into embree's.
+
+			\param mesh Mesh to copy the vertices and triangles of.
+
+			\returns A record of the new geometry with an ID of -1.
+		*/
+		SceneMesh NewMesh(const HF::Geometry::MeshInfo<float>& mesh);
+
+		/*!
+			\brief Create and commit a triangle mesh that embree reads directly from `buffers`.
+
+			\param buffers Buffers to share with embree. The returned record keeps them alive.
+
+			\returns A record of the new geometry with an ID of -1.
+		*/
+		SceneMesh NewMesh(std::shared_ptr<HF::Geometry::MeshBuffers<float>> buffers);
+
+		/*! \brief Get the mesh or instance attached with `id`, or nullptr if there is none. */
+		SceneMesh* FindMesh(int id);
+
+		/*!
+			\brief Notify embree that the vertex buffer of `mesh` has changed, then refit its BVH.
+
+			\param mesh Triangle mesh whose vertices were written to.
+			\param Commit Whether or not to commit the scene.
+		*/
+		void RefitMesh(SceneMesh& mesh, bool Commit);
+
 	public:
 		/*!
 			\brief Construct an empty EmbreeRayTracer;
 		
 			\param use_precise If set to true, use a more precise intesection algorithm to determine
 				   the distance between rays origin points and their points of intesection
+			\param quality Quality of the BVH to build when geometry is added.
 			\code
 				// Requires #include "embree_raytracer.h", #include "objloader.h"
 
@@ -397,7 +515,7 @@ namespace HF::RayTracer {
 				EmbreeRayTracer ert;
 			\endcode
 		*/
-		EmbreeRayTracer(bool use_precise = false);
+		EmbreeRayTracer(bool use_precise = false, BUILD_QUALITY quality = BUILD_QUALITY::HIGH);
 
 		/// <summary> Create a new EmbreeRayTracer and add a single mesh to the scene. </summary>
 		/// <param name="MI"> The mesh to use for scene construction. </param>
@@ -425,9 +543,16 @@ namespace HF::RayTracer {
 
 				// Create the EmbreeRayTracer
 				auto ert = EmbreeRayTracer(geom);
+
+				// Create an EmbreeRayTracer that builds quickly, for a scene that will be edited often
+				auto interactive_ert = EmbreeRayTracer(geom, false, HF::RayTracer::BUILD_QUALITY::LOW);
 			\endcode
 		*/
-		EmbreeRayTracer(std::vector<HF::Geometry::MeshInfo<float>>& MI, bool use_precise_intersection = false);
+		EmbreeRayTracer(
+			std::vector<HF::Geometry::MeshInfo<float>>& MI,
+			bool use_precise_intersection = false,
+			BUILD_QUALITY quality = BUILD_QUALITY::HIGH
+		);
 
 		/*! 
 			\brief Construct the raytracer using only a single mesh.
@@ -435,8 +560,33 @@ namespace HF::RayTracer {
 			\param MI MeshInfo<float> instance to create the BVH with.
 			\param use_precise If set to true, use a more precise intesection algorithm to determine
 							   the distance between rays origin points and their points of intesection
+			\param quality Quality of the BVH to build.
+		*/
+		EmbreeRayTracer(HF::Geometry::MeshInfo<float>& MI, bool use_precise = false, BUILD_QUALITY quality = BUILD_QUALITY::HIGH);
+
+		/*!
+			\brief Create a new EmbreeRayTracer that takes ownership of the buffers of every mesh in `MI`.
+
+			\param MI Meshes to add to the scene. Each is left without vertices or triangles, but with
+			the ID it was added to the scene with.
+			\param use_precise_intersection If set to true, use a more precise intesection algorithm to determine
+				   the distance between rays origin points and their points of intesection
+			\param quality Quality of the BVH to build.
+
+			\throws std::logic_error `MI` is empty.
+			\throws HF::Exceptions::InvalidOBJ A mesh in `MI` has no vertices or triangles.
+
+			\details
+			Rather than copying the meshes into buffers allocated by embree, embree reads the meshes'
+			own buffers. This is the cheapest way to construct a raytracer from a large model.
+
+			\see AddMesh(HF::Geometry::MeshInfo<float>&&, bool) for details.
 		*/
-		EmbreeRayTracer(HF::Geometry::MeshInfo<float>& MI, bool use_precise = false);
+		EmbreeRayTracer(
+			std::vector<HF::Geometry::MeshInfo<float>>&& MI,
+			bool use_precise_intersection = false,
+			BUILD_QUALITY quality = BUILD_QUALITY::HIGH
+		);
 
 
 		/*! \brief Construct a raytracer using another raytracer.
@@ -482,7 +632,7 @@ namespace HF::RayTracer {
 				auto ert = HF::RayTracer::EmbreeRayTracer(directions);
 			\endcode
 		*/
-		EmbreeRayTracer(const std::vector<std::array<float, 3>>& geometry);
+		EmbreeRayTracer(const std::vector<std::array<float, 3>>& geometry, BUILD_QUALITY quality = BUILD_QUALITY::HIGH);
 
 		/// <summary> Add a new mesh to this raytracer's BVH with the specified ID. </summary>
 /// <param name="Mesh"> A vector of 3d points composing the mesh </param>
@@ -586,6 +736,32 @@ namespace HF::RayTracer {
 		*/
 		bool AddMesh(HF::Geometry::MeshInfo<float>& Mesh, bool Commit);
 
+		/*!
+			\brief Add a new mesh to the scene by taking ownership of its buffers instead of copying them.
+
+			\param Mesh Mesh to add to the scene. Its meshid will be updated with the ID it was added with.
+			\param Commit Whether or not to commit changes to the scene after adding the mesh.
+
+			\returns True.
+
+			\throws HF::Exceptions::InvalidOBJ `Mesh` has no vertices or triangles.
+
+			\post `Mesh` has no vertices or triangles, but keeps its name and ID.
+
+			\details
+			The vertices and indices of `Mesh` are released with MeshInfo::ReleaseBuffers, then registered
+			with embree as shared buffers. Embree builds its BVH by reading them in place, and this
+			raytracer frees them once the mesh is no longer used by any copy of it. Adding a large mesh
+			this way never holds more than one copy of its geometry in memory.
+
+			Meshes added this way can be edited with UpdateMeshVertices, TransformMesh and
+			ReplaceMesh like any other mesh.
+
+			\par Example
+			\snippet tests\src\embree_raytracer.cpp EX_AddMeshShared
+		*/
+		bool AddMesh(HF::Geometry::MeshInfo<float>&& Mesh, bool Commit);
+
 		/// <summary> Add several new meshes to the BVH. </summary>
 /// <param name="Meshes"> A vector of meshinfo to each be added as a seperate mesh. </param>
 /// <param name="Commit">
@@ -645,6 +821,182 @@ namespace HF::RayTracer {
 */
 		bool AddMesh(std::vector<HF::Geometry::MeshInfo<float>>& Meshes, bool Commit = true);
 
+		/*!
+			\brief Add several meshes to the scene by taking ownership of their buffers.
+
+			\param Meshes Meshes to add. Each is left without vertices or triangles, but with
+			the ID it was added to the scene with.
+			\param Commit Whether or not to commit changes to the scene after every mesh has been added.
+
+			\returns True.
+
+			\throws HF::Exceptions::InvalidOBJ A mesh in `Meshes` has no vertices or triangles. Every mesh
+			is checked before any buffers are taken, so neither `Meshes` nor the scene are modified.
+
+			\see AddMesh(HF::Geometry::MeshInfo<float>&&, bool) for details.
+		*/
+		bool AddMesh(std::vector<HF::Geometry::MeshInfo<float>>&& Meshes, bool Commit = true);
+
+		/*!
+			\brief Save the vertices, triangles and IDs of every mesh in this raytracer's scene to a file.
+
+			\param path Path to write the scene cache to. Any existing file at this path will be overwritten.
+			\param key Value identifying the geometry the scene was built from, such as the result of SceneCacheKey.
+					   LoadScene can be given this key to reject files that were saved from different geometry.
+
+			\returns True if the file was written successfully, false if it couldn't be opened or written to.
+
+			\details
+			Writes the vertex and index buffers of every mesh exactly as they were given to Embree, after
+			vertices have been deduplicated and converted. Loading the file skips parsing the mesh and
+			rebuilding these buffers entirely, leaving only the BVH build.
+
+			\see LoadScene to create a raytracer from a file written by this function.
+
+			\par Example
+			\snippet tests\src\embree_raytracer.cpp EX_SaveLoadScene
+		*/
+		bool SaveScene(const std::string& path, uint64_t key = 0) const;
+
+		/*!
+			\brief Create a raytracer from a scene cache written by SaveScene.
+
+			\param path Path to the scene cache.
+			\param key If not 0, only accept a file that was saved with this same key.
+			\param use_precise If true, use the more precise intersection algorithm for the loaded raytracer.
+			\param quality Quality of the BVH to build from the cached geometry.
+
+			\returns A raytracer containing every mesh from the cache, with the same IDs they were saved with.
+
+			\throws HF::Exceptions::FileNotFound No file exists at `path`.
+			\throws std::runtime_error The file isn't a scene cache, was written with an unsupported version
+									   of the format, is truncated, has a triangle with a vertex that doesn't exist,
+									   or doesn't match `key`.
+		*/
+		static EmbreeRayTracer LoadScene(
+			const std::string& path,
+			uint64_t key = 0,
+			bool use_precise = false,
+			BUILD_QUALITY quality = BUILD_QUALITY::HIGH
+		);
+
+		/*!
+			\brief Remove a mesh or instance from the scene.
+
+			\param id ID of the mesh or instance to remove.
+			\param Commit Whether or not to commit the scene. Only do this after the last edit in a batch.
+
+			\returns True if the mesh was removed, false if there was no mesh with `id` in the scene.
+
+			\details
+			The ID of the removed mesh is freed, and may be assigned to the next mesh that's added.
+
+			\par Example
+			\snippet tests\src\embree_raytracer.cpp EX_EditScene
+		*/
+		bool RemoveMesh(int id, bool Commit = true);
+
+		/*!
+			\brief Overwrite the vertices of a mesh in the scene, keeping its triangles.
+
+			\param id ID of the mesh to update.
+			\param vertices New vertices of the mesh, with every 3 floats representing a vertex. Must be
+							indexed the same way as the mesh's vertices, as returned by MeshInfo::GetIndexedVertices.
+			\param Commit Whether or not to commit the scene.
+
+			\returns True if the mesh was updated, false if there was no mesh with `id` or `vertices`
+					 contains a different number of vertices than the mesh.
+
+			\remarks
+			The mesh's BVH is refit to its new vertices instead of being rebuilt. Embree only keeps
+			separate per-mesh BVHs when the scene's build quality is BUILD_QUALITY::LOW, so construct
+			the raytracer with that quality if meshes will be updated often.
+		*/
+		bool UpdateMeshVertices(int id, const std::vector<float>& vertices, bool Commit = true);
+
+		/*!
+			\brief Apply a transform to every vertex of a mesh in the scene.
+
+			\param id ID of the mesh to transform.
+			\param transform Transform to apply to the mesh's vertices.
+			\param Commit Whether or not to commit the scene.
+
+			\returns True if the mesh was transformed, false if there was no mesh with `id`.
+
+			\details
+			The transform is applied to the mesh's current vertices, so transforms are cumulative.
+			The mesh's BVH is refit as it is in UpdateMeshVertices.
+
+			\see SetInstanceTransform to move an instance.
+		*/
+		bool TransformMesh(int id, const InstanceTransform& transform, bool Commit = true);
+
+		/*!
+			\brief Replace the geometry of a mesh in the scene with the geometry of another mesh.
+
+			\param Mesh Mesh to replace the existing mesh with. The mesh with the same ID as this mesh
+						will be replaced. If there is no mesh with its ID, `Mesh` is added instead.
+			\param Commit Whether or not to commit the scene.
+
+			\returns True on completion.
+
+			\details
+			If `Mesh` has the same number of vertices and triangles as the existing mesh, its buffers
+			are overwritten in place. The BVH is only refit if every triangle has the same indices
+			as before, and is rebuilt at the scene's build quality otherwise. If the counts differ,
+			the existing mesh is removed and `Mesh` is added in its place with the same ID.
+
+			\throws HF::Exceptions::InvalidOBJ `Mesh` has no vertices or triangles.
+		*/
+		bool ReplaceMesh(HF::Geometry::MeshInfo<float>& Mesh, bool Commit = true);
+
+		/*!
+			\brief Build a BVH for a mesh that can be placed in the scene any number of times with AddInstance.
+
+			\param Mesh Mesh to instance.
+
+			\returns The index of the new prototype, to be given to AddInstance.
+
+			\details
+			The prototype isn't part of the scene by itself. Every instance of it shares the prototype's
+			BVH, so placing a repeated object many times costs no more to build than placing it once.
+
+			\throws HF::Exceptions::InvalidOBJ `Mesh` has no vertices or triangles.
+		*/
+		int AddPrototype(HF::Geometry::MeshInfo<float>& Mesh);
+
+		/*!
+			\brief Place an instance of a prototype in the scene.
+
+			\param prototype Index of the prototype returned by AddPrototype.
+			\param transform Transform from the prototype's space to the scene.
+			\param id ID to attempt to add the instance with. If it's already taken, or -1, the next available
+					  ID will be used instead.
+			\param Commit Whether or not to commit the scene.
+
+			\returns The ID of the instance. Hits on the instance will report this as their meshid.
+
+			\remarks
+			Hits on instances always use embree's distance, even if `use_precise` is true.
+
+			\throws std::out_of_range `prototype` isn't the index of a prototype in this raytracer.
+		*/
+		int AddInstance(int prototype, const InstanceTransform& transform, int id = -1, bool Commit = true);
+
+		/*!
+			\brief Move an instance by replacing its transform.
+
+			\param id ID of the instance to move.
+			\param transform New transform from the prototype's space to the scene.
+			\param Commit Whether or not to commit the scene.
+
+			\returns True if the instance was moved, false if there was no instance with `id`.
+		*/
+		bool SetInstanceTransform(int id, const InstanceTransform& transform, bool Commit = true);
+
+		/*! \brief Commit every change made to the scene since the last commit. */
+		void CommitScene();
+
 		/// <summary>
 		/// Cast a ray and overwrite the origin with the hitpoint if it intersects any geometry.
 		/// </summary>
@@ -975,6 +1327,135 @@ namespace HF::RayTracer {
 			, bool use_parallel = true
 		);
 
+		/*! \brief Cast a batch of rays as Embree ray streams and get the distance and meshid of every hit.
+
+			\param origins Origin points of every ray. If only one is supplied, it will be used for every direction.
+			\param directions Directions of every ray. If only one is supplied, it will be used for every origin.
+			\param max_distance Maximum distance a ray can travel before intersections are ignored. Set to -1
+								for infinite distance.
+			\param use_parallel If true, streams will be cast in parallel using all available cores.
+
+			\returns An ordered array with one HitStruct for every ray cast. Rays that do not result in an
+					 intersection will have a meshid of -1, checkable with the HitStruct's DidHit() function.
+
+			\details
+			Rays are packed into blocks of RAY_STREAM_SIZE and traced with `rtcIntersect1M`, allowing Embree to
+			regroup them into SIMD packets internally instead of traversing the BVH one ray at a time. When every
+			ray shares the same origin or the same direction, the streams are marked as coherent.
+
+			\remarks
+			If `use_precise` is set to true, then the distance of every hit will be recalculated using the more
+			precise intersection algorithm after the stream has been traced.
+
+			\exception std::runtime_error The sizes of origins and directions didn't match any of the
+										  valid configurations described in PointIntersections.
+
+			\see OccludedStream for the occlusion equivalent of this function.
+		*/
+		std::vector<HitStruct<float>> IntersectStream(
+			const std::vector<std::array<float, 3>>& origins,
+			const std::vector<std::array<float, 3>>& directions,
+			float max_distance = -1,
+			bool use_parallel = true
+		);
+
+		/*! \brief Cast a batch of occlusion rays as Embree ray streams.
+
+			\param origins Origin points of every ray. If only one is supplied, it will be used for every direction.
+			\param directions Directions of every ray. If only one is supplied, it will be used for every origin.
+			\param max_distance Maximum distance a ray can travel before intersections are ignored. Set to -1
+								for infinite distance.
+			\param use_parallel If true, streams will be cast in parallel using all available cores.
+
+			\returns An ordered array of chars where every true indicates a hit and every false indicates a miss.
+
+			\details
+			Identical to Occlusions, but rays are traced in blocks of RAY_STREAM_SIZE with `rtcOccluded1M`.
+
+			\exception std::runtime_error The sizes of origins and directions didn't match any of the
+										  valid configurations described in Occlusions.
+
+			\see IntersectStream for more information on how rays are grouped.
+		*/
+		std::vector<char> OccludedStream(
+			const std::vector<std::array<float, 3>>& origins,
+			const std::vector<std::array<float, 3>>& directions,
+			float max_distance = -1,
+			bool use_parallel = true
+		);
+
+		/*! \brief Cast a batch of occlusion rays as Embree ray streams, each with its own maximum distance.
+
+			\param origins Origin points of every ray. If only one is supplied, it will be used for every direction.
+			\param directions Directions of every ray. If only one is supplied, it will be used for every origin.
+			\param max_distances Maximum distance of every ray. If only one is supplied, it will be used for every ray.
+			\param use_parallel If true, streams will be cast in parallel using all available cores.
+
+			\returns An ordered array of chars where every true indicates a hit and every false indicates a miss.
+
+			\details
+			Useful for line of sight checks between pairs of points, where every ray must stop at its target.
+
+			\exception std::runtime_error The sizes of origins, directions, and max_distances didn't match any of
+										  the valid configurations.
+		*/
+		std::vector<char> OccludedStream(
+			const std::vector<std::array<float, 3>>& origins,
+			const std::vector<std::array<float, 3>>& directions,
+			const std::vector<float>& max_distances,
+			bool use_parallel = true
+		);
+
+		/*! \brief Find the closest point on any geometry to `point`.
+
+			\param point Point to find the closest geometry to.
+			\param max_distance Only consider geometry within this distance of `point`. Set to -1 for infinite
+								distance.
+			\param ignore_horizontal If true, ignore triangles that face within 45 degrees of straight up or down,
+									 such as floors and ceilings.
+			\param filter If not null, only meshes this filter accepts are considered.
+
+			\returns The closest point on any geometry, its distance from `point`, and the ID of the mesh it's on.
+					 If no geometry was found within `max_distance` the returned meshid will be -1.
+
+			\details
+			Uses embree's point queries, which skip every part of the BVH further away than the closest
+			triangle found so far. Instances are reported with their own ID, like Intersect.
+
+			\remarks Use FindClosestPoints to query many points at once.
+
+			\par Example
+			\snippet tests\src\embree_raytracer.cpp EX_FindClosestPoint
+		*/
+		ClosestPoint FindClosestPoint(
+			const std::array<float, 3>& point,
+			float max_distance = -1,
+			bool ignore_horizontal = false,
+			const MeshFilter* filter = nullptr
+		) const;
+
+		/*! \brief Find the closest point on any geometry to every point in `points`.
+
+			\param points Points to find the closest geometry to.
+			\param max_distance Only consider geometry within this distance of each point. Set to -1 for
+								infinite distance.
+			\param ignore_horizontal If true, ignore triangles that face within 45 degrees of straight up or down,
+									 such as floors and ceilings.
+			\param filter If not null, only meshes this filter accepts are considered.
+			\param use_parallel If true, points will be queried in parallel using all available cores.
+
+			\returns An ordered array with the closest point for every point in `points`.
+
+			\see FindClosestPoint for details on each query.
+		*/
+		std::vector<ClosestPoint> FindClosestPoints(
+			const std::vector<std::array<float, 3>>& points,
+			float max_distance = -1,
+			bool ignore_horizontal = false,
+			const MeshFilter* filter = nullptr,
+			bool use_parallel = true
+		) const;
+
 
 		/*! \brief Cast a ray from origin in direction. 
 		
@@ -988,6 +1469,8 @@ namespace HF::RayTracer {
 								for infinite distance.
 			\param mesh_id Only consider intersections with the mesh at this ID. Set to -1 to consider
 							intersections with all meshes. 
+			\param filter If not null, the ray will pass through any mesh this filter doesn't accept
+						  and return the first hit on a mesh it does accept.
 
 			\returns The distance from origin to the ray's point of intersection. If no intersection was found
 					 the returned hitstruct's meshID will be -1. This is checkable with the hitstruct's DidHit()
@@ -1004,9 +1487,10 @@ namespace HF::RayTracer {
 		HitStruct<return_type> Intersect(
 			const N& node,
 			const V& direction,
-			float max_distance = -1.0f, int mesh_id = -0.1f)
+			float max_distance = -1.0f, int mesh_id = -0.1f,
+			const MeshFilter* filter = nullptr)
 		{
-			return Intersect<return_type>(node[0], node[1], node[2], direction[0], direction[1], direction[2], max_distance, mesh_id);
+			return Intersect<return_type>(node[0], node[1], node[2], direction[0], direction[1], direction[2], max_distance, mesh_id, filter);
 		}
 
 		/*! \brief Cast a ray from origin in direction.
@@ -1025,6 +1509,8 @@ namespace HF::RayTracer {
 								for infinite distance.
 			\param mesh_id Ignore intersections with any mesh other than the mesh with this ID. set to -1 to
 					        consider intersections with any geometry
+			\param filter If not null, the ray will pass through any mesh this filter doesn't accept
+						  and return the first hit on a mesh it does accept.
 
 			\returns The distance from origin to the ray's point of intersection. If no intersection was found
 					 the returned hitstruct's meshID will be -1. This is checkable with the hitstruct's DidHit()
@@ -1044,7 +1530,8 @@ namespace HF::RayTracer {
 		HitStruct<return_type> Intersect(
 				numeric1 x, numeric1 y, numeric1 z,
 				numeric2 dx, numeric2 dy, numeric2 dz,
-				float distance = -1.0f, int mesh_id = -1)
+				float distance = -1.0f, int mesh_id = -1,
+				const MeshFilter* filter = nullptr)
 		{
 			// create output value
 			HitStruct<return_type> out_struct;
@@ -1052,14 +1539,14 @@ namespace HF::RayTracer {
 			// Cast the ray
 			auto result = Intersect_IMPL(
 				x,y,z,
-				dx,dy,dz, distance, mesh_id
+				dx,dy,dz, distance, mesh_id, filter
 			);
 
 			// If an intersection occured, update the struct. 
 			if (DidIntersect(result.hit.geomID))
 			{
-				// Use a precise ray intersection if required
-				if (!(this->use_precise))
+				// Use a precise ray intersection if required. Instances don't store their vertices in world space.
+				if (!(this->use_precise) || result.hit.instID[0] != RTC_INVALID_GEOMETRY_ID)
 					out_struct.distance = result.ray.tfar;
 				else
 					out_struct.distance = CalculatePreciseDistance(
@@ -1170,6 +1657,7 @@ namespace HF::RayTracer {
 			\param direction Direction to cast the ray in. Same constraints as node, but can be a different type.
 			\param max_distance Maximum distance a ray can travel before intersections are ignored. Set to -1 
 								for infinite distance.
+			\param filter If not null, intersections with any mesh this filter doesn't accept are ignored.
 
 			\returns `true` if the ray intersected with any geometry within max_distance, `false` otherwise
 		
@@ -1190,12 +1678,13 @@ namespace HF::RayTracer {
 			const N& origin,
 			const V& direction,
 			float max_distance = -1.0f,
-			int mesh_id = -1
+			int mesh_id = -1,
+			const MeshFilter* filter = nullptr
 		) {
 			return Occluded_IMPL(
 				origin[0], origin[1], origin[2],
 				direction[0], direction[1], direction[2],
-				max_distance, mesh_id
+				max_distance, mesh_id, filter
 			);
 		}
 
@@ -1217,6 +1706,7 @@ namespace HF::RayTracer {
 								for infinite distance.
 			\param mesh_id Ignore intersections with any mesh other than the mesh with this ID. set to -1 to
 					        consider intersections with any geometry
+			\param filter If not null, intersections with any mesh this filter doesn't accept are ignored.
 
 			\returns `true` if the ray intersected with any geometry within max_distance, `false` otherwise
 
@@ -1237,12 +1727,13 @@ namespace HF::RayTracer {
 			numeric1 x, numeric1 y, numeric1 z,
 			numeric2 dx, numeric2 dy, numeric2 dz,
 			dist_type max_distance = -1.0,
-			int mesh_id = -1
+			int mesh_id = -1,
+			const MeshFilter* filter = nullptr
 		) {
 			return Occluded_IMPL(
 				x,y,z,
 				dx,dy,dz,
-				max_distance, mesh_id
+				max_distance, mesh_id, filter
 			);
 		}
 
@@ -1328,5 +1819,29 @@ namespace HF::RayTracer {
 		const Vector3D& v1,
 		const Vector3D& v2,
 		const Vector3D& v3);
+
+	/*!
+		\brief Hash the contents of a set of meshes into a key for EmbreeRayTracer::SaveScene.
+
+		\param meshes Meshes to hash.
+
+		\returns A 64-bit FNV-1a hash of the ID, vertices, and indices of every mesh in `meshes`.
+	*/
+	uint64_t SceneCacheKey(const std::vector<HF::Geometry::MeshInfo<float>>& meshes);
+
+	/*!
+		\brief Hash the contents of a file into a key for EmbreeRayTracer::SaveScene.
+
+		\param file_path Path to the file to hash, such as the OBJ the scene is loaded from.
+
+		\returns A 64-bit FNV-1a hash of every byte in the file.
+
+		\throws HF::Exceptions::FileNotFound No file exists at `file_path`.
+
+		\remarks
+		Hashing the source file instead of the parsed meshes allows a cached scene to be found
+		without parsing the file at all.
+	*/
+	uint64_t SceneCacheKey(const std::string& file_path);
 }
 #endif
@@ -0,0 +1,269 @@
+///
+/// \file		embree_scene_cache.cpp
+/// \brief		Contains implementation for saving and loading the scene of an <see cref="HF::RayTracer::EmbreeRayTracer">EmbreeRayTracer</see>
+///
+///	\author		TBA
+///	\date		26 Jun 2020
+
+#include <embree_raytracer.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <meshinfo.h>
+#include <HFExceptions.h>
+
+using std::string;
+using std::vector;
+
+namespace HF::RayTracer {
+
+	constexpr char SCENE_FILE_MAGIC[8] = { 'D', 'H', 'A', 'R', 'T', 'S', 'C', '\0' }; ///< First bytes of every scene cache.
+	constexpr uint32_t SCENE_FILE_VERSION = 2; ///< Version of the scene cache format written by SaveScene.
+
+	constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull; ///< Starting value of a 64-bit FNV-1a hash.
+	constexpr uint64_t FNV_PRIME = 1099511628211ull; ///< Multiplier of a 64-bit FNV-1a hash.
+
+	/*!
+		\brief The first section of every scene cache.
+
+		\details
+		The header is followed by `num_prototypes` prototypes, then `num_meshes` meshes. Each is
+		made of a SceneFileMesh, then `num_vertices` x,y,z triplets of floats, then `num_triangles`
+		triplets of vertex indices. The file ends with `num_instances` SceneFileInstances.
+	*/
+	struct SceneFileHeader {
+		char magic[8];			///< Must match SCENE_FILE_MAGIC.
+		uint32_t version;		///< Version of the format this file was written with.
+		uint32_t num_meshes;	///< Number of triangle meshes in the scene.
+		uint64_t key;			///< Key the scene was saved with.
+		uint32_t num_prototypes;///< Number of meshes that can be instanced.
+		uint32_t num_instances;	///< Number of instances in the scene.
+	};
+
+	/*! \brief Describes a single mesh in a scene cache. */
+	struct SceneFileMesh {
+		int32_t id;				///< ID of the mesh in the scene.
+		uint32_t num_vertices;	///< Number of vertices in the mesh.
+		uint32_t num_triangles;	///< Number of triangles in the mesh.
+		uint32_t reserved;		///< Unused. Keeps this a multiple of 8 bytes.
+	};
+
+	/*! \brief An instance of a prototype in a scene cache. */
+	struct SceneFileInstance {
+		int32_t id;					///< ID of the instance in the scene.
+		int32_t prototype;			///< Index of the prototype being instanced.
+		InstanceTransform transform;///< Transform of the instance.
+	};
+
+	/*! \brief Write the header and buffers of a triangle mesh. */
+	inline void WriteMesh(std::ofstream& out, int id, RTCGeometry geom, unsigned int num_vertices, unsigned int num_triangles) {
+		const SceneFileMesh mesh_header{ id, num_vertices, num_triangles, 0 };
+		out.write(reinterpret_cast<const char*>(&mesh_header), sizeof(mesh_header));
+
+		// Write the buffers embree is already using, since they're already deduplicated
+		const char* vertices = static_cast<const char*>(rtcGetGeometryBufferData(geom, RTC_BUFFER_TYPE_VERTEX, 0));
+		const char* triangles = static_cast<const char*>(rtcGetGeometryBufferData(geom, RTC_BUFFER_TYPE_INDEX, 0));
+		out.write(vertices, sizeof(float) * 3 * num_vertices);
+		out.write(triangles, sizeof(uint32_t) * 3 * num_triangles);
+	}
+
+	/*!
+		\brief Read the header and buffers of a triangle mesh into new geometry.
+
+		\param in File to read from.
+		\param device Device to create the geometry with.
+		\param file_size Size of the file, to check counts against before allocating.
+		\param offset Number of bytes read from the file so far. Updated to include this mesh.
+		\param mesh Output for the header of the mesh that was read.
+
+		\returns Uncommitted geometry containing the mesh.
+
+		\throws std::runtime_error The file ends before the mesh does, or one of its triangles
+		references a vertex that doesn't exist.
+	*/
+	inline RTCGeometry ReadMesh(std::ifstream& in, RTCDevice device, uint64_t file_size, uint64_t& offset, SceneFileMesh& mesh) {
+		if (!in.read(reinterpret_cast<char*>(&mesh), sizeof(mesh)))
+			throw std::runtime_error("Scene cache is truncated");
+
+		// Check sizes before allocating anything so a corrupt count can't trigger a huge allocation
+		const uint64_t vertex_bytes = sizeof(float) * 3 * uint64_t(mesh.num_vertices);
+		const uint64_t triangle_bytes = sizeof(uint32_t) * 3 * uint64_t(mesh.num_triangles);
+		offset += sizeof(mesh) + vertex_bytes + triangle_bytes;
+		if (offset > file_size)
+			throw std::runtime_error("Scene cache is truncated");
+
+		// Read straight into embree's buffers. Both are padded by one element, as in
+		// ConstructGeometryFromBuffers, since embree may read past the end of them.
+		RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_TRIANGLE);
+		char* triangles = static_cast<char*>(rtcSetNewGeometryBuffer(
+			geom, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3,
+			sizeof(uint32_t) * 3, mesh.num_triangles + 1
+		));
+		char* vertices = static_cast<char*>(rtcSetNewGeometryBuffer(
+			geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3,
+			sizeof(float) * 3, mesh.num_vertices + 1
+		));
+		in.read(vertices, vertex_bytes);
+		in.read(triangles, triangle_bytes);
+
+		// Embree doesn't check indices, so one past the end of the vertices would be read out of bounds
+		const uint32_t* indices = reinterpret_cast<const uint32_t*>(triangles);
+		const uint64_t num_indices = 3 * uint64_t(mesh.num_triangles);
+		const bool valid = in.good() && std::all_of(
+			indices, indices + num_indices,
+			[&mesh](uint32_t index) { return index < mesh.num_vertices; }
+		);
+		if (!valid) {
+			rtcReleaseGeometry(geom);
+			throw std::runtime_error("Scene cache contains a triangle with a vertex that doesn't exist");
+		}
+
+		return geom;
+	}
+
+	/*! \brief Add `num_bytes` bytes from `data` to the FNV-1a hash `hash`. */
+	inline uint64_t HashBytes(uint64_t hash, const void* data, size_t num_bytes) {
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < num_bytes; i++) {
+			hash ^= bytes[i];
+			hash *= FNV_PRIME;
+		}
+		return hash;
+	}
+
+	uint64_t SceneCacheKey(const vector<HF::Geometry::MeshInfo<float>>& meshes) {
+		uint64_t hash = FNV_OFFSET_BASIS;
+		for (const auto& mesh : meshes) {
+			const int id = mesh.GetMeshID();
+			const auto vertices = mesh.GetIndexedVertices();
+			const auto indices = mesh.getRawIndices();
+
+			hash = HashBytes(hash, &id, sizeof(id));
+			hash = HashBytes(hash, vertices.data(), vertices.size() * sizeof(float));
+			hash = HashBytes(hash, indices.data(), indices.size() * sizeof(int));
+		}
+		return hash;
+	}
+
+	uint64_t SceneCacheKey(const string& file_path) {
+		std::ifstream in(file_path, std::ios::binary);
+		if (!in.good())
+			throw HF::Exceptions::FileNotFound();
+
+		// Read in blocks so large models don't have to fit in memory twice
+		uint64_t hash = FNV_OFFSET_BASIS;
+		vector<char> block(1 << 20);
+		while (in) {
+			in.read(block.data(), block.size());
+			hash = HashBytes(hash, block.data(), static_cast<size_t>(in.gcount()));
+		}
+		return hash;
+	}
+
+	bool EmbreeRayTracer::SaveScene(const string& path, uint64_t key) const {
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		if (!out.good()) return false;
+
+		const auto num_instances = std::count_if(
+			contents->geometry.begin(), contents->geometry.end(),
+			[](const SceneMesh& mesh) { return mesh.prototype >= 0; }
+		);
+
+		SceneFileHeader header;
+		std::memcpy(header.magic, SCENE_FILE_MAGIC, sizeof(header.magic));
+		header.version = SCENE_FILE_VERSION;
+		header.num_meshes = static_cast<uint32_t>(contents->geometry.size() - num_instances);
+		header.key = key;
+		header.num_prototypes = static_cast<uint32_t>(contents->prototypes.size());
+		header.num_instances = static_cast<uint32_t>(num_instances);
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		for (const auto& prototype : contents->prototypes) {
+			const SceneMesh& mesh = prototype.mesh;
+			WriteMesh(out, mesh.id, mesh.geom, mesh.num_vertices, mesh.num_triangles);
+		}
+		for (const auto& mesh : contents->geometry)
+			if (mesh.prototype < 0)
+				WriteMesh(out, mesh.id, mesh.geom, mesh.num_vertices, mesh.num_triangles);
+
+		for (const auto& mesh : contents->geometry) {
+			if (mesh.prototype < 0) continue;
+			const SceneFileInstance instance{ mesh.id, mesh.prototype, mesh.transform };
+			out.write(reinterpret_cast<const char*>(&instance), sizeof(instance));
+		}
+
+		return out.good();
+	}
+
+	EmbreeRayTracer EmbreeRayTracer::LoadScene(
+		const string& path,
+		uint64_t key,
+		bool use_precise,
+		BUILD_QUALITY quality
+	) {
+		std::ifstream in(path, std::ios::binary | std::ios::ate);
+		if (!in.good())
+			throw HF::Exceptions::FileNotFound();
+
+		const uint64_t file_size = static_cast<uint64_t>(in.tellg());
+		in.seekg(0);
+
+		SceneFileHeader header;
+		if (file_size < sizeof(header) || !in.read(reinterpret_cast<char*>(&header), sizeof(header)))
+			throw std::runtime_error("Scene cache is truncated");
+		if (std::memcmp(header.magic, SCENE_FILE_MAGIC, sizeof(header.magic)) != 0)
+			throw std::runtime_error("File is not a scene cache");
+		if (header.version != SCENE_FILE_VERSION)
+			throw std::runtime_error("Scene cache was written with an unsupported version of the format");
+		if (key != 0 && header.key != key)
+			throw std::runtime_error("Scene cache was saved from different geometry");
+
+		EmbreeRayTracer ert(use_precise, quality);
+		ert.use_precise = use_precise;
+
+		uint64_t offset = sizeof(header);
+		for (uint32_t i = 0; i < header.num_prototypes; i++) {
+			SceneFileMesh mesh;
+			RTCGeometry geom = ReadMesh(in, ert.device, file_size, offset, mesh);
+			rtcCommitGeometry(geom);
+
+			Prototype prototype{ rtcNewScene(ert.device), SceneMesh{ -1, geom, mesh.num_vertices, mesh.num_triangles } };
+			rtcSetSceneBuildQuality(prototype.scene, RTC_BUILD_QUALITY_HIGH);
+			rtcSetSceneFlags(prototype.scene, RTC_SCENE_FLAG_ROBUST | RTC_SCENE_FLAG_CONTEXT_FILTER_FUNCTION);
+			prototype.mesh.id = static_cast<int>(rtcAttachGeometry(prototype.scene, geom));
+			rtcCommitScene(prototype.scene);
+			ert.contents->prototypes.push_back(prototype);
+		}
+
+		for (uint32_t i = 0; i < header.num_meshes; i++) {
+			SceneFileMesh mesh;
+			RTCGeometry geom = ReadMesh(in, ert.device, file_size, offset, mesh);
+
+			ert.contents->geometry.push_back(SceneMesh{ -1, geom, mesh.num_vertices, mesh.num_triangles });
+			rtcSetGeometryBuildQuality(geom, static_cast<RTCBuildQuality>(quality));
+			rtcCommitGeometry(geom);
+			ert.InsertGeom(geom, mesh.id);
+		}
+
+		offset += sizeof(SceneFileInstance) * uint64_t(header.num_instances);
+		if (offset > file_size)
+			throw std::runtime_error("Scene cache is truncated");
+		for (uint32_t i = 0; i < header.num_instances; i++) {
+			SceneFileInstance instance;
+			in.read(reinterpret_cast<char*>(&instance), sizeof(instance));
+			if (instance.prototype < 0 || instance.prototype >= static_cast<int>(ert.contents->prototypes.size()))
+				throw std::runtime_error("Scene cache contains an instance of a prototype that doesn't exist");
+
+			ert.AddInstance(instance.prototype, instance.transform, instance.id, false);
+		}
+
+		if (!in)
+			throw std::runtime_error("Scene cache is truncated");
+
+		rtcCommitScene(ert.scene);
+		return ert;
+	}
+}
@@ -5,6 +5,8 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <thread>
+#include <stdexcept>
 
 
 nanoRT_Data::nanoRT_Data(HF::nanoGeom::Mesh * m) : 
@@ -118,47 +120,122 @@ namespace HF::nanoGeom {
 }; // end namespace
 
 namespace HF::RayTracer{
-   
-    NanoRTRayTracer::NanoRTRayTracer(const HF::Geometry::MeshInfo<float>& MI) {
-        // Get the index and vertex arrays of the meshinfo
-        auto mi_vertices = MI.GetVertexPointer().CopyArray();
-        vertices.resize(mi_vertices.size());
-        for (int i = 0; i < mi_vertices.size(); i++)
-            vertices[i] = static_cast<vertex_t>(mi_vertices[i]);
-
-        // Convert indices to unsigned integer because that's what nanoRT uses
-        auto mi_indices = MI.GetIndexPointer().CopyArray();
-        indices.resize(mi_indices.size());
-        for (int i = 0; i < mi_indices.size(); i++)
-            indices[i] = static_cast<unsigned int>(mi_indices[i]);
-
-        // Build the BVH
-        bvh = HF::nanoGeom::nanoRT_BVH<vertex_t>(indices.data(), vertices.data(), vertices.size() / 3, indices.size() / 3);
-
-        // Create a new intersector. Note: This can't be held as a member by value since you can't even construct this object without
-        // the proper input arguments, however the input arguments cannot be created until we've copied the data from
-        // the mesh and converted it to the proper types. Using a pointer allows us to construct an intersector later.
-        intersector = std::unique_ptr<Intersector>(new Intersector(vertices.data(), indices.data(), sizeof(real_t) * 3));
+
+    template <typename vertex_type>
+    template <typename mesh_type>
+    void BasicNanoRTRayTracer<vertex_type>::AddMesh(const HF::Geometry::MeshInfo<mesh_type>& MI) {
+        const auto mi_vertices = MI.GetVertexPointer();
+        const auto mi_indices = MI.GetIndexPointer();
+
+        // Indices of this mesh need to be offset by the number of vertices already added
+        const unsigned int vertex_offset = static_cast<unsigned int>(vertices.size() / 3);
+
+        // Record which triangles belong to this mesh
+        mesh_offsets.push_back(static_cast<unsigned int>(indices.size() / 3));
+        mesh_ids.push_back(MI.GetMeshID());
+
+        // Read straight from the mesh's buffers, converting to the types NanoRT uses
+        vertices.insert(vertices.end(), mi_vertices.data, mi_vertices.data + mi_vertices.size);
+
+        const size_t first_index = indices.size();
+        indices.resize(first_index + mi_indices.size);
+        for (int i = 0; i < mi_indices.size; i++)
+            indices[first_index + i] = static_cast<unsigned int>(mi_indices.data[i]) + vertex_offset;
     }
-    NanoRTRayTracer::NanoRTRayTracer(const HF::Geometry::MeshInfo<double>& MI) {
-        // Get the index and vertex arrays of the meshinfo
-        auto mi_vertices = MI.GetVertexPointer().CopyArray();
-        vertices.resize(mi_vertices.size());
-        for (int i = 0; i < mi_vertices.size(); i++)
-            vertices[i] = static_cast<vertex_t>(mi_vertices[i]);
-
-        // Convert indices to unsigned integer because that's what nanoRT uses
-        auto mi_indices = MI.GetIndexPointer().CopyArray();
-        indices.resize(mi_indices.size());
-        for (int i = 0; i < mi_indices.size(); i++)
-            indices[i] = static_cast<unsigned int>(mi_indices[i]);
-
-        // Build the BVH
-        bvh = HF::nanoGeom::nanoRT_BVH<vertex_t>(indices.data(), vertices.data(), vertices.size() / 3, indices.size() / 3);
-
-        // Create a new intersector. Note: This can't be held as a member by value since you can't even construct this object without
-        // the proper input arguments, however the input arguments cannot be created until we've copied the data from
-        // the mesh and converted it to the proper types. Using a pointer allows us to construct an intersector later.
-        intersector = std::unique_ptr<Intersector>(new Intersector(vertices.data(), indices.data(), sizeof(real_t) * 3));
+
+    template <typename vertex_type>
+    void BasicNanoRTRayTracer<vertex_type>::BuildBVH(bool parallel_build) {
+        if (indices.empty())
+            throw std::logic_error("NanoRT Ray Tracer was passed a mesh without any triangles!");
+
+        nanort::BVHBuildOptions<vertex_t> build_options;
+        build_options.cache_bbox = false;
+
+        if (parallel_build) {
+            // NanoRT splits the top of the tree into 2^shallow_depth subtrees, then builds
+            // them on separate threads. Create enough subtrees to keep every thread busy.
+            const unsigned int num_threads = std::max(1u, std::thread::hardware_concurrency());
+            while ((1u << build_options.shallow_depth) < num_threads * 2 && build_options.shallow_depth < 8)
+                build_options.shallow_depth++;
+        }
+        else
+            build_options.min_primitives_for_parallel_build = std::numeric_limits<unsigned int>::max();
+
+        nanort::TriangleMesh<vertex_t> triangle_mesh(vertices.data(), indices.data(), sizeof(vertex_t) * 3);
+        nanort::TriangleSAHPred<vertex_t> triangle_pred(vertices.data(), indices.data(), sizeof(vertex_t) * 3);
+
+        bvh.Build(static_cast<unsigned int>(indices.size() / 3), triangle_mesh, triangle_pred, build_options);
     }
-}
\ No newline at end of file
+
+    template <typename vertex_type>
+    BasicNanoRTRayTracer<vertex_type>::BasicNanoRTRayTracer(const HF::Geometry::MeshInfo<float>& MI, bool parallel_build) {
+        AddMesh(MI);
+        BuildBVH(parallel_build);
+    }
+
+    template <typename vertex_type>
+    BasicNanoRTRayTracer<vertex_type>::BasicNanoRTRayTracer(const HF::Geometry::MeshInfo<double>& MI, bool parallel_build) {
+        AddMesh(MI);
+        BuildBVH(parallel_build);
+    }
+
+    template <typename vertex_type>
+    BasicNanoRTRayTracer<vertex_type>::BasicNanoRTRayTracer(const std::vector<HF::Geometry::MeshInfo<float>>& meshes, bool parallel_build) {
+        for (const auto& mesh : meshes)
+            AddMesh(mesh);
+        BuildBVH(parallel_build);
+    }
+
+    template <typename vertex_type>
+    BasicNanoRTRayTracer<vertex_type>::BasicNanoRTRayTracer(const std::vector<HF::Geometry::MeshInfo<double>>& meshes, bool parallel_build) {
+        for (const auto& mesh : meshes)
+            AddMesh(mesh);
+        BuildBVH(parallel_build);
+    }
+
+    template <typename vertex_type>
+    std::vector<HitStruct<double>> BasicNanoRTRayTracer<vertex_type>::Intersections(
+        const std::vector<real3>& origins,
+        const std::vector<real3>& directions,
+        real_t max_distance,
+        bool use_parallel)
+    {
+        const int num_rays = StreamRayCount(origins.size(), directions.size());
+        std::vector<HitStruct<real_t>> out_results(num_rays);
+
+        #pragma omp parallel for if(use_parallel) schedule(dynamic, 128)
+        for (int i = 0; i < num_rays; i++)
+            out_results[i] = this->Intersect(
+                origins[origins.size() == 1 ? 0 : i],
+                directions[directions.size() == 1 ? 0 : i],
+                max_distance
+            );
+
+        return out_results;
+    }
+
+    template <typename vertex_type>
+    std::vector<char> BasicNanoRTRayTracer<vertex_type>::Occlusions(
+        const std::vector<real3>& origins,
+        const std::vector<real3>& directions,
+        real_t max_distance,
+        bool use_parallel)
+    {
+        const int num_rays = StreamRayCount(origins.size(), directions.size());
+        std::vector<char> out_results(num_rays);
+
+        #pragma omp parallel for if(use_parallel) schedule(dynamic, 128)
+        for (int i = 0; i < num_rays; i++)
+            out_results[i] = this->Occluded(
+                origins[origins.size() == 1 ? 0 : i],
+                directions[directions.size() == 1 ? 0 : i],
+                static_cast<float>(max_distance)
+            );
+
+        return out_results;
+    }
+}
+
+template class HF::RayTracer::BasicNanoRTRayTracer<double>;
+
+template class HF::RayTracer::BasicNanoRTRayTracer<float>;
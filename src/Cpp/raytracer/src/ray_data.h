@@ -2,8 +2,12 @@
 #define NANORT_USE_CPP11_FEATURE
 #include "nanort.h"
 #include <HitStruct.h>
+#include <MeshFilter.h>
+#include <RayStream.h>
 #include <iostream>
 #include <array>
+#include <algorithm>
+#include <vector>
 
 #undef max
 // Forward Declares
@@ -132,30 +136,89 @@ namespace HF::nanoGeom {
 }
 namespace HF::RayTracer {
 
-    class NanoRTRayTracer {
+    /*! \brief A raytracer that uses NanoRT to cast rays against one or more meshes.
+
+        \tparam vertex_type Type used to store vertices, build the BVH, and cast rays. Storing vertices
+                            as float uses half the memory of double, at the cost of precision.
+
+        \details
+        The vertices and indices of every mesh are appended into a single pair of arrays, and a single
+        BVH is built over all of them. The ID of the mesh each triangle belongs to is recorded so
+        intersections can report the meshid of the mesh they hit, like the EmbreeRayTracer.
+
+        \see NanoRTRayTracer for a raytracer that stores its vertices as doubles.
+        \see NanoRTRayTracerFloat for a raytracer that stores its vertices as floats.
+    */
+    template <typename vertex_type>
+    class BasicNanoRTRayTracer {
 
     private:
-        using vertex_t = double;
+        using vertex_t = vertex_type;
         using real_t = double;
-        using Intersection = nanort::TriangleIntersection<real_t>;
+        using Intersection = nanort::TriangleIntersection<vertex_t>;
         using Intersector = nanort::TriangleIntersector<vertex_t, Intersection>;
         using NanoBVH = nanort::BVHAccel<vertex_t>;
-        using NanoRay = nanort::Ray<real_t>;
+        using NanoRay = nanort::Ray<vertex_t>;
+        using real3 = std::array<real_t, 3>;
+
+        /*! \brief A triangle intersector that ignores triangles of meshes a MeshFilter rejects. */
+        class FilteredIntersector : public Intersector {
+        private:
+            const BasicNanoRTRayTracer* ray_tracer; ///< Raytracer that owns the triangles being tested
+            const MeshFilter* filter; ///< Filter every triangle's mesh is checked against
+
+        public:
+            inline FilteredIntersector(const BasicNanoRTRayTracer* ray_tracer, const MeshFilter* filter)
+                : Intersector(ray_tracer->vertices.data(), ray_tracer->indices.data(), sizeof(vertex_t) * 3),
+                ray_tracer(ray_tracer), filter(filter) {}
+
+            inline bool Intersect(vertex_t* t_inout, const unsigned int prim_index) const {
+                if (!filter->Accepts(ray_tracer->MeshIDOfPrimitive(prim_index)))
+                    return false;
+                return Intersector::Intersect(t_inout, prim_index);
+            }
+        };
+
+        /*! \brief An intersector that stops traversing the BVH once any triangle is hit.
+
+            \details
+            After the first hit the closest distance is reported as lower than any distance the
+            ray can have, so every remaining node fails its bounding box test and is skipped.
+            Only whether or not the ray hit anything is meaningful afterwards.
+        */
+        template <typename base_intersector>
+        class AnyHitIntersector : public base_intersector {
+        public:
+            using base_intersector::base_intersector;
+
+            inline void Update(vertex_t t, unsigned int prim_idx) const {
+                if (prim_idx == static_cast<unsigned int>(-1))
+                    base_intersector::Update(t, prim_idx);
+                else
+                    base_intersector::Update(std::numeric_limits<vertex_t>::lowest(), prim_idx);
+            }
+        };
 
-        // Add a hit object to be referenced
-        std::unique_ptr<Intersector> intersector; ///< Triangle Intersector
         NanoBVH bvh; ///< A NanoRT BVH 
 
-        const real_t min_dist = 0.0;
-        std::vector<real_t> vertices; //< Internal vertex array
+        const vertex_t min_dist = 0.0;
+        std::vector<vertex_t> vertices; //< Internal vertex array
         std::vector<unsigned int> indices; //< Internal index array
 
+        std::vector<unsigned int> mesh_offsets; //< Index of the first triangle of every mesh in indices
+        std::vector<int> mesh_ids; //< ID of every mesh, in the same order as mesh_offsets
+
         template <typename dist_type = real_t, typename N>
         inline NanoRay ConstructRay(const N& origin, const N& direction, dist_type max_dist = std::numeric_limits<dist_type>::max()) {
             NanoRay out_ray;
-            out_ray.org[0] = origin[0]; out_ray.org[1] = origin[1]; out_ray.org[2] = origin[2];
-            out_ray.dir[0] = direction[0]; out_ray.dir[1] = direction[1]; out_ray.dir[2] = direction[2];
-            out_ray.min_t = min_dist; out_ray.max_t = max_dist;
+            out_ray.org[0] = static_cast<vertex_t>(origin[0]);
+            out_ray.org[1] = static_cast<vertex_t>(origin[1]);
+            out_ray.org[2] = static_cast<vertex_t>(origin[2]);
+            out_ray.dir[0] = static_cast<vertex_t>(direction[0]);
+            out_ray.dir[1] = static_cast<vertex_t>(direction[1]);
+            out_ray.dir[2] = static_cast<vertex_t>(direction[2]);
+            out_ray.min_t = min_dist; 
+            out_ray.max_t = (max_dist > std::numeric_limits<vertex_t>::max()) ? std::numeric_limits<vertex_t>::max() : static_cast<vertex_t>(max_dist);
 
             return out_ray;
         }
@@ -173,34 +236,89 @@ namespace HF::RayTracer {
             point[2] += (dir[2] * dist);
         }
 
+        /*! \brief Get the ID of the mesh that contains a triangle. */
+        inline int MeshIDOfPrimitive(unsigned int prim_id) const {
+            auto first_after = std::upper_bound(mesh_offsets.begin(), mesh_offsets.end(), prim_id);
+            return mesh_ids[std::distance(mesh_offsets.begin(), first_after) - 1];
+        }
+
+        /*! \brief Append the vertices and indices of a mesh to this raytracer's arrays. */
+        template <typename mesh_type>
+        void AddMesh(const HF::Geometry::MeshInfo<mesh_type>& MI);
+
+        /*! \brief Build the BVH over every mesh added to this raytracer.
+            
+            \param parallel_build Build the deeper levels of the BVH on multiple threads.
+
+            \exception std::logic_error No triangles were added to the raytracer.
+        */
+        void BuildBVH(bool parallel_build);
+
     public:
 
-        /*! \brief Construct a new raytracer with an instance of meshinfo*/
-        NanoRTRayTracer(const HF::Geometry::MeshInfo<float>& MI);
-        NanoRTRayTracer(const HF::Geometry::MeshInfo<double>& MI);
+        /*! \brief Construct a new raytracer with an instance of meshinfo. 
+        
+            \param MI Mesh to cast rays at. Its meshid will be returned by Intersect.
+            \param parallel_build Build the BVH using multiple threads.
+
+            \exception std::logic_error MI doesn't contain any triangles.
+        */
+        BasicNanoRTRayTracer(const HF::Geometry::MeshInfo<float>& MI, bool parallel_build = true);
+        BasicNanoRTRayTracer(const HF::Geometry::MeshInfo<double>& MI, bool parallel_build = true);
+
+        /*! \brief Construct a new raytracer from several instances of meshinfo.
+
+            \param meshes Meshes to cast rays at. Intersect will return the meshid of the mesh that was hit.
+            \param parallel_build Build the BVH using multiple threads.
 
+            \exception std::logic_error meshes doesn't contain any triangles.
 
+            \par Example
+            \code
+                auto meshes = HF::Geometry::LoadMeshObjects("sponza.obj", HF::Geometry::BY_GROUP);
+                HF::RayTracer::NanoRTRayTracerFloat ray_tracer(meshes);
+
+                auto hit = ray_tracer.Intersect(std::array<float, 3>{0, 0, 1}, std::array<float, 3>{0, 0, -1});
+                if (hit.DidHit())
+                    std::cout << "Hit mesh " << hit.meshid << " at distance " << hit.distance << std::endl;
+            \endcode
+        */
+        BasicNanoRTRayTracer(const std::vector<HF::Geometry::MeshInfo<float>>& meshes, bool parallel_build = true);
+        BasicNanoRTRayTracer(const std::vector<HF::Geometry::MeshInfo<double>>& meshes, bool parallel_build = true);
+
+        /*! \brief Cast a ray and get the distance and meshid of the first mesh it hits.
+
+            \param filter If not null, the ray will pass through any mesh this filter doesn't accept
+                          and return the first hit on a mesh it does accept.
+        */
         template<typename point_type, typename dist_type = real_t>
         inline HitStruct<real_t> Intersect(
             const point_type& origin,
             const point_type& dir,
             dist_type distance = -1.0,
-            int mesh_id = -1) 
+            int mesh_id = -1,
+            const MeshFilter* filter = nullptr) 
         {
             dist_type max_dist = (distance < 0) ? std::numeric_limits<dist_type>::max() : distance;
 
             NanoRay ray = ConstructRay<dist_type>(origin, dir, max_dist);
             Intersection hit = CreateHit();
 
-            // Create a new intersector every time
-            NanoRTRayTracer::Intersector temp_intersector(this->vertices.data(), this->indices.data(), sizeof(real_t)*3);
-            
-            bool did_intersect = bvh.Traverse<Intersector>(ray, temp_intersector, &hit);
+            bool did_intersect = false;
+            if (filter && !filter->AcceptsAll()) {
+                FilteredIntersector temp_intersector(this, filter);
+                did_intersect = bvh.template Traverse<FilteredIntersector>(ray, temp_intersector, &hit);
+            }
+            else {
+                // Create a new intersector every time
+                Intersector temp_intersector(this->vertices.data(), this->indices.data(), sizeof(vertex_t)*3);
+                did_intersect = bvh.template Traverse<Intersector>(ray, temp_intersector, &hit);
+            }
             
             if (did_intersect)
-                return HitStruct{ hit.t, 0 };
+                return HitStruct<real_t>( hit.t, MeshIDOfPrimitive(hit.prim_id) );
             else
-                return HitStruct();
+                return HitStruct<real_t>();
 
         }
 
@@ -209,9 +327,23 @@ namespace HF::RayTracer {
             const point_type& origin,
             const point_type& dir,
             float distance = -1,
-            int mesh_id = -1)
+            int mesh_id = -1,
+            const MeshFilter* filter = nullptr)
         {
-            return Intersect(origin, dir, distance, mesh_id).DidHit();
+            real_t max_dist = (distance < 0) ? std::numeric_limits<real_t>::max() : distance;
+
+            NanoRay ray = ConstructRay<real_t>(origin, dir, max_dist);
+            Intersection hit = CreateHit();
+
+            // Unlike Intersect, traversal can stop at the first triangle that's hit
+            if (filter && !filter->AcceptsAll()) {
+                AnyHitIntersector<FilteredIntersector> temp_intersector(this, filter);
+                return bvh.template Traverse<AnyHitIntersector<FilteredIntersector>>(ray, temp_intersector, &hit);
+            }
+            else {
+                AnyHitIntersector<Intersector> temp_intersector(this->vertices.data(), this->indices.data(), sizeof(vertex_t) * 3);
+                return bvh.template Traverse<AnyHitIntersector<Intersector>>(ray, temp_intersector, &hit);
+            }
         }
 
         template<typename point_type>
@@ -219,9 +351,10 @@ namespace HF::RayTracer {
             point_type & origin,
             const point_type & dir,
             float distance = -1,
-            int mesh_id = -1
+            int mesh_id = -1,
+            const MeshFilter* filter = nullptr
         ) {
-            auto res = Intersect(origin, dir, distance, mesh_id);
+            auto res = Intersect(origin, dir, distance, mesh_id, filter);
 
             // If it intersected, move the node and return true, otherwise do nothing and return false.
             if (res.DidHit()) {
@@ -231,5 +364,52 @@ namespace HF::RayTracer {
             else
                 return false;
         }
+
+        /*! \brief Cast a batch of rays and get the distance and meshid of every hit.
+
+            \param origins Origin points of every ray. If only one is supplied, it will be used for every direction.
+            \param directions Directions of every ray. If only one is supplied, it will be used for every origin.
+            \param max_distance Maximum distance of every ray. Set to -1 for infinite distance.
+            \param use_parallel Whether or not to cast the rays in parallel.
+
+            \returns An ordered array with one HitStruct for every ray cast.
+
+            \exception std::runtime_error origins and directions are different sizes and neither contains
+                                          exactly one element.
+        */
+        std::vector<HitStruct<real_t>> Intersections(
+            const std::vector<real3>& origins,
+            const std::vector<real3>& directions,
+            real_t max_distance = -1,
+            bool use_parallel = true
+        );
+
+        /*! \brief Cast a batch of occlusion rays.
+
+            \param origins Origin points of every ray. If only one is supplied, it will be used for every direction.
+            \param directions Directions of every ray. If only one is supplied, it will be used for every origin.
+            \param max_distance Maximum distance of every ray. Set to -1 for infinite distance.
+            \param use_parallel Whether or not to cast the rays in parallel.
+
+            \returns An ordered array of chars set to true for every ray that was occluded.
+
+            \exception std::runtime_error origins and directions are different sizes and neither contains
+                                          exactly one element.
+        */
+        std::vector<char> Occlusions(
+            const std::vector<real3>& origins,
+            const std::vector<real3>& directions,
+            real_t max_distance = -1,
+            bool use_parallel = true
+        );
+
+        /*! \brief Get the number of triangles in this raytracer's BVH. */
+        inline int NumTris() const { return static_cast<int>(indices.size() / 3); }
     };
+
+    /// A NanoRT raytracer that stores vertices and casts rays in double precision.
+    using NanoRTRayTracer = BasicNanoRTRayTracer<double>;
+
+    /// A NanoRT raytracer that stores vertices and casts rays in single precision.
+    using NanoRTRayTracerFloat = BasicNanoRTRayTracer<float>;
 }
@@ -8,6 +8,7 @@
 /// \todo Forward declares for eigen.
 
 #include <graph.h>
+#include <node_index.h>
 #include <algorithm>
 #include <cmath>
 #include <constants.h>
@@ -137,34 +138,60 @@ namespace HF::SpatialStructures {
 
 	}
 
+	int Graph::RemoveOutgoingEdges(const std::vector<int>& parent_ids)
+	{
+		// Mark every parent so rows can be checked in constant time
+		vector<bool> remove(std::max(this->MaxID(), static_cast<int>(edge_matrix.rows())) + 1, false);
+		for (int id : parent_ids)
+			if (id >= 0 && id < remove.size()) remove[id] = true;
+
+		// If the graph hasn't been compressed yet, the edges are still in triplets
+		if (this->needs_compression) {
+			const auto old_size = triplets.size();
+			triplets.erase(
+				std::remove_if(triplets.begin(), triplets.end(),
+					[&remove](const Eigen::Triplet<float>& t) { return remove[t.row()]; }),
+				triplets.end()
+			);
+			return static_cast<int>(old_size - triplets.size());
+		}
 
+		// Compacting in place requires the values of each row to be contiguous
+		edge_matrix.makeCompressed();
 
-	inline float StringToFloat(const std::string& str_to_convert) {
+		int* outer_index_ptr = edge_matrix.outerIndexPtr();
+		int* inner_index_ptr = edge_matrix.innerIndexPtr();
+		float* value_ptr = edge_matrix.valuePtr();
+		const int num_rows = edge_matrix.rows();
+		const int nnz = edge_matrix.nonZeros();
 
-		// As stated in the docs for stod, this will throw if the string you're trying to convert
-		// can't be converted to a number. This will occur when the string is empty, as it is in
-		// the case of a parameter that doesn't exist. 
-		try {
-			return std::stof(str_to_convert);
-		}
-		catch (std::invalid_argument) {
-			// Return -1 to signal that this string could not be converted
-			// to a decimal number
-			return -1;
+		// Shift every kept edge back over the removed ones. Cost arrays share the CSR's
+		// indexing, so they're shifted the same way.
+		int next_index = 0;
+		for (int row = 0; row < num_rows; row++) {
+			const int row_start = outer_index_ptr[row];
+			const int row_end = outer_index_ptr[row + 1];
+			outer_index_ptr[row] = next_index;
+
+			if (remove[row]) continue;
+
+			for (int i = row_start; i < row_end; i++, next_index++) {
+				inner_index_ptr[next_index] = inner_index_ptr[i];
+				value_ptr[next_index] = value_ptr[i];
+				for (auto& cost_map : edge_cost_maps)
+					if (cost_map.second.size() > i)
+						cost_map.second[next_index] = cost_map.second[i];
+			}
 		}
-	}
+		outer_index_ptr[num_rows] = next_index;
+		edge_matrix.data().resize(next_index);
+		for (auto& cost_map : edge_cost_maps)
+			cost_map.second.Shrink(next_index);
 
-	inline std::vector<float> ConvertStringsToFloat(const std::vector<string>& strings) {
-		// Initialize a vector that's big enough to hold the result for every value in strings
-		std::vector<float> out_floats(strings.size());
+		return nnz - next_index;
+	}
 
-		// Iterate through every attribute in strings and convert them to floating point numbers
-		for (int i = 0; i < out_floats.size(); i++)
-			out_floats[i] = StringToFloat(strings[i]);
 
-		// Return output
-		return out_floats;
-	}
 
 	void Graph::AttrToCost(
 		const std::string& node_attribute,
@@ -187,11 +214,11 @@ namespace HF::SpatialStructures {
 		// Get the costs for this attribute and convert every value to float. In the case that a 
 		// attribute score could not be converted due to not being a numeric value or not being set
 		// in the first place, those values will be set to -1.
-		vector<float> scores;
-		if (this->IsFloatAttribute(node_attribute))
-			scores = this->GetNodeAttributesFloat(node_attribute);
-		else
-			scores = ConvertStringsToFloat(this->GetNodeAttributes(node_attribute));
+		// Numeric attributes are read directly without conversion.
+		const NodeAttributeColumn& column = node_attributes.at(node_attribute);
+		vector<float> scores(ordered_nodes.size());
+		for (int id = 0; id < scores.size(); id++)
+			scores[id] = column.ToFloat(id);
 
 		// Iterate through all nodes in the graph
 		for (const auto& parent : ordered_nodes) {
@@ -267,6 +294,18 @@ namespace HF::SpatialStructures {
 			return -1;
 	}
 
+	const NodeIndex& Graph::GetNodeIndex(bool use_x, bool use_y, bool use_z) const
+	{
+		// Each combination of axes gets its own index
+		const int key = (use_x ? 1 : 0) | (use_y ? 2 : 0) | (use_z ? 4 : 0);
+
+		auto& index = node_indices[key];
+		if (!index)
+			index = std::make_shared<const NodeIndex>(ordered_nodes, use_x, use_y, use_z);
+
+		return *index;
+	}
+
 	EdgeCostSet& Graph::GetCostArray(const string& key)
 	{
 		// If this is the default key, then you're missing a check
@@ -452,6 +491,30 @@ namespace HF::SpatialStructures {
 		return out_csr;
 	}
 
+	CSRPtrs Graph::GetCSRPointers(const string& cost_type) const
+	{
+		// This is const, so it can't compress the graph for the caller
+		if (this->needs_compression || !edge_matrix.isCompressed())
+			throw std::runtime_error("The graph must be compressed!");
+
+		// Eigen only hands out const pointers to a const matrix. Callers are
+		// told not to write through these.
+		CSRPtrs out_csr{
+			static_cast<int>(edge_matrix.nonZeros()),
+			static_cast<int>(edge_matrix.rows()),
+			static_cast<int>(edge_matrix.cols()),
+
+			const_cast<float*>(edge_matrix.valuePtr()),
+			const_cast<int*>(edge_matrix.outerIndexPtr()),
+			const_cast<int*>(edge_matrix.innerIndexPtr())
+		};
+
+		if (!this->IsDefaultName(cost_type))
+			out_csr.data = const_cast<float*>(this->GetCostArray(cost_type).GetPtr());
+
+		return out_csr;
+	}
+
 	Node Graph::NodeFromID(int id) const { return ordered_nodes.at(id); }
 
 	std::vector<Node> Graph::Nodes() const {
@@ -832,12 +895,13 @@ namespace HF::SpatialStructures {
 
 	bool Graph::HasNodeAttribute(const std::string& key) const
 	{
-		return this->node_attr_map.count(key) > 0 || this->node_float_attr_map.count(key) > 0;
+		return this->node_attributes.count(key) > 0;
 	}
 
 	bool Graph::IsFloatAttribute(const std::string& name) const
 	{
-		return this->node_float_attr_map.count(name) > 0;
+		const NodeAttributeColumn* column = GetNodeAttributeColumn(name);
+		return column && column->IsNumeric();
 	}
 
 
@@ -997,6 +1061,9 @@ namespace HF::SpatialStructures {
 			return getID(input_node);
 
 		else {
+			// Any existing indexes won't contain this node
+			if (!node_indices.empty()) node_indices.clear();
+
 			// Set the id in the hashmap, and add the node to nodes
 			idmap[input_node] = next_id;
 			ordered_nodes.push_back(input_node);
@@ -1027,7 +1094,8 @@ namespace HF::SpatialStructures {
 			// Set the id of the empty node
 			ordered_nodes.back().id = input_int;
 
-			this->next_id = std::max(input_int, this->next_id);
+			// Nodes added by position must never be given this ID
+			this->next_id = std::max(input_int + 1, this->next_id);
 		}
 
 		return input_int;
@@ -1131,6 +1199,11 @@ namespace HF::SpatialStructures {
 			// Mark this graph as not requiring compression
 			needs_compression = false;
 		}
+
+		// Inserting edges into the CSR leaves free space at the end of rows
+		// that has to be squeezed out before its arrays can be used directly.
+		else if (!edge_matrix.isCompressed())
+			edge_matrix.makeCompressed();
 	}
 
 	void Graph::Clear() {
@@ -1142,6 +1215,7 @@ namespace HF::SpatialStructures {
 		// Other graph representations should be cleared too
 		ordered_nodes.clear();
 		idmap.clear();
+		node_indices.clear();
 
 		// Clear all cost arrays
 		// Clear all cost arrays.
@@ -1252,64 +1326,18 @@ namespace HF::SpatialStructures {
 		// Check if this id belongs to any node in the graph
 		if (id > this->MaxID()) return;
 
-		// Retrieve an iterator to the [node attribute : NodeAttributeValueMap]
-		// that corresponds with name
-		auto node_attr_map_it = node_attr_map.find(name);
-
-		if (node_attr_map_it == node_attr_map.end()) {
-			
-			// Check if name could be a float-type attribute
-			auto node_float_attr_map_it = node_float_attr_map.find(name);
-
-			// If the attribute type does not exist...create it.
-			// Regardless of whether or not we are converting a float-type attribute,
-			// we need to create a new map for the input string attribute.
-			node_attr_map[name] = NodeAttributeValueMap();
-
-			if (node_float_attr_map_it != node_float_attr_map.end())
-			{
-				// name is in float map, so we assume user
-				// wants to convert the attribute to a string-type attribute. 
-				NodeFloatAttributeValueMap& node_float_attr_value_map = node_float_attr_map_it->second;
-				
-				NodeAttributeValueMap& node_attr_value_map = node_attr_map.find(name)->second;
-
-				for (auto it : node_float_attr_value_map)
-				{
-					node_attr_value_map[it.first] = std::to_string(it.second);
-				}
-
-				// Remove float attribute from float map to avoid duplicates
-				node_float_attr_map.erase(node_float_attr_map_it->first);
-
-				// This should only happen once the first time
-				// AddNodeAttribute is called with a float-type attribute.
-				// Subsequent calls should find this attribute in the string-type map.
-			}
-
-			// Update this iterator so it can be used in the next code block
-			node_attr_map_it = node_attr_map.find(name);
-		}
+		// Get the column for this attribute, creating it if it doesn't exist yet.
+		auto column_it = node_attributes.find(name);
+		if (column_it == node_attributes.end())
+			column_it = node_attributes.emplace(name, NodeAttributeColumn(NODE_ATTRIBUTE_TYPE::STRING)).first;
+		NodeAttributeColumn& column = column_it->second;
 
-		// We now have the NodeAttributeValueMap for the desired attribute.
-		// A NodeAttributeValueMap stores buckets of [node id : node attribute value as string]
-		NodeAttributeValueMap& node_attr_value_map = node_attr_map_it->second;
+		// If this is a numeric attribute, we assume the user wants to
+		// convert the attribute to a string-type attribute. This should only
+		// happen the first time a string is added to the attribute.
+		column.ConvertTo(NODE_ATTRIBUTE_TYPE::STRING);
 
-		// Need to see if id exists as a key within node_attr_value_map
-		// This will give us the position of a bucket containing:
-		// [node id : node attribute value as string]
-		auto node_attr_value_map_it = node_attr_value_map.find(id);
-
-		if (node_attr_value_map_it == node_attr_value_map.end()) {
-			// If the node id provided does not exist in the value map...add it.
-			node_attr_value_map[id] = score;
-
-		}
-		else
-		{
-			// Otherwise, the key-value pair exists, and we can set the value to score
-			node_attr_value_map_it->second = score;
-		}
+		column.SetString(id, score);
 	}
 
 	void Graph::AddNodeAttributeFloat(int id, const std::string& name, const float score)
@@ -1317,49 +1345,21 @@ namespace HF::SpatialStructures {
 		// Check if this id belongs to any node in the graph
 		if (id > this->MaxID()) return;
 
-		// Retrieve an iterator to the [node attribute : NodeFloatAttributeValueMap]
-		// that corresponds with attribute
-		auto node_float_attr_map_it = node_float_attr_map.find(name);
-
-		if (node_float_attr_map_it == node_float_attr_map.end())
-		{
-			// Check if attribute could be a string attribute
-			auto node_attr_map_it = node_attr_map.find(name);
-			if (node_attr_map_it != node_attr_map.end())
-			{
-				// We assume the user wants to add strings representing floats
-				// to a string attribute, so convert to string and add.
-				// score is guaranteed to be convertable since it is a float.
-				AddNodeAttribute(id, name, std::to_string(score));
-				return;
-			}
-			else
-			{
-				// If the attribute type does not exist...create it.
-				node_float_attr_map[name] = NodeFloatAttributeValueMap();
-
-				// Update this iterator so it can be used in the next code block
-				node_float_attr_map_it = node_float_attr_map.find(name);
-			}
-		}
-
-		// We now have the NodeFloatAttributeValueMap for the desired attribute.
-		// A NodeFloatAttributeValueMap stores buckets of [node id : node attribute value as float]
-		NodeFloatAttributeValueMap& node_float_attr_value_map = node_float_attr_map_it->second;
-
-		// Need to see if id exists as a key within node_float_attr_value_map
-		// This will give us the position of a bucket containing:
-		// [node id : node attribute value as float]
-		auto node_float_attr_value_map_it = node_float_attr_value_map.find(id);
-
-		if (node_float_attr_value_map_it == node_float_attr_value_map.end())
-		{
-			// If the node id provided does not exist in the value map...add it.
-			node_float_attr_value_map[id] = score;
-		}
-		else
-		{
-			node_float_attr_value_map_it->second = score;
+		// Get the column for this attribute, creating it if it doesn't exist yet.
+		auto column_it = node_attributes.find(name);
+		if (column_it == node_attributes.end())
+			column_it = node_attributes.emplace(name, NodeAttributeColumn(NODE_ATTRIBUTE_TYPE::FLOAT)).first;
+		NodeAttributeColumn& column = column_it->second;
+
+		// We assume the user wants to add strings representing floats
+		// to a string attribute, so convert to string and add.
+		// score is guaranteed to be convertable since it is a float.
+		if (column.Type() == NODE_ATTRIBUTE_TYPE::STRING)
+			column.SetString(id, std::to_string(score));
+		else {
+			// Int and bool attributes can't hold this score, so widen them to floats
+			column.ConvertTo(NODE_ATTRIBUTE_TYPE::FLOAT);
+			column.SetFloat(id, score);
 		}
 	}
 
@@ -1401,31 +1401,38 @@ namespace HF::SpatialStructures {
 			AddNodeAttributeFloat(node_id, name, *(scores_iterator++));
 		}
 	}
-	vector<string> Graph::GetNodeAttributes(string name) const {
 
-		// Return an empty array if this attribute doesn't exist
-		if (node_attr_map.count(name) < 1) return vector<string>();
-	
-		// Get the attribute map for name now that we know it exists
-		const auto& attr_map = node_attr_map.at(name);
-		
-		// Preallocate output array with empty strings. We'll only be modifying
-		// the indexes that have scores assigned to them, and leaving the rest
-		// as empty strings
-		const int num_nodes = ordered_nodes.size();
-		vector<string> out_attributes(ordered_nodes.size(), "");
+	void Graph::SetNodeAttributeColumn(const std::string& name, NODE_ATTRIBUTE_TYPE type, const void* values, int num_values)
+	{
+		if (num_values > this->size())
+			throw std::out_of_range("Tried to set values for more nodes than exist in the graph");
 
-		// Iterate through attribute map to assign scores for the nodes
-		// that have them
-		for (const auto& it : attr_map)
-		{
-			// Get the id and score of this element in the hashmap
-			const int id = it.first;
-			const string& score = it.second;
+		// Replace any existing values for this attribute
+		NodeAttributeColumn column(type);
+		column.ResizeIfNeeded(this->size());
+		column.SetValues(values, num_values);
 
-			// Copy it to the index of the node's ID in our output array
-			out_attributes[id] = score;
-		}
+		node_attributes[name] = std::move(column);
+	}
+
+	const NodeAttributeColumn* Graph::GetNodeAttributeColumn(const std::string& name) const
+	{
+		const auto column_it = node_attributes.find(name);
+		return column_it == node_attributes.end() ? nullptr : &column_it->second;
+	}
+
+	vector<string> Graph::GetNodeAttributes(string name) const {
+
+		// Return an empty array if this attribute doesn't exist or isn't a string attribute
+		const NodeAttributeColumn* column = GetNodeAttributeColumn(name);
+		if (!column || column->IsNumeric()) return vector<string>();
+
+		// Copy the value of every node in the graph. Nodes without
+		// values will be left as empty strings.
+		vector<string> out_attributes(ordered_nodes.size(), "");
+		const int num_values = std::min(column->size(), static_cast<int>(out_attributes.size()));
+		for (int id = 0; id < num_values; id++)
+			out_attributes[id] = column->ToString(id);
 
 		// Return all found attributes
 		return out_attributes;
@@ -1433,29 +1440,22 @@ namespace HF::SpatialStructures {
 
 	vector<string> Graph::GetNodeAttributesByID(vector<int>& ids, string name) const {
 		
-		// Return an empty array if this attribute doesn't exist
-		if (node_attr_map.count(name) < 1) return vector<string>();
-
-		// Get the attribute map for name now that we know it exists
-		const auto& attr_map = node_attr_map.at(name);
+		// Return an empty array if this attribute doesn't exist or isn't a string attribute
+		const NodeAttributeColumn* column = GetNodeAttributeColumn(name);
+		if (!column || column->IsNumeric()) return vector<string>();
 
-		// Preallocate output array with empty strings.
 		// Only allocate as many spots we need for the specified IDs.
 		const int num_nodes = ids.size();
 		vector<string> out_attributes(num_nodes, "");
 		
-		// Keep index of return array, since it isn't necessarily the same as the ID
-		int idx = 0;
 		// Iterate through all specified IDs
 		for (int i = 0; i < num_nodes; i++)
 		{
-			// For each ID, get associated node, and get the node's attribute
-			int id = ids[i];
-			const auto& score = attr_map.at(id);
+			const int id = ids[i];
+			if (!column->IsAssigned(id))
+				throw std::out_of_range("Node " + std::to_string(id) + " has no value for " + name);
 
-			out_attributes[idx] = score;
-			// Increment index to the next space in the output array
-			idx++;
+			out_attributes[i] = column->ToString(id);
 		}
 		// Return all found attributes
 		return out_attributes;
@@ -1463,29 +1463,21 @@ namespace HF::SpatialStructures {
 
 	vector<float> Graph::GetNodeAttributesFloat(string name) const {
 
-		// Return an empty array if this attribute doesn't exist
-		if (node_float_attr_map.count(name) < 1) return vector<float>();
-
-		// Get the attribute map for name now that we know it exists
-		const auto& float_attr_map = node_float_attr_map.at(name);
+		// Return an empty array if this attribute doesn't exist or isn't numeric
+		const NodeAttributeColumn* column = GetNodeAttributeColumn(name);
+		if (!column || !column->IsNumeric()) return vector<float>();
 
-		// Preallocate output array with empty strings. We'll only be modifying
-		// the indexes that have scores assigned to them, and leaving the rest
-		// as empty strings
+		// Copy the value of every node in the graph. Nodes without
+		// values will be left as zero.
 		const int num_nodes = ordered_nodes.size();
 		vector<float> out_attributes(num_nodes, 0.0);
+		const int num_values = std::min(column->size(), num_nodes);
 
-		// Iterate through attribute map to assign scores for the nodes
-		// that have them
-		for (const auto& it : float_attr_map)
-		{
-			// Get the id and score of this element in the hashmap
-			const int id = it.first;
-			const float score = it.second;
-
-			// Copy it to the index of the node's ID in our output array
-			out_attributes[id] = score;
-		}
+		if (column->Type() == NODE_ATTRIBUTE_TYPE::FLOAT)
+			std::copy_n(static_cast<const float*>(column->Data()), num_values, out_attributes.begin());
+		else
+			for (int id = 0; id < num_values; id++)
+				out_attributes[id] = column->ToFloat(id);
 
 		// Return all found attributes
 		return out_attributes;
@@ -1493,29 +1485,22 @@ namespace HF::SpatialStructures {
 
 	vector<float> Graph::GetNodeAttributesByIDFloat(vector<int>& ids, string name) const {
 
-		// Return an empty array if this attribute doesn't exist
-		if (node_float_attr_map.count(name) < 1) return vector<float>();
-
-		// Get the attribute map for name now that we know it exists
-		const auto& float_attr_map = node_float_attr_map.at(name);
+		// Return an empty array if this attribute doesn't exist or isn't numeric
+		const NodeAttributeColumn* column = GetNodeAttributeColumn(name);
+		if (!column || !column->IsNumeric()) return vector<float>();
 
-		// Preallocate output array with empty strings.
 		// Only allocate as many spots we need for the specified IDs.
 		const int num_nodes = ids.size();
 		vector<float> out_attributes(num_nodes, 0.0);
 
-		// Keep index of return array, since it isn't necessarily the same as the ID
-		int idx = 0;
 		// Iterate through all specified IDs
 		for (int i = 0; i < num_nodes; i++)
 		{
-			// For each ID, get associated node, and get the node's attribute
-			int id = ids[i];
-			const auto& score = float_attr_map.at(id);
+			const int id = ids[i];
+			if (!column->IsAssigned(id))
+				throw std::out_of_range("Node " + std::to_string(id) + " has no value for " + name);
 
-			out_attributes[idx] = score;
-			// Increment index to the next space in the output array
-			idx++;
+			out_attributes[i] = column->ToFloat(id);
 		}
 		// Return all found attributes
 		return out_attributes;
@@ -1653,18 +1638,9 @@ namespace HF::SpatialStructures {
 		*/
 		//	std::string lower_cased = name;
 
-		// Check if we have this name in our dictionary. Only try to delete
-		// it if it already exists.
-		if (node_attr_map.count(name) > 0) {
-
-			// Erase the key from the dictionary, implicitly freeing the object
-			// it contains.
-			node_attr_map.erase(name);
-		}
-		if (node_float_attr_map.count(name) > 0)
-		{
-			node_float_attr_map.erase(name);
-		}
+		// Erase the column from the dictionary, implicitly freeing its values.
+		// Nothing happens if it doesn't exist.
+		node_attributes.erase(name);
 	}
 
 	using namespace nlohmann;
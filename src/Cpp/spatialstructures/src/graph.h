@@ -12,13 +12,18 @@
 #include <edge.h>
 #include <node.h>
 #include <path.h>
+#include <node_attributes.h>
 #include <Eigen>
 #include <iostream>
+#include <memory>
 
 namespace Eigen {
 }
 
 namespace HF::SpatialStructures {
+	class NodeIndex;
+	class GraphBuilder;
+
 	using EdgeMatrix = Eigen::SparseMatrix<float, 1>; ///< The type of matrix the graph uses internally
 	using TempMatrix = Eigen::Map<const EdgeMatrix>;  ///< A mapped matrix of EdgeMatrix. Only owns pointers to memory. 
 
@@ -417,6 +422,16 @@ namespace HF::SpatialStructures {
 		/*! \brief Clear all values from this edge cost set.*/
 		inline void Clear() { this->costs.clear(); }
 
+		/*!
+			\brief Remove every cost after the first `new_size` costs.
+
+			\param new_size Number of costs to keep. If this set has fewer costs, nothing is removed.
+		*/
+		inline void Shrink(int new_size) {
+			if (this->size() > new_size)
+				this->costs.resize(new_size);
+		}
+
 		/*!
 			\brief Index internal values array
 			\param i index to get the cost of
@@ -488,8 +503,6 @@ namespace HF::SpatialStructures {
 
 	*/
 	class Graph {
-		using NodeAttributeValueMap = robin_hood::unordered_map<int, std::string>;
-		using NodeFloatAttributeValueMap = robin_hood::unordered_map<int, float>;
 	private:
 		int next_id = 0;								///< The id for the next unique node.
 		std::vector<Node> ordered_nodes;				///< A list of nodes contained by the graph.
@@ -500,8 +513,7 @@ namespace HF::SpatialStructures {
 		std::vector<Eigen::Triplet<float>> triplets;	///< Edges to be converted to a CSR when Graph::Compress() is called.
 		bool needs_compression = true;					///< If true, the CSR is inaccurate and requires compression.
 
-		robin_hood::unordered_map<std::string, NodeAttributeValueMap> node_attr_map; ///< Node attribute type : Map of node id to node attribute
-		robin_hood::unordered_map<std::string, NodeFloatAttributeValueMap> node_float_attr_map; ///< Node attribute type : Map of node id to node attribute for float
+		robin_hood::unordered_map<std::string, NodeAttributeColumn> node_attributes; ///< Node attribute name : Values of the attribute for every node
 		std::string active_cost_type;								///< The active edge matrix to use for the graph
 		EdgeMatrix edge_matrix;				///< The underlying CSR containing edge information.
 
@@ -525,6 +537,15 @@ namespace HF::SpatialStructures {
 		*/
 		bool nodes_out_of_order = false;
 
+		/*!
+			\brief Spatial indexes of the graph's nodes, keyed by the axes they include.
+
+			\details
+			Built on demand by GetNodeIndex and discarded whenever a node is added to or removed
+			from the graph.
+		*/
+		mutable robin_hood::unordered_map<int, std::shared_ptr<const NodeIndex>> node_indices;
+
 		/*!
 			\brief
 			Get the unique ID for this x, y, z position and assign it an new one if it doesn't already exist.
@@ -887,6 +908,26 @@ namespace HF::SpatialStructures {
 			const std::string& default_cost = "Distance"
 		);
 
+		/*!
+			\brief Construct a graph from a list of nodes and the edges stored in a GraphBuilder.
+
+			\param nodes Nodes of the graph. Each node is assigned the ID of its index in this array.
+			\param edges Edges to add to the graph. Edges stored by ID must use the IDs of `nodes`.
+			\param default_cost Default cost of the graph. This is the name of the first used cost.
+
+			\details
+			Builds the CSR in parallel without sorting the edges through triplets.
+			Unlike the constructor that takes arrays of edges, the graph can still be modified
+			afterwards.
+
+			\see BulkAddEdges for details on how the CSR is built.
+		*/
+		Graph(
+			const std::vector<Node>& nodes,
+			const GraphBuilder& edges,
+			const std::string& default_cost = "Distance"
+		);
+
 		/*! \brief Construct an empty graph.
 
 			\remarks This can be used to create a new graph to later be filled with edges/nodes
@@ -1565,6 +1606,28 @@ namespace HF::SpatialStructures {
 		*/
 		int getID(const Node& node) const;
 
+		/*!
+			\brief Get a spatial index of this graph's nodes for nearest neighbour and radius queries.
+
+			\param use_x Include the x axis in distance calculations.
+			\param use_y Include the y axis in distance calculations.
+			\param use_z Include the z axis in distance calculations.
+
+			\returns An index over every node in the graph with a position.
+
+			\details
+			The index is built the first time it's requested for a set of axes, then reused until nodes
+			are added to or removed from the graph. Querying the index is thread safe, but this function
+			must not be called from multiple threads at once.
+
+			\par Time Complexity
+			`O(n log n)` where `n` is the number of nodes in the graph if the index must be built, `O(1)` otherwise.
+
+			\par Example
+			\snippet tests\src\SpatialStructures.cpp EX_GetNodeIndex
+		*/
+		const NodeIndex& GetNodeIndex(bool use_x = true, bool use_y = true, bool use_z = true) const;
+
 		/*!
 			\brief Compress the graph to a CSR and enable the usage of several functions.
 
@@ -1664,6 +1727,22 @@ namespace HF::SpatialStructures {
 		*/
 		CSRPtrs GetCSRPointers(const std::string& cost_type = "");
 
+		/*!
+			\brief Get pointers to the CSR of a compressed graph without modifying it.
+
+			\param cost_type Cost type to use for the data pointer. Leave blank for the graph's default cost.
+
+			\returns Pointers and sizes of the arrays that comprise the CSR. These point to the graph's own
+			memory, and must not be written to or used after the graph is modified.
+
+			\throws std::runtime_error The graph isn't compressed.
+			\throws HF::Exceptions::NoCost `cost_type` isn't the default cost and doesn't exist in the graph.
+
+			\details Unlike the non-const overload, this can't compress the graph, so it can be used
+			by read-only consumers such as the pathfinder to search the graph in place.
+		*/
+		CSRPtrs GetCSRPointers(const std::string& cost_type = "") const;
+
 		/// <summary>
 		/// Retrieve the node that corresponds to id.
 		/// </summary>
@@ -2085,9 +2164,45 @@ namespace HF::SpatialStructures {
 		*/
 		std::vector<float> GetNodeAttributesByIDFloat(std::vector<int>& ids, std::string name) const;
 
-		/*! \brief Check if this attribute exists in the graph and contains float values*/
+		/*! \brief Check if this attribute exists in the graph and contains numeric values that can be read as floats*/
 		bool IsFloatAttribute(const std::string& name) const;
 
+		/*!
+			\brief Replace the values of an attribute for every node in the graph at once.
+
+			\param name The attribute to set. If it already exists, it will be replaced.
+			\param type The type of values in `values`.
+			\param values Array of `num_values` values of `type`, ordered by node ID. For string attributes
+			this must be an array of null terminated char arrays. Bools must be one byte each.
+			\param num_values Number of values in `values`.
+
+			\throws std::out_of_range `num_values` is greater than the number of nodes in the graph.
+
+			\details
+			Unlike AddNodeAttributes, this doesn't need to look up the position of each node, so
+			numeric values are copied into the graph in a single block. This is intended for writing the
+			results of an analysis that produced one value for every node back onto the graph.
+
+			\post The nodes with IDs from 0 to `num_values` - 1 will have values for `name`.
+
+			\par Example
+			\snippet tests\src\SpatialStructures.cpp EX_NodeAttributeColumn
+		*/
+		void SetNodeAttributeColumn(const std::string& name, NODE_ATTRIBUTE_TYPE type, const void* values, int num_values);
+
+		/*!
+			\brief Get direct access to the stored values of an attribute.
+
+			\param name The attribute to get.
+
+			\returns A pointer to the column holding the values of `name`, or null if the attribute doesn't exist.
+
+			\remarks
+			The pointer is invalidated whenever an attribute is added to or cleared from the graph.
+			Pointers to the column's data are also invalidated if this attribute is modified.
+		*/
+		const NodeAttributeColumn* GetNodeAttributeColumn(const std::string& name) const;
+
 		/// <summary>
 		/// Count the number of edges of associated cost type
 		/// </summary>
@@ -2212,6 +2327,77 @@ namespace HF::SpatialStructures {
 
 		bool DumpToJson(const std::string & path);
 
+		/*!
+			\brief Save this graph to a binary file.
+
+			\param path Path to write the graph to. Any existing file will be overwritten.
+
+			\returns True if the graph was written successfully, false if the file couldn't be written.
+
+			\details
+			Writes the graph's nodes, CSR, alternate cost types, and node attributes to a single file.
+			Every array is written exactly as it's stored in memory and aligned to 8 bytes, so
+			LoadBinary can copy them directly out of a memory mapped view of the file without
+			parsing anything.
+
+			If the graph isn't compressed, a compressed copy of it is written instead, and the graph
+			itself is left unchanged. Compress the graph first to avoid making the copy.
+
+			\see LoadBinary to read a graph written by this function.
+
+			\par Example
+			\snippet tests\src\SpatialStructures.cpp EX_SaveLoadBinary
+		*/
+		bool SaveBinary(const std::string& path) const;
+
+		/*!
+			\brief Load a graph from a file written by SaveBinary.
+
+			\param path Path to the graph file.
+
+			\returns The graph stored in the file at `path`, including its alternate cost types
+			and node attributes.
+
+			\throws HF::Exceptions::FileNotFound No file exists at `path`.
+			\throws std::runtime_error The file at `path` isn't a graph file, was written with an
+			unsupported version of the format, is truncated, or contains a CSR, node ID or cost
+			type that doesn't match the rest of the graph. Node IDs must be unique, and the ID
+			the graph would give its next node must be greater than all of them.
+		*/
+		static Graph LoadBinary(const std::string& path);
+
+		/*!
+			\brief Add every edge stored in a GraphBuilder to the graph and compress it.
+
+			\param edges Edges to add to the graph.
+
+			\details
+			Edges stored by position are assigned IDs first, in the order of their buffers. Nodes
+			that aren't in the graph yet get the same IDs they would have if every edge was added
+			by calling addEdge in that order. Any IDs used by edges stored by ID that aren't in the
+			graph are then added in increasing order.
+
+			The CSR is then built directly with a parallel counting sort of every edge by its parent,
+			instead of passing through Eigen's serial setFromTriplets. The graph's existing edges are
+			kept, and any edges that were still waiting to be compressed are compressed first.
+
+			If the same edge appears more than once in `edges`, only the copy with the lowest cost
+			is kept, so the result doesn't depend on which buffer each edge was stored in. Edges that
+			are already in the graph are replaced by new edges between the same nodes.
+
+			Alternate cost types are moved along with the edges they belong to. New edges, including
+			ones that replace existing edges, have no cost in any alternate cost type until one is
+			added for them.
+
+			\post The graph will be compressed.
+
+			\throws std::out_of_range An edge stored by ID has a negative ID.
+
+			\par Example
+			\snippet tests\src\SpatialStructures.cpp EX_GraphBuilder
+		*/
+		void BulkAddEdges(const GraphBuilder& edges);
+
 		/*!
 			\brief Add multiple edges to the graph.
 
@@ -2308,6 +2494,21 @@ namespace HF::SpatialStructures {
 		*/
 		void ClearCostArrays(const std::string & cost_name = "");
 
+		/*!
+			\brief Remove every outgoing edge of a set of nodes.
+
+			\param parent_ids IDs of the nodes to remove the outgoing edges of. IDs that aren't in
+							  the graph are ignored.
+
+			\returns The number of edges that were removed.
+
+			\details
+			The nodes themselves are kept, so the IDs of every node in the graph remain the same. If the
+			graph is compressed, the CSR is compacted in place, and every cost array is compacted and
+			shrunk along with it so their costs still line up with the remaining edges.
+		*/
+		int RemoveOutgoingEdges(const std::vector<int>& parent_ids);
+
 		/*! \brief Generate edge costs from a set of node attributes. 
 		
 			\param attr_key Attribute to create a new cost set from.
@@ -0,0 +1,497 @@
+///
+/// \file		graph_builder.cpp
+/// \brief		Contains implementation for the <see cref="HF::SpatialStructures::GraphBuilder">GraphBuilder</see> class
+///				and building a <see cref="HF::SpatialStructures::Graph">Graph's</see> CSR from it in parallel.
+///
+///	\author		TBA
+///	\date		06 Jun 2020
+
+#include <graph_builder.h>
+#include <graph.h>
+
+#include <omp.h>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+using std::string;
+using std::vector;
+
+namespace HF::SpatialStructures {
+
+	constexpr int EDGES_PER_BLOCK = 32768;	///< Target number of new edges in each block of rows sorted by BulkAddEdges.
+	constexpr int MAX_BLOCKS = 4096;		///< Maximum number of blocks of rows sorted by BulkAddEdges.
+
+	GraphBuilder::GraphBuilder(int num_buffers) {
+		if (num_buffers < 1)
+			num_buffers = omp_get_max_threads();
+
+		buffers.resize(num_buffers);
+	}
+
+	int GraphBuilder::NumBuffers() const { return static_cast<int>(buffers.size()); }
+
+	size_t GraphBuilder::NumEdges() const {
+		size_t num_edges = 0;
+		for (const auto& buffer : buffers)
+			num_edges += buffer.id_costs.size() + buffer.node_costs.size();
+
+		return num_edges;
+	}
+
+	void GraphBuilder::Reserve(int buffer, size_t num_id_edges, size_t num_node_edges) {
+		EdgeBuffer& b = buffers[buffer];
+		b.parent_ids.reserve(b.parent_ids.size() + num_id_edges);
+		b.child_ids.reserve(b.child_ids.size() + num_id_edges);
+		b.id_costs.reserve(b.id_costs.size() + num_id_edges);
+
+		b.parent_nodes.reserve(b.parent_nodes.size() + num_node_edges);
+		b.child_nodes.reserve(b.child_nodes.size() + num_node_edges);
+		b.node_costs.reserve(b.node_costs.size() + num_node_edges);
+	}
+
+	void GraphBuilder::AddEdges(int buffer, const int* parent_ids, const int* child_ids, const float* costs, int num_edges) {
+		EdgeBuffer& b = buffers[buffer];
+		b.parent_ids.insert(b.parent_ids.end(), parent_ids, parent_ids + num_edges);
+		b.child_ids.insert(b.child_ids.end(), child_ids, child_ids + num_edges);
+		b.id_costs.insert(b.id_costs.end(), costs, costs + num_edges);
+	}
+
+	void GraphBuilder::AddEdges(int buffer, const float* parents, const float* children, const float* costs, int num_edges) {
+		Reserve(buffer, 0, num_edges);
+		for (int i = 0; i < num_edges; i++) {
+			const float* parent = parents + (i * 3);
+			const float* child = children + (i * 3);
+			AddEdge(buffer, Node(parent[0], parent[1], parent[2]), Node(child[0], child[1], child[2]), costs[i]);
+		}
+	}
+
+	void GraphBuilder::Clear() {
+		for (auto& buffer : buffers)
+			buffer = EdgeBuffer();
+	}
+
+	/*! \brief Edges stored by position in a single buffer, and where they start in the edges of every buffer. */
+	struct NodeEdgeSpan {
+		const Node* parents;	///< Parent of every edge in the buffer.
+		const Node* children;	///< Child of every edge in the buffer.
+		int begin;				///< Index of the buffer's first edge in the edges of every buffer.
+		int size;				///< Number of edges in the buffer.
+	};
+
+	/*! \brief Nodes found in a contiguous range of edges stored by position. */
+	struct NodeChunk {
+		robin_hood::unordered_map<Node, int> local_ids;	///< Index of every node in unique_nodes.
+		vector<Node> unique_nodes;						///< Every node in the range in order of first appearance.
+		vector<int> global_ids;							///< ID of every node in unique_nodes in the graph.
+	};
+
+	/*!
+		\brief Assign a local ID to the parent and child of every edge stored by position.
+
+		\param spans Edges stored by position in each buffer, in buffer order.
+		\param num_edges Total number of edges in every span.
+		\param chunks Chunks to divide the edges between. The local IDs of each chunk index its unique_nodes.
+		\param out_parents Output array for the local ID of the parent of every edge.
+		\param out_children Output array for the local ID of the child of every edge.
+
+		\details
+		Every chunk covers a contiguous range of edges, and lists its nodes in the order they
+		first appear in that range. Visiting the chunks in order therefore visits every node in
+		the same order addEdge would have.
+	*/
+	inline void AssignLocalNodeIDs(
+		const vector<NodeEdgeSpan>& spans,
+		int num_edges,
+		vector<NodeChunk>& chunks,
+		int* out_parents,
+		int* out_children
+	) {
+		const int num_chunks = static_cast<int>(chunks.size());
+
+		#pragma omp parallel for schedule(dynamic)
+		for (int c = 0; c < num_chunks; c++) {
+			const int first_edge = static_cast<int>((static_cast<long long>(num_edges) * c) / num_chunks);
+			const int last_edge = static_cast<int>((static_cast<long long>(num_edges) * (c + 1)) / num_chunks);
+
+			NodeChunk& chunk = chunks[c];
+			auto local_id = [&chunk](const Node& node) {
+				const auto it = chunk.local_ids.find(node);
+				if (it != chunk.local_ids.end()) return it->second;
+
+				const int id = static_cast<int>(chunk.unique_nodes.size());
+				chunk.local_ids.emplace(node, id);
+				chunk.unique_nodes.push_back(node);
+				return id;
+			};
+
+			int span = 0;
+			for (int edge = first_edge; edge < last_edge; edge++) {
+				while (edge >= spans[span].begin + spans[span].size) span++;
+
+				// Parents are assigned before children, the same as addEdge
+				const int i = edge - spans[span].begin;
+				out_parents[edge] = local_id(spans[span].parents[i]);
+				out_children[edge] = local_id(spans[span].children[i]);
+			}
+		}
+	}
+
+	Graph::Graph(
+		const vector<Node>& nodes,
+		const GraphBuilder& edges,
+		const string& default_cost
+	) {
+		this->default_cost = default_cost;
+
+		// Assign ids to nodes in order, the same as the constructor that takes arrays of edges
+		idmap.reserve(nodes.size());
+		ordered_nodes.reserve(nodes.size());
+		for (const Node& node : nodes) {
+			if (idmap.count(node) > 0) continue;
+
+			idmap[node] = next_id;
+			ordered_nodes.push_back(node);
+			ordered_nodes.back().id = next_id;
+			next_id++;
+		}
+
+		BulkAddEdges(edges);
+	}
+
+	void Graph::BulkAddEdges(const GraphBuilder& edges)
+	{
+		// Existing triplets are compressed the normal way so their duplicates are summed like they
+		// would be otherwise. After this the existing edges are in a compressed CSR.
+		this->Compress();
+
+		const auto& buffers = edges.buffers;
+
+		// Find where each buffer's edges start in the combined arrays
+		vector<NodeEdgeSpan> node_spans;
+		int num_node_edges = 0;
+		int num_id_edges = 0;
+		for (const auto& buffer : buffers) {
+			node_spans.push_back(NodeEdgeSpan{
+				buffer.parent_nodes.data(),
+				buffer.child_nodes.data(),
+				num_node_edges,
+				static_cast<int>(buffer.node_costs.size())
+			});
+			num_node_edges += static_cast<int>(buffer.node_costs.size());
+			num_id_edges += static_cast<int>(buffer.id_costs.size());
+		}
+		const int num_new_edges = num_node_edges + num_id_edges;
+		if (num_new_edges == 0) return;
+
+		// Edges stored by position come first, followed by edges stored by ID
+		vector<int> parents(num_new_edges);
+		vector<int> children(num_new_edges);
+		vector<float> costs(num_new_edges);
+
+		// Assign IDs to the nodes of edges stored by position
+		if (num_node_edges > 0) {
+			const int num_chunks = std::min(num_node_edges, omp_get_max_threads());
+			vector<NodeChunk> chunks(num_chunks);
+			AssignLocalNodeIDs(node_spans, num_node_edges, chunks, parents.data(), children.data());
+
+			// Merge the nodes of every chunk into the graph in order. This is the only part that
+			// has to be serial, and it only touches each chunk's unique nodes.
+			bool added_nodes = false;
+			for (auto& chunk : chunks) {
+				chunk.global_ids.resize(chunk.unique_nodes.size());
+				for (int i = 0; i < static_cast<int>(chunk.unique_nodes.size()); i++) {
+					const Node& node = chunk.unique_nodes[i];
+
+					const auto it = idmap.find(node);
+					if (it != idmap.end()) {
+						chunk.global_ids[i] = it->second;
+						continue;
+					}
+
+					idmap[node] = next_id;
+					ordered_nodes.push_back(node);
+					ordered_nodes.back().id = next_id;
+					chunk.global_ids[i] = next_id;
+					next_id++;
+					added_nodes = true;
+				}
+			}
+
+			// Any existing indexes won't contain the new nodes
+			if (added_nodes) node_indices.clear();
+
+			// Replace local ids with global ids
+			#pragma omp parallel for schedule(dynamic)
+			for (int c = 0; c < num_chunks; c++) {
+				const int first_edge = static_cast<int>((static_cast<long long>(num_node_edges) * c) / num_chunks);
+				const int last_edge = static_cast<int>((static_cast<long long>(num_node_edges) * (c + 1)) / num_chunks);
+				const auto& global_ids = chunks[c].global_ids;
+
+				for (int edge = first_edge; edge < last_edge; edge++) {
+					parents[edge] = global_ids[parents[edge]];
+					children[edge] = global_ids[children[edge]];
+				}
+			}
+
+			for (int b = 0; b < static_cast<int>(buffers.size()); b++)
+				std::copy(buffers[b].node_costs.begin(), buffers[b].node_costs.end(), costs.begin() + node_spans[b].begin);
+		}
+
+		// Copy edges stored by ID and add any IDs that aren't in the graph
+		if (num_id_edges > 0) {
+			int offset = num_node_edges;
+			for (const auto& buffer : buffers) {
+				std::copy(buffer.parent_ids.begin(), buffer.parent_ids.end(), parents.begin() + offset);
+				std::copy(buffer.child_ids.begin(), buffer.child_ids.end(), children.begin() + offset);
+				std::copy(buffer.id_costs.begin(), buffer.id_costs.end(), costs.begin() + offset);
+				offset += static_cast<int>(buffer.id_costs.size());
+			}
+
+			int min_id = 0;
+			int max_id = -1;
+			for (int edge = num_node_edges; edge < num_new_edges; edge++) {
+				min_id = std::min(min_id, std::min(parents[edge], children[edge]));
+				max_id = std::max(max_id, std::max(parents[edge], children[edge]));
+			}
+			if (min_id < 0)
+				throw std::out_of_range("Tried to add an edge with a negative node ID");
+
+			// 0 = unused, 1 = used by an edge, 2 = already in the graph
+			vector<char> id_state(max_id + 1, 0);
+			for (int edge = num_node_edges; edge < num_new_edges; edge++) {
+				id_state[parents[edge]] = 1;
+				id_state[children[edge]] = 1;
+			}
+			for (const Node& node : ordered_nodes)
+				if (node.id >= 0 && node.id <= max_id)
+					id_state[node.id] = 2;
+
+			// Add an empty node for every missing ID, the same as addEdge
+			bool added_nodes = false;
+			for (int id = 0; id <= max_id; id++) {
+				if (id_state[id] != 1) continue;
+
+				ordered_nodes.push_back(Node());
+				ordered_nodes.back().id = id;
+				next_id = std::max(id + 1, next_id);
+				added_nodes = true;
+			}
+
+			if (added_nodes) {
+				nodes_out_of_order = true;
+				node_indices.clear();
+			}
+		}
+
+		// Size the CSR the same way ResizeIfNeeded does
+		const int old_rows = static_cast<int>(edge_matrix.rows());
+		const int rows = std::max(old_rows, (nodes_out_of_order ? MaxID() : size()) + 1);
+
+		const int* old_outer = edge_matrix.outerIndexPtr();
+		const int* old_inner = edge_matrix.innerIndexPtr();
+		const float* old_values = edge_matrix.valuePtr();
+
+		// Rows are divided into contiguous blocks so each block's edges can be sorted by a single
+		// thread while they're in cache. Edges are first sorted into blocks, then into rows.
+		const int num_threads = omp_get_max_threads();
+		const int num_blocks = std::max(1, std::min({ rows, MAX_BLOCKS, std::max(num_threads * 64, num_new_edges / EDGES_PER_BLOCK) }));
+		const int rows_per_block = (rows + num_blocks - 1) / num_blocks;
+
+		// Count the new edges in every block. Each thread counts a contiguous range of edges.
+		vector<int> thread_block_offsets(num_threads * num_blocks, 0);
+
+		#pragma omp parallel for schedule(static)
+		for (int thread = 0; thread < num_threads; thread++) {
+			int* counts = thread_block_offsets.data() + (thread * num_blocks);
+			const int first_edge = static_cast<int>((static_cast<long long>(num_new_edges) * thread) / num_threads);
+			const int last_edge = static_cast<int>((static_cast<long long>(num_new_edges) * (thread + 1)) / num_threads);
+
+			for (int edge = first_edge; edge < last_edge; edge++)
+				counts[parents[edge] / rows_per_block]++;
+		}
+
+		// Convert the counts to where each thread starts writing in each block. Blocks are ordered by
+		// thread, so edges stay in the order they were stored in.
+		vector<int> block_begin(num_blocks + 1, 0);
+		for (int block = 0, offset = 0; block < num_blocks; block++) {
+			block_begin[block] = offset;
+			for (int thread = 0; thread < num_threads; thread++) {
+				const int count = thread_block_offsets[thread * num_blocks + block];
+				thread_block_offsets[thread * num_blocks + block] = offset;
+				offset += count;
+			}
+			block_begin[block + 1] = offset;
+		}
+
+		vector<int> block_parents(num_new_edges);
+		vector<int> block_children(num_new_edges);
+		vector<float> block_costs(num_new_edges);
+
+		#pragma omp parallel for schedule(static)
+		for (int thread = 0; thread < num_threads; thread++) {
+			int* offsets = thread_block_offsets.data() + (thread * num_blocks);
+			const int first_edge = static_cast<int>((static_cast<long long>(num_new_edges) * thread) / num_threads);
+			const int last_edge = static_cast<int>((static_cast<long long>(num_new_edges) * (thread + 1)) / num_threads);
+
+			for (int edge = first_edge; edge < last_edge; edge++) {
+				const int index = offsets[parents[edge] / rows_per_block]++;
+				block_parents[index] = parents[edge];
+				block_children[index] = children[edge];
+				block_costs[index] = costs[edge];
+			}
+		}
+
+		// Each block's rows hold their existing edges followed by their new ones
+		vector<int> block_out_begin(num_blocks + 1, 0);
+		for (int block = 0; block < num_blocks; block++) {
+			const int first_row = std::min(old_rows, block * rows_per_block);
+			const int last_row = std::min(old_rows, (block + 1) * rows_per_block);
+			const int num_existing = (old_rows > 0) ? old_outer[last_row] - old_outer[first_row] : 0;
+
+			block_out_begin[block + 1] = block_out_begin[block] + num_existing + (block_begin[block + 1] - block_begin[block]);
+		}
+
+		vector<int> row_begin(rows, 0);
+		vector<int> row_sizes(rows, 0);
+		vector<int> row_children(block_out_begin[num_blocks]);
+		vector<float> row_costs(block_out_begin[num_blocks]);
+
+		// Alternate costs are indexed like the CSR's values, so if there are any, track where
+		// every edge was in the old CSR to move its costs along with it. New edges are -1.
+		const bool move_costs = !edge_cost_maps.empty();
+		vector<int> row_sources(move_costs ? block_out_begin[num_blocks] : 0);
+
+		// Sort every block's edges into rows, then sort every row by child and remove duplicates
+		#pragma omp parallel
+		{
+			vector<int> row_cursors;
+			vector<std::pair<int, float>> new_edges;
+			vector<std::pair<int, float>> merged;
+			vector<int> merged_sources;
+
+			#pragma omp for schedule(dynamic)
+			for (int block = 0; block < num_blocks; block++) {
+				const int first_row = std::min(rows, block * rows_per_block);
+				const int last_row = std::min(rows, (block + 1) * rows_per_block);
+
+				row_cursors.assign(last_row - first_row, 0);
+				for (int i = block_begin[block]; i < block_begin[block + 1]; i++)
+					row_cursors[block_parents[i] - first_row]++;
+
+				// Copy existing edges to the start of every row
+				int offset = block_out_begin[block];
+				for (int row = first_row; row < last_row; row++) {
+					const int num_new = row_cursors[row - first_row];
+					const int num_existing = (row < old_rows) ? old_outer[row + 1] - old_outer[row] : 0;
+
+					row_begin[row] = offset;
+					std::copy_n(old_inner + (num_existing > 0 ? old_outer[row] : 0), num_existing, row_children.begin() + offset);
+					std::copy_n(old_values + (num_existing > 0 ? old_outer[row] : 0), num_existing, row_costs.begin() + offset);
+					if (move_costs && num_existing > 0)
+						std::iota(row_sources.begin() + offset, row_sources.begin() + offset + num_existing, old_outer[row]);
+
+					row_sizes[row] = num_existing;
+					row_cursors[row - first_row] = offset + num_existing;
+					offset += num_existing + num_new;
+				}
+
+				// Then append new edges after them in the order they were stored
+				for (int i = block_begin[block]; i < block_begin[block + 1]; i++) {
+					const int index = row_cursors[block_parents[i] - first_row]++;
+					row_children[index] = block_children[i];
+					row_costs[index] = block_costs[i];
+					if (move_costs) row_sources[index] = -1;
+				}
+
+				for (int row = first_row; row < last_row; row++) {
+					const int begin = row_begin[row];
+					const int existing_end = begin + row_sizes[row];
+					const int end = row_cursors[row - first_row];
+					if (existing_end == end) continue;
+
+					// Sorting by cost as well means the first copy of each edge has the lowest cost
+					new_edges.clear();
+					for (int i = existing_end; i < end; i++)
+						new_edges.emplace_back(row_children[i], row_costs[i]);
+					std::sort(new_edges.begin(), new_edges.end());
+
+					// Merge with the existing edges, which are already sorted by child.
+					// New edges replace existing edges to the same child.
+					merged.clear();
+					merged_sources.clear();
+					int existing = begin;
+					for (int i = 0; i < static_cast<int>(new_edges.size()); i++) {
+						const int child = new_edges[i].first;
+						if (i > 0 && new_edges[i - 1].first == child) continue;
+
+						while (existing < existing_end && row_children[existing] < child) {
+							merged.emplace_back(row_children[existing], row_costs[existing]);
+							merged_sources.push_back(move_costs ? row_sources[existing] : -1);
+							existing++;
+						}
+						if (existing < existing_end && row_children[existing] == child)
+							existing++;
+
+						merged.push_back(new_edges[i]);
+						merged_sources.push_back(-1);
+					}
+					for (; existing < existing_end; existing++) {
+						merged.emplace_back(row_children[existing], row_costs[existing]);
+						merged_sources.push_back(move_costs ? row_sources[existing] : -1);
+					}
+
+					for (int i = 0; i < static_cast<int>(merged.size()); i++) {
+						row_children[begin + i] = merged[i].first;
+						row_costs[begin + i] = merged[i].second;
+					}
+					if (move_costs)
+						std::copy(merged_sources.begin(), merged_sources.end(), row_sources.begin() + begin);
+					row_sizes[row] = static_cast<int>(merged.size());
+				}
+			}
+		}
+
+		// Fill the CSR's arrays directly with every row's unique edges
+		edge_matrix.resize(rows, rows);
+		int* outer = edge_matrix.outerIndexPtr();
+		outer[0] = 0;
+		for (int row = 0; row < rows; row++)
+			outer[row + 1] = outer[row] + row_sizes[row];
+
+		edge_matrix.resizeNonZeros(outer[rows]);
+		int* inner = edge_matrix.innerIndexPtr();
+		float* values = edge_matrix.valuePtr();
+
+		#pragma omp parallel for schedule(dynamic)
+		for (int block = 0; block < num_blocks; block++) {
+			const int first_row = std::min(rows, block * rows_per_block);
+			const int last_row = std::min(rows, (block + 1) * rows_per_block);
+
+			for (int row = first_row; row < last_row; row++) {
+				std::copy_n(row_children.begin() + row_begin[row], row_sizes[row], inner + outer[row]);
+				std::copy_n(row_costs.begin() + row_begin[row], row_sizes[row], values + outer[row]);
+			}
+		}
+
+		// Move every alternate cost to its edge's new index. Edges without one are left as NAN.
+		for (auto& cost_map : edge_cost_maps) {
+			const EdgeCostSet& old_costs = cost_map.second;
+			EdgeCostSet new_costs(outer[rows]);
+
+			#pragma omp parallel for schedule(dynamic)
+			for (int row = 0; row < rows; row++) {
+				for (int i = 0; i < row_sizes[row]; i++) {
+					const int source = row_sources[row_begin[row] + i];
+					if (source >= 0 && source < old_costs.size())
+						new_costs[outer[row] + i] = old_costs[source];
+				}
+			}
+			cost_map.second = std::move(new_costs);
+		}
+
+		triplets.clear();
+		needs_compression = false;
+	}
+}
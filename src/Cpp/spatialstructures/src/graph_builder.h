@@ -0,0 +1,141 @@
+///
+/// \file		graph_builder.h
+/// \brief		Contains definitions for the <see cref="HF::SpatialStructures::GraphBuilder">GraphBuilder</see> class
+///
+///	\author		TBA
+///	\date		06 Jun 2020
+
+#pragma once
+
+#include <node.h>
+
+#include <vector>
+
+namespace HF::SpatialStructures {
+
+	/*!
+		\brief Per-thread buffers of edges to be added to a Graph all at once.
+
+		\details
+		Every buffer is only ever written to by one thread, so threads can store edges without
+		locking or sharing a hashmap. Once every edge is stored, Graph::BulkAddEdges assigns IDs
+		to nodes and builds the CSR from every buffer in parallel.
+
+		Edges can be stored either by the IDs of their parent and child, or by the position of
+		their parent and child, in which case they'll be assigned IDs the same way Graph::addEdge
+		would.
+
+		\remarks
+		The easiest way to use this is to create one buffer per OpenMP thread and have each thread
+		write to the buffer at omp_get_thread_num().
+
+		\see Graph::BulkAddEdges for adding the edges to a graph.
+
+		\par Example
+		\snippet tests\src\SpatialStructures.cpp EX_GraphBuilder
+	*/
+	class GraphBuilder {
+	private:
+		/*! \brief Edges stored by a single thread. */
+		struct EdgeBuffer {
+			std::vector<int> parent_ids;	///< Parent of every edge stored by ID.
+			std::vector<int> child_ids;		///< Child of every edge stored by ID.
+			std::vector<float> id_costs;	///< Cost of every edge stored by ID.
+
+			std::vector<Node> parent_nodes;	///< Parent of every edge stored by position.
+			std::vector<Node> child_nodes;	///< Child of every edge stored by position.
+			std::vector<float> node_costs;	///< Cost of every edge stored by position.
+		};
+
+		std::vector<EdgeBuffer> buffers; ///< Edges stored by each thread.
+
+		friend class Graph;
+
+	public:
+		/*!
+			\brief Create a builder with `num_buffers` empty buffers.
+
+			\param num_buffers Number of buffers to create. If less than 1, one buffer will be
+			created for every thread OpenMP can use.
+		*/
+		GraphBuilder(int num_buffers = -1);
+
+		/*! \brief Get the number of buffers in this builder. */
+		int NumBuffers() const;
+
+		/*! \brief Get the number of edges stored in every buffer, including duplicates. */
+		size_t NumEdges() const;
+
+		/*!
+			\brief Preallocate space for edges in a buffer.
+
+			\param buffer Index of the buffer to reserve space in.
+			\param num_id_edges Number of edges that will be stored by ID.
+			\param num_node_edges Number of edges that will be stored by position.
+		*/
+		void Reserve(int buffer, size_t num_id_edges, size_t num_node_edges = 0);
+
+		/*!
+			\brief Store an edge between the nodes with ids `parent_id` and `child_id`.
+
+			\param buffer Index of the buffer to store the edge in.
+			\param parent_id ID of the parent node.
+			\param child_id ID of the child node.
+			\param cost Cost of traversing from parent to child.
+
+			\pre Only one thread may write to `buffer` at a time.
+		*/
+		inline void AddEdge(int buffer, int parent_id, int child_id, float cost) {
+			EdgeBuffer& b = buffers[buffer];
+			b.parent_ids.push_back(parent_id);
+			b.child_ids.push_back(child_id);
+			b.id_costs.push_back(cost);
+		}
+
+		/*!
+			\brief Store an edge between the nodes at the positions of `parent` and `child`.
+
+			\param buffer Index of the buffer to store the edge in.
+			\param parent Parent node.
+			\param child Child node.
+			\param cost Cost of traversing from parent to child.
+
+			\pre Only one thread may write to `buffer` at a time.
+		*/
+		inline void AddEdge(int buffer, const Node& parent, const Node& child, float cost) {
+			EdgeBuffer& b = buffers[buffer];
+			b.parent_nodes.push_back(parent);
+			b.child_nodes.push_back(child);
+			b.node_costs.push_back(cost);
+		}
+
+		/*!
+			\brief Store `num_edges` edges by ID.
+
+			\param buffer Index of the buffer to store the edges in.
+			\param parent_ids ID of the parent of every edge.
+			\param child_ids ID of the child of every edge.
+			\param costs Cost of every edge.
+			\param num_edges Number of edges in each array.
+
+			\pre Only one thread may write to `buffer` at a time.
+		*/
+		void AddEdges(int buffer, const int* parent_ids, const int* child_ids, const float* costs, int num_edges);
+
+		/*!
+			\brief Store `num_edges` edges by position.
+
+			\param buffer Index of the buffer to store the edges in.
+			\param parents X, Y, Z position of the parent of every edge. Must hold `num_edges * 3` floats.
+			\param children X, Y, Z position of the child of every edge. Must hold `num_edges * 3` floats.
+			\param costs Cost of every edge.
+			\param num_edges Number of edges in each array.
+
+			\pre Only one thread may write to `buffer` at a time.
+		*/
+		void AddEdges(int buffer, const float* parents, const float* children, const float* costs, int num_edges);
+
+		/*! \brief Remove every edge from every buffer. */
+		void Clear();
+	};
+}
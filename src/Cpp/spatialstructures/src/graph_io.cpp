@@ -0,0 +1,389 @@
+///
+/// \file		graph_io.cpp
+/// \brief		Contains implementation for saving and loading a <see cref="HF::SpatialStructures::Graph">Graph</see> as a binary file.
+///
+///	\author		TBA
+///	\date		06 Jun 2020
+
+#include <graph.h>
+#include <mapped_file.h>
+#include <HFExceptions.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+using std::string;
+using std::vector;
+using HF::Geometry::MappedFile;
+
+namespace HF::SpatialStructures {
+
+	constexpr char GRAPH_FILE_MAGIC[8] = { 'D', 'H', 'A', 'R', 'T', 'G', 'R', '\0' }; ///< First bytes of every graph file.
+	constexpr uint32_t GRAPH_FILE_VERSION = 2; ///< Version of the graph file format written by SaveBinary.
+	constexpr size_t GRAPH_FILE_ALIGNMENT = 8; ///< Every section of the file starts on a multiple of this many bytes.
+
+	/*!
+		\brief The first section of every graph file.
+
+		\details
+		The rest of the file is made of the following sections, in order. Each section is padded
+		to GRAPH_FILE_ALIGNMENT bytes so every array can be read directly from a mapping of the file.
+
+		1) The graph's default cost name.
+		2) Node positions as `num_nodes` x,y,z triplets of floats, then node IDs, then node types.
+		3) The CSR's outer indices (`rows` + 1 ints), inner indices (`nnz` ints), then values (`nnz` floats).
+		4) For every alternate cost type, its name, its size, and its values.
+		5) For every node attribute, its name, its NODE_ATTRIBUTE_TYPE, its size, a byte for every node
+		   that is 1 if the node has a value, then its values. String values are stored as the length
+		   of every string followed by every string concatenated.
+
+		Strings are stored as a uint32_t length followed by that many characters.
+	*/
+	struct GraphFileHeader {
+		char magic[8];				///< Must match GRAPH_FILE_MAGIC.
+		uint32_t version;			///< Version of the format this file was written with.
+		uint32_t flags;				///< Bit 0 is set if the graph's nodes were added out of order.
+		int32_t num_nodes;			///< Number of nodes in the graph.
+		int32_t next_id;			///< ID that would be assigned to the next new node.
+		int32_t rows;				///< Number of rows in the CSR.
+		int32_t cols;				///< Number of columns in the CSR.
+		int32_t nnz;				///< Number of non-zeros in the CSR.
+		int32_t num_cost_types;		///< Number of alternate cost types.
+		int32_t num_node_attrs;		///< Number of node attributes.
+		int32_t reserved;			///< Unused. Keeps the header a multiple of 8 bytes.
+	};
+
+	/*! \brief Writes arrays to a file, padding each one to GRAPH_FILE_ALIGNMENT. */
+	class GraphFileWriter {
+	private:
+		std::ofstream out; ///< The file being written to.
+		size_t offset = 0; ///< Number of bytes written so far.
+
+	public:
+		/*! \brief Open `path` for writing, replacing any existing file. */
+		GraphFileWriter(const string& path) : out(path, std::ios::binary | std::ios::trunc) {}
+
+		/*! \brief Check that the file was opened and nothing has failed to write. */
+		bool good() const { return out.good(); }
+
+		/*! \brief Write `count` elements from `data`, then pad to the next aligned offset. */
+		template <typename T>
+		void Write(const T* data, size_t count) {
+			const size_t num_bytes = sizeof(T) * count;
+			if (num_bytes > 0)
+				out.write(reinterpret_cast<const char*>(data), num_bytes);
+			offset += num_bytes;
+
+			static const char zeros[GRAPH_FILE_ALIGNMENT] = { 0 };
+			const size_t padding = (GRAPH_FILE_ALIGNMENT - (offset % GRAPH_FILE_ALIGNMENT)) % GRAPH_FILE_ALIGNMENT;
+			out.write(zeros, padding);
+			offset += padding;
+		}
+
+		/*! \brief Write a single value. */
+		template <typename T>
+		void Write(const T& value) { Write(&value, 1); }
+
+		/*! \brief Write a string as its length followed by its characters. */
+		void WriteString(const string& str) {
+			const uint32_t length = static_cast<uint32_t>(str.size());
+			out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+			offset += sizeof(length);
+			Write(str.data(), str.size());
+		}
+	};
+
+	/*! \brief Reads arrays out of a mapped graph file, matching the layout of GraphFileWriter. */
+	class GraphFileReader {
+	private:
+		const char* begin; ///< Start of the file.
+		const char* current; ///< Start of the next section.
+		const char* end; ///< End of the file.
+
+		/*! \brief Throw if fewer than `num_bytes` remain in the file. */
+		void Require(size_t num_bytes) const {
+			if (num_bytes > static_cast<size_t>(end - current))
+				throw std::runtime_error("Graph file ended unexpectedly");
+		}
+
+		/*! \brief Move forward `num_bytes`, then to the next aligned offset. */
+		const char* Advance(size_t num_bytes) {
+			Require(num_bytes);
+			const char* start = current;
+			current += num_bytes;
+
+			const size_t offset = static_cast<size_t>(current - begin);
+			const size_t padding = (GRAPH_FILE_ALIGNMENT - (offset % GRAPH_FILE_ALIGNMENT)) % GRAPH_FILE_ALIGNMENT;
+			current += std::min(padding, static_cast<size_t>(end - current));
+			return start;
+		}
+
+	public:
+		/*! \brief Read from the contents of `file`. */
+		GraphFileReader(const MappedFile& file) : begin(file.data()), current(file.data()), end(file.data() + file.size()) {}
+
+		/*! \brief Get a pointer to the next `count` elements of type T. */
+		template <typename T>
+		const T* Read(size_t count) {
+			return reinterpret_cast<const T*>(Advance(sizeof(T) * count));
+		}
+
+		/*! \brief Read a string written by GraphFileWriter::WriteString. */
+		string ReadString() {
+			// The length isn't padded, so the string's characters start right after it
+			uint32_t length;
+			Require(sizeof(length));
+			std::memcpy(&length, current, sizeof(length));
+			current += sizeof(length);
+
+			const char* str = Advance(length);
+			return string(str, length);
+		}
+	};
+
+	bool Graph::SaveBinary(const string& path) const
+	{
+		// The CSR's arrays are only contiguous once it's been compressed. This is
+		// const, so compress a copy instead of changing the caller's graph.
+		if (needs_compression || !edge_matrix.isCompressed()) {
+			Graph compressed(*this);
+			compressed.Compress();
+			return compressed.SaveBinary(path);
+		}
+
+		GraphFileWriter writer(path);
+		if (!writer.good()) return false;
+
+		// Write the header
+		GraphFileHeader header;
+		std::memcpy(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic));
+		header.version = GRAPH_FILE_VERSION;
+		header.flags = nodes_out_of_order ? 1 : 0;
+		header.num_nodes = static_cast<int32_t>(ordered_nodes.size());
+		header.next_id = next_id;
+		header.rows = static_cast<int32_t>(edge_matrix.rows());
+		header.cols = static_cast<int32_t>(edge_matrix.cols());
+		header.nnz = static_cast<int32_t>(edge_matrix.nonZeros());
+		header.num_cost_types = static_cast<int32_t>(edge_cost_maps.size());
+		header.num_node_attrs = static_cast<int32_t>(node_attributes.size());
+		header.reserved = 0;
+		writer.Write(header);
+
+		writer.WriteString(default_cost);
+
+		// Write nodes as separate arrays of positions, IDs and types
+		const int num_nodes = header.num_nodes;
+		vector<float> positions(size_t(num_nodes) * 3);
+		vector<int32_t> ids(num_nodes);
+		vector<int16_t> types(num_nodes);
+		for (int i = 0; i < num_nodes; i++) {
+			const Node& node = ordered_nodes[i];
+			positions[size_t(i) * 3] = node.x;
+			positions[size_t(i) * 3 + 1] = node.y;
+			positions[size_t(i) * 3 + 2] = node.z;
+			ids[i] = node.id;
+			types[i] = node.type;
+		}
+		writer.Write(positions.data(), positions.size());
+		writer.Write(ids.data(), ids.size());
+		writer.Write(types.data(), types.size());
+
+		// Write the CSR exactly as Eigen stores it
+		writer.Write(edge_matrix.outerIndexPtr(), size_t(header.rows) + 1);
+		writer.Write(edge_matrix.innerIndexPtr(), header.nnz);
+		writer.Write(edge_matrix.valuePtr(), header.nnz);
+
+		// Alternate cost types share the CSR's indices, so only their values are needed
+		for (const auto& cost_type : edge_cost_maps) {
+			const EdgeCostSet& cost_set = cost_type.second;
+			const int32_t size = cost_set.size();
+
+			writer.WriteString(cost_type.first);
+			writer.Write(size);
+			if (size > 0) writer.Write(cost_set.GetPtr(), size);
+		}
+
+		// Write node attributes as their stored columns
+		for (const auto& attr : node_attributes) {
+			const NodeAttributeColumn& column = attr.second;
+			const int32_t size = column.size();
+
+			writer.WriteString(attr.first);
+			writer.Write(static_cast<int32_t>(column.Type()));
+			writer.Write(size);
+			writer.Write(column.AssignedData(), size);
+
+			switch (column.Type()) {
+			case NODE_ATTRIBUTE_TYPE::FLOAT:
+				writer.Write(static_cast<const float*>(column.Data()), size);
+				break;
+			case NODE_ATTRIBUTE_TYPE::INT:
+				writer.Write(static_cast<const int32_t*>(column.Data()), size);
+				break;
+			case NODE_ATTRIBUTE_TYPE::BOOL:
+				writer.Write(static_cast<const uint8_t*>(column.Data()), size);
+				break;
+			case NODE_ATTRIBUTE_TYPE::STRING:
+			{
+				vector<uint32_t> lengths(size);
+				string chars;
+				for (int id = 0; id < size; id++) {
+					const string value = column.ToString(id);
+					lengths[id] = static_cast<uint32_t>(value.size());
+					chars += value;
+				}
+				writer.Write(lengths.data(), lengths.size());
+				writer.Write(chars.data(), chars.size());
+				break;
+			}
+			}
+		}
+
+		return writer.good();
+	}
+
+	Graph Graph::LoadBinary(const string& path)
+	{
+		MappedFile file(path);
+		GraphFileReader reader(file);
+
+		// Check that this is actually a graph file that we can read
+		const GraphFileHeader header = *reader.Read<GraphFileHeader>(1);
+		if (std::memcmp(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic)) != 0)
+			throw std::runtime_error(path + " is not a graph file");
+		if (header.version != GRAPH_FILE_VERSION)
+			throw std::runtime_error(path + " was written with an unsupported version of the graph format");
+		if (header.num_nodes < 0 || header.rows < 0 || header.cols != header.rows || header.nnz < 0
+			|| header.num_cost_types < 0 || header.num_node_attrs < 0)
+			throw std::runtime_error(path + " has an invalid header");
+
+		Graph g(reader.ReadString());
+		g.nodes_out_of_order = (header.flags & 1) != 0;
+
+		// Read nodes, and add every node with a position to the idmap
+		// so they can be found by getID.
+		const int num_nodes = header.num_nodes;
+		const float* positions = reader.Read<float>(size_t(num_nodes) * 3);
+		const int32_t* ids = reader.Read<int32_t>(num_nodes);
+		const int16_t* types = reader.Read<int16_t>(num_nodes);
+
+		g.ordered_nodes.resize(num_nodes);
+		g.idmap.reserve(num_nodes);
+		vector<int32_t> used_ids;
+		used_ids.reserve(num_nodes);
+		for (int i = 0; i < num_nodes; i++) {
+			Node& node = g.ordered_nodes[i];
+			node.x = positions[size_t(i) * 3];
+			node.y = positions[size_t(i) * 3 + 1];
+			node.z = positions[size_t(i) * 3 + 2];
+			node.id = ids[i];
+			node.type = types[i];
+
+			// Nodes are looked up in the CSR by ID, so every ID must be one of its rows.
+			// Only nodes without a position, like the ones added for integer IDs, may have no ID.
+			const bool has_position = !std::isnan(node.x);
+			const bool valid_id = node.id >= 0 && (header.rows == 0 || node.id < header.rows);
+			if (!valid_id && (has_position || node.id != -1))
+				throw std::runtime_error(path + " has a node with an invalid ID");
+
+			if (has_position)
+				g.idmap[node] = node.id;
+			if (node.id >= 0)
+				used_ids.push_back(node.id);
+		}
+
+		// IDs are indices into the CSR, so no two nodes can share one, and new nodes
+		// must be given an ID that isn't already in use
+		std::sort(used_ids.begin(), used_ids.end());
+		if (std::adjacent_find(used_ids.begin(), used_ids.end()) != used_ids.end())
+			throw std::runtime_error(path + " has multiple nodes with the same ID");
+		if (header.next_id < 0 || (!used_ids.empty() && header.next_id <= used_ids.back()))
+			throw std::runtime_error(path + " has an invalid header");
+		g.next_id = header.next_id;
+
+		// Copy the CSR's arrays directly into Eigen's storage
+		const int32_t* outer_indices = reader.Read<int32_t>(size_t(header.rows) + 1);
+		const int32_t* inner_indices = reader.Read<int32_t>(header.nnz);
+		const float* values = reader.Read<float>(header.nnz);
+
+		// Eigen and the path finders trust these without checking them, so make sure
+		// every row's edges are in order within the arrays and point to real columns
+		if (outer_indices[0] != 0 || outer_indices[header.rows] != header.nnz)
+			throw std::runtime_error(path + " has an invalid CSR");
+		for (int row = 0; row < header.rows; row++)
+			if (outer_indices[row] > outer_indices[row + 1])
+				throw std::runtime_error(path + " has an invalid CSR");
+		for (int edge = 0; edge < header.nnz; edge++)
+			if (inner_indices[edge] < 0 || inner_indices[edge] >= header.cols)
+				throw std::runtime_error(path + " has an invalid CSR");
+
+		g.edge_matrix.resize(header.rows, header.cols);
+		g.edge_matrix.resizeNonZeros(header.nnz);
+		std::memcpy(g.edge_matrix.outerIndexPtr(), outer_indices, sizeof(int32_t) * (size_t(header.rows) + 1));
+		std::memcpy(g.edge_matrix.innerIndexPtr(), inner_indices, sizeof(int32_t) * size_t(header.nnz));
+		std::memcpy(g.edge_matrix.valuePtr(), values, sizeof(float) * size_t(header.nnz));
+		g.needs_compression = false;
+
+		// Read alternate cost types
+		for (int i = 0; i < header.num_cost_types; i++) {
+			const string name = reader.ReadString();
+			const int32_t size = *reader.Read<int32_t>(1);
+			// Cost types are indexed by the same positions as the CSR's values
+			if (size < header.nnz) throw std::runtime_error(path + " has an invalid cost type");
+
+			EdgeCostSet cost_set(size);
+			if (size > 0)
+				std::memcpy(cost_set.GetPtr(), reader.Read<float>(size), sizeof(float) * size);
+
+			g.edge_cost_maps[name] = std::move(cost_set);
+		}
+		g.has_cost_arrays = header.num_cost_types > 0;
+
+		// Read node attributes
+		for (int i = 0; i < header.num_node_attrs; i++) {
+			const string name = reader.ReadString();
+			const int32_t type = *reader.Read<int32_t>(1);
+			const int32_t size = *reader.Read<int32_t>(1);
+			if (size < 0 || type < 0 || type > static_cast<int32_t>(NODE_ATTRIBUTE_TYPE::STRING))
+				throw std::runtime_error(path + " has an invalid node attribute");
+
+			const uint8_t* assigned = reader.Read<uint8_t>(size);
+
+			NodeAttributeColumn column(static_cast<NODE_ATTRIBUTE_TYPE>(type));
+			switch (column.Type()) {
+			case NODE_ATTRIBUTE_TYPE::FLOAT:
+				column.SetValues(reader.Read<float>(size), size, assigned);
+				break;
+			case NODE_ATTRIBUTE_TYPE::INT:
+				column.SetValues(reader.Read<int32_t>(size), size, assigned);
+				break;
+			case NODE_ATTRIBUTE_TYPE::BOOL:
+				column.SetValues(reader.Read<uint8_t>(size), size, assigned);
+				break;
+			case NODE_ATTRIBUTE_TYPE::STRING:
+			{
+				const uint32_t* lengths = reader.Read<uint32_t>(size);
+
+				size_t total_length = 0;
+				for (int id = 0; id < size; id++) total_length += lengths[id];
+				const char* chars = reader.Read<char>(total_length);
+
+				column.ResizeIfNeeded(size);
+				for (int id = 0; id < size; id++) {
+					if (assigned[id]) column.SetString(id, string(chars, lengths[id]));
+					chars += lengths[id];
+				}
+				break;
+			}
+			}
+
+			g.node_attributes[name] = std::move(column);
+		}
+
+		return g;
+	}
+}
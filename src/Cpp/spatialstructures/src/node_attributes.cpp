@@ -0,0 +1,216 @@
+///
+/// \file		node_attributes.cpp
+/// \brief		Contains implementation for the <see cref="HF::SpatialStructures::NodeAttributeColumn">NodeAttributeColumn</see> class
+///
+///	\author		TBA
+///	\date		06 Jun 2020
+
+#include <node_attributes.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+using std::string;
+using std::vector;
+
+namespace HF::SpatialStructures {
+
+	/*!
+		\brief Convert a string to a float.
+
+		\returns The number in `str_to_convert`, or -1 if it couldn't be converted.
+	*/
+	inline float StringToFloat(const string& str_to_convert) {
+
+		// As stated in the docs for stof, this will throw if the string you're trying to convert
+		// can't be converted to a number. This will occur when the string is empty, as it is in
+		// the case of a node that wasn't assigned a value.
+		try {
+			return std::stof(str_to_convert);
+		}
+		catch (const std::invalid_argument&) {
+			return -1;
+		}
+		catch (const std::out_of_range&) {
+			return -1;
+		}
+	}
+
+	NodeAttributeColumn::NodeAttributeColumn(NODE_ATTRIBUTE_TYPE type) : type(type) {}
+
+	NODE_ATTRIBUTE_TYPE NodeAttributeColumn::Type() const
+	{
+		return type;
+	}
+
+	bool NodeAttributeColumn::IsNumeric() const
+	{
+		return type != NODE_ATTRIBUTE_TYPE::STRING;
+	}
+
+	int NodeAttributeColumn::size() const
+	{
+		return static_cast<int>(assigned.size());
+	}
+
+	void NodeAttributeColumn::ResizeIfNeeded(int new_size)
+	{
+		if (new_size <= size()) return;
+
+		assigned.resize(new_size, 0);
+		switch (type) {
+		case NODE_ATTRIBUTE_TYPE::FLOAT:
+			floats.resize(new_size, 0.0f);
+			break;
+		case NODE_ATTRIBUTE_TYPE::INT:
+			ints.resize(new_size, 0);
+			break;
+		case NODE_ATTRIBUTE_TYPE::BOOL:
+			bools.resize(new_size, 0);
+			break;
+		case NODE_ATTRIBUTE_TYPE::STRING:
+			strings.resize(new_size);
+			break;
+		}
+	}
+
+	bool NodeAttributeColumn::IsAssigned(int id) const
+	{
+		return id >= 0 && id < size() && assigned[id];
+	}
+
+	void NodeAttributeColumn::SetFloat(int id, float value)
+	{
+		assert(type == NODE_ATTRIBUTE_TYPE::FLOAT);
+
+		ResizeIfNeeded(id + 1);
+		floats[id] = value;
+		assigned[id] = 1;
+	}
+
+	void NodeAttributeColumn::SetString(int id, const string& value)
+	{
+		assert(type == NODE_ATTRIBUTE_TYPE::STRING);
+
+		ResizeIfNeeded(id + 1);
+		strings[id] = value;
+		assigned[id] = 1;
+	}
+
+	void NodeAttributeColumn::SetValues(const void* values, int num_values, const uint8_t* assigned_mask)
+	{
+		if (num_values <= 0) return;
+
+		ResizeIfNeeded(num_values);
+		switch (type) {
+		case NODE_ATTRIBUTE_TYPE::FLOAT:
+			std::memcpy(floats.data(), values, sizeof(float) * num_values);
+			break;
+		case NODE_ATTRIBUTE_TYPE::INT:
+			std::memcpy(ints.data(), values, sizeof(int) * num_values);
+			break;
+		case NODE_ATTRIBUTE_TYPE::BOOL:
+			std::memcpy(bools.data(), values, sizeof(uint8_t) * num_values);
+			break;
+		case NODE_ATTRIBUTE_TYPE::STRING:
+		{
+			const char* const* char_arrays = static_cast<const char* const*>(values);
+			for (int i = 0; i < num_values; i++)
+				strings[i] = string(char_arrays[i]);
+			break;
+		}
+		}
+
+		if (assigned_mask)
+			std::copy_n(assigned_mask, num_values, assigned.begin());
+		else
+			std::fill(assigned.begin(), assigned.begin() + num_values, 1);
+	}
+
+	string NodeAttributeColumn::ToString(int id) const
+	{
+		if (!IsAssigned(id)) return "";
+
+		switch (type) {
+		case NODE_ATTRIBUTE_TYPE::FLOAT:
+			return std::to_string(floats[id]);
+		case NODE_ATTRIBUTE_TYPE::INT:
+			return std::to_string(ints[id]);
+		case NODE_ATTRIBUTE_TYPE::BOOL:
+			return std::to_string(static_cast<int>(bools[id]));
+		default:
+			return strings[id];
+		}
+	}
+
+	float NodeAttributeColumn::ToFloat(int id) const
+	{
+		// Values that were never assigned are 0 in numeric columns, but -1 in string
+		// columns since the empty string isn't a number
+		if (id < 0 || id >= size())
+			return IsNumeric() ? 0.0f : -1.0f;
+
+		switch (type) {
+		case NODE_ATTRIBUTE_TYPE::FLOAT:
+			return floats[id];
+		case NODE_ATTRIBUTE_TYPE::INT:
+			return static_cast<float>(ints[id]);
+		case NODE_ATTRIBUTE_TYPE::BOOL:
+			return static_cast<float>(bools[id]);
+		default:
+			return StringToFloat(strings[id]);
+		}
+	}
+
+	void NodeAttributeColumn::ConvertTo(NODE_ATTRIBUTE_TYPE new_type)
+	{
+		if (new_type == type) return;
+
+		// Build the new column, then swap it with this one
+		NodeAttributeColumn converted(new_type);
+		converted.ResizeIfNeeded(size());
+		converted.assigned = assigned;
+
+		for (int id = 0; id < size(); id++) {
+			if (!assigned[id]) continue;
+
+			switch (new_type) {
+			case NODE_ATTRIBUTE_TYPE::FLOAT:
+				converted.floats[id] = ToFloat(id);
+				break;
+			case NODE_ATTRIBUTE_TYPE::INT:
+				converted.ints[id] = static_cast<int>(ToFloat(id));
+				break;
+			case NODE_ATTRIBUTE_TYPE::BOOL:
+				converted.bools[id] = ToFloat(id) != 0.0f ? 1 : 0;
+				break;
+			case NODE_ATTRIBUTE_TYPE::STRING:
+				converted.strings[id] = ToString(id);
+				break;
+			}
+		}
+
+		*this = std::move(converted);
+	}
+
+	const void* NodeAttributeColumn::Data() const
+	{
+		switch (type) {
+		case NODE_ATTRIBUTE_TYPE::FLOAT:
+			return floats.data();
+		case NODE_ATTRIBUTE_TYPE::INT:
+			return ints.data();
+		case NODE_ATTRIBUTE_TYPE::BOOL:
+			return bools.data();
+		default:
+			return nullptr;
+		}
+	}
+
+	const uint8_t* NodeAttributeColumn::AssignedData() const
+	{
+		return assigned.data();
+	}
+}
@@ -0,0 +1,136 @@
+///
+/// \file		node_attributes.h
+/// \brief		Contains definitions for the <see cref="HF::SpatialStructures::NodeAttributeColumn">NodeAttributeColumn</see> class
+///
+///	\author		TBA
+///	\date		06 Jun 2020
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace HF::SpatialStructures {
+
+	/*! \brief Types of values that can be stored in a node attribute. */
+	enum class NODE_ATTRIBUTE_TYPE : int {
+		FLOAT = 0,	///< 32 bit floating point numbers.
+		INT = 1,	///< 32 bit signed integers.
+		BOOL = 2,	///< Booleans stored as one byte each, 0 for false and 1 for true.
+		STRING = 3	///< Strings of any length.
+	};
+
+	/*!
+		\brief The values of a single node attribute for every node in a graph.
+
+		\details
+		Values are stored in a dense array of a single type indexed by node ID, so a node's
+		value can be found without hashing, and the values of numeric attributes can be read or
+		written as a contiguous block of memory. Alongside the values, the column keeps track of
+		which nodes have actually been assigned a value.
+
+		Nodes that haven't been assigned a value read as 0, false, or the empty string depending
+		on the type of the column.
+
+		\invariant The values array of the column's type is always the same size as the assigned array.
+		Arrays of other types are always empty.
+	*/
+	class NodeAttributeColumn {
+	private:
+		NODE_ATTRIBUTE_TYPE type;			///< Type of values stored in this column.
+		std::vector<float> floats;			///< Values if this is a float column.
+		std::vector<int> ints;				///< Values if this is an int column.
+		std::vector<uint8_t> bools;			///< Values if this is a bool column.
+		std::vector<std::string> strings;	///< Values if this is a string column.
+		std::vector<uint8_t> assigned;		///< 1 for every node that has been assigned a value, 0 otherwise.
+
+	public:
+		/*! \brief Create an empty column that stores values of `type`. */
+		explicit NodeAttributeColumn(NODE_ATTRIBUTE_TYPE type = NODE_ATTRIBUTE_TYPE::STRING);
+
+		/*! \brief Get the type of values stored in this column. */
+		NODE_ATTRIBUTE_TYPE Type() const;
+
+		/*! \brief Check if this column stores float, int, or bool values. */
+		bool IsNumeric() const;
+
+		/*! \brief Get the number of node IDs this column has space for. */
+		int size() const;
+
+		/*!
+			\brief Grow this column to hold at least `new_size` nodes.
+
+			\details Does nothing if the column is already large enough. New nodes are unassigned.
+		*/
+		void ResizeIfNeeded(int new_size);
+
+		/*! \brief Check if the node with `id` has been assigned a value. */
+		bool IsAssigned(int id) const;
+
+		/*!
+			\brief Set the value of a node in a float column.
+			\pre This must be a float column.
+		*/
+		void SetFloat(int id, float value);
+
+		/*!
+			\brief Set the value of a node in a string column.
+			\pre This must be a string column.
+		*/
+		void SetString(int id, const std::string& value);
+
+		/*!
+			\brief Replace the values of the first `num_values` nodes.
+
+			\param values Array of `num_values` values of this column's type. For string columns
+			this must be an array of null terminated char arrays.
+			\param num_values Number of values in `values`.
+			\param assigned_mask Optional array of `num_values` bytes that are 1 for nodes that should be
+			assigned and 0 for nodes that shouldn't. If null, every node is assigned.
+
+			\details
+			Numeric values are copied in a single block. Nodes with IDs of `num_values` or more are
+			left as they are.
+		*/
+		void SetValues(const void* values, int num_values, const uint8_t* assigned_mask = nullptr);
+
+		/*!
+			\brief Get the value of a node as a string.
+
+			\returns The value of the node with `id`. Numeric values are converted with std::to_string.
+			Nodes without values return the empty string.
+		*/
+		std::string ToString(int id) const;
+
+		/*!
+			\brief Get the value of a node as a float.
+
+			\returns The value of the node with `id`. Strings are parsed as decimal numbers, and
+			-1 is returned for any string that isn't a number. Nodes without values return 0 in
+			numeric columns and -1 in string columns.
+		*/
+		float ToFloat(int id) const;
+
+		/*!
+			\brief Convert every value in this column to `new_type`.
+
+			\details
+			Numeric values are cast between numeric types, and converted with ToString or ToFloat
+			when converting to or from strings. The nodes that are assigned don't change.
+		*/
+		void ConvertTo(NODE_ATTRIBUTE_TYPE new_type);
+
+		/*!
+			\brief Get a pointer to the values of this column.
+
+			\returns A pointer to `size()` values of this column's type, or null for string columns.
+
+			\remarks The pointer is invalidated by any function that changes the size or type of the column.
+		*/
+		const void* Data() const;
+
+		/*! \brief Get a pointer to `size()` bytes that are 1 for assigned nodes and 0 for others. */
+		const uint8_t* AssignedData() const;
+	};
+}
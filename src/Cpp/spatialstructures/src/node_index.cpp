@@ -0,0 +1,349 @@
+///
+/// \file		node_index.cpp
+/// \brief		Contains implementation for the <see cref="HF::SpatialStructures::NodeIndex">NodeIndex</see> class
+///
+///	\author		TBA
+///	\date		06 Jun 2020
+
+#include <node_index.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+using std::array;
+using std::vector;
+
+namespace HF::SpatialStructures {
+
+	/// Ranges with this many points or fewer are scanned linearly instead of being split further.
+	constexpr int leaf_size = 8;
+
+	/// A candidate for the result of a query.
+	struct Candidate {
+		float dist_squared; ///< Squared distance from the query point.
+		int id; ///< ID of the node.
+
+		/*!
+			\brief Order candidates by distance, then by ID.
+
+			\details
+			Breaking ties by ID makes results independent of the shape of the tree,
+			so nodes equidistant from a point will always be returned in the same order.
+		*/
+		inline bool operator<(const Candidate& other) const {
+			return dist_squared < other.dist_squared
+				|| (dist_squared == other.dist_squared && id < other.id);
+		}
+	};
+
+	/*! \brief Calculate the squared distance between two points. */
+	inline float DistanceSquared(const array<float, 3>& a, const array<float, 3>& b) {
+		const float dx = a[0] - b[0];
+		const float dy = a[1] - b[1];
+		const float dz = a[2] - b[2];
+		return dx * dx + dy * dy + dz * dz;
+	}
+
+	/*!
+		\brief Visit every point in the tree that could be closer to `point` than `bound`.
+
+		\param points Points of the tree in tree order.
+		\param split_axes Splitting axis of every point in the tree.
+		\param begin Start of the range to search.
+		\param end End of the range to search.
+		\param point Point to search from.
+		\param bound Function returning the current squared distance that points must be within to be visited.
+		\param visit Function called with the index and squared distance of every point visited.
+	*/
+	template <typename bound_func, typename visit_func>
+	void SearchTree(
+		const vector<array<float, 3>>& points,
+		const vector<char>& split_axes,
+		int begin,
+		int end,
+		const array<float, 3>& point,
+		const bound_func& bound,
+		const visit_func& visit
+	) {
+		// If this is a leaf, just check every point in it
+		if (end - begin <= leaf_size) {
+			for (int i = begin; i < end; i++) {
+				const float dist_squared = DistanceSquared(point, points[i]);
+				if (dist_squared <= bound())
+					visit(i, dist_squared);
+			}
+			return;
+		}
+
+		const int mid = begin + (end - begin) / 2;
+		const int axis = split_axes[mid];
+		const float diff = point[axis] - points[mid][axis];
+
+		// Check the splitting point itself
+		const float dist_squared = DistanceSquared(point, points[mid]);
+		if (dist_squared <= bound())
+			visit(mid, dist_squared);
+
+		// Search the side of the split containing the point first, since that's most likely
+		// to shrink the bound. Only search the other side if the bound reaches past the split.
+		if (diff < 0) {
+			SearchTree(points, split_axes, begin, mid, point, bound, visit);
+			if (diff * diff <= bound())
+				SearchTree(points, split_axes, mid + 1, end, point, bound, visit);
+		}
+		else {
+			SearchTree(points, split_axes, mid + 1, end, point, bound, visit);
+			if (diff * diff <= bound())
+				SearchTree(points, split_axes, begin, mid, point, bound, visit);
+		}
+	}
+
+	NodeIndex::NodeIndex(const vector<Node>& nodes, bool use_x, bool use_y, bool use_z)
+	{
+		axes = { use_x, use_y, use_z };
+
+		// Get the position of every node that has one
+		points.reserve(nodes.size());
+		ids.reserve(nodes.size());
+		for (const Node& node : nodes) {
+			if (std::isnan(node.x) || std::isnan(node.y) || std::isnan(node.z)) continue;
+
+			points.push_back(MaskPoint(node.getArray()));
+			ids.push_back(node.id);
+		}
+
+		split_axes.resize(points.size(), 0);
+		Build(0, static_cast<int>(points.size()));
+	}
+
+	void NodeIndex::Build(int begin, int end)
+	{
+		if (end - begin <= leaf_size) return;
+
+		// Split along the axis this range is widest on
+		array<float, 3> min_pt = points[begin];
+		array<float, 3> max_pt = points[begin];
+		for (int i = begin + 1; i < end; i++) {
+			for (int axis = 0; axis < 3; axis++) {
+				min_pt[axis] = std::min(min_pt[axis], points[i][axis]);
+				max_pt[axis] = std::max(max_pt[axis], points[i][axis]);
+			}
+		}
+
+		int split_axis = 0;
+		for (int axis = 1; axis < 3; axis++)
+			if (max_pt[axis] - min_pt[axis] > max_pt[split_axis] - min_pt[split_axis])
+				split_axis = axis;
+
+		// Move the median to the middle of the range, with smaller points before it and larger points after it.
+		// Points and IDs are sorted together through a permutation of the range.
+		const int mid = begin + (end - begin) / 2;
+		vector<int> order(end - begin);
+		std::iota(order.begin(), order.end(), begin);
+		std::nth_element(order.begin(), order.begin() + (mid - begin), order.end(),
+			[&](int a, int b) { return points[a][split_axis] < points[b][split_axis]; }
+		);
+
+		vector<array<float, 3>> sorted_points(order.size());
+		vector<int> sorted_ids(order.size());
+		for (int i = 0; i < static_cast<int>(order.size()); i++) {
+			sorted_points[i] = points[order[i]];
+			sorted_ids[i] = ids[order[i]];
+		}
+		std::copy(sorted_points.begin(), sorted_points.end(), points.begin() + begin);
+		std::copy(sorted_ids.begin(), sorted_ids.end(), ids.begin() + begin);
+
+		split_axes[mid] = static_cast<char>(split_axis);
+
+		Build(begin, mid);
+		Build(mid + 1, end);
+	}
+
+	array<float, 3> NodeIndex::ExpandPoint(const float* point) const
+	{
+		array<float, 3> out_point = { 0, 0, 0 };
+
+		int component = 0;
+		for (int axis = 0; axis < 3; axis++)
+			if (axes[axis])
+				out_point[axis] = point[component++];
+
+		return out_point;
+	}
+
+	array<float, 3> NodeIndex::MaskPoint(const array<float, 3>& point) const
+	{
+		return {
+			axes[0] ? point[0] : 0.0f,
+			axes[1] ? point[1] : 0.0f,
+			axes[2] ? point[2] : 0.0f
+		};
+	}
+
+	int NodeIndex::size() const
+	{
+		return static_cast<int>(ids.size());
+	}
+
+	int NodeIndex::Dimensions() const
+	{
+		return static_cast<int>(axes[0]) + static_cast<int>(axes[1]) + static_cast<int>(axes[2]);
+	}
+
+	int NodeIndex::Nearest(const array<float, 3>& point, float* out_distance) const
+	{
+		const array<float, 3> query = MaskPoint(point);
+		Candidate best{ std::numeric_limits<float>::infinity(), -1 };
+
+		SearchTree(points, split_axes, 0, size(), query,
+			[&]() { return best.dist_squared; },
+			[&](int index, float dist_squared) {
+				const Candidate candidate{ dist_squared, ids[index] };
+				if (candidate < best) best = candidate;
+			}
+		);
+
+		if (out_distance)
+			*out_distance = best.id >= 0 ? std::sqrt(best.dist_squared) : NAN;
+
+		return best.id;
+	}
+
+	void NodeIndex::KNearest(
+		const array<float, 3>& point,
+		int k,
+		vector<int>& out_ids,
+		vector<float>& out_distances
+	) const {
+		out_ids.clear();
+		out_distances.clear();
+		if (k <= 0) return;
+
+		const array<float, 3> query = MaskPoint(point);
+
+		// Keep the k best candidates in a max heap so the furthest can be replaced
+		vector<Candidate> heap;
+		heap.reserve(k);
+
+		SearchTree(points, split_axes, 0, size(), query,
+			[&]() {
+				return heap.size() < static_cast<size_t>(k) ? std::numeric_limits<float>::infinity() : heap.front().dist_squared;
+			},
+			[&](int index, float dist_squared) {
+				const Candidate candidate{ dist_squared, ids[index] };
+				if (heap.size() < static_cast<size_t>(k)) {
+					heap.push_back(candidate);
+					std::push_heap(heap.begin(), heap.end());
+				}
+				else if (candidate < heap.front()) {
+					std::pop_heap(heap.begin(), heap.end());
+					heap.back() = candidate;
+					std::push_heap(heap.begin(), heap.end());
+				}
+			}
+		);
+
+		std::sort_heap(heap.begin(), heap.end());
+
+		out_ids.reserve(heap.size());
+		out_distances.reserve(heap.size());
+		for (const auto& candidate : heap) {
+			out_ids.push_back(candidate.id);
+			out_distances.push_back(std::sqrt(candidate.dist_squared));
+		}
+	}
+
+	void NodeIndex::WithinRadius(
+		const array<float, 3>& point,
+		float radius,
+		vector<int>& out_ids,
+		vector<float>& out_distances
+	) const {
+		out_ids.clear();
+		out_distances.clear();
+		if (radius < 0) return;
+
+		const array<float, 3> query = MaskPoint(point);
+		const float radius_squared = radius * radius;
+
+		vector<Candidate> in_range;
+		SearchTree(points, split_axes, 0, size(), query,
+			[&]() { return radius_squared; },
+			[&](int index, float dist_squared) { in_range.push_back({ dist_squared, ids[index] }); }
+		);
+
+		std::sort(in_range.begin(), in_range.end());
+
+		out_ids.reserve(in_range.size());
+		out_distances.reserve(in_range.size());
+		for (const auto& candidate : in_range) {
+			out_ids.push_back(candidate.id);
+			out_distances.push_back(std::sqrt(candidate.dist_squared));
+		}
+	}
+
+	void NodeIndex::Nearest(const float* points, int num_points, int* out_ids, float* out_distances) const
+	{
+		const int dims = Dimensions();
+
+		#pragma omp parallel for schedule(static)
+		for (int i = 0; i < num_points; i++) {
+			float distance;
+			out_ids[i] = Nearest(ExpandPoint(points + i * dims), &distance);
+
+			if (out_distances) out_distances[i] = distance;
+		}
+	}
+
+	void NodeIndex::KNearest(const float* points, int num_points, int k, int* out_ids, float* out_distances) const
+	{
+		const int dims = Dimensions();
+
+		#pragma omp parallel for schedule(static)
+		for (int i = 0; i < num_points; i++) {
+			vector<int> ids_for_point;
+			vector<float> distances_for_point;
+			KNearest(ExpandPoint(points + i * dims), k, ids_for_point, distances_for_point);
+
+			// Copy results, then fill any remaining space if there weren't enough nodes
+			const int found = static_cast<int>(ids_for_point.size());
+			for (int j = 0; j < k; j++) {
+				out_ids[i * k + j] = j < found ? ids_for_point[j] : -1;
+				if (out_distances) out_distances[i * k + j] = j < found ? distances_for_point[j] : NAN;
+			}
+		}
+	}
+
+	void NodeIndex::WithinRadius(
+		const float* points,
+		int num_points,
+		float radius,
+		vector<int>& out_offsets,
+		vector<int>& out_ids,
+		vector<float>& out_distances
+	) const {
+		const int dims = Dimensions();
+
+		// Query every point in parallel, then concatenate the results
+		vector<vector<int>> ids_per_point(num_points);
+		vector<vector<float>> distances_per_point(num_points);
+
+		#pragma omp parallel for schedule(dynamic, 64)
+		for (int i = 0; i < num_points; i++)
+			WithinRadius(ExpandPoint(points + i * dims), radius, ids_per_point[i], distances_per_point[i]);
+
+		out_offsets.resize(num_points + 1);
+		out_offsets[0] = 0;
+		for (int i = 0; i < num_points; i++)
+			out_offsets[i + 1] = out_offsets[i] + static_cast<int>(ids_per_point[i].size());
+
+		out_ids.resize(out_offsets.back());
+		out_distances.resize(out_offsets.back());
+		for (int i = 0; i < num_points; i++) {
+			std::copy(ids_per_point[i].begin(), ids_per_point[i].end(), out_ids.begin() + out_offsets[i]);
+			std::copy(distances_per_point[i].begin(), distances_per_point[i].end(), out_distances.begin() + out_offsets[i]);
+		}
+	}
+}
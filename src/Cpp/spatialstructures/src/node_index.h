@@ -0,0 +1,172 @@
+///
+/// \file		node_index.h
+/// \brief		Contains definitions for the <see cref="HF::SpatialStructures::NodeIndex">NodeIndex</see> class
+///
+///	\author		TBA
+///	\date		06 Jun 2020
+
+#pragma once
+
+#include <node.h>
+
+#include <array>
+#include <vector>
+
+namespace HF::SpatialStructures {
+
+	/*!
+		\brief A k-d tree over the positions of a graph's nodes for nearest neighbour and radius queries.
+
+		\details
+		Unlike Graph::getID, which only finds nodes at exactly the position given, this can find the
+		node closest to any point in space. The tree is stored as a flat array of nodes sorted so the
+		median of every range is its splitting point, which keeps it compact and avoids allocating
+		a separate object for every branch.
+
+		Axes can be excluded from the index, in which case they're ignored by every distance
+		calculation. For example, excluding the z axis finds the closest node in plan.
+
+		\remarks
+		The index is a snapshot of the nodes it was built from, and won't be updated if nodes are
+		later added to the graph. Graph::GetNodeIndex handles rebuilding the index when this happens.
+
+		\remarks
+		Queries don't modify the index, so it's safe to query from multiple threads at once.
+
+		\see Graph::GetNodeIndex for getting an index of a graph's nodes.
+	*/
+	class NodeIndex {
+	private:
+		std::vector<std::array<float, 3>> points; ///< Positions of nodes in tree order, with excluded axes set to 0.
+		std::vector<int> ids; ///< ID of the node at each position in points.
+		std::vector<char> split_axes; ///< Axis that the point at each position in points splits its range on.
+		std::array<bool, 3> axes; ///< Whether or not the x, y, and z axes are included in the index.
+
+		/*! \brief Recursively sort the range [begin, end) of points into a k-d tree. */
+		void Build(int begin, int end);
+
+		/*! \brief Convert a point with only the included axes to a full point with excluded axes set to 0. */
+		std::array<float, 3> ExpandPoint(const float* point) const;
+
+		/*! \brief Set any excluded axes of `point` to 0. */
+		std::array<float, 3> MaskPoint(const std::array<float, 3>& point) const;
+
+	public:
+		/*!
+			\brief Build an index over the positions of `nodes`.
+
+			\param nodes Nodes to index. Nodes with NaN positions, such as those added to the graph by ID only,
+			are skipped.
+			\param use_x Include the x axis in distance calculations.
+			\param use_y Include the y axis in distance calculations.
+			\param use_z Include the z axis in distance calculations.
+
+			\par Time Complexity
+			`O(n log n)` where `n` is the number of nodes.
+		*/
+		NodeIndex(const std::vector<Node>& nodes, bool use_x = true, bool use_y = true, bool use_z = true);
+
+		/*! \brief Number of nodes in the index. */
+		int size() const;
+
+		/*! \brief Number of axes included in the index. */
+		int Dimensions() const;
+
+		/*!
+			\brief Find the node closest to a point.
+
+			\param point Point to search from. Excluded axes are ignored.
+			\param out_distance If not null, set to the distance between `point` and the closest node.
+
+			\returns The ID of the node closest to `point`, or -1 if the index is empty.
+		*/
+		int Nearest(const std::array<float, 3>& point, float* out_distance = nullptr) const;
+
+		/*!
+			\brief Find the `k` nodes closest to a point.
+
+			\param point Point to search from. Excluded axes are ignored.
+			\param k Maximum number of nodes to find.
+			\param out_ids Output array for the IDs of the closest nodes, sorted from nearest to furthest.
+			\param out_distances Output array for the distance to each node in `out_ids`.
+
+			\post `out_ids` and `out_distances` will contain `min(k, size())` elements.
+		*/
+		void KNearest(
+			const std::array<float, 3>& point,
+			int k,
+			std::vector<int>& out_ids,
+			std::vector<float>& out_distances
+		) const;
+
+		/*!
+			\brief Find every node within `radius` of a point.
+
+			\param point Point to search from. Excluded axes are ignored.
+			\param radius Maximum distance from `point`. Nodes exactly `radius` away are included.
+			\param out_ids Output array for the IDs of nodes in range, sorted from nearest to furthest.
+			\param out_distances Output array for the distance to each node in `out_ids`.
+		*/
+		void WithinRadius(
+			const std::array<float, 3>& point,
+			float radius,
+			std::vector<int>& out_ids,
+			std::vector<float>& out_distances
+		) const;
+
+		/*!
+			\brief Find the closest node to every point in an array of points.
+
+			\param points Points to search from, containing `Dimensions()` floats for each point
+			with the included axes in x, y, z order.
+			\param num_points Number of points in `points`.
+			\param out_ids Output array of `num_points` ints for the ID of the closest node to each point.
+			\param out_distances If not null, output array of `num_points` floats for the distance
+			to each closest node.
+
+			\details Points are processed in parallel.
+		*/
+		void Nearest(const float* points, int num_points, int* out_ids, float* out_distances = nullptr) const;
+
+		/*!
+			\brief Find the `k` closest nodes to every point in an array of points.
+
+			\param points Points to search from, containing `Dimensions()` floats for each point
+			with the included axes in x, y, z order.
+			\param num_points Number of points in `points`.
+			\param k Number of nodes to find for each point.
+			\param out_ids Output array of `num_points * k` ints. The closest nodes to the point
+			at index `i` start at `i * k`, sorted from nearest to furthest.
+			\param out_distances If not null, output array of `num_points * k` floats for the distance
+			to each node in `out_ids`.
+
+			\details
+			Points are processed in parallel. If fewer than `k` nodes are in the index, then the remaining
+			IDs for each point are set to -1 and the remaining distances are set to NaN.
+		*/
+		void KNearest(const float* points, int num_points, int k, int* out_ids, float* out_distances = nullptr) const;
+
+		/*!
+			\brief Find every node within `radius` of every point in an array of points.
+
+			\param points Points to search from, containing `Dimensions()` floats for each point
+			with the included axes in x, y, z order.
+			\param num_points Number of points in `points`.
+			\param radius Maximum distance from each point.
+			\param out_offsets Output array of `num_points + 1` offsets. The nodes in range of the
+			point at index `i` are stored between `out_offsets[i]` and `out_offsets[i + 1]`.
+			\param out_ids Output array for the IDs of nodes in range of each point, sorted from nearest to furthest.
+			\param out_distances Output array for the distance to each node in `out_ids`.
+
+			\details Points are processed in parallel.
+		*/
+		void WithinRadius(
+			const float* points,
+			int num_points,
+			float radius,
+			std::vector<int>& out_offsets,
+			std::vector<int>& out_ids,
+			std::vector<float>& out_distances
+		) const;
+	};
+}
@@ -13,8 +13,10 @@
 #include <graph_generator.h>
 #include <objloader.h>
 #include <unique_queue.h>
+#include <floor_cache.h>
 
 #include <MultiRT.h>
+#include <ray_data.h>
 
 using HF::SpatialStructures::Graph;
 using HF::GraphGenerator::GraphGenerator;
@@ -344,6 +346,154 @@ TEST(_GraphGenerator, CrawlGeom) {
 	ComparePoints(expected_parallel, g.Nodes());
 }
 
+TEST(_GraphGenerator, CrawlGeomLattice) {
+	EmbreeRayTracer ray_tracer = CreateGGExmapleRT();
+	HF::GraphGenerator::GraphGenerator GG(ray_tracer);
+
+	GG.core_count = -1;
+	GG.max_nodes = 500;
+	GG.max_step_connection = 1;
+	GG.min_connections = 1;
+	GG.params.up_step = 1; GG.params.down_step = 1;
+	GG.params.up_slope = 45; GG.params.down_slope = 45;
+	GG.params.precision.ground_offset = 0.01;
+	GG.params.precision.node_z = 0.001f;
+	GG.params.precision.node_spacing = 0.001;
+	GG.spacing = HF::GraphGenerator::real3{ 1,1,1 };
+
+	const HF::GraphGenerator::real3 start_point{ 0,1,0 };
+
+	// Generate the graph with the existing parallel generator
+	HF::GraphGenerator::UniqueQueue queue;
+	queue.PushAny(start_point);
+	auto expected = GG.CrawlGeomParallel(queue);
+	expected.Compress();
+
+	// Generate it again with the lattice generator
+	auto actual = GG.CrawlGeomLattice(start_point);
+
+	// Node IDs may differ, but both graphs should contain the same nodes and edges
+	ASSERT_EQ(actual.size(), expected.size());
+	ASSERT_EQ(actual.GetCSRPointers().nnz, expected.GetCSRPointers().nnz);
+
+	for (const auto& node : expected.Nodes()) {
+		ASSERT_TRUE(actual.hasKey(node));
+
+		const auto expected_edges = expected[node];
+		const auto actual_edges = actual[node];
+		EXPECT_EQ(expected_edges.size(), actual_edges.size());
+	}
+
+	// Node IDs shouldn't depend on which thread found each node first
+	auto again = GG.CrawlGeomLattice(start_point);
+	ComparePoints(actual.Nodes(), again.Nodes());
+
+	const auto actual_csr = actual.GetCSRPointers();
+	const auto again_csr = again.GetCSRPointers();
+	ASSERT_EQ(actual_csr.nnz, again_csr.nnz);
+	for (int i = 0; i < actual_csr.nnz; i++) {
+		EXPECT_EQ(actual_csr.inner_indices[i], again_csr.inner_indices[i]);
+		EXPECT_EQ(actual_csr.data[i], again_csr.data[i]);
+	}
+}
+
+TEST(_GraphGenerator, CrawlGeomConcreteRayTracer) {
+	auto mesh = HF::Geometry::LoadMeshObjects("plane.obj", HF::Geometry::ONLY_FILE, true);
+	EmbreeRayTracer embree_rt(mesh);
+	HF::RayTracer::NanoRTRayTracer nano_rt(mesh[0]);
+
+	HF::GraphGenerator::GraphGenerator GG(embree_rt);
+	GG.core_count = -1;
+	GG.max_nodes = 50;
+	GG.max_step_connection = 1;
+	GG.min_connections = 1;
+	GG.params.up_step = 1; GG.params.down_step = 1;
+	GG.params.up_slope = 45; GG.params.down_slope = 45;
+	GG.params.precision.ground_offset = 0.01;
+	GG.params.precision.node_z = 0.001f;
+	GG.params.precision.node_spacing = 0.001;
+	GG.spacing = HF::GraphGenerator::real3{ 1,1,1 };
+
+	const HF::GraphGenerator::real3 start_point{ 0,1,0 };
+
+	// Generate the graph through the MultiRT held by the graph generator
+	HF::GraphGenerator::UniqueQueue multi_queue;
+	multi_queue.PushAny(start_point);
+	auto expected = GG.CrawlGeom(multi_queue);
+
+	// Casting rays directly on either raytracer should produce the same graph
+	HF::GraphGenerator::UniqueQueue embree_queue;
+	embree_queue.PushAny(start_point);
+	auto embree_graph = GG.CrawlGeom(embree_queue, embree_rt);
+
+	HF::GraphGenerator::UniqueQueue nano_queue;
+	nano_queue.PushAny(start_point);
+	auto nano_graph = GG.CrawlGeom(nano_queue, nano_rt);
+
+	ComparePoints(expected.Nodes(), embree_graph.Nodes());
+	ComparePoints(expected.Nodes(), nano_graph.Nodes());
+}
+
+TEST(_GraphGenerator, RegenerateRegion) {
+	const std::vector<float> plane_vertices{
+		-10.0f, 10.0f, 0.0f,
+		-10.0f, -10.0f, 0.0f,
+		10.0f, 10.0f, 0.0f,
+		10.0f, -10.0f, 0.0f,
+	};
+	const std::vector<int> plane_indices{ 3, 1, 0, 2, 3, 0 };
+	std::vector<HF::Geometry::MeshInfo<float>> meshes{ HF::Geometry::MeshInfo<float>(plane_vertices, plane_indices, 0, "plane") };
+	EmbreeRayTracer ray_tracer(meshes);
+
+	HF::GraphGenerator::GraphGenerator GG(ray_tracer);
+	const std::array<float, 3> start_point{ 0, 0, 1 };
+	const std::array<float, 3> spacing{ 1, 1, 1 };
+
+	Graph graph = GG.BuildNetwork(start_point, spacing, -1, 1, 45, 1, 45, 1, 1, 1);
+	graph.Compress();
+
+	//! [EX_RegenerateRegion]
+
+	// Add a wall between x = 3 and x = 4 to the raytracer used to generate the graph
+	const std::vector<float> wall_vertices{
+		3.5f, -2.0f, 0.0f,
+		3.5f, 2.0f, 0.0f,
+		3.5f, 2.0f, 3.0f,
+		3.5f, -2.0f, 3.0f,
+	};
+	const std::vector<int> wall_indices{ 0, 1, 2, 0, 2, 3 };
+	HF::Geometry::MeshInfo<float> wall(wall_vertices, wall_indices, 1, "wall");
+	ray_tracer.AddMesh(wall, true);
+
+	// Only update the part of the graph around the wall
+	const HF::GraphGenerator::real3 region_min{ 3.5, -2, 0 };
+	const HF::GraphGenerator::real3 region_max{ 3.5, 2, 3 };
+	int num_updated = GG.RegenerateRegion(graph, region_min, region_max);
+
+	//! [EX_RegenerateRegion]
+
+	// Only nodes near the wall should have been updated
+	EXPECT_GT(num_updated, 0);
+	EXPECT_LT(num_updated, graph.size());
+
+	// The wall now blocks edges that pass through it
+	const std::array<float, 3> before_wall{ 3, 0, 0 };
+	const std::array<float, 3> after_wall{ 4, 0, 0 };
+	EXPECT_FALSE(graph.HasEdge(before_wall, after_wall));
+
+	// The result should match a graph generated from scratch with the wall
+	HF::GraphGenerator::GraphGenerator fresh_GG(ray_tracer);
+	Graph expected = fresh_GG.BuildNetwork(start_point, spacing, -1, 1, 45, 1, 45, 1, 1, 1);
+	expected.Compress();
+
+	ASSERT_EQ(expected.size(), graph.size());
+	ASSERT_EQ(expected.GetCSRPointers().nnz, graph.GetCSRPointers().nnz);
+	for (const auto& node : expected.Nodes()) {
+		ASSERT_TRUE(graph.hasKey(node));
+		EXPECT_EQ(expected[node].size(), graph[node].size());
+	}
+}
+
 TEST(_GraphGenerator, ValidateStartPoint) {
 	EmbreeRayTracer ray_tracer = CreateGGExmapleRT();
 
@@ -424,6 +574,67 @@ TEST(_GraphGenerator, CheckRay) {
 	ASSERT_TRUE(result.pt[0] == 1 && result.pt[1] == 1 && result.pt[2] == 0);
 }
 
+TEST(_GraphGenerator, CheckRayFiltered) {
+	// Place a floor under an unflagged canopy
+	const std::vector<int> indices{ 0, 1, 2, 0, 2, 3 };
+	std::vector<HF::Geometry::MeshInfo<float>> meshes{
+		HF::Geometry::MeshInfo<float>(std::vector<float>{ -10, -10, 0, 10, -10, 0, 10, 10, 0, -10, 10, 0 }, indices, 0, "floor"),
+		HF::Geometry::MeshInfo<float>(std::vector<float>{ -10, -10, 3, 10, -10, 3, 10, 10, 3, -10, 10, 3 }, indices, 1, "canopy")
+	};
+	EmbreeRayTracer ray_tracer(meshes);
+	HF::RayTracer::MultiRT multi_rt(&ray_tracer);
+
+	const HF::GraphGenerator::real3 start_point{ 1, 1, 5 };
+	const HF::GraphGenerator::real3 direction{ 0, 0, -1 };
+
+	// Flag the floor as walkable and nothing as an obstacle
+	HF::GraphGenerator::GeometryFlagMap geom_ids;
+	geom_ids.Set(0, HF::GraphGenerator::HIT_FLAG::FLOORS);
+	geom_ids.Mode = HF::GraphGenerator::GeometryFilterMode::OBSTACLES_AND_FLOORS;
+
+	// The ray passes through the canopy and lands on the floor
+	auto result = HF::GraphGenerator::CheckRay(multi_rt, start_point, direction, 0.01, HF::GraphGenerator::HIT_FLAG::FLOORS, geom_ids);
+	ASSERT_TRUE(result);
+	ASSERT_NEAR(0, result.pt[2], 0.0001);
+
+	// Obstacles still block the floor beneath them
+	geom_ids.Set(1, HF::GraphGenerator::HIT_FLAG::OBSTACLES);
+	ASSERT_FALSE(HF::GraphGenerator::CheckRay(ray_tracer, start_point, direction, 0.01, HF::GraphGenerator::HIT_FLAG::FLOORS, geom_ids));
+
+	// Clearing the flag lets rays pass through the canopy again
+	geom_ids.Set(1, HF::GraphGenerator::HIT_FLAG::NO_FLAG);
+	ASSERT_TRUE(HF::GraphGenerator::CheckRay(ray_tracer, start_point, direction, 0.01, HF::GraphGenerator::HIT_FLAG::FLOORS, geom_ids));
+}
+
+TEST(_GraphGenerator, CalculateAndStoreClearance) {
+	// Place a wall 3 units from the origin on a floor
+	const std::vector<int> indices{ 0, 1, 2, 0, 2, 3 };
+	std::vector<HF::Geometry::MeshInfo<float>> meshes{
+		HF::Geometry::MeshInfo<float>(std::vector<float>{ -10, -10, 0, 10, -10, 0, 10, 10, 0, -10, 10, 0 }, indices, 0, "floor"),
+		HF::Geometry::MeshInfo<float>(std::vector<float>{ 3, -10, 0, 3, 10, 0, 3, 10, 5, 3, -10, 5 }, indices, 1, "wall")
+	};
+	EmbreeRayTracer ray_tracer(meshes);
+
+	Graph g;
+	g.addEdge(Node(0, 0, 0), Node(1, 0, 0), 1);
+	g.addEdge(Node(1, 0, 0), Node(-5, 0, 0), 6);
+	g.Compress();
+
+	//! [EX_CalculateAndStoreClearance]
+
+	// Store the distance from every node to the nearest wall, searching up to 4 units away
+	HF::GraphGenerator::CalculateAndStoreClearance(g, ray_tracer, "clearance", 0.5f, 4.0f);
+	std::vector<float> clearance = g.GetNodeAttributesFloat("clearance");
+
+	//! [EX_CalculateAndStoreClearance]
+
+	// The floor is ignored, and nodes further than max_distance from any wall are given max_distance
+	ASSERT_EQ(3, clearance.size());
+	ASSERT_NEAR(3.0f, clearance[0], 0.0001);
+	ASSERT_NEAR(2.0f, clearance[1], 0.0001);
+	ASSERT_NEAR(4.0f, clearance[2], 0.0001);
+}
+
 TEST(_GraphGenerator, CreateDirecs) {
 	
 	//! [EX_CreateDirecs]
@@ -574,6 +785,89 @@ TEST(_GraphGenerator, CheckChildren) {
 		EXPECT_NEAR(0, DistanceTo(actual_child, expected_child), 0.00001);
 	}
 }
+TEST(_GraphGenerator, FloorCache) {
+	EmbreeRayTracer ray_tracer = CreateGGExmapleRT();
+	HF::RayTracer::MultiRT multi_rt(&ray_tracer);
+
+	// Create a parent and some children to check
+	HF::GraphGenerator::real3 parent{ 0,0,1 };
+	std::vector<HF::GraphGenerator::real3> possible_children{
+		HF::GraphGenerator::real3{0,2,1}, HF::GraphGenerator::real3{1,0,1},
+		HF::GraphGenerator::real3{0,1,1}, HF::GraphGenerator::real3{2,0,1}
+	};
+
+	HF::GraphGenerator::GraphParams params;
+	params.up_step = 2; params.down_step = 2;
+	params.up_slope = 45; params.down_slope = 45;
+	params.precision.node_z = 0.01f;
+	params.precision.node_spacing = 0.01f;
+	params.precision.ground_offset = 0.01f;
+
+	HF::GraphGenerator::FloorCache cache(params.precision.node_spacing, params.precision.node_z);
+
+	// The first call should miss on every child and fill the cache
+	auto first = HF::GraphGenerator::CheckChildren(parent, possible_children, multi_rt, params, &cache);
+	EXPECT_EQ(cache.Misses(), possible_children.size());
+	EXPECT_EQ(cache.Hits(), 0);
+	EXPECT_EQ(cache.size(), possible_children.size());
+
+	// The second call should hit on every child and produce the same results
+	auto second = HF::GraphGenerator::CheckChildren(parent, possible_children, multi_rt, params, &cache);
+	EXPECT_EQ(cache.Hits(), possible_children.size());
+
+	ASSERT_EQ(first.size(), second.size());
+	for (int i = 0; i < first.size(); i++)
+		EXPECT_NEAR(0, DistanceTo(first[i], second[i]), 0.00001);
+
+	// Misses should be cached as well
+	std::vector<HF::GraphGenerator::real3> off_plane{ HF::GraphGenerator::real3{1000, 1000, 1} };
+	EXPECT_TRUE(HF::GraphGenerator::CheckChildren(parent, off_plane, multi_rt, params, &cache).empty());
+	EXPECT_TRUE(HF::GraphGenerator::CheckChildren(parent, off_plane, multi_rt, params, &cache).empty());
+	EXPECT_EQ(cache.Hits(), possible_children.size() + 1);
+
+	cache.Clear();
+	EXPECT_EQ(cache.size(), 0);
+	EXPECT_EQ(cache.Hits(), 0);
+	EXPECT_EQ(cache.Misses(), 0);
+}
+
+TEST(_GraphGenerator, CrawlGeomFloorCache) {
+	EmbreeRayTracer ray_tracer = CreateGGExmapleRT();
+	HF::GraphGenerator::GraphGenerator GG(ray_tracer);
+
+	GG.core_count = -1;
+	GG.max_nodes = 50;
+	GG.max_step_connection = 1;
+	GG.min_connections = 1;
+	GG.params.up_step = 1; GG.params.down_step = 1;
+	GG.params.up_slope = 45; GG.params.down_slope = 45;
+	GG.params.precision.ground_offset = 0.01;
+	GG.params.precision.node_z = 0.001f;
+	GG.params.precision.node_spacing = 0.001;
+	GG.spacing = HF::GraphGenerator::real3{ 1,1,1 };
+
+	const std::array<float, 3> start_point{ 0,1,0 };
+
+	// Generate once without the cache, then again with it
+	GG.use_floor_cache = false;
+	HF::GraphGenerator::UniqueQueue uncached_queue;
+	uncached_queue.push(start_point);
+	auto uncached = GG.CrawlGeom(uncached_queue);
+	EXPECT_EQ(GG.floor_cache_hits, 0);
+
+	GG.use_floor_cache = true;
+	HF::GraphGenerator::UniqueQueue cached_queue;
+	cached_queue.push(start_point);
+	auto cached = GG.CrawlGeom(cached_queue);
+
+	// Neighbouring parents share children, so some rays must have been skipped
+	EXPECT_GT(GG.floor_cache_hits, 0);
+	EXPECT_GT(GG.floor_cache_misses, 0);
+
+	// The cache shouldn't change the graph
+	ComparePoints(uncached.Nodes(), cached.Nodes());
+}
+
 TEST(_GraphGenerator, CheckConnection) {
 	EmbreeRayTracer ray_tracer = CreateGGExmapleRT();
 
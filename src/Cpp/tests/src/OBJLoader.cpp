@@ -3,6 +3,10 @@
 #include <meshinfo.h>
 #include <HFExceptions.h>
 #include <string>
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
 
 #include "objloader_C.h"
 #include "performance_testing.h"
@@ -315,6 +319,270 @@ TEST(_meshInfo, LoadRawVertices) {
 		std::cout << "(" << vertex[0] << ", " << vertex[1] << ", " << vertex[2] << ")" << std::endl;
 	}
 }
+
+TEST(_meshInfo, LoadMeshObjectsParallel) {
+	//! [EX_LoadMeshObjectsParallel]
+	// Parse the file on every thread, and cache the result next to it for next time
+	std::vector<MeshInfo> meshes = HF::Geometry::LoadMeshObjectsParallel(
+		"big_teapot.obj", HF::Geometry::GROUP_METHOD::ONLY_FILE, false, 1, true
+	);
+	//! [EX_LoadMeshObjectsParallel]
+
+	// The result should match tinyobj's, though polygons may be split into different triangles
+	std::vector<MeshInfo> expected = HF::Geometry::LoadMeshObjects("big_teapot.obj", HF::Geometry::GROUP_METHOD::ONLY_FILE, false);
+	ASSERT_EQ(1, meshes.size());
+	ASSERT_EQ(expected[0].NumVerts(), meshes[0].NumVerts());
+	ASSERT_EQ(expected[0].NumTris(), meshes[0].NumTris());
+	ASSERT_TRUE(expected[0] == meshes[0]);
+
+	// The second load should come from the cache and match the first
+	ASSERT_TRUE(std::filesystem::exists(HF::Geometry::MeshCachePath("big_teapot.obj")));
+	std::vector<MeshInfo> cached = HF::Geometry::LoadMeshObjectsParallel(
+		"big_teapot.obj", HF::Geometry::GROUP_METHOD::ONLY_FILE, false, 1, true
+	);
+	ASSERT_EQ(meshes[0].GetIndexedVertices(), cached[0].GetIndexedVertices());
+	ASSERT_EQ(meshes[0].getRawIndices(), cached[0].getRawIndices());
+	ASSERT_EQ(meshes[0].name, cached[0].name);
+
+	std::filesystem::remove(HF::Geometry::MeshCachePath("big_teapot.obj"));
+}
+
+TEST(_meshInfo, LoadMeshObjectsParallelGroups) {
+	const std::string path = (std::filesystem::temp_directory_path() / "parallel_groups.obj").string();
+	{
+		std::ofstream obj(path);
+		obj << "# Two groups, one using relative indices\n"
+			<< "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+			<< "g floor\nusemtl stone\nf 1/1/1 2/2/2 3/3/3 4/4/4\n"
+			<< "g wall\nusemtl wood\nv 0 0 2.5e0\nv 1 0 2.5\nf -1 -2 1\n"
+			<< "usemtl stone\nf 2 3 -1\n";
+	}
+
+	// Quads are split into two triangles, and each group only keeps the vertices it uses
+	auto groups = HF::Geometry::LoadMeshObjectsParallel(path, HF::Geometry::GROUP_METHOD::BY_GROUP);
+	ASSERT_EQ(2, groups.size());
+	ASSERT_EQ("floor", groups[0].name);
+	ASSERT_EQ(0, groups[0].meshid);
+	ASSERT_EQ(2, groups[0].NumTris());
+	ASSERT_EQ(4, groups[0].NumVerts());
+	ASSERT_EQ("wall", groups[1].name);
+	ASSERT_EQ(1, groups[1].meshid);
+	ASSERT_EQ(2, groups[1].NumTris());
+	ASSERT_EQ(5, groups[1].NumVerts());
+	ASSERT_FLOAT_EQ(2.5f, groups[1][0][2]);
+
+	// Faces with the same material are combined, even across groups
+	auto materials = HF::Geometry::LoadMeshObjectsParallel(path, HF::Geometry::GROUP_METHOD::BY_MATERIAL);
+	ASSERT_EQ(2, materials.size());
+	ASSERT_EQ(path + "/stone", materials[0].name);
+	ASSERT_EQ(3, materials[0].NumTris());
+	ASSERT_EQ(path + "/wood", materials[1].name);
+	ASSERT_EQ(1, materials[1].NumTris());
+
+	// Faces can't reference vertices that don't exist
+	{
+		std::ofstream obj(path);
+		obj << "v 0 0 0\nv 1 0 0\nf 1 2 3\n";
+	}
+	ASSERT_THROW(HF::Geometry::LoadMeshObjectsParallel(path), HF::Exceptions::InvalidOBJ);
+	std::filesystem::remove(path);
+
+	ASSERT_THROW(HF::Geometry::LoadMeshObjectsParallel(path), HF::Exceptions::FileNotFound);
+}
+
+TEST(_meshInfo, MeshCache) {
+	const std::string path = (std::filesystem::temp_directory_path() / "plane.meshcache").string();
+	std::vector<MeshInfo> meshes = HF::Geometry::LoadMeshObjects("plane.obj");
+
+	ASSERT_TRUE(HF::Geometry::SaveMeshCache(meshes, path, 42));
+	std::vector<MeshInfo> loaded = HF::Geometry::LoadMeshCache(path, 42);
+	ASSERT_EQ(meshes.size(), loaded.size());
+	ASSERT_EQ(meshes[0].GetIndexedVertices(), loaded[0].GetIndexedVertices());
+	ASSERT_EQ(meshes[0].getRawIndices(), loaded[0].getRawIndices());
+	ASSERT_EQ(meshes[0].meshid, loaded[0].meshid);
+
+	// Caches saved with a different key are rejected
+	ASSERT_THROW(HF::Geometry::LoadMeshCache(path, 7), std::runtime_error);
+	std::filesystem::remove(path);
+}
+
+/*! \brief Append the bytes of `value` to `bytes`, optionally in big endian order. */
+template <typename T>
+void AppendBytes(std::string& bytes, T value, bool big_endian = false) {
+	char raw[sizeof(T)];
+	std::memcpy(raw, &value, sizeof(T));
+	if (big_endian) std::reverse(raw, raw + sizeof(T));
+	bytes.append(raw, sizeof(T));
+}
+
+/*! \brief Write `bytes` to a file named `name` in the temp directory and return its path. */
+std::string WriteTempFile(const std::string& name, const std::string& bytes) {
+	const std::string path = (std::filesystem::temp_directory_path() / name).string();
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(bytes.data(), bytes.size());
+	return path;
+}
+
+TEST(_meshInfo, LoadPLY) {
+	// A unit square with a color on each vertex, stored as a quad
+	std::string little = "ply\nformat binary_little_endian 1.0\ncomment unit square\n"
+		"element vertex 4\nproperty float x\nproperty float y\nproperty float z\nproperty uchar red\n"
+		"element face 1\nproperty list uchar int vertex_indices\n"
+		"element edge 1\nproperty int vertex1\nproperty int vertex2\nend_header\n";
+	std::string big = "ply\r\nformat binary_big_endian 1.0\r\n"
+		"element vertex 4\r\nproperty double x\r\nproperty double y\r\nproperty double z\r\n"
+		"element face 1\r\nproperty list uchar uint vertex_index\r\nend_header\r\n";
+
+	const float square[4][3] = { {0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0} };
+	for (const auto& vertex : square) {
+		for (float value : vertex) {
+			AppendBytes(little, value);
+			AppendBytes(big, static_cast<double>(value), true);
+		}
+		AppendBytes<uint8_t>(little, 255);
+	}
+	AppendBytes<uint8_t>(little, 4);
+	AppendBytes<uint8_t>(big, 4);
+	for (int i = 0; i < 4; i++) {
+		AppendBytes<int32_t>(little, i);
+		AppendBytes<uint32_t>(big, i, true);
+	}
+	AppendBytes<int32_t>(little, 0);
+	AppendBytes<int32_t>(little, 1);
+
+	//! [EX_LoadPLY]
+	const std::string path = WriteTempFile("square.ply", little);
+	std::vector<MeshInfo> meshes = HF::Geometry::LoadPLY(path);
+	//! [EX_LoadPLY]
+
+	// The quad is split into two triangles
+	ASSERT_EQ(1, meshes.size());
+	ASSERT_EQ(4, meshes[0].NumVerts());
+	ASSERT_EQ(2, meshes[0].NumTris());
+	ASSERT_FLOAT_EQ(1.0f, meshes[0][2][1]);
+
+	// Both byte orders and any numeric type give the same mesh
+	std::vector<MeshInfo> big_meshes = HF::Geometry::LoadPLY(WriteTempFile("square.ply", big));
+	ASSERT_EQ(meshes[0].GetIndexedVertices(), big_meshes[0].GetIndexedVertices());
+	ASSERT_EQ(meshes[0].getRawIndices(), big_meshes[0].getRawIndices());
+
+	// ASCII PLYs and faces that reference missing vertices are rejected
+	ASSERT_THROW(HF::Geometry::LoadPLY(WriteTempFile("square.ply", "ply\nformat ascii 1.0\nend_header\n")), HF::Exceptions::InvalidOBJ);
+	little[little.size() - 12] = 9;
+	ASSERT_THROW(HF::Geometry::LoadPLY(WriteTempFile("square.ply", little)), HF::Exceptions::InvalidOBJ);
+
+	// Counts larger than the file could hold are rejected before anything is allocated
+	const std::string huge = "ply\nformat binary_little_endian 1.0\nelement vertex 4000000000\n"
+		"property float x\nproperty float y\nproperty float z\nend_header\n";
+	ASSERT_THROW(HF::Geometry::LoadPLY(WriteTempFile("square.ply", huge + "0123456789ab")), HF::Exceptions::InvalidOBJ);
+	std::filesystem::remove(path);
+}
+
+TEST(_meshInfo, LoadSTL) {
+	// Two triangles sharing an edge
+	std::string stl(80, ' ');
+	AppendBytes<uint32_t>(stl, 2);
+	const float triangles[2][3][3] = {
+		{ {0, 0, 0}, {1, 0, 0}, {1, 1, 0} },
+		{ {0, 0, 0}, {1, 1, 0}, {0, 1, 0} }
+	};
+	for (const auto& triangle : triangles) {
+		for (int i = 0; i < 3; i++) AppendBytes(stl, 0.0f);
+		for (const auto& vertex : triangle)
+			for (float value : vertex) AppendBytes(stl, value);
+		AppendBytes<uint16_t>(stl, 0);
+	}
+
+	//! [EX_LoadSTL]
+	const std::string path = WriteTempFile("square.stl", stl);
+	std::vector<MeshInfo> meshes = HF::Geometry::LoadSTL(path, false, 2);
+	//! [EX_LoadSTL]
+
+	// Corners at the same position become a single vertex
+	ASSERT_EQ(1, meshes.size());
+	ASSERT_EQ(4, meshes[0].NumVerts());
+	ASSERT_EQ(2, meshes[0].NumTris());
+	ASSERT_FLOAT_EQ(2.0f, meshes[0][2][0]);
+	ASSERT_EQ(std::vector<int>({ 0, 1, 2, 0, 2, 3 }), meshes[0].getRawIndices());
+
+	// Files whose size doesn't match their triangle count are rejected
+	ASSERT_THROW(HF::Geometry::LoadSTL(WriteTempFile("square.stl", stl + "extra")), HF::Exceptions::InvalidOBJ);
+	std::filesystem::remove(path);
+}
+
+TEST(_meshInfo, LoadGLTF) {
+	// One triangle, followed by its indices
+	std::string buffer;
+	for (float value : { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f }) AppendBytes(buffer, value);
+	for (uint16_t index : { 0, 1, 2, 0 }) AppendBytes(buffer, index);
+
+	// The triangle is drawn twice: once scaled inside a translated parent, and once as is
+	const std::string json_start = R"({"asset":{"version":"2.0"},"scene":0,"scenes":[{"nodes":[0,2]}],)"
+		R"("nodes":[{"name":"root","children":[1],"translation":[0,0,10]},{"name":"floor","mesh":0,"scale":[2,2,2]},{"mesh":0}],)"
+		R"("meshes":[{"name":"triangle","primitives":[{"attributes":{"POSITION":0},"indices":1}]}],)"
+		R"("accessors":[{"bufferView":0,"componentType":5126,"count":3,"type":"VEC3"},)"
+		R"({"bufferView":1,"componentType":5123,"count":3,"type":"SCALAR"}],)"
+		R"("bufferViews":[{"buffer":0,"byteLength":36},{"buffer":0,"byteOffset":36,"byteLength":6}],)";
+
+	// GLBs keep the buffer in a chunk after the JSON, which is padded to 4 bytes
+	std::string glb_json = json_start + R"("buffers":[{"byteLength":44}]})";
+	glb_json.resize((glb_json.size() + 3) / 4 * 4, ' ');
+	std::string glb;
+	AppendBytes<uint32_t>(glb, 0x46546C67);
+	AppendBytes<uint32_t>(glb, 2);
+	AppendBytes<uint32_t>(glb, static_cast<uint32_t>(12 + 8 + glb_json.size() + 8 + buffer.size()));
+	AppendBytes<uint32_t>(glb, static_cast<uint32_t>(glb_json.size()));
+	AppendBytes<uint32_t>(glb, 0x4E4F534A);
+	glb += glb_json;
+	AppendBytes<uint32_t>(glb, static_cast<uint32_t>(buffer.size()));
+	AppendBytes<uint32_t>(glb, 0x004E4942);
+	glb += buffer;
+
+	//! [EX_LoadGLTF]
+	const std::string path = WriteTempFile("triangle.glb", glb);
+	std::vector<MeshInfo> meshes = HF::Geometry::LoadGLTF(path);
+	//! [EX_LoadGLTF]
+
+	// Each node gets its own mesh, with the node's index as its ID
+	ASSERT_EQ(2, meshes.size());
+	ASSERT_EQ(1, meshes[0].meshid);
+	ASSERT_EQ("floor", meshes[0].name);
+	ASSERT_EQ(2, meshes[1].meshid);
+	ASSERT_EQ("triangle", meshes[1].name);
+	ASSERT_EQ(1, meshes[0].NumTris());
+
+	// Nodes are transformed by their parents
+	ASSERT_FLOAT_EQ(2.0f, meshes[0][1][0]);
+	ASSERT_FLOAT_EQ(10.0f, meshes[0][1][2]);
+	ASSERT_FLOAT_EQ(1.0f, meshes[1][1][0]);
+	ASSERT_FLOAT_EQ(0.0f, meshes[1][1][2]);
+
+	// A .gltf with its buffer in a separate file gives the same result
+	WriteTempFile("triangle.bin", buffer);
+	const std::string gltf_path = WriteTempFile("triangle.gltf", json_start + R"("buffers":[{"byteLength":44,"uri":"triangle.bin"}]})");
+	std::vector<MeshInfo> gltf_meshes = HF::Geometry::LoadMeshFile(gltf_path);
+	ASSERT_EQ(2, gltf_meshes.size());
+	ASSERT_EQ(meshes[0].GetIndexedVertices(), gltf_meshes[0].GetIndexedVertices());
+	ASSERT_EQ(meshes[1].getRawIndices(), gltf_meshes[1].getRawIndices());
+
+	// Missing buffers and broken JSON are reported
+	std::filesystem::remove(std::filesystem::temp_directory_path() / "triangle.bin");
+	ASSERT_THROW(HF::Geometry::LoadGLTF(gltf_path), HF::Exceptions::FileNotFound);
+	ASSERT_THROW(HF::Geometry::LoadGLTF(WriteTempFile("triangle.gltf", json_start)), HF::Exceptions::InvalidOBJ);
+
+	// Accessors with negative or huge counts and offsets are rejected
+	WriteTempFile("triangle.bin", buffer);
+	const std::string vec3 = R"("count":3,"type":"VEC3")";
+	for (const std::string bad : { R"("count":-3,"type":"VEC3")", R"("count":1e300,"type":"VEC3")", R"("count":3,"byteOffset":1e20,"type":"VEC3")" }) {
+		std::string bad_json = json_start + R"("buffers":[{"byteLength":44,"uri":"triangle.bin"}]})";
+		bad_json.replace(bad_json.find(vec3), vec3.size(), bad);
+		ASSERT_THROW(HF::Geometry::LoadGLTF(WriteTempFile("triangle.gltf", bad_json)), HF::Exceptions::InvalidOBJ);
+	}
+	std::filesystem::remove(std::filesystem::temp_directory_path() / "triangle.bin");
+
+	std::filesystem::remove(path);
+	std::filesystem::remove(gltf_path);
+}
 /// end objloader.h
 
 TEST(_meshInfo, ConstructorDefault) {
@@ -764,6 +1032,29 @@ TEST(_meshInfo, OperatorIndex) {
 		<< vertex[2] << ")" << std::endl;
 }
 
+TEST(_meshInfo, ReleaseBuffers) {
+	std::vector<float> vertices = { 34.1, 63.9, 16.5, 23.5, 85.7, 45.2, 12.0, 24.6, 99.4 };
+	std::vector<int> indices = { 0, 1, 2 };
+	MeshInfo mesh(vertices, indices, 5901, "This Mesh");
+
+	auto buffers = mesh.ReleaseBuffers();
+
+	// Buffers hold the mesh followed by a padding vertex of zeros
+	ASSERT_EQ(3, buffers.NumVerts());
+	ASSERT_EQ(1, buffers.NumTris());
+	for (int i = 0; i < vertices.size(); i++)
+		ASSERT_EQ(vertices[i], buffers.vertices.data()[i]);
+	for (int i = 0; i < 3; i++)
+		ASSERT_EQ(0.0f, buffers.vertices(i, 3));
+	ASSERT_EQ(indices, std::vector<int>(buffers.indices.data(), buffers.indices.data() + 3));
+
+	// The mesh is left empty, but keeps its ID and name
+	ASSERT_EQ(0, mesh.NumVerts());
+	ASSERT_EQ(0, mesh.NumTris());
+	ASSERT_EQ(5901, mesh.meshid);
+	ASSERT_EQ("This Mesh", mesh.name);
+}
+
 TEST(_MeshInfo, CopyOperator) {
 
 }
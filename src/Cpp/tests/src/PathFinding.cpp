@@ -9,6 +9,8 @@
 
 #include <path_finder.h>
 #include <boost_graph.h>
+#include <csr_path_finder.h>
+#include <contraction_hierarchy.h>
 #include <graph.h>
 #include <node.h>
 #include <edge.h>
@@ -19,6 +21,8 @@
 #include "cost_algorithms.h"
 #include "spatialstructures_C.h"
 #include <numeric>
+#include <fstream>
+#include <cstring>
 
 using namespace HF::SpatialStructures;
 using namespace HF::Pathfinding;
@@ -177,6 +181,71 @@ TEST(_Pathfinding, DistanceAndPredecessorMatrices) {
 	//! [EX_DistPred_2]
 }
 
+TEST(_Pathfinding, DistanceTiles) {
+	// Create an undirected graph
+	Graph g;
+	g.addEdge(0, 1, 1); g.addEdge(1, 0, 1);
+	g.addEdge(0, 2, 2); g.addEdge(2, 0, 2);
+	g.addEdge(1, 3, 3); g.addEdge(3, 1, 3);
+	g.addEdge(2, 4, 1); g.addEdge(4, 2, 1);
+	g.addEdge(3, 4, 5); g.addEdge(4, 3, 5);
+	g.Compress();
+	auto bg = CreateBoostGraph(g);
+
+	// Generate the full matrix to compare against
+	auto matricies = GenerateDistanceAndPred(*bg.get());
+	const vector<float> expected = *matricies.dist;
+	const int num_nodes = matricies.size;
+	delete matricies.dist;
+	delete matricies.pred;
+
+	//! [EX_DistanceTiles]
+
+	// Generate the distances to nodes with higher IDs, 2 rows at a time
+	vector<float> upper_triangle;
+	GenerateDistanceTiles(
+		*bg.get(),
+		[&upper_triangle](const DistanceTile& tile) {
+			const float* values = static_cast<const float*>(tile.data);
+			upper_triangle.insert(upper_triangle.end(), values, values + tile.num_values);
+		},
+		DISTANCE_FORMAT::FLOAT32, 1.0f, true, 2
+	);
+
+	// Generate the full matrix quantized to units of 0.5
+	vector<uint16_t> quantized;
+	GenerateDistanceTiles(
+		*bg.get(),
+		[&quantized](const DistanceTile& tile) {
+			const uint16_t* values = static_cast<const uint16_t*>(tile.data);
+			quantized.insert(quantized.end(), values, values + tile.num_values);
+		},
+		DISTANCE_FORMAT::UINT16, 0.5f, false, 2
+	);
+
+	//! [EX_DistanceTiles]
+
+	ASSERT_EQ(num_nodes * (num_nodes - 1) / 2, upper_triangle.size());
+	ASSERT_EQ(num_nodes * num_nodes, quantized.size());
+
+	int upper_index = 0;
+	for (int row = 0; row < num_nodes; row++) {
+		for (int col = 0; col < num_nodes; col++) {
+			const float distance = expected[row * num_nodes + col];
+			EXPECT_EQ(static_cast<uint16_t>(distance * 2), quantized[row * num_nodes + col]);
+			if (col > row)
+				EXPECT_EQ(distance, upper_triangle[upper_index++]);
+		}
+	}
+
+	// Files contain a 32 byte header followed by every value
+	ASSERT_TRUE(WriteDistanceMatrix(*bg.get(), "distances.dhdm", DISTANCE_FORMAT::UINT16, 0.5f, true, 2));
+	std::ifstream file("distances.dhdm", std::ios::binary | std::ios::ate);
+	EXPECT_EQ(32 + upper_triangle.size() * sizeof(uint16_t), static_cast<size_t>(file.tellg()));
+
+	EXPECT_THROW(GenerateDistanceTiles(*bg.get(), [](const DistanceTile&) {}, DISTANCE_FORMAT::FLOAT32, 1.0f, false, 0), std::out_of_range);
+}
+
 
 // Performs the same task as the C++ DistanceAndPredecessor Matricies
 // using the C-Interface, then compares the results to the results
@@ -539,6 +608,291 @@ TEST(_pathFinding, FindPaths) {
 	}
 }
 
+TEST(_pathFinding, FindPathAStar) {
+	//! [EX_FindPathAStar]
+
+	// Create a graph from nodes with positions, using the distance between them as the cost
+	HF::SpatialStructures::Graph g;
+	HF::SpatialStructures::Node n0(0, 0, 0), n1(1, 0, 0), n2(2, 0, 0), n3(1, 1, 0), n4(2, 1, 0);
+	g.addEdge(n0, n1, 1);
+	g.addEdge(n1, n2, 1);
+	g.addEdge(n0, n3, 1.41421f);
+	g.addEdge(n3, n4, 1);
+	g.addEdge(n2, n4, 1);
+	g.Compress();
+
+	auto boostGraph = HF::Pathfinding::CreateBoostGraph(g);
+
+	// Find the path from n0 to n4 with A*
+	const int start = g.getID(n0);
+	const int end = g.getID(n4);
+	HF::SpatialStructures::Path path = HF::Pathfinding::FindPathAStar(boostGraph.get(), start, end);
+
+	//! [EX_FindPathAStar]
+
+	// A* should find a path with the same cost as Dijkstra
+	HF::SpatialStructures::Path expected = HF::Pathfinding::FindPath(boostGraph.get(), start, end);
+	ASSERT_EQ(path.size(), expected.size());
+	for (int i = 0; i < path.size(); i++) {
+		EXPECT_EQ(path.members[i].node, expected.members[i].node);
+		EXPECT_NEAR(path.members[i].cost, expected.members[i].cost, 0.0001);
+	}
+
+	// There's no way back to n0, so no path should be returned
+	EXPECT_TRUE(HF::Pathfinding::FindPathAStar(boostGraph.get(), end, start).empty());
+}
+
+TEST(_pathFinding, FindPathBidirectional) {
+	//! [EX_FindPathBidirectional]
+
+	// Create a Graph g, and compress it.
+	HF::SpatialStructures::Graph g;
+	g.addEdge(0, 1, 1);
+	g.addEdge(0, 2, 2);
+	g.addEdge(1, 3, 3);
+	g.addEdge(2, 4, 1);
+	g.addEdge(3, 4, 5);
+	g.Compress();
+
+	// Create a boostGraph from g
+	auto boostGraph = HF::Pathfinding::CreateBoostGraph(g);
+
+	// Get the path from node (id 0) to node (id 4)
+	HF::SpatialStructures::Path path = HF::Pathfinding::FindPathBidirectional(boostGraph.get(), 0, 4);
+
+	//! [EX_FindPathBidirectional]
+
+	// Every path should match the one found by FindPath
+	for (int start = 0; start < 5; start++) {
+		for (int end = 0; end < 5; end++) {
+			const auto actual = HF::Pathfinding::FindPathBidirectional(boostGraph.get(), start, end);
+			const auto expected = HF::Pathfinding::FindPath(boostGraph.get(), start, end);
+
+			ASSERT_EQ(actual.size(), expected.size());
+			for (int i = 0; i < actual.size(); i++) {
+				EXPECT_EQ(actual.members[i].node, expected.members[i].node);
+				EXPECT_NEAR(actual.members[i].cost, expected.members[i].cost, 0.0001);
+			}
+		}
+	}
+}
+
+TEST(_pathFinding, FindNearestSources) {
+	HF::SpatialStructures::Graph g;
+	g.addEdge(0, 1, 1);
+	g.addEdge(0, 2, 2);
+	g.addEdge(1, 3, 3);
+	g.addEdge(2, 4, 1);
+	g.addEdge(3, 4, 5);
+	g.Compress();
+	auto boostGraph = HF::Pathfinding::CreateBoostGraph(g);
+
+	//! [EX_FindNearestSources]
+
+	// Find the cost from the nearest of nodes 0 and 3 to every node
+	auto nearest = HF::Pathfinding::FindNearestSources(boostGraph.get(), { 0, 3 });
+
+	// Find the cost from every node to node 4, like the distance to an exit
+	auto to_exit = HF::Pathfinding::FindNearestSources(boostGraph.get(), { 4 }, -1, true);
+
+	//! [EX_FindNearestSources]
+
+	const vector<float> expected_distance{ 0, 1, 2, 0, 3 };
+	const vector<int> expected_source{ 0, 0, 0, 3, 0 };
+	const vector<int> expected_pred{ 0, 0, 0, 3, 2 };
+	EXPECT_EQ(expected_distance, nearest.distance);
+	EXPECT_EQ(expected_source, nearest.source);
+	EXPECT_EQ(expected_pred, nearest.predecessor);
+
+	// In reverse, the predecessor is the next node on the way to the source
+	const vector<float> expected_exit_distance{ 3, 8, 1, 5, 0 };
+	const vector<int> expected_next{ 2, 3, 4, 4, 4 };
+	EXPECT_EQ(expected_exit_distance, to_exit.distance);
+	EXPECT_EQ(expected_next, to_exit.predecessor);
+
+	// Nodes past the cutoff are unreachable
+	auto cut_off = HF::Pathfinding::FindNearestSources(boostGraph.get(), { 0 }, 2);
+	const vector<float> expected_cut_off{ 0, 1, 2, -1, -1 };
+	EXPECT_EQ(expected_cut_off, cut_off.distance);
+	EXPECT_EQ(-1, cut_off.source[4]);
+}
+
+TEST(_pathFinding, FindReachable) {
+	HF::SpatialStructures::Graph g;
+	g.addEdge(0, 1, 1);
+	g.addEdge(0, 2, 2);
+	g.addEdge(1, 3, 3);
+	g.addEdge(2, 4, 1);
+	g.addEdge(3, 4, 5);
+	g.Compress();
+	auto boostGraph = HF::Pathfinding::CreateBoostGraph(g);
+
+	//! [EX_FindReachable]
+
+	// Find every node within a cost of 2 from node 0
+	auto reachable = HF::Pathfinding::FindReachable(boostGraph.get(), { 0 }, 2);
+
+	//! [EX_FindReachable]
+
+	// Nodes are returned in order of cost
+	ASSERT_EQ(3, reachable.size());
+	for (int i = 0; i < 3; i++) {
+		EXPECT_EQ(i, reachable[i].node);
+		EXPECT_EQ(static_cast<float>(i), reachable[i].cost);
+		EXPECT_EQ(0, reachable[i].source);
+	}
+
+	// Every node that can reach node 4 within a cost of 3
+	auto reaches_exit = HF::Pathfinding::FindReachable(boostGraph.get(), { 4 }, 3, true);
+	ASSERT_EQ(3, reaches_exit.size());
+	EXPECT_EQ(4, reaches_exit[0].node);
+	EXPECT_EQ(2, reaches_exit[1].node);
+	EXPECT_EQ(0, reaches_exit[2].node);
+}
+
+TEST(_pathFinding, CSRPathFinder) {
+	HF::SpatialStructures::Graph g;
+	g.addEdge(0, 1, 1);
+	g.addEdge(0, 2, 2);
+	g.addEdge(1, 3, 3);
+	g.addEdge(2, 4, 1);
+	g.addEdge(3, 4, 5);
+	g.Compress();
+	auto boostGraph = HF::Pathfinding::CreateBoostGraph(g);
+
+	//! [EX_CSRPathFinder]
+
+	// Search the graph's CSR directly. No copy of the graph is made.
+	HF::Pathfinding::CSRPathFinder path_finder(g);
+	HF::SpatialStructures::Path path = path_finder.FindPath(0, 4);
+
+	//! [EX_CSRPathFinder]
+
+	// Every pair should match the boost graph
+	const int num_nodes = path_finder.size();
+	std::vector<int> starts, ends;
+	for (int start = 0; start < num_nodes; start++) {
+		for (int end = 0; end < num_nodes; end++) {
+			starts.push_back(start);
+			ends.push_back(end);
+		}
+	}
+
+	auto csr_paths = path_finder.FindPaths(starts, ends);
+	auto boost_paths = HF::Pathfinding::FindPaths(boostGraph.get(), starts, ends);
+	for (int i = 0; i < starts.size(); i++) {
+		EXPECT_EQ(boost_paths[i], csr_paths[i]);
+		EXPECT_EQ(boost_paths[i], path_finder.FindPath(starts[i], ends[i]));
+	}
+
+	// Rows of distances use -1 for unreachable nodes
+	std::vector<float> dist(num_nodes);
+	std::vector<int> pred(num_nodes);
+	path_finder.DistanceAndPredecessorRow(1, dist.data(), pred.data());
+	EXPECT_EQ(-1, dist[0]);
+	EXPECT_EQ(0, dist[1]);
+	EXPECT_EQ(3, dist[3]);
+	EXPECT_EQ(8, dist[4]);
+	EXPECT_EQ(3, pred[4]);
+
+	// Alternate costs are searched through their own array
+	g.addEdge(0, 1, 1, "cross");
+	g.addEdge(0, 2, 10, "cross");
+	g.addEdge(1, 3, 1, "cross");
+	g.addEdge(2, 4, 10, "cross");
+	g.addEdge(3, 4, 1, "cross");
+	HF::Pathfinding::CSRPathFinder cross_finder(g, "cross");
+	auto cross_path = cross_finder.FindPath(0, 4);
+	ASSERT_EQ(4, cross_path.size());
+	EXPECT_EQ(3, cross_path[2].node);
+
+	EXPECT_THROW(HF::Pathfinding::CSRPathFinder(g, "not a cost"), HF::Exceptions::NoCost);
+}
+
+TEST(_pathFinding, ContractionHierarchy) {
+	// Build a grid with enough nodes for contraction to add shortcuts
+	const int width = 10;
+	HF::SpatialStructures::Graph g;
+	for (int x = 0; x < width; x++) {
+		for (int y = 0; y < width; y++) {
+			const int id = x * width + y;
+			if (x + 1 < width) {
+				g.addEdge(id, id + width, 1.0f + (id % 3));
+				g.addEdge(id + width, id, 1.0f + (id % 5));
+			}
+			if (y + 1 < width) {
+				g.addEdge(id, id + 1, 1.0f + (id % 7));
+				g.addEdge(id + 1, id, 1.0f + (id % 2));
+			}
+		}
+	}
+	g.Compress();
+	auto boostGraph = HF::Pathfinding::CreateBoostGraph(g);
+
+	//! [EX_ContractionHierarchy]
+
+	// Preprocess the graph once, then find paths with the hierarchy
+	HF::Pathfinding::ContractionHierarchy ch(g);
+	HF::SpatialStructures::Path path = ch.FindPath(0, 99);
+
+	// Save the hierarchy so it doesn't need to be built again
+	ch.SaveBinary("contraction_hierarchy.ch");
+	auto loaded = HF::Pathfinding::ContractionHierarchy::LoadBinary("contraction_hierarchy.ch");
+
+	//! [EX_ContractionHierarchy]
+
+	ASSERT_EQ(g.size(), loaded.size());
+	ASSERT_EQ(ch.NumEdges(), loaded.NumEdges());
+
+	// Costs of every path should match dijkstra
+	const int num_nodes = g.size();
+	std::vector<int> starts, ends;
+	for (int start = 0; start < num_nodes; start += 7) {
+		for (int end = 0; end < num_nodes; end++) {
+			starts.push_back(start);
+			ends.push_back(end);
+		}
+	}
+
+	auto boost_paths = HF::Pathfinding::FindPaths(boostGraph.get(), starts, ends);
+	auto ch_paths = loaded.FindPaths(starts, ends);
+	for (int i = 0; i < starts.size(); i++) {
+		float boost_cost = 0;
+		for (const auto& member : boost_paths[i].members) boost_cost += member.cost;
+
+		float ch_cost = 0;
+		for (const auto& member : ch_paths[i].members) ch_cost += member.cost;
+
+		ASSERT_EQ(boost_paths[i].size() == 0, ch_paths[i].size() == 0);
+		EXPECT_NEAR(boost_cost, ch_cost, 0.0001f);
+
+		// Every member must be connected to the next by an edge of the graph with its cost
+		for (int j = 0; j + 1 < ch_paths[i].size(); j++)
+			EXPECT_EQ(g.GetCost(ch_paths[i][j].node, ch_paths[i][j + 1].node), ch_paths[i][j].cost);
+	}
+
+	EXPECT_THROW(HF::Pathfinding::ContractionHierarchy::LoadBinary("not_a_file.ch"), HF::Exceptions::FileNotFound);
+
+	// The last value in the file is the middle node of the last downward edge. Point it past
+	// the end of the graph, then cut the file short, and make sure neither is accepted.
+	std::ifstream in("contraction_hierarchy.ch", std::ios::binary);
+	std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	in.close();
+
+	std::string corrupt = bytes;
+	const int bad_node = 1 << 30;
+	std::memcpy(&corrupt[corrupt.size() - sizeof(int)], &bad_node, sizeof(int));
+	std::ofstream("corrupt_hierarchy.ch", std::ios::binary) << corrupt;
+	EXPECT_THROW(HF::Pathfinding::ContractionHierarchy::LoadBinary("corrupt_hierarchy.ch"), std::runtime_error);
+
+	std::ofstream("corrupt_hierarchy.ch", std::ios::binary) << bytes.substr(0, bytes.size() - 1);
+	EXPECT_THROW(HF::Pathfinding::ContractionHierarchy::LoadBinary("corrupt_hierarchy.ch"), std::runtime_error);
+
+	// Hierarchies are built from the CSR, which only exists once the graph is compressed
+	g.addEdge(0, 99, 1.0f);
+	EXPECT_THROW(HF::Pathfinding::ContractionHierarchy ch_uncompressed(g), std::runtime_error);
+}
+
 TEST(_pathFinding, MakePathArray) {
 	// be sure to #include "path_finder.h", #include "boost_graph.h", and #include "graph.h"
 
@@ -1039,6 +1393,34 @@ namespace CInterfaceTests {
 		out_path_member = nullptr;
 	}
 
+	TEST(C_Pathfinder, CreatePathAStarAndBidirectional) {
+		// Create a Graph g, and compress it.
+		HF::SpatialStructures::Graph g;
+		g.addEdge(0, 1, 1);
+		g.addEdge(0, 2, 2);
+		g.addEdge(1, 3, 3);
+		g.addEdge(2, 4, 1);
+		g.addEdge(3, 4, 5);
+		g.Compress();
+
+		HF::SpatialStructures::Path* out_path = nullptr;
+		HF::SpatialStructures::PathMember* out_path_member = nullptr;
+		int out_size = -1;
+
+		// Nodes added by ID have no position, so A* will behave like Dijkstra
+		ASSERT_EQ(HF::Exceptions::OK, CreatePathAStar(&g, 0, 4, &out_size, &out_path, &out_path_member));
+		EXPECT_EQ(out_size, 3);
+		DestroyPath(out_path);
+
+		ASSERT_EQ(HF::Exceptions::OK, CreatePathBidirectional(&g, 0, 4, "", &out_size, &out_path, &out_path_member));
+		EXPECT_EQ(out_size, 3);
+		DestroyPath(out_path);
+
+		// Node 4 has no outgoing edges
+		EXPECT_EQ(HF::Exceptions::NO_PATH, CreatePathBidirectional(&g, 4, 0, "", &out_size, &out_path, &out_path_member));
+		EXPECT_EQ(HF::Exceptions::NO_COST, CreatePathBidirectional(&g, 0, 4, "NotACost", &out_size, &out_path, &out_path_member));
+	}
+
 	TEST(C_Pathfinder, CreatePaths) {
 		//! [snippet_pathfinder_C_CreatePaths]
 		// Requires #include "pathfinder_C.h", #include "graph.h", #include "path.h", #include "path_finder.h"
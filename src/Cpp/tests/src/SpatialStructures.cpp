@@ -6,6 +6,12 @@
 #include <constants.h>
 #include <HFExceptions.h>
 #include <spatialstructures_C.h>
+#include <cinterface_utils.h>
+#include <node_index.h>
+#include <graph_builder.h>
+#include <fstream>
+#include <cstring>
+#include <random>
 
 
 using namespace HF::SpatialStructures;
@@ -836,6 +842,438 @@ TEST(C_Graph, AttrToParams) {
 	ASSERT_EQ(scores[ids[2]] + scores[ids[1]], G.GetCost(ids[2], ids[1], "output_str"));
 }
 
+TEST(_Graph, SaveLoadBinary) {
+	Graph G = CreateNodeAttributeGraph();
+	const auto ids = GetIds(G, test_param_nodes);
+	G.AttrToCost(test_attribute, "output_str", Direction::INCOMING);
+	G.AddNodeAttributesFloat(ids, "float_attr", { 0.5f, 1.5f, 2.5f, 3.5f, 4.5f });
+
+	//! [EX_SaveLoadBinary]
+
+	// Save the graph to a file, then load it back
+	G.SaveBinary("save_load_binary.dhg");
+	Graph loaded = Graph::LoadBinary("save_load_binary.dhg");
+
+	//! [EX_SaveLoadBinary]
+
+	// Nodes and their IDs are preserved
+	ASSERT_EQ(G.size(), loaded.size());
+	for (int i = 0; i < test_param_nodes.size(); i++)
+		ASSERT_EQ(ids[i], loaded.getID(test_param_nodes[i]));
+
+	// Edges in both the default and alternate cost types are preserved
+	for (const auto& cost_type : { string(""), string("output_str") }) {
+		ASSERT_EQ(G.CountEdges(cost_type), loaded.CountEdges(cost_type));
+		ASSERT_EQ(G.GetCost(ids[0], ids[1], cost_type), loaded.GetCost(ids[0], ids[1], cost_type));
+		ASSERT_EQ(G.GetCost(ids[3], ids[0], cost_type), loaded.GetCost(ids[3], ids[0], cost_type));
+		ASSERT_EQ(G.GetCost(ids[2], ids[1], cost_type), loaded.GetCost(ids[2], ids[1], cost_type));
+	}
+
+	// Node attributes are preserved
+	ASSERT_EQ(G.GetNodeAttributes(test_attribute), loaded.GetNodeAttributes(test_attribute));
+	ASSERT_EQ(G.GetNodeAttributesFloat("float_attr"), loaded.GetNodeAttributesFloat("float_attr"));
+
+	// The loaded graph can still be modified
+	loaded.addEdge(ids[4], ids[0], 10);
+	loaded.Compress();
+	ASSERT_EQ(10, loaded.GetCost(ids[4], ids[0]));
+}
+
+TEST(_Graph, LoadBinaryErrors) {
+	ASSERT_THROW(Graph::LoadBinary("this_graph_does_not_exist.dhg"), HF::Exceptions::FileNotFound);
+
+	{
+		std::ofstream not_a_graph("not_a_graph.dhg", std::ios::binary);
+		not_a_graph << "This isn't a graph file";
+	}
+	ASSERT_THROW(Graph::LoadBinary("not_a_graph.dhg"), std::runtime_error);
+
+	// Saving doesn't compress a const graph, but what's written is still compressed
+	Graph G;
+	G.addEdge(Node(0, 0, 0), Node(1, 0, 0), 1.0f);
+	G.addEdge(Node(1, 0, 0), Node(2, 0, 0), 2.0f);
+	const Graph& const_graph = G;
+	ASSERT_TRUE(const_graph.SaveBinary("two_edges.dhg"));
+	ASSERT_THROW(const_graph.GetCSRPointers(), std::runtime_error);
+	ASSERT_EQ(2.0f, Graph::LoadBinary("two_edges.dhg").GetCost(1, 2));
+
+	// With an even number of edges and no other cost types or attributes, the file ends with
+	// the CSR's values, right after its inner indices. Point the last edge past the last column.
+	std::ifstream in("two_edges.dhg", std::ios::binary);
+	std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	in.close();
+
+	const int bad_column = 1 << 30;
+	std::memcpy(&bytes[bytes.size() - 2 * sizeof(float) - sizeof(int)], &bad_column, sizeof(int));
+	std::ofstream("bad_csr.dhg", std::ios::binary) << bytes;
+	ASSERT_THROW(Graph::LoadBinary("bad_csr.dhg"), std::runtime_error);
+
+	// The header's next ID comes right after its magic, version, flags, and node count.
+	// It must be greater than every node's ID, or new nodes would reuse one.
+	const size_t next_id_offset = 8 + 3 * sizeof(int32_t);
+	for (int next_id : { -1, 2 }) {
+		std::string bad_header = bytes;
+		std::memcpy(&bad_header[next_id_offset], &next_id, sizeof(int));
+		std::ofstream("bad_next_id.dhg", std::ios::binary) << bad_header;
+		ASSERT_THROW(Graph::LoadBinary("bad_next_id.dhg"), std::runtime_error);
+	}
+
+	// Node IDs are written before the CSR, whose outer indices also start with 0, 1, 2.
+	// Give the last node the same ID as the one before it.
+	const int first_ids[3] = { 0, 1, 2 };
+	std::string duplicate_ids = bytes;
+	const size_t ids_offset = duplicate_ids.find(std::string(reinterpret_cast<const char*>(first_ids), sizeof(first_ids)));
+	ASSERT_NE(std::string::npos, ids_offset);
+	std::memcpy(&duplicate_ids[ids_offset + 2 * sizeof(int)], &first_ids[1], sizeof(int));
+	std::ofstream("duplicate_ids.dhg", std::ios::binary) << duplicate_ids;
+	ASSERT_THROW(Graph::LoadBinary("duplicate_ids.dhg"), std::runtime_error);
+
+	// Graphs with integer IDs are still valid, and new nodes don't reuse their IDs
+	Graph int_graph;
+	int_graph.addEdge(0, 3, 1.0f);
+	int_graph.Compress();
+	ASSERT_TRUE(int_graph.SaveBinary("int_ids.dhg"));
+	Graph loaded = Graph::LoadBinary("int_ids.dhg");
+	loaded.addEdge(Node(5, 5, 5), Node(6, 6, 6), 1.0f);
+	ASSERT_EQ(4, loaded.getID(Node(5, 5, 5)));
+	ASSERT_EQ(5, loaded.getID(Node(6, 6, 6)));
+}
+
+TEST(_Graph, BulkAddEdges) {
+	std::mt19937 gen(7);
+	std::uniform_int_distribution<int> position(0, 30);
+	std::uniform_real_distribution<float> cost(1.0f, 10.0f);
+
+	// Random edges between points on a grid, with plenty of duplicates
+	vector<Node> parents, children;
+	vector<float> costs;
+	for (int i = 0; i < 5000; i++) {
+		parents.emplace_back(position(gen), position(gen), 0);
+		children.emplace_back(position(gen), position(gen), 0);
+		costs.push_back(cost(gen));
+	}
+
+	//! [EX_GraphBuilder]
+
+	// Store edges in 4 buffers. Every buffer could be filled by a different thread.
+	GraphBuilder builder(4);
+	for (int i = 0; i < parents.size(); i++)
+		builder.AddEdge(i * 4 / parents.size(), parents[i], children[i], costs[i]);
+
+	// Add every edge to the graph and build its CSR at once
+	Graph G;
+	G.BulkAddEdges(builder);
+
+	//! [EX_GraphBuilder]
+
+	// Nodes get the same IDs as they would from addEdge
+	Graph expected;
+	for (int i = 0; i < parents.size(); i++)
+		expected.addEdge(parents[i], children[i], costs[i]);
+	expected.Compress();
+
+	ASSERT_EQ(expected.size(), G.size());
+	for (const Node& node : expected.Nodes())
+		ASSERT_EQ(expected.getID(node), G.getID(node));
+
+	// Only the cheapest copy of each duplicate edge is kept
+	robin_hood::unordered_map<long long, float> cheapest;
+	for (int i = 0; i < parents.size(); i++) {
+		const long long key = static_cast<long long>(G.getID(parents[i])) * G.size() + G.getID(children[i]);
+		const auto it = cheapest.find(key);
+		if (it == cheapest.end() || costs[i] < it->second)
+			cheapest[key] = costs[i];
+	}
+	ASSERT_EQ(cheapest.size(), G.CountEdges(""));
+	for (const auto& edge : cheapest)
+		ASSERT_EQ(edge.second, G.GetCost(edge.first / G.size(), edge.first % G.size()));
+
+	// The result doesn't depend on how many buffers were used
+	GraphBuilder single_buffer(1);
+	for (int i = 0; i < parents.size(); i++)
+		single_buffer.AddEdge(0, parents[i], children[i], costs[i]);
+	Graph G2;
+	G2.BulkAddEdges(single_buffer);
+
+	const CSRPtrs csr = G.GetCSRPointers();
+	const CSRPtrs csr2 = G2.GetCSRPointers();
+	ASSERT_EQ(csr.nnz, csr2.nnz);
+	ASSERT_TRUE(std::equal(csr.outer_indices, csr.outer_indices + csr.rows + 1, csr2.outer_indices));
+	ASSERT_TRUE(std::equal(csr.inner_indices, csr.inner_indices + csr.nnz, csr2.inner_indices));
+	ASSERT_TRUE(std::equal(csr.data, csr.data + csr.nnz, csr2.data));
+}
+
+TEST(_Graph, BulkAddEdgesExistingGraph) {
+	Graph G;
+	G.addEdge(0, 1, 5);
+	G.addEdge(1, 2, 5);
+	G.Compress();
+	G.addEdge(0, 1, 50, "alternate");
+	G.addEdge(1, 2, 60, "alternate");
+
+	// New edges replace existing ones, and missing IDs are added to the graph
+	GraphBuilder builder(2);
+	const vector<int> parent_ids = { 0, 2, 2 };
+	const vector<int> child_ids = { 1, 4, 4 };
+	const vector<float> costs = { 1, 3, 2 };
+	builder.AddEdges(1, parent_ids.data(), child_ids.data(), costs.data(), parent_ids.size());
+	G.BulkAddEdges(builder);
+
+	ASSERT_EQ(4, G.size());
+	ASSERT_EQ(1, G.GetCost(0, 1));
+	ASSERT_EQ(5, G.GetCost(1, 2));
+	ASSERT_EQ(2, G.GetCost(2, 4));
+	ASSERT_EQ(3, G.CountEdges(""));
+
+	// Alternate costs follow the edges they belong to. New edges don't have one.
+	ASSERT_EQ(60, G.GetCost(1, 2, "alternate"));
+	ASSERT_TRUE(std::isnan(G.GetCost(0, 1, "alternate")));
+	ASSERT_TRUE(std::isnan(G.GetCost(2, 4, "alternate")));
+
+	// Removing edges shrinks cost arrays along with the CSR
+	G.RemoveOutgoingEdges({ 1 });
+	ASSERT_EQ(2, G.GetEdgeCosts("alternate").size());
+	ASSERT_EQ(2, G.CountEdges(""));
+
+	GraphBuilder negative(1);
+	negative.AddEdge(0, -1, 0, 1.0f);
+	ASSERT_THROW(G.BulkAddEdges(negative), std::out_of_range);
+}
+
+TEST(C_Graph, SaveLoadGraph) {
+	Graph G = CreateNodeAttributeGraph();
+	const auto ids = GetIds(G, test_param_nodes);
+
+	ASSERT_EQ(HF_STATUS::OK, SaveGraph(&G, "save_load_graph_c.dhg"));
+
+	Graph* loaded = nullptr;
+	ASSERT_EQ(HF_STATUS::OK, LoadGraph("save_load_graph_c.dhg", &loaded));
+	ASSERT_EQ(G.GetCost(ids[0], ids[1]), loaded->GetCost(ids[0], ids[1]));
+	ASSERT_EQ(G.GetNodeAttributes(test_attribute), loaded->GetNodeAttributes(test_attribute));
+	DestroyGraph(loaded);
+
+	Graph* missing = nullptr;
+	ASSERT_EQ(HF_STATUS::NOT_FOUND, LoadGraph("this_graph_does_not_exist.dhg", &missing));
+}
+
+TEST(_Graph, NodeAttributeColumn) {
+	Graph G = CreateNodeAttributeGraph();
+	const auto ids = GetIds(G, test_param_nodes);
+
+	//! [EX_NodeAttributeColumn]
+
+	// Set a score for every node in the graph at once, ordered by node ID
+	const vector<float> scores = { 0.5f, 1.5f, 2.5f, 3.5f, 4.5f };
+	G.SetNodeAttributeColumn("score", NODE_ATTRIBUTE_TYPE::FLOAT, scores.data(), scores.size());
+
+	// Read the scores back without copying them
+	const NodeAttributeColumn* column = G.GetNodeAttributeColumn("score");
+	const float* stored_scores = static_cast<const float*>(column->Data());
+
+	//! [EX_NodeAttributeColumn]
+
+	ASSERT_EQ(NODE_ATTRIBUTE_TYPE::FLOAT, column->Type());
+	ASSERT_EQ(G.size(), column->size());
+	for (int i = 0; i < scores.size(); i++)
+		ASSERT_EQ(scores[i], stored_scores[i]);
+	ASSERT_TRUE(G.IsFloatAttribute("score"));
+	ASSERT_EQ(scores, G.GetNodeAttributesFloat("score"));
+
+	// Int and bool columns can be read as floats, and used as costs
+	const vector<int> int_scores = { 1, 2, 3, 4, 5 };
+	G.SetNodeAttributeColumn("int_score", NODE_ATTRIBUTE_TYPE::INT, int_scores.data(), int_scores.size());
+	ASSERT_TRUE(G.IsFloatAttribute("int_score"));
+	ASSERT_EQ(vector<float>({ 1, 2, 3, 4, 5 }), G.GetNodeAttributesFloat("int_score"));
+
+	G.AttrToCost("int_score", "int_cost", Direction::INCOMING);
+	ASSERT_EQ(int_scores[ids[1]], G.GetCost(ids[0], ids[1], "int_cost"));
+
+	// Adding a float to an int column widens it to floats
+	G.AddNodeAttributeFloat(ids[0], "int_score", 0.25f);
+	ASSERT_EQ(NODE_ATTRIBUTE_TYPE::FLOAT, G.GetNodeAttributeColumn("int_score")->Type());
+	ASSERT_EQ(0.25f, G.GetNodeAttributesFloat("int_score")[ids[0]]);
+
+	// Nodes that weren't assigned a value can't be read by ID
+	vector<int> unassigned = { ids[4] };
+	ASSERT_THROW(G.GetNodeAttributesByID(unassigned, test_attribute), std::out_of_range);
+
+	// Columns can't be longer than the graph
+	ASSERT_THROW(G.SetNodeAttributeColumn("too_long", NODE_ATTRIBUTE_TYPE::INT, int_scores.data(), 100), std::out_of_range);
+}
+
+TEST(C_Graph, NodeAttributePointers) {
+	Graph G = CreateNodeAttributeGraph();
+
+	const std::array<uint8_t, 5> flags = { 1, 0, 1, 0, 1 };
+	ASSERT_EQ(HF_STATUS::OK, SetNodeAttributeColumn(&G, "flag", static_cast<int>(NODE_ATTRIBUTE_TYPE::BOOL), flags.data(), flags.size()));
+
+	int type, size;
+	const void* values;
+	const uint8_t* assigned;
+	ASSERT_EQ(HF_STATUS::OK, GetNodeAttributePointers(&G, "flag", &type, &values, &assigned, &size));
+	ASSERT_EQ(static_cast<int>(NODE_ATTRIBUTE_TYPE::BOOL), type);
+	ASSERT_EQ(5, size);
+	for (int i = 0; i < 5; i++) {
+		ASSERT_EQ(flags[i], static_cast<const uint8_t*>(values)[i]);
+		ASSERT_EQ(1, assigned[i]);
+	}
+
+	// String attributes have no value pointer, but still report which nodes are assigned
+	ASSERT_EQ(HF_STATUS::OK, GetNodeAttributePointers(&G, test_attribute.c_str(), &type, &values, &assigned, &size));
+	ASSERT_EQ(static_cast<int>(NODE_ATTRIBUTE_TYPE::STRING), type);
+	ASSERT_EQ(nullptr, values);
+
+	ASSERT_EQ(HF_STATUS::NOT_FOUND, GetNodeAttributePointers(&G, "missing", &type, &values, &assigned, &size));
+	ASSERT_EQ(HF_STATUS::OUT_OF_RANGE, SetNodeAttributeColumn(&G, "flag", 7, flags.data(), flags.size()));
+}
+
+/*! \brief Create a graph with nodes at random positions for testing the node index. */
+Graph CreateRandomNodeGraph(int num_nodes) {
+	std::mt19937 gen(5);
+	std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+
+	Graph G;
+	Node last(0, 0, 0);
+	for (int i = 0; i < num_nodes; i++) {
+		Node next(dist(gen), dist(gen), dist(gen) / 10.0f);
+		G.addEdge(last, next, 1);
+		last = next;
+	}
+	G.Compress();
+	return G;
+}
+
+/*! \brief Get every node sorted by its distance to a point using only the given axes. */
+vector<std::pair<float, int>> BruteForceDistances(const Graph& G, const std::array<float, 3>& point, bool x, bool y, bool z) {
+	vector<std::pair<float, int>> distances;
+	for (const auto& node : G.Nodes()) {
+		const float dx = x ? node.x - point[0] : 0;
+		const float dy = y ? node.y - point[1] : 0;
+		const float dz = z ? node.z - point[2] : 0;
+		distances.emplace_back(std::sqrt(dx * dx + dy * dy + dz * dz), node.id);
+	}
+	std::sort(distances.begin(), distances.end());
+	return distances;
+}
+
+TEST(_NodeIndex, MatchesBruteForce) {
+	Graph G = CreateRandomNodeGraph(2000);
+
+	std::mt19937 gen(12);
+	std::uniform_real_distribution<float> dist(-120.0f, 120.0f);
+
+	for (const auto& axes : vector<std::array<bool, 3>>{ {true, true, true}, {true, true, false} }) {
+		const NodeIndex& index = G.GetNodeIndex(axes[0], axes[1], axes[2]);
+		ASSERT_EQ(G.size(), index.size());
+
+		for (int i = 0; i < 100; i++) {
+			const std::array<float, 3> point = { dist(gen), dist(gen), dist(gen) / 10.0f };
+			const auto expected = BruteForceDistances(G, point, axes[0], axes[1], axes[2]);
+
+			// Nearest
+			float distance;
+			ASSERT_EQ(expected[0].second, index.Nearest(point, &distance));
+			ASSERT_NEAR(expected[0].first, distance, 0.001);
+
+			// K nearest
+			vector<int> ids;
+			vector<float> distances;
+			index.KNearest(point, 10, ids, distances);
+			ASSERT_EQ(10, ids.size());
+			for (int k = 0; k < 10; k++)
+				ASSERT_NEAR(expected[k].first, distances[k], 0.001);
+
+			// Radius
+			index.WithinRadius(point, 15.0f, ids, distances);
+			const auto num_in_range = std::count_if(expected.begin(), expected.end(),
+				[](const auto& pair) { return pair.first <= 15.0f; });
+			ASSERT_EQ(num_in_range, ids.size());
+			for (int k = 0; k < ids.size(); k++)
+				ASSERT_NEAR(expected[k].first, distances[k], 0.001);
+		}
+	}
+}
+
+TEST(_NodeIndex, Batched) {
+	//! [EX_GetNodeIndex]
+
+	// Create a graph with a few nodes along the x axis
+	Graph G;
+	G.addEdge(Node(0, 0, 0), Node(1, 0, 0), 1);
+	G.addEdge(Node(1, 0, 0), Node(2, 0, 0), 1);
+	G.addEdge(Node(2, 0, 0), Node(5, 0, 1), 1);
+	G.Compress();
+
+	// Find the closest node to two points in plan, ignoring z
+	const NodeIndex& index = G.GetNodeIndex(true, true, false);
+	const vector<float> points = { 1.2f, 0.0f,   4.0f, 1.0f };
+	vector<int> closest(2);
+	index.Nearest(points.data(), 2, closest.data());
+
+	// closest is { 1, 3 }
+
+	//! [EX_GetNodeIndex]
+	ASSERT_EQ(1, closest[0]);
+	ASSERT_EQ(3, closest[1]);
+
+	// Asking for more nodes than the graph has pads the results
+	vector<int> k_ids(5 * 2);
+	vector<float> k_distances(5 * 2);
+	index.KNearest(points.data(), 2, 5, k_ids.data(), k_distances.data());
+	ASSERT_EQ(vector<int>({ 1, 2, 0, 3, -1 }), vector<int>(k_ids.begin(), k_ids.begin() + 5));
+	ASSERT_TRUE(std::isnan(k_distances[4]));
+
+	// Radius queries are grouped by point
+	vector<int> offsets, ids;
+	vector<float> distances;
+	index.WithinRadius(points.data(), 2, 1.5f, offsets, ids, distances);
+	ASSERT_EQ(vector<int>({ 0, 3, 4 }), offsets);
+	ASSERT_EQ(vector<int>({ 1, 2, 0, 3 }), ids);
+}
+
+TEST(_NodeIndex, RebuiltWhenNodesAdded) {
+	Graph G;
+	G.addEdge(Node(0, 0, 0), Node(1, 0, 0), 1);
+	ASSERT_EQ(1, G.GetNodeIndex().Nearest({ 10, 0, 0 }));
+
+	// Adding a node should invalidate the old index
+	G.addEdge(Node(1, 0, 0), Node(9, 0, 0), 1);
+	ASSERT_EQ(2, G.GetNodeIndex().Nearest({ 10, 0, 0 }));
+
+	G.Clear();
+	ASSERT_EQ(-1, G.GetNodeIndex().Nearest({ 10, 0, 0 }));
+}
+
+TEST(C_Graph, NearestNodeQueries) {
+	Graph G = CreateRandomNodeGraph(500);
+	const vector<float> points = { 10, 10, 0,   -50, 20, 1,   90, -90, 0 };
+
+	vector<int> ids(3);
+	vector<float> distances(3);
+	ASSERT_EQ(HF_STATUS::OK, GetClosestNodes(&G, points.data(), 3, true, true, true, ids.data(), distances.data()));
+	for (int i = 0; i < 3; i++)
+		ASSERT_EQ(BruteForceDistances(G, { points[i * 3], points[i * 3 + 1], points[i * 3 + 2] }, true, true, true)[0].second, ids[i]);
+
+	vector<int> k_ids(3 * 4);
+	ASSERT_EQ(HF_STATUS::OK, GetKNearestNodes(&G, points.data(), 3, 4, true, true, true, k_ids.data(), nullptr));
+	ASSERT_EQ(ids[1], k_ids[4]);
+	ASSERT_EQ(HF_STATUS::OUT_OF_RANGE, GetKNearestNodes(&G, points.data(), 3, 0, true, true, true, k_ids.data(), nullptr));
+
+	std::vector<int>* offsets_vector, * ids_vector;
+	std::vector<float>* distances_vector;
+	int* offsets_data, * ids_data;
+	float* distances_data;
+	int size;
+	ASSERT_EQ(HF_STATUS::OK, GetNodesWithinRadius(&G, points.data(), 3, 20.0f, true, true, true,
+		&offsets_vector, &offsets_data, &ids_vector, &ids_data, &distances_vector, &distances_data, &size));
+	ASSERT_EQ(size, offsets_data[3]);
+	ASSERT_EQ(ids[0], ids_data[0]);
+
+	DestroyIntVector(offsets_vector);
+	DestroyIntVector(ids_vector);
+	DestroyFloatVector(distances_vector);
+}
+
 TEST(_Rounding, addition_error)
 {
 	// define values as floats
@@ -258,6 +258,53 @@ TEST(_ViewAnalysis, AllRaysHit) {
 	ASSERT_LT(scores[1], scores[0]);
 }
 
+// Streaming results in chunks should produce the same results as analyzing every node at once
+TEST(_ViewAnalysis, SphericalViewAnalysisStream) {
+	auto MI = LoadMeshObjects(big_teapot_path);
+	EmbreeRayTracer ERT(MI);
+
+	std::vector<std::array<float, 3>> points;
+	for (int i = 0; i < 10; i++)
+		points.push_back({ static_cast<float>(i) - 5.0f, -5.0f, 0.0f });
+
+	auto expected = ViewAnalysis::SphericalViewAnalysis<RayResult>(ERT, points, 100);
+
+	//! [EX_SphericalViewAnalysisStream]
+
+	// Count the number of rays that hit something for every node, 3 nodes at a time. Only the
+	// results of the current chunk are kept in memory.
+	std::vector<int> hit_counts(points.size(), 0);
+	std::vector<RayResult> streamed_results;
+	const int rays_per_node = ViewAnalysis::FibbonacciDistributePoints(100).size();
+
+	int num_directions = ViewAnalysis::SphericalViewAnalysisStream<RayResult>(
+		ERT, points, 100,
+		[&](int start, int count, const RayResult* results) {
+			for (int i = 0; i < count; i++)
+				for (int k = 0; k < rays_per_node; k++)
+					if (results[i * rays_per_node + k].meshid >= 0)
+						hit_counts[start + i]++;
+
+			streamed_results.insert(streamed_results.end(), results, results + count * rays_per_node);
+		},
+		3
+	);
+
+	//! [EX_SphericalViewAnalysisStream]
+
+	ASSERT_EQ(expected.size(), points.size() * num_directions);
+	ASSERT_EQ(expected.size(), streamed_results.size());
+	for (int i = 0; i < expected.size(); i++) {
+		ASSERT_EQ(expected[i].meshid, streamed_results[i].meshid);
+		ASSERT_EQ(expected[i].distance, streamed_results[i].distance);
+	}
+
+	EXPECT_THROW(
+		ViewAnalysis::SphericalViewAnalysisStream<RayResult>(ERT, points, 100, [](int, int, const RayResult*) {}, 0),
+		std::out_of_range
+	);
+}
+
 TEST(_ViewAnalysis, FibbonacciGeneratesRightAmtOfRays) {
 	ASSERT_EQ(ViewAnalysis::FibbonacciDistributePoints(100).size(), 100);
 }
@@ -766,3 +813,61 @@ TEST(C_ViewAnalysisCInterface, SphericalViewAnalysisNoAggregate) {
 	DestroyMeshInfo(MI);
 	DestroyRayTracer(ert);
 }
+
+TEST(C_ViewAnalysisCInterface, ViewAnalysisStream) {
+	auto MI = LoadMeshObjects(big_teapot_path);
+	EmbreeRayTracer ERT(MI);
+
+	std::vector<float> nodes;
+	for (int i = 0; i < 5; i++) {
+		nodes.push_back(i); nodes.push_back(-5); nodes.push_back(0);
+	}
+	const int num_nodes = nodes.size() / 3;
+
+	// Get the results of every node at once to compare against
+	int expected_rays = 50;
+	std::vector<RayResult>* expected;
+	RayResult* expected_ptr;
+	SphericalViewAnalysisNoAggregateFlat(
+		&ERT, nodes.data(), num_nodes, &expected_rays, 50.0f, 70.0f, 1.7f, &expected, &expected_ptr
+	);
+
+	// Create a stream that analyzes two nodes at a time
+	int max_rays = 50;
+	ViewAnalysisStream* stream;
+	auto res = CreateViewAnalysisStream(&ERT, nodes.data(), num_nodes, &max_rays, 50.0f, 70.0f, 1.7f, 2, &stream);
+	ASSERT_EQ(HF::Exceptions::HF_STATUS::OK, res);
+	ASSERT_EQ(expected_rays, max_rays);
+
+	// Iterate through every chunk until the stream is empty
+	int num_chunks = 0;
+	int next_start = 0;
+	RayResult* chunk;
+	int start, count;
+	while (ViewAnalysisStreamNext(stream, &chunk, &start, &count) == HF::Exceptions::HF_STATUS::OK && count > 0) {
+		ASSERT_EQ(next_start, start);
+		for (int i = 0; i < count * max_rays; i++) {
+			ASSERT_EQ(expected_ptr[start * max_rays + i].meshid, chunk[i].meshid);
+			ASSERT_EQ(expected_ptr[start * max_rays + i].distance, chunk[i].distance);
+		}
+		next_start += count;
+		num_chunks++;
+	}
+	ASSERT_EQ(3, num_chunks);
+	ASSERT_EQ(num_nodes, next_start);
+
+	DestroyViewAnalysisStream(stream);
+	DestroyRayResultVector(expected);
+
+	// A chunk size of zero is invalid
+	res = CreateViewAnalysisStream(&ERT, nodes.data(), num_nodes, &max_rays, 50.0f, 70.0f, 1.7f, 0, &stream);
+	ASSERT_EQ(HF::Exceptions::HF_STATUS::OUT_OF_RANGE, res);
+
+	// Null pointers are rejected instead of dereferenced
+	res = CreateViewAnalysisStream(&ERT, nodes.data(), num_nodes, nullptr, 50.0f, 70.0f, 1.7f, 2, &stream);
+	ASSERT_EQ(HF::Exceptions::HF_STATUS::INVALID_PTR, res);
+	res = CreateViewAnalysisStream(&ERT, nodes.data(), num_nodes, &max_rays, 50.0f, 70.0f, 1.7f, 2, nullptr);
+	ASSERT_EQ(HF::Exceptions::HF_STATUS::INVALID_PTR, res);
+
+	ASSERT_EQ(HF::Exceptions::HF_STATUS::INVALID_PTR, ViewAnalysisStreamNext(nullptr, &chunk, &start, &count));
+}
@@ -11,6 +11,8 @@
 #include <string>
 #include <array>
 #include <visibility_graph_C.h>
+#include <spatialstructures_C.h>
+#include <HFExceptions.h>
 
 using namespace HF::VisibilityGraph;
 using HF::SpatialStructures::Graph;
@@ -178,6 +180,126 @@ TEST(C_VisibilityGraph, GroupConstructsValidGraph) {
 	}
 }
 
+// Nodes within the maximum distance should have exactly the same edges as AllToAll
+TEST(_VisibilityGraph, CulledMatchesAllToAllWithinDistance) {
+	auto raytracer = CreatePlaneTracer();
+
+	vector<Node> nodes;
+	for (int i = -5; i < 5; i++)
+		for (int k = -5; k < 5; k++)
+			nodes.emplace_back(Node(i, k, 0));
+
+	const float max_distance = 2.5f;
+	auto full_graph = AllToAll(raytracer, nodes);
+	auto culled_graph = AllToAllCulled(raytracer, nodes, 1.7f, max_distance);
+	auto unlimited_graph = AllToAllCulled(raytracer, nodes, 1.7f, -1.0f);
+	auto undirected_graph = AllToAllUndirectedCulled(raytracer, nodes, 1.7f, max_distance);
+
+	for (const auto& node : nodes) {
+		int expected_count = 0;
+		for (const auto& edge : full_graph[node])
+			if (edge.score <= max_distance) expected_count++;
+
+		ASSERT_EQ(expected_count, culled_graph[node].size());
+		ASSERT_EQ(full_graph[node].size(), unlimited_graph[node].size());
+		for (const auto& edge : culled_graph[node])
+			ASSERT_LE(edge.score, max_distance);
+	}
+
+	// Every pair should only be stored once in the undirected graph
+	auto directed_counts = culled_graph.AggregateGraph(HF::SpatialStructures::COST_AGGREGATE::COUNT);
+	auto undirected_counts = undirected_graph.AggregateGraph(HF::SpatialStructures::COST_AGGREGATE::COUNT, false);
+	for (int i = 0; i < directed_counts.size(); i++)
+		ASSERT_EQ(directed_counts[i], undirected_counts[i]);
+}
+
+// Nodes should only connect to nodes inside of their field of view
+TEST(_VisibilityGraph, CulledFieldOfView) {
+	auto raytracer = CreatePlaneTracer();
+
+	//! [EX_AllToAllCulled]
+
+	// Create a row of nodes along the x axis
+	vector<Node> nodes;
+	for (int i = 0; i < 10; i++)
+		nodes.emplace_back(Node(i, 0, 0));
+
+	// Only connect nodes within 3 meters of eachother, and only if they're
+	// inside a 90 degree cone facing the positive x direction
+	float max_distance = 3.0f;
+	float fov = 90.0f;
+	std::vector<std::array<float, 3>> view_directions = { {1, 0, 0} };
+
+	Graph graph = AllToAllCulled(raytracer, nodes, 1.7f, max_distance, fov, view_directions);
+
+	//! [EX_AllToAllCulled]
+
+	for (int i = 0; i < nodes.size(); i++) {
+		auto edges = graph[nodes[i]];
+		ASSERT_EQ(std::min(3, 9 - i), edges.size());
+		for (const auto& edge : edges)
+			ASSERT_GT(edge.child.x, nodes[i].x);
+	}
+
+	// A view direction must be given when the field of view is enabled
+	EXPECT_THROW(AllToAllCulled(raytracer, nodes, 1.7f, max_distance, fov), std::out_of_range);
+}
+
+// Walls should still block nodes within the maximum distance
+TEST(_VisibilityGraph, CulledGroupToGroup) {
+	vector<MeshInfo> meshInfos = LoadMeshObjects(walled_plane_path, HF::Geometry::ONLY_FILE, true);
+	EmbreeRayTracer walled_tracer(meshInfos);
+
+	vector<Node> from = { Node(0, -1, 0), Node(20, -1, 0) };
+	vector<Node> to = { Node(0, -2, 0), Node(0, 1, 0) };
+
+	auto graph = GroupToGroupCulled(walled_tracer, from, to, 1.7f, 5.0f);
+	auto counts = graph.AggregateGraph(HF::SpatialStructures::COST_AGGREGATE::COUNT);
+
+	// The first node can only see the node on its side of the wall, and the
+	// second node is too far away to see either
+	ASSERT_EQ(4, graph.size());
+	ASSERT_EQ(1, counts[0]);
+	ASSERT_EQ(0, counts[1]);
+}
+
+TEST(C_VisibilityGraph, CulledVisibilityGraphs) {
+	auto raytracer = CreatePlaneTracer();
+
+	vector<float> nodes;
+	for (int i = 0; i < 10; i++) {
+		nodes.push_back(i); nodes.push_back(0); nodes.push_back(0);
+	}
+	const int num_nodes = nodes.size() / 3;
+	vector<float> view_direction = { 1, 0, 0 };
+
+	Graph* directed;
+	auto res = CreateVisibilityGraphAllToAllCulled(
+		&raytracer, nodes.data(), num_nodes, &directed, 1.7f, 3.0f, 90.0f, view_direction.data(), 1, -1
+	);
+	ASSERT_EQ(HF::Exceptions::HF_STATUS::OK, res);
+	auto counts = directed->AggregateGraph(HF::SpatialStructures::COST_AGGREGATE::COUNT);
+	ASSERT_EQ(3, counts[0]);
+	ASSERT_EQ(0, counts[9]);
+	DestroyGraph(directed);
+
+	Graph* undirected;
+	res = CreateVisibilityGraphAllToAllUndirectedCulled(&raytracer, nodes.data(), num_nodes, &undirected, 1.7f, 1.5f, -1);
+	ASSERT_EQ(HF::Exceptions::HF_STATUS::OK, res);
+	counts = undirected->AggregateGraph(HF::SpatialStructures::COST_AGGREGATE::COUNT);
+	ASSERT_EQ(1, counts[0]);
+	ASSERT_EQ(0, counts[9]);
+	DestroyGraph(undirected);
+
+	// Two view directions is invalid for ten nodes
+	vector<float> two_directions = { 1, 0, 0, 0, 1, 0 };
+	Graph* invalid;
+	res = CreateVisibilityGraphAllToAllCulled(
+		&raytracer, nodes.data(), num_nodes, &invalid, 1.7f, 3.0f, 90.0f, two_directions.data(), 2, -1
+	);
+	ASSERT_EQ(HF::Exceptions::HF_STATUS::OUT_OF_RANGE, res);
+}
+
 ///
 ///	The following are tests for the code samples for HF::VisibilityGraph
 ///
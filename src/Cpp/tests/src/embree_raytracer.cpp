@@ -8,6 +8,7 @@
 #include <cmath>
 #include <iostream>
 #include <fstream>
+#include <cstring>
 #include <view_analysis.h>
 #include <HFExceptions.h>
 
@@ -445,6 +446,64 @@ TEST(_EmbreeRayTracer, Occlusions) {
 }
 
 
+TEST(_EmbreeRayTracer, IntersectStream) {
+	EmbreeRayTracer ert = CreateRTWithPlane();
+
+	// Create enough rays to fill several streams, with every other ray pointing away from the plane
+	const int num_rays = (RAY_STREAM_SIZE * 3) + 7;
+	std::vector<std::array<float, 3>> origins(num_rays);
+	std::vector<std::array<float, 3>> directions(num_rays);
+	for (int i = 0; i < num_rays; i++) {
+		origins[i] = std::array<float, 3>{ static_cast<float>(i % 20) - 9.5f, 0.0f, 1.0f + (i % 5) };
+		directions[i] = std::array<float, 3>{ 0.0f, 0.0f, (i % 2 == 0) ? -1.0f : 1.0f };
+	}
+
+	// Cast the stream, then compare every result to a single ray cast
+	auto results = ert.IntersectStream(origins, directions);
+	ASSERT_EQ(results.size(), num_rays);
+
+	for (int i = 0; i < num_rays; i++) {
+		auto expected = ert.Intersect<float>(origins[i], directions[i]);
+		ASSERT_EQ(expected.DidHit(), results[i].DidHit());
+		if (expected.DidHit()) {
+			ASSERT_EQ(expected.meshid, results[i].meshid);
+			ASSERT_NEAR(expected.distance, results[i].distance, 0.0001);
+		}
+	}
+
+	// One origin, multiple directions
+	std::vector<std::array<float, 3>> single_origin{ {0.0f, 0.0f, 1.0f} };
+	results = ert.IntersectStream(single_origin, directions);
+	ASSERT_EQ(results.size(), num_rays);
+	for (int i = 0; i < num_rays; i++)
+		ASSERT_EQ(results[i].DidHit(), i % 2 == 0);
+
+	// Max distance should be respected
+	std::vector<std::array<float, 3>> down{ {0.0f, 0.0f, -1.0f} };
+	results = ert.IntersectStream(single_origin, down, 0.5f);
+	ASSERT_FALSE(results[0].DidHit());
+}
+
+TEST(_EmbreeRayTracer, OccludedStream) {
+	EmbreeRayTracer ert = CreateRTWithPlane();
+
+	// Origins alternate between being above and below the plane
+	const int num_rays = (RAY_STREAM_SIZE * 2) + 3;
+	std::vector<std::array<float, 3>> directions(1, std::array<float, 3>{0, 0, -1});
+	std::vector<std::array<float, 3>> origins(num_rays);
+	for (int i = 0; i < num_rays; i++)
+		origins[i] = std::array<float, 3>{ 0.0f, 0.0f, (i % 2 == 0) ? 1.0f : -1.0f };
+
+	std::vector<char> results = ert.OccludedStream(origins, directions);
+	std::vector<char> expected = ert.Occlusions(origins, directions);
+
+	ASSERT_EQ(results.size(), num_rays);
+	for (int i = 0; i < num_rays; i++) {
+		ASSERT_EQ(results[i], expected[i]);
+		ASSERT_EQ(static_cast<bool>(results[i]), i % 2 == 0);
+	}
+}
+
 TEST(_EmbreeRayTracer, OcclusionMultiOrigin) {
 	// Create Plane
 
@@ -917,6 +976,329 @@ TEST(_EmbreeRayTracer, OperatorAssignment) {
 	ert_1 = ert_0;
 }
 
+TEST(_EmbreeRayTracer, SaveLoadScene) {
+	const vector<float> plane_vertices{
+		-10.0f, 10.0f, 0.0f,
+		-10.0f, -10.0f, 0.0f,
+		10.0f, 10.0f, 0.0f,
+		10.0f, -10.0f, 0.0f,
+	};
+	const vector<int> plane_indices{ 3, 1, 0, 2, 3, 0 };
+	std::vector<MeshInfo<float>> meshes{ MeshInfo<float>(plane_vertices, plane_indices, 7, "plane") };
+	EmbreeRayTracer ert(meshes);
+
+	//! [EX_SaveLoadScene]
+
+	// Key the cache on the geometry it was built from, then save it and load it back
+	const uint64_t key = SceneCacheKey(meshes);
+	ert.SaveScene("save_load_scene.dhsc", key);
+	EmbreeRayTracer loaded = EmbreeRayTracer::LoadScene("save_load_scene.dhsc", key, false, BUILD_QUALITY::LOW);
+
+	//! [EX_SaveLoadScene]
+
+	// Hits on the loaded scene match the original, including the mesh's ID
+	const std::array<float, 3> origin{ 1.0f, 1.0f, 5.0f };
+	const std::array<float, 3> direction{ 0.0f, 0.0f, -1.0f };
+	auto expected = ert.Intersect<float>(origin, direction);
+	auto result = loaded.Intersect<float>(origin, direction);
+	ASSERT_TRUE(result.DidHit());
+	ASSERT_EQ(expected.meshid, result.meshid);
+	ASSERT_NEAR(expected.distance, result.distance, 0.0001);
+
+	// Keys depend on the geometry's contents
+	std::vector<MeshInfo<float>> moved{ MeshInfo<float>(plane_vertices, plane_indices, 8, "plane") };
+	ASSERT_NE(key, SceneCacheKey(moved));
+	ASSERT_THROW(EmbreeRayTracer::LoadScene("save_load_scene.dhsc", SceneCacheKey(moved)), std::runtime_error);
+
+	ASSERT_THROW(EmbreeRayTracer::LoadScene("this_scene_does_not_exist.dhsc"), HF::Exceptions::FileNotFound);
+	{
+		std::ofstream not_a_scene("not_a_scene.dhsc", std::ios::binary);
+		not_a_scene << "This isn't a scene cache";
+	}
+	ASSERT_THROW(EmbreeRayTracer::LoadScene("not_a_scene.dhsc"), std::runtime_error);
+
+	// The file ends with the plane's triangles, so point its last index past its vertices
+	std::ifstream in("save_load_scene.dhsc", std::ios::binary);
+	std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	in.close();
+
+	const uint32_t bad_index = 1 << 30;
+	std::memcpy(&bytes[bytes.size() - sizeof(bad_index)], &bad_index, sizeof(bad_index));
+	std::ofstream("bad_index_scene.dhsc", std::ios::binary) << bytes;
+	ASSERT_THROW(EmbreeRayTracer::LoadScene("bad_index_scene.dhsc", key), std::runtime_error);
+}
+
+TEST(_EmbreeRayTracer, EditScene) {
+	const vector<float> plane_vertices{
+		-10.0f, 10.0f, 0.0f,
+		-10.0f, -10.0f, 0.0f,
+		10.0f, 10.0f, 0.0f,
+		10.0f, -10.0f, 0.0f,
+	};
+	const vector<int> plane_indices{ 3, 1, 0, 2, 3, 0 };
+	MeshInfo<float> plane(plane_vertices, plane_indices, 0, "plane");
+	std::vector<MeshInfo<float>> meshes{ plane };
+
+	const std::array<float, 3> origin{ 1.0f, 1.0f, 5.0f };
+	const std::array<float, 3> down{ 0.0f, 0.0f, -1.0f };
+
+	//! [EX_EditScene]
+
+	// Build with low quality so edited meshes are refit instead of rebuilt
+	EmbreeRayTracer ert(meshes, false, BUILD_QUALITY::LOW);
+
+	// Raise the plane by 2 units
+	const InstanceTransform raise_by_two{ 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 2 };
+	ert.TransformMesh(0, raise_by_two);
+
+	// Remove the plane, then place two instances of it above and below the origin
+	ert.RemoveMesh(0);
+	const int prototype = ert.AddPrototype(plane);
+	const int above = ert.AddInstance(prototype, InstanceTransform{ 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 10 });
+	const int below = ert.AddInstance(prototype, InstanceTransform{ 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 1 });
+
+	// Move the lower instance
+	ert.SetInstanceTransform(below, raise_by_two);
+
+	//! [EX_EditScene]
+
+	// The lower instance is hit at its new height and reports its own ID
+	auto hit = ert.Intersect<float>(origin, down);
+	ASSERT_TRUE(hit.DidHit());
+	ASSERT_EQ(below, hit.meshid);
+	ASSERT_NEAR(3.0f, hit.distance, 0.0001);
+
+	const std::array<float, 3> up{ 0.0f, 0.0f, 1.0f };
+	hit = ert.Intersect<float>(origin, up);
+	ASSERT_EQ(above, hit.meshid);
+	ASSERT_NEAR(5.0f, hit.distance, 0.0001);
+
+	// Instances are preserved by the scene cache
+	ert.SaveScene("edit_scene.dhsc");
+	auto loaded = EmbreeRayTracer::LoadScene("edit_scene.dhsc");
+	hit = loaded.Intersect<float>(origin, down);
+	ASSERT_EQ(below, hit.meshid);
+	ASSERT_NEAR(3.0f, hit.distance, 0.0001);
+
+	// Removed meshes and instances can no longer be hit or edited
+	ASSERT_FALSE(ert.RemoveMesh(0));
+	ASSERT_TRUE(ert.RemoveMesh(below));
+	ASSERT_FALSE(ert.SetInstanceTransform(below, raise_by_two));
+	ASSERT_FALSE(ert.Occluded(origin, down));
+	ASSERT_THROW(ert.AddInstance(prototype + 1, raise_by_two), std::out_of_range);
+
+	// Copies share the scene, so a mesh removed through one copy is gone from all of them
+	EmbreeRayTracer copy = ert;
+	ASSERT_TRUE(copy.RemoveMesh(above));
+	ASSERT_FALSE(ert.RemoveMesh(above));
+	ASSERT_FALSE(ert.Intersect<float>(origin, up).DidHit());
+}
+
+TEST(_EmbreeRayTracer, UpdateMesh) {
+	const vector<float> plane_vertices{
+		-10.0f, 10.0f, 0.0f,
+		-10.0f, -10.0f, 0.0f,
+		10.0f, 10.0f, 0.0f,
+		10.0f, -10.0f, 0.0f,
+	};
+	const vector<int> plane_indices{ 3, 1, 0, 2, 3, 0 };
+	std::vector<MeshInfo<float>> meshes{ MeshInfo<float>(plane_vertices, plane_indices, 0, "plane") };
+	EmbreeRayTracer ert(meshes, false, BUILD_QUALITY::LOW);
+
+	const std::array<float, 3> origin{ 1.0f, 1.0f, 5.0f };
+	const std::array<float, 3> down{ 0.0f, 0.0f, -1.0f };
+
+	// Move every vertex up by 1 in place
+	vector<float> raised = meshes[0].GetIndexedVertices();
+	for (int i = 2; i < raised.size(); i += 3)
+		raised[i] += 1.0f;
+	ASSERT_TRUE(ert.UpdateMeshVertices(0, raised));
+	ASSERT_NEAR(4.0f, ert.Intersect<float>(origin, down).distance, 0.0001);
+
+	// The number of vertices must match
+	ASSERT_FALSE(ert.UpdateMeshVertices(0, vector<float>{ 0, 0, 0 }));
+	ASSERT_FALSE(ert.UpdateMeshVertices(5, raised));
+
+	// Replacing the triangles with two copies of the first one keeps the same counts, but
+	// the BVH must be rebuilt so the half of the plane that's no longer covered is missed
+	MeshInfo<float> half_plane(raised, vector<int>{ 3, 1, 0, 3, 1, 0 }, 0, "half_plane");
+	ASSERT_TRUE(ert.ReplaceMesh(half_plane));
+	ASSERT_TRUE(ert.Intersect<float>(std::array<float, 3>{ -5.0f, -2.0f, 5.0f }, down).DidHit());
+	ASSERT_FALSE(ert.Intersect<float>(std::array<float, 3>{ 5.0f, 2.0f, 5.0f }, down).DidHit());
+
+	// Replacing with a single triangle changes the mesh's topology but keeps its ID
+	MeshInfo<float> triangle(vector<float>{ -10, -10, 2, 10, -10, 2, 0, 10, 2 }, vector<int>{ 0, 1, 2 }, 0, "triangle");
+	ASSERT_TRUE(ert.ReplaceMesh(triangle));
+	auto hit = ert.Intersect<float>(std::array<float, 3>{ 0.0f, 0.0f, 5.0f }, down);
+	ASSERT_EQ(0, hit.meshid);
+	ASSERT_NEAR(3.0f, hit.distance, 0.0001);
+}
+
+TEST(_EmbreeRayTracer, AddMeshShared) {
+	//! [EX_AddMeshShared]
+	const vector<float> plane_vertices{
+		-10.0f, 10.0f, 0.0f,
+		-10.0f, -10.0f, 0.0f,
+		10.0f, 10.0f, 0.0f,
+		10.0f, -10.0f, 0.0f,
+	};
+	const vector<int> plane_indices{ 3, 1, 0, 2, 3, 0 };
+	MeshInfo<float> plane(plane_vertices, plane_indices, 4, "plane");
+
+	// Hand the plane's buffers to embree instead of copying them
+	EmbreeRayTracer ert(false, BUILD_QUALITY::LOW);
+	ert.AddMesh(std::move(plane), true);
+
+	const std::array<float, 3> origin{ 1.0f, 1.0f, 5.0f };
+	const std::array<float, 3> down{ 0.0f, 0.0f, -1.0f };
+	auto hit = ert.Intersect<float>(origin, down);
+	//! [EX_AddMeshShared]
+
+	// The plane keeps its ID, but no longer has any geometry
+	ASSERT_EQ(4, plane.meshid);
+	ASSERT_EQ(0, plane.NumVerts());
+	ASSERT_EQ(0, plane.NumTris());
+
+	ASSERT_EQ(4, hit.meshid);
+	ASSERT_NEAR(5.0f, hit.distance, 0.0001);
+
+	// Shared buffers can still be edited, and outlive the raytracer they were added to
+	EmbreeRayTracer copy(ert);
+	{
+		EmbreeRayTracer other = ert;
+	}
+	ASSERT_TRUE(copy.TransformMesh(4, HF::RayTracer::InstanceTransform{ 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 2 }));
+	ASSERT_NEAR(3.0f, copy.Intersect<float>(origin, down).distance, 0.0001);
+
+	// Constructing from a vector of meshes gives the same results as copying them
+	std::vector<MeshInfo<float>> copied_meshes{ MeshInfo<float>(plane_vertices, plane_indices, 0, "plane") };
+	std::vector<MeshInfo<float>> moved_meshes = copied_meshes;
+	EmbreeRayTracer copied(copied_meshes);
+	EmbreeRayTracer moved(std::move(moved_meshes));
+	ASSERT_EQ(copied.Intersect<float>(origin, down).distance, moved.Intersect<float>(origin, down).distance);
+}
+
+TEST(_EmbreeRayTracer, AddMeshSharedInvalid) {
+	const vector<float> plane_vertices{ -10, 10, 0, -10, -10, 0, 10, 10, 0, 10, -10, 0 };
+	const vector<int> plane_indices{ 3, 1, 0, 2, 3, 0 };
+
+	// The second mesh has already given its buffers away, so it has no triangles
+	MeshInfo<float> empty(plane_vertices, plane_indices, 6, "empty");
+	EmbreeRayTracer other(false, BUILD_QUALITY::LOW);
+	other.AddMesh(std::move(empty), true);
+
+	std::vector<MeshInfo<float>> meshes{ MeshInfo<float>(plane_vertices, plane_indices, 5, "plane"), empty };
+
+	EmbreeRayTracer ert(false, BUILD_QUALITY::LOW);
+	EXPECT_THROW(ert.AddMesh(std::move(meshes), true), HF::Exceptions::InvalidOBJ);
+
+	// Nothing should have been taken from the valid mesh or added to the scene
+	ASSERT_EQ(2, meshes[0].NumTris());
+	ASSERT_EQ(4, meshes[0].NumVerts());
+	EXPECT_FALSE(ert.RemoveMesh(5));
+}
+
+TEST(_EmbreeRayTracer, FindClosestPoint) {
+	const vector<int> quad_indices{ 0, 1, 2, 0, 2, 3 };
+	MeshInfo<float> floor(vector<float>{ -10, -10, 0, 10, -10, 0, 10, 10, 0, -10, 10, 0 }, quad_indices, 0, "floor");
+	MeshInfo<float> wall(vector<float>{ 3, -10, 0, 3, 10, 0, 3, 10, 5, 3, -10, 5 }, quad_indices, 1, "wall");
+	vector<MeshInfo<float>> meshes{ floor, wall };
+
+	//! [EX_FindClosestPoint]
+
+	EmbreeRayTracer ert(meshes);
+	const std::array<float, 3> point{ 1.0f, 0.0f, 1.0f };
+
+	// The floor directly below the point is closest
+	ClosestPoint closest = ert.FindClosestPoint(point);
+
+	// Ignore the floor to find the distance to the wall
+	ClosestPoint closest_wall = ert.FindClosestPoint(point, -1.0f, true);
+
+	//! [EX_FindClosestPoint]
+
+	ASSERT_TRUE(closest.DidHit());
+	ASSERT_EQ(0, closest.meshid);
+	ASSERT_NEAR(1.0f, closest.distance, 0.0001);
+	ASSERT_NEAR(0.0f, closest.point[2], 0.0001);
+
+	ASSERT_EQ(1, closest_wall.meshid);
+	ASSERT_NEAR(2.0f, closest_wall.distance, 0.0001);
+	ASSERT_NEAR(3.0f, closest_wall.point[0], 0.0001);
+	ASSERT_NEAR(1.0f, closest_wall.point[2], 0.0001);
+
+	// Nothing is found past the maximum distance
+	ASSERT_FALSE(ert.FindClosestPoint(point, 0.5f).DidHit());
+
+	// Filtered meshes are skipped
+	const auto skip_floor = MeshFilter::Except({ 0 });
+	ASSERT_EQ(1, ert.FindClosestPoint(point, -1.0f, false, &skip_floor).meshid);
+
+	// Instances are checked in world space and report their own ID
+	const int prototype = ert.AddPrototype(wall);
+	const int instance = ert.AddInstance(prototype, InstanceTransform{ 1, 0, 0, 0, 1, 0, 0, 0, 1, -3.5f, 0, 0 });
+	closest_wall = ert.FindClosestPoint(point, -1.0f, true);
+	ASSERT_EQ(instance, closest_wall.meshid);
+	ASSERT_NEAR(1.5f, closest_wall.distance, 0.0001);
+	ASSERT_NEAR(-0.5f, closest_wall.point[0], 0.0001);
+
+	// Batches match single queries
+	const vector<std::array<float, 3>> points{ point, { 2.5f, 1.0f, 1.0f }, { -20.0f, 0.0f, 1.0f } };
+	const auto results = ert.FindClosestPoints(points, -1.0f, true);
+	ASSERT_EQ(points.size(), results.size());
+	for (int i = 0; i < points.size(); i++) {
+		const auto single = ert.FindClosestPoint(points[i], -1.0f, true);
+		ASSERT_EQ(single.meshid, results[i].meshid);
+		ASSERT_FLOAT_EQ(single.distance, results[i].distance);
+	}
+}
+
+TEST(_EmbreeRayTracer, FilteredIntersect) {
+	const vector<float> plane_vertices{
+		-10.0f, 10.0f, 0.0f,
+		-10.0f, -10.0f, 0.0f,
+		10.0f, 10.0f, 0.0f,
+		10.0f, -10.0f, 0.0f,
+	};
+	const vector<int> plane_indices{ 3, 1, 0, 2, 3, 0 };
+	const vector<float> canopy_vertices{
+		-10.0f, 10.0f, 3.0f,
+		-10.0f, -10.0f, 3.0f,
+		10.0f, 10.0f, 3.0f,
+		10.0f, -10.0f, 3.0f,
+	};
+	MeshInfo<float> floor(plane_vertices, plane_indices, 0, "floor");
+	MeshInfo<float> canopy(canopy_vertices, plane_indices, 1, "canopy");
+
+	vector<MeshInfo<float>> meshes{ floor, canopy };
+	EmbreeRayTracer ert(meshes);
+	const std::array<float, 3> origin{ 1.0f, 1.0f, 5.0f };
+	const std::array<float, 3> down{ 0.0f, 0.0f, -1.0f };
+
+	//! [EX_FilteredIntersect]
+
+	// Without a filter the ray hits the canopy 2 units below it
+	auto hit = ert.Intersect<float>(origin, down);
+	ASSERT_EQ(1, hit.meshid);
+
+	// Reject the canopy so the ray continues through it to the floor
+	const auto skip_canopy = MeshFilter::Except({ 1 });
+	hit = ert.Intersect<float>(origin, down, -1.0f, -1, &skip_canopy);
+
+	//! [EX_FilteredIntersect]
+
+	ASSERT_TRUE(hit.DidHit());
+	ASSERT_EQ(0, hit.meshid);
+	ASSERT_NEAR(5.0f, hit.distance, 0.0001);
+
+	// Occlusion rays ignore every mesh the filter rejects
+	const auto only_canopy = MeshFilter::Only({ 1 });
+	ASSERT_TRUE(ert.Occluded(origin, down, -1.0f, -1, &only_canopy));
+	ASSERT_FALSE(ert.Occluded(origin, down, 1.0f, -1, &only_canopy));
+	const auto only_missing = MeshFilter::Only({ 4 });
+	ASSERT_FALSE(ert.Occluded(origin, down, -1.0f, -1, &only_missing));
+}
+
 TEST(_FullRayRequest, ConstructorArgs) {
 	// Requires #include "RayRequest.h"
 
@@ -11,6 +11,7 @@
 #include <view_analysis.h>
 #include <HFExceptions.h>
 #include <ray_data.h>
+#include <MultiRT.h>
 
 #include <objloader_C.h>
 #include <raytracer_C.h>
@@ -128,6 +129,141 @@ TEST(_nanoRayTracer, NanoRayTracerBasic) {
 	ASSERT_EQ(10, origins[1][2]);
 }
 
+/*! \brief Create a square plane at a given height with a specific meshid. */
+static MeshInfo<float> CreatePlane(float height, int id) {
+	const vector<float> vertices = {
+		-10, -10, height,
+		 10, -10, height,
+		 10,  10, height,
+		-10,  10, height
+	};
+	const vector<int> indices = { 0, 1, 2, 0, 2, 3 };
+	return MeshInfo<float>(vertices, indices, id, "plane_" + std::to_string(id));
+}
+
+TEST(_nanoRayTracer, MultipleMeshes) {
+	// Stack two planes with different ids on top of eachother
+	vector<MeshInfo<float>> meshes = { CreatePlane(0, 3), CreatePlane(5, 7) };
+	HF::RayTracer::NanoRTRayTracer ray_tracer(meshes);
+
+	ASSERT_EQ(4, ray_tracer.NumTris());
+
+	// Cast a ray down from above both planes, then a ray down from between them
+	const array<double, 3> direction{ 0, 0, -1 };
+	auto top_hit = ray_tracer.Intersect(array<double, 3>{ 1, 1, 10 }, direction);
+	auto bottom_hit = ray_tracer.Intersect(array<double, 3>{ 1, 1, 2 }, direction);
+
+	ASSERT_TRUE(top_hit.DidHit());
+	EXPECT_EQ(7, top_hit.meshid);
+	EXPECT_NEAR(5, top_hit.distance, 0.0001);
+
+	ASSERT_TRUE(bottom_hit.DidHit());
+	EXPECT_EQ(3, bottom_hit.meshid);
+	EXPECT_NEAR(2, bottom_hit.distance, 0.0001);
+}
+
+TEST(_nanoRayTracer, FilteredIntersect) {
+	vector<MeshInfo<float>> meshes = { CreatePlane(0, 3), CreatePlane(5, 7) };
+	HF::RayTracer::NanoRTRayTracerFloat ray_tracer(meshes);
+
+	const array<double, 3> origin{ 1, 1, 10 };
+	const array<double, 3> direction{ 0, 0, -1 };
+
+	// Rays pass through the top plane when it's rejected
+	const auto skip_top = MeshFilter::Except({ 7 });
+	auto hit = ray_tracer.Intersect(origin, direction, -1.0, -1, &skip_top);
+	ASSERT_TRUE(hit.DidHit());
+	EXPECT_EQ(3, hit.meshid);
+	EXPECT_NEAR(10, hit.distance, 0.0001);
+
+	// Filters that accept every mesh match unfiltered rays
+	const auto accept_all = MeshFilter();
+	EXPECT_EQ(7, ray_tracer.Intersect(origin, direction, -1.0, -1, &accept_all).meshid);
+
+	// Nothing is hit when neither plane is accepted
+	auto only_missing = MeshFilter::Only({ 2 });
+	EXPECT_FALSE(ray_tracer.Occluded(origin, direction, -1, -1, &only_missing));
+
+	// Meshes can be added to and removed from a filter one at a time
+	only_missing.SetListed(3, true);
+	EXPECT_EQ(3, ray_tracer.Intersect(origin, direction, -1.0, -1, &only_missing).meshid);
+	only_missing.SetListed(3, false);
+	EXPECT_FALSE(ray_tracer.Occluded(origin, direction, -1, -1, &only_missing));
+}
+
+TEST(_nanoRayTracer, FloatMatchesDouble) {
+	auto mesh = HF::Geometry::LoadMeshObjects("VisibilityTestCases.obj")[0];
+
+	HF::RayTracer::NanoRTRayTracer double_rt(mesh);
+	HF::RayTracer::NanoRTRayTracerFloat float_rt(mesh, false);
+
+	const array<double, 3> direction{ 0, 0, -1 };
+	for (double x = 0; x < 30; x += 0.5) {
+		const array<double, 3> origin{ x, 10, 15 };
+		auto double_hit = double_rt.Intersect(origin, direction);
+		auto float_hit = float_rt.Intersect(origin, direction);
+
+		ASSERT_EQ(double_hit.DidHit(), float_hit.DidHit());
+		if (double_hit.DidHit()) {
+			EXPECT_NEAR(double_hit.distance, float_hit.distance, 0.001);
+			EXPECT_EQ(double_hit.meshid, float_hit.meshid);
+		}
+	}
+}
+
+TEST(_nanoRayTracer, BatchMatchesSingle) {
+	auto mesh = HF::Geometry::LoadMeshObjects("VisibilityTestCases.obj")[0];
+	HF::RayTracer::NanoRTRayTracer ray_tracer(mesh);
+
+	// Use a single direction for every origin
+	vector<array<double, 3>> origins;
+	for (double x = 0; x < 30; x += 0.25)
+		origins.push_back(array<double, 3>{ x, 10, 15 });
+	const vector<array<double, 3>> directions = { {0, 0, -1} };
+
+	auto hits = ray_tracer.Intersections(origins, directions);
+	auto occlusions = ray_tracer.Occlusions(origins, directions, 3);
+
+	ASSERT_EQ(origins.size(), hits.size());
+	ASSERT_EQ(origins.size(), occlusions.size());
+	for (int i = 0; i < origins.size(); i++) {
+		auto single_hit = ray_tracer.Intersect(origins[i], directions[0]);
+		EXPECT_EQ(single_hit.DidHit(), hits[i].DidHit());
+		EXPECT_EQ(single_hit.distance, hits[i].distance);
+		EXPECT_EQ(ray_tracer.Occluded(origins[i], directions[0], 3), static_cast<bool>(occlusions[i]));
+		EXPECT_EQ(single_hit.DidHit() && single_hit.distance <= 3, static_cast<bool>(occlusions[i]));
+	}
+}
+
+TEST(_nanoRayTracer, BatchSizeMismatch) {
+	auto mesh = HF::Geometry::LoadMeshObjects("VisibilityTestCases.obj")[0];
+	HF::RayTracer::NanoRTRayTracer ray_tracer(mesh);
+
+	const vector<array<double, 3>> two_origins = { {0, 10, 15}, {1, 10, 15} };
+	const vector<array<double, 3>> three_directions = { {0, 0, -1}, {0, 0, -1}, {0, 0, -1} };
+	const vector<array<double, 3>> no_directions;
+
+	// Sizes must match unless one of them only has a single element
+	EXPECT_THROW(ray_tracer.Intersections(two_origins, three_directions), std::runtime_error);
+	EXPECT_THROW(ray_tracer.Occlusions(two_origins, three_directions), std::runtime_error);
+	EXPECT_THROW(ray_tracer.Intersections(two_origins, no_directions), std::runtime_error);
+	EXPECT_THROW(ray_tracer.Occlusions(two_origins, no_directions), std::runtime_error);
+}
+
+TEST(_nanoRayTracer, MultiRTBatchSizeMismatch) {
+	auto mesh = HF::Geometry::LoadMeshObjects("VisibilityTestCases.obj")[0];
+	HF::RayTracer::NanoRTRayTracer ray_tracer(mesh);
+	HF::RayTracer::MultiRT multi_rt(&ray_tracer);
+
+	const vector<array<double, 3>> two_origins = { {0, 10, 15}, {1, 10, 15} };
+	const vector<array<double, 3>> three_directions = { {0, 0, -1}, {0, 0, -1}, {0, 0, -1} };
+
+	// MultiRT should reject the same sizes no matter which raytracer it holds
+	EXPECT_THROW(multi_rt.Intersections(two_origins, three_directions), std::runtime_error);
+	EXPECT_THROW(multi_rt.Occlusions(two_origins, three_directions), std::runtime_error);
+	EXPECT_EQ(2, multi_rt.Occlusions(two_origins, { three_directions[0] }).size());
+}
+
 TEST(_nanoRayTracer, nanoRayTolerance) {
 
 	std::string objFilename = "energy_blob_zup.obj";
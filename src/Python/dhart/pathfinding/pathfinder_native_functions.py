@@ -247,6 +247,52 @@ def c_calculate_distance_and_predecessor(
 
 
 
+def c_calculate_distance_matrix_to_file(
+    graph_ptr: c_void_p,
+    cost_type: str,
+    path: str,
+    format: int,
+    scale: float,
+    upper_triangle: bool,
+    tile_rows: int,
+) -> None:
+    """ Write the distance matrix of a graph to a file in C++, a few rows at a time
+
+    Args:
+        graph_ptr : Graph to calculate distances in
+        cost_type : Type of cost to use to calculate distances. Default if left blank.
+        path : Path of the file to write to
+        format : 0 to store distances as floats, 1 to store them as 16-bit integers
+        scale : Distance represented by 1 when format is 1
+        upper_triangle : Only write distances to nodes with higher IDs
+        tile_rows : Number of rows to hold in memory at a time
+
+    Raises:
+        KeyError : cost_type wasn't left blank, and didn't already exist in the graph.
+        OutOfRangeException : tile_rows was less than 1 or scale wasn't greater than 0.
+        FileNotFoundError : The file couldn't be written to.
+    """
+
+    res = HFPython.CalculateDistanceMatrixToFile(
+        graph_ptr,
+        GetStringPtr(cost_type),
+        GetStringPtr(path),
+        c_int(format),
+        c_float(scale),
+        c_bool(upper_triangle),
+        c_int(tile_rows),
+    )
+
+    if res == HF_STATUS.NO_COST:
+        raise KeyError(f"Cost Type {cost_type} was not the key to cost in the graph")
+    elif res == HF_STATUS.OUT_OF_RANGE:
+        raise OutOfRangeException()
+    elif res == HF_STATUS.NOT_FOUND:
+        raise FileNotFoundError(f"Couldn't write a distance matrix to {path}")
+
+    assert(res == HF_STATUS.OK)
+
+
 def C_DestroyPath(path_ptr: c_void_p) -> None:
     """ Delete a path in C++"""
     try:  # Sometimes the pointers need tobe converted to c_void_p again.
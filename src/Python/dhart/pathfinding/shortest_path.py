@@ -10,6 +10,7 @@ from dhart.native_collections import FloatArray2D, IntArray2D
 
 __all__ = ["ConvertNodesToIds", "DijkstraShortestPath", 
            "DijkstraFindAllShortestPaths", "calculate_distance_and_predecessor",
+           "write_distance_matrix", "read_distance_matrix",
            "AllShortestPathsCSR", "get_path_from_csr", "AlternateCostsAlongPath"]
 
 
@@ -431,6 +432,104 @@ def calculate_distance_and_predecessor(graph: Graph, cost_type: str = ""
     return (dist_matrix, pred_matrix)
 
 
+# Layout of the header written by CalculateDistanceMatrixToFile
+_distance_file_header = numpy.dtype([
+    ("magic", "S8"), ("version", "<u4"), ("format", "<u4"), ("num_nodes", "<u4"),
+    ("upper_triangle", "<u4"), ("scale", "<f4"), ("reserved", "<u4"),
+])
+
+
+def write_distance_matrix(
+    graph: Graph,
+    path: str,
+    cost_type: str = "",
+    quantize_scale: Union[float, None] = None,
+    upper_triangle: bool = False,
+    tile_rows: int = 256,
+) -> None:
+    """ Write the distance from every node to every other node to a file
+
+    Unlike calculate_distance_and_predecessor, only tile_rows rows of the
+    distance matrix are held in memory at a time and no predecessors are
+    calculated, so this can be used on graphs whose matrix wouldn't fit in
+    memory.
+
+    Args:
+        graph : Graph to calculate distances in
+        path : Path of the file to create
+        cost_type : Type of cost to use. Uses graph's default cost type if left blank
+        quantize_scale : If set, store distances as 16-bit integers in units of
+            this distance instead of as floats. Distances to unreachable nodes
+            are 65535, and distances longer than 65534 units are clamped.
+        upper_triangle : Only store the distance from each node to the nodes with
+            higher IDs. Only use this for undirected graphs.
+        tile_rows : Number of rows to hold in memory at a time
+
+    Raises:
+        KeyError : cost_type wasn't left blank, and didn't already exist in the graph.
+        OutOfRangeException : tile_rows was less than 1 or quantize_scale wasn't
+            greater than 0.
+        FileNotFoundError : The file couldn't be written to.
+
+    Examples:
+        >>> from dhart.pathfinding import write_distance_matrix, read_distance_matrix
+        >>> from dhart.spatialstructures import Graph
+
+        >>> g = Graph()
+        >>> nodes = [(1, 2, 3), (4, 5, 6), (7, 8, 9), (10, 1, 2)]
+        >>> g.AddEdgeToGraph(nodes[1], nodes[2], 20)
+        >>> g.AddEdgeToGraph(nodes[0], nodes[2], 5)
+        >>> g.AddEdgeToGraph(nodes[1], nodes[0], 10)
+        >>> csr = g.CompressToCSR()
+        >>> write_distance_matrix(g, "distances.dhdm")
+        >>> print(read_distance_matrix("distances.dhdm"))
+        [[ 0. 15. 10.]
+         [-1.  0. -1.]
+         [-1.  5.  0.]]
+
+    """
+    format = 0 if quantize_scale is None else 1
+    scale = 1.0 if quantize_scale is None else quantize_scale
+
+    pathfinder_native_functions.c_calculate_distance_matrix_to_file(
+        graph.graph_ptr, cost_type, path, format, scale, upper_triangle, tile_rows
+    )
+
+
+def read_distance_matrix(path: str, mmap: bool = True) -> numpy.ndarray:
+    """ Read a distance matrix written by write_distance_matrix
+
+    Args:
+        path : Path of the file to read
+        mmap : Map the file instead of reading it into memory
+
+    Returns:
+        A num_nodes by num_nodes array for full matrices, or a flat array of
+        every row for upper triangle matrices, where row i contains the distances
+        from node i to nodes i + 1 through num_nodes - 1. Quantized matrices are
+        returned as 16-bit integers and should be multiplied by their scale.
+
+    Raises:
+        ValueError : The file isn't a distance matrix.
+    """
+    header = numpy.fromfile(path, dtype=_distance_file_header, count=1)[0]
+    if header["magic"] != b"DHARTDM":
+        raise ValueError(f"{path} is not a distance matrix")
+
+    dtype = numpy.float32 if header["format"] == 0 else numpy.uint16
+    num_nodes = int(header["num_nodes"])
+    if header["upper_triangle"]:
+        shape = ((num_nodes * (num_nodes - 1)) // 2,)
+    else:
+        shape = (num_nodes, num_nodes)
+
+    offset = _distance_file_header.itemsize
+    if mmap:
+        return numpy.memmap(path, dtype=dtype, mode="r", offset=offset, shape=shape)
+    else:
+        return numpy.fromfile(path, dtype=dtype, offset=offset).reshape(shape)
+
+
 def AllShortestPathsCSR(
     graph: Graph,
     cost_type: str = "",
@@ -72,6 +72,49 @@ class EmbreeBVH(object):
             mesh.SetupVertAndIndexArrays()
 
 
+    def save(self, path: str, key: int = 0):
+        """ Save the geometry in this BVH to a scene cache
+
+        Loading the cache skips parsing and converting the mesh, which can
+        take much longer than building the BVH itself for large models.
+
+        Args:
+            path : Path to write the scene cache to. Any existing file will be overwritten.
+            key : Value identifying the geometry this BVH was built from, such as a
+                hash of the source file. Pass the same key to EmbreeBVH.load to make sure
+                a stale cache is never used.
+
+        Raises:
+            dhart.Exceptions.FileNotFoundException:
+                The file at path couldn't be written.
+
+        """
+        raytracer_native_functions.C_SaveRayTracerScene(self.pointer, path, key)
+
+    @staticmethod
+    def load(path: str, key: int = 0, use_precise: bool = False, build_quality: int = 2) -> "EmbreeBVH":
+        """ Create a BVH from a scene cache written by EmbreeBVH.save
+
+        Args:
+            path : Path to the scene cache.
+            key : If not 0, only load the cache if it was saved with this key.
+            use_precise : Use a more precise, but slower ray intersection function
+            build_quality : 0 to build the BVH as fast as possible for scenes that will
+                be edited, 2 to build the fastest BVH to cast rays at, or 1 for a balance.
+
+        Raises:
+            dhart.Exceptions.FileNotFoundException:
+                No file exists at path.
+            dhart.Exceptions.HFException:
+                The file isn't a valid scene cache, or was saved with a different key.
+
+        """
+        bvh = EmbreeBVH.__new__(EmbreeBVH)
+        bvh.pointer = raytracer_native_functions.C_LoadRayTracerScene(
+            path, key, use_precise, build_quality
+        )
+        return bvh
+
     def __del__(self):
         if self.pointer != 0:
             raytracer_native_functions.DestroyRayTracer(self.pointer)
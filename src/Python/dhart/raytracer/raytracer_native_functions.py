@@ -3,6 +3,7 @@ from dhart.Exceptions import *
 from dhart.common_native_functions import (
     getDLLHandle,
     ConvertPointsToArray,
+    GetStringPtr,
 )
 from typing import *
 
@@ -350,6 +351,56 @@ def C_AddMeshes(bvh_ptr: c_void_p, mesh_ptrs : List[c_void_p]):
     # Call C++ function to add the meshinfos
     HFPython.AddMeshes(bvh_ptr, pointer_array, c_int(num_meshes))
 
+def C_SaveRayTracerScene(rt_ptr: c_void_p, path: str, key: int = 0) -> None:
+    """ Save the geometry of a raytracer to a scene cache
+
+    Args:
+        rt_ptr (c_void_p): Pointer to the raytracer to save
+        path (str): Path to write the scene cache to. Any existing file will be overwritten.
+        key (int): Value identifying the geometry the scene was built from
+
+    Raises:
+        FileNotFoundException: The file at path couldn't be written
+    """
+
+    error_code = HFPython.SaveRaytracerScene(rt_ptr, GetStringPtr(path), c_uint64(key))
+
+    if error_code == HF_STATUS.NOT_FOUND:
+        raise FileNotFoundException
+
+    assert error_code == HF_STATUS.OK
+
+def C_LoadRayTracerScene(path: str, key: int = 0, use_precise: bool = False, build_quality: int = 2) -> c_void_p:
+    """ Create a raytracer from a scene cache written by C_SaveRayTracerScene
+
+    Args:
+        path (str): Path to the scene cache
+        key (int): If not 0, only load the cache if it was saved with this key
+        use_precise (bool): Use a slower but more accurate ray intersection method where applicable
+        build_quality (int): Quality of the BVH to build. 0 for low, 1 for medium, 2 for high.
+
+    Returns:
+        c_void_p: A pointer to the newly created BVH
+
+    Raises:
+        FileNotFoundException: No file exists at path
+        HFException: The file at path isn't a valid scene cache or doesn't match key
+    """
+
+    rt_ptr = c_void_p(0)
+    error_code = HFPython.LoadRaytracerScene(
+        GetStringPtr(path), c_uint64(key), c_bool(use_precise), c_int(build_quality), byref(rt_ptr)
+    )
+
+    if error_code == HF_STATUS.NOT_FOUND:
+        raise FileNotFoundException
+    elif error_code == HF_STATUS.GENERIC_ERROR:
+        raise HFException(f"{path} is not a valid scene cache for this key")
+
+    assert error_code == HF_STATUS.OK
+
+    return rt_ptr
+
 def DestroyRayTracer(rt_ptr: c_void_p):
     """ Call the destructor for a raytracer """
     HFPython.DestroyRayTracer(rt_ptr)
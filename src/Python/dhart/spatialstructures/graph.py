@@ -2,7 +2,6 @@ import ctypes
 import numpy
 from numpy.lib import recfunctions as rfn
 from scipy.sparse import csr_matrix
-from scipy.spatial.distance import cdist
 from ctypes import c_float, c_int, c_void_p
 from typing import *
 from enum import IntEnum
@@ -264,7 +263,9 @@ class Graph:
         Note
         ----
 
-        In future this should be calling a method in C interface instead of implemented in Python
+        Uses a spatial index built over the graph's nodes the first time it's
+        needed, so snapping many points at once is much faster than calling
+        this once per point.
 
         Examples
         --------
@@ -313,18 +314,116 @@ class Graph:
 
         """
 
-        # if this is one point, wrap in a list
-        if len(p_desired.shape) == 1:
-            p_desired=[p_desired]
-            # Get the closest node to the point 
-            closest_nodes = cdist(p_desired, self.get_node_points(x=x, y=y, z=z)).argmin()
+        p_desired = numpy.asarray(p_desired)
+        closest_nodes, _ = spatial_structures_native_functions.C_GetClosestNodes(
+            self.graph_ptr, p_desired, x, y, z
+        )
 
-        else:
-            # Get the closest node to the point and return array
-            closest_nodes = cdist(p_desired, self.get_node_points(x=x, y=y, z=z)).argmin(axis=1)
+        # if this is one point, return a single id
+        if len(p_desired.shape) == 1:
+            return closest_nodes[0]
 
         return closest_nodes
 
+    def get_k_nearest_nodes(self, p_desired, k, x=True, y=True, z=True):
+        """ Get the k closest nodes to the input set of points
+
+        Parameters
+        ----------
+
+        p_desired : ndarray
+            n x m shape where n is the number of points an m is equal to the axis set to True
+        k : int
+            Number of nodes to find for each point
+        x : bool, optional
+            Include x axis in the distance comparison, Default True
+        y : bool, optional
+            Include y axis in the distance comparison, Default True
+        z : bool, optional
+            Include z axis in the distance comparison, Default True
+
+        Returns
+        -------
+
+        Tuple[ndarray[int], ndarray[float]]
+            n x k arrays of the ids of the closest nodes to each point sorted
+            from nearest to furthest, and the distance to each of those nodes.
+            If the graph has fewer than k nodes, remaining ids are -1 and
+            remaining distances are NaN.
+
+        Raises
+        ------
+
+        dhart.Exceptions.OutOfRangeException
+            k was less than 1
+
+        Examples
+        --------
+
+        >>> import numpy as np
+        >>> from dhart.spatialstructures import Graph
+
+        >>> g = Graph()
+        >>> g.AddEdgeToGraph((0, 0, 0), (1, 0, 0), 1)
+        >>> g.AddEdgeToGraph((0, 0, 0), (3, 0, 0), 3)
+        >>> ids, distances = g.get_k_nearest_nodes(np.array([[0.9, 0, 0]]), 2)
+        >>> print(ids, distances)
+        [[1 0]] [[0.1 0.9]]
+
+        """
+
+        return spatial_structures_native_functions.C_GetKNearestNodes(
+            self.graph_ptr, numpy.asarray(p_desired), k, x, y, z
+        )
+
+    def get_nodes_within_radius(self, p_desired, radius, x=True, y=True, z=True):
+        """ Get every node within a radius of each point in the input set of points
+
+        Parameters
+        ----------
+
+        p_desired : ndarray
+            n x m shape where n is the number of points an m is equal to the axis set to True
+        radius : float
+            Maximum distance from each point
+        x : bool, optional
+            Include x axis in the distance comparison, Default True
+        y : bool, optional
+            Include y axis in the distance comparison, Default True
+        z : bool, optional
+            Include z axis in the distance comparison, Default True
+
+        Returns
+        -------
+
+        List[Tuple[ndarray[int], ndarray[float]]]
+            For each point, the ids of every node within radius of it sorted
+            from nearest to furthest, and the distance to each of those nodes.
+
+        Examples
+        --------
+
+        >>> import numpy as np
+        >>> from dhart.spatialstructures import Graph
+
+        >>> g = Graph()
+        >>> g.AddEdgeToGraph((0, 0, 0), (1, 0, 0), 1)
+        >>> g.AddEdgeToGraph((0, 0, 0), (3, 0, 0), 3)
+        >>> in_range = g.get_nodes_within_radius(np.array([[0.9, 0, 0]]), 1)
+        >>> print(in_range[0][0])
+        [1 0]
+
+        """
+
+        offsets, ids, distances = spatial_structures_native_functions.C_GetNodesWithinRadius(
+            self.graph_ptr, numpy.asarray(p_desired), radius, x, y, z
+        )
+
+        return [
+            (ids[offsets[i]:offsets[i + 1]], distances[offsets[i]:offsets[i + 1]])
+            for i in range(len(offsets) - 1)
+        ]
+
     def get_closest_points():
         """ 
             Get the closest point in the graph to the input set of points
@@ -398,6 +497,58 @@ class Graph:
         """
         spatial_structures_native_functions.C_ClearGraph(self.graph_ptr, cost_type)
 
+    def save(self, path: str):
+        """ Save this graph to a binary file
+
+        The file contains the graph's nodes, edges, alternate cost types, and
+        node attributes, and can be loaded much faster than the graph could
+        be regenerated or rebuilt from json.
+
+        Args:
+            path : str
+                Path to write the graph to. Any existing file will be overwritten.
+
+        Raises:
+            dhart.Exceptions.FileNotFoundException:
+                The file at path couldn't be written.
+
+        Examples:
+            Save a graph then load it back
+
+           >>> from dhart.spatialstructures import Graph
+           >>> g = Graph()
+           >>> g.AddEdgeToGraph(0, 1, 100)
+           >>> g.AddEdgeToGraph(0, 2, 50)
+           >>> g.CompressToCSR()
+           >>> g.save("graph.dhg")
+           >>> loaded = Graph.load("graph.dhg")
+           >>> loaded.GetEdgeCost(0, 1)
+           100.0
+
+        """
+        spatial_structures_native_functions.C_SaveGraph(self.graph_ptr, path)
+
+    @staticmethod
+    def load(path: str) -> "Graph":
+        """ Load a graph from a file written by Graph.save
+
+        Args:
+            path : str
+                Path to the graph file.
+
+        Returns:
+            Graph: The graph stored in the file, including its alternate cost
+            types and node attributes.
+
+        Raises:
+            dhart.Exceptions.FileNotFoundException:
+                No file exists at path.
+            dhart.Exceptions.HFException:
+                The file at path isn't a valid graph file.
+
+        """
+        return Graph(spatial_structures_native_functions.C_LoadGraph(path))
+
     def ConvertToLists(self, just_nodes = False) -> Tuple[List[Tuple], List[Tuple]]:
         """ Convert the CSR to a list of nodes and tuples, useful for serialization """
         
@@ -640,6 +791,67 @@ class Graph:
             self.graph_ptr, attribute, self.NumNodes(), ids
         )
 
+    def get_node_attribute_array(self, attribute: str) -> Union[numpy.ndarray, None]:
+        """ Get a numpy array that reads the values of a numeric node attribute directly from C++
+
+        Unlike get_node_attributes, no values are copied, which makes this
+        much faster for large graphs.
+
+        Args:
+            attribute : str
+                Unique key of the attribute to get.
+
+        Returns:
+            numpy.ndarray or None: The values of the attribute ordered by node
+            ID, or None if the attribute is stored as strings. Nodes without a
+            value read as 0. The array is only valid until an attribute of the
+            graph is modified or the graph is destroyed; copy it to keep it
+            longer.
+
+        Raises:
+            KeyError : The attribute doesn't exist in the graph.
+
+        Examples:
+           >>> import numpy as np
+           >>> from dhart.spatialstructures import Graph
+           >>> g = Graph()
+           >>> g.AddEdgeToGraph(0, 1, 100)
+           >>> g.AddEdgeToGraph(0, 2, 50)
+           >>> g.AddEdgeToGraph(1, 2, 20)
+           >>> g.CompressToCSR()
+           >>> g.set_node_attribute_array("score", np.array([0.5, 1.5, 2.5]))
+           >>> g.get_node_attribute_array("score")
+           array([0.5, 1.5, 2.5], dtype=float32)
+
+        """
+        return spatial_structures_native_functions.C_GetNodeAttributeArray(
+            self.graph_ptr, attribute
+        )
+
+    def set_node_attribute_array(self, attribute: str, values: numpy.ndarray):
+        """ Replace the values of a node attribute for every node in the graph at once
+
+        This copies the whole array into the graph in a single block, so it's
+        much faster than add_node_attributes for writing one value per node,
+        such as the results of an analysis.
+
+        Args:
+            attribute : str
+                Unique key of the attribute to set. Any existing values for
+                this attribute will be replaced.
+            values : numpy.ndarray
+                Values ordered by node ID. Bool arrays are stored as bools,
+                integer arrays as ints, and anything else as floats.
+
+        Raises:
+            dhart.Exceptions.OutOfRangeException : values has more elements
+                than there are nodes in the graph.
+
+        """
+        spatial_structures_native_functions.C_SetNodeAttributeArray(
+            self.graph_ptr, attribute, values
+        )
+
     def clear_node_attribute(self, attribute: str):
         """ Clear a node attribute and all of its scores from the graph
 
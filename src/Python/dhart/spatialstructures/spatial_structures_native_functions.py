@@ -1,6 +1,7 @@
 from ctypes import *
 from dhart.Exceptions import *
 from typing import *
+import numpy
 from numpy import (
     ndarray,
     float32,
@@ -593,6 +594,84 @@ def c_get_node_attributes(
     return out_vals
 
 
+# Numpy dtypes for every NODE_ATTRIBUTE_TYPE in C++, in order
+_attribute_dtypes = [numpy.float32, numpy.int32, numpy.bool_]
+
+def C_GetNodeAttributeArray(graph_ptr: c_void_p, attr: str) -> Union[ndarray, None]:
+    """ Get a numpy array that maps directly to the values of a numeric node attribute in C++
+
+    Args:
+        graph_ptr : Pointer to the graph to get the attribute from
+        attr : Unique key of the attribute to get
+
+    Returns:
+        A numpy array of the attribute's values ordered by node ID, or None if
+        the attribute is stored as strings. No values are copied, so the array
+        is only valid until an attribute of the graph is modified or the graph
+        is destroyed.
+
+    Raises:
+        KeyError: The attribute doesn't exist in the graph
+    """
+
+    attr_ptr = GetStringPtr(attr)
+    out_type = c_int(0)
+    out_values = c_void_p(0)
+    out_assigned = c_void_p(0)
+    out_size = c_int(0)
+
+    error_code = HFPython.GetNodeAttributePointers(
+        graph_ptr, attr_ptr, byref(out_type), byref(out_values), byref(out_assigned), byref(out_size)
+    )
+
+    if error_code == HF_STATUS.NOT_FOUND:
+        raise KeyError(f"{attr} is not an attribute of the graph")
+
+    assert error_code == HF_STATUS.OK
+
+    # Strings can't be mapped to numpy
+    if out_type.value >= len(_attribute_dtypes):
+        return None
+    if out_size.value == 0:
+        return numpy.empty(0, dtype=_attribute_dtypes[out_type.value])
+
+    c_type = numpy.ctypeslib.as_ctypes_type(_attribute_dtypes[out_type.value])
+    values_ptr = cast(out_values, POINTER(c_type))
+    return numpy.ctypeslib.as_array(values_ptr, shape=(out_size.value,))
+
+def C_SetNodeAttributeArray(graph_ptr: c_void_p, attr: str, values: ndarray) -> None:
+    """ Replace the values of a node attribute for every node in the graph at once
+
+    Args:
+        graph_ptr : Pointer to the graph to set the attribute in
+        attr : Unique key of the attribute to set
+        values : Array of values ordered by node ID. The attribute is stored
+            as floats, ints, or bools depending on the array's dtype. Any
+            other dtype is converted to float.
+
+    Raises:
+        OutOfRangeException: values contains more elements than there are nodes in the graph
+    """
+
+    values = numpy.asarray(values)
+    if values.dtype == numpy.bool_:
+        type_index = 2
+    elif numpy.issubdtype(values.dtype, numpy.integer):
+        type_index = 1
+    else:
+        type_index = 0
+    values = numpy.ascontiguousarray(values, dtype=_attribute_dtypes[type_index])
+
+    attr_ptr = GetStringPtr(attr)
+    error_code = HFPython.SetNodeAttributeColumn(
+        graph_ptr, attr_ptr, c_int(type_index), values.ctypes.data_as(c_void_p), c_int(values.size)
+    )
+
+    if error_code == HF_STATUS.OUT_OF_RANGE:
+        raise OutOfRangeException(f"Tried to set {values.size} values for {attr}, but the graph has fewer nodes")
+
+    assert error_code == HF_STATUS.OK
+
 def c_add_node_attributes(
     graph_ptr: c_void_p, attr: str, ids: List[int], scores: Union[List[str], List[float]]
     ) -> None:
@@ -702,6 +781,205 @@ def C_AttrsToCosts(
     assert error_code == HF_STATUS.OK
 
 
+def C_SaveGraph(graph_ptr: c_void_p, path: str) -> None:
+    """ Save a graph to a binary file
+
+    Args:
+        graph_ptr (c_void_p): Pointer to the graph to save
+        path (str): Path to write the graph to. Any existing file will be overwritten.
+
+    Raises:
+        FileNotFoundException: The file at path couldn't be written
+    """
+
+    path_ptr = GetStringPtr(path)
+    error_code = HFPython.SaveGraph(graph_ptr, path_ptr)
+
+    if error_code == HF_STATUS.NOT_FOUND:
+        raise FileNotFoundException
+
+    assert error_code == HF_STATUS.OK
+
+def C_LoadGraph(path: str) -> c_void_p:
+    """ Load a graph from a file written by C_SaveGraph
+
+    Args:
+        path (str): Path to the graph file
+
+    Returns:
+        c_void_p: A pointer to the loaded graph in C++
+
+    Raises:
+        FileNotFoundException: No file exists at path
+        HFException: The file at path isn't a valid graph file
+    """
+
+    path_ptr = GetStringPtr(path)
+    graph_ptr = c_void_p()
+    error_code = HFPython.LoadGraph(path_ptr, byref(graph_ptr))
+
+    if error_code == HF_STATUS.NOT_FOUND:
+        raise FileNotFoundException
+    elif error_code == HF_STATUS.GENERIC_ERROR:
+        raise HFException(f"{path} is not a valid graph file")
+
+    assert error_code == HF_STATUS.OK
+
+    return graph_ptr
+
+
+def _points_to_array(points: ndarray, num_axes: int) -> ndarray:
+    """ Convert points to a contiguous n x num_axes float32 array for C++ """
+    points = numpy.ascontiguousarray(points, dtype=float32)
+    return points.reshape(-1, num_axes)
+
+def C_GetClosestNodes(
+    graph_ptr: c_void_p, points: ndarray, x: bool, y: bool, z: bool
+) -> Tuple[ndarray, ndarray]:
+    """ Find the closest node in the graph to every point in points
+
+    Args:
+        graph_ptr (c_void_p): Pointer to the graph to search
+        points (ndarray): n x m array of points where m is the number of axes set to True
+        x (bool): Include the x axis in distance calculations
+        y (bool): Include the y axis in distance calculations
+        z (bool): Include the z axis in distance calculations
+
+    Returns:
+        Tuple[ndarray, ndarray]: The ID of the closest node to each point, and the
+        distance to that node. IDs are -1 if the graph has no nodes.
+    """
+
+    points = _points_to_array(points, int(x) + int(y) + int(z))
+    num_points = points.shape[0]
+
+    out_ids = numpy.empty(num_points, dtype=int32)
+    out_distances = numpy.empty(num_points, dtype=float32)
+
+    error_code = HFPython.GetClosestNodes(
+        graph_ptr,
+        points.ctypes.data_as(POINTER(c_float)),
+        c_int(num_points),
+        c_bool(x),
+        c_bool(y),
+        c_bool(z),
+        out_ids.ctypes.data_as(POINTER(c_int)),
+        out_distances.ctypes.data_as(POINTER(c_float)),
+    )
+
+    assert error_code == HF_STATUS.OK
+
+    return out_ids, out_distances
+
+def C_GetKNearestNodes(
+    graph_ptr: c_void_p, points: ndarray, k: int, x: bool, y: bool, z: bool
+) -> Tuple[ndarray, ndarray]:
+    """ Find the k closest nodes in the graph to every point in points
+
+    Args:
+        graph_ptr (c_void_p): Pointer to the graph to search
+        points (ndarray): n x m array of points where m is the number of axes set to True
+        k (int): Number of nodes to find for each point
+        x (bool): Include the x axis in distance calculations
+        y (bool): Include the y axis in distance calculations
+        z (bool): Include the z axis in distance calculations
+
+    Returns:
+        Tuple[ndarray, ndarray]: n x k arrays of the IDs of the closest nodes to each point,
+        sorted from nearest to furthest, and the distance to each of those nodes. If the graph
+        has fewer than k nodes, remaining IDs are -1 and remaining distances are NaN.
+
+    Raises:
+        OutOfRangeException: k was less than 1
+    """
+
+    points = _points_to_array(points, int(x) + int(y) + int(z))
+    num_points = points.shape[0]
+
+    out_ids = numpy.empty((num_points, k), dtype=int32)
+    out_distances = numpy.empty((num_points, k), dtype=float32)
+
+    error_code = HFPython.GetKNearestNodes(
+        graph_ptr,
+        points.ctypes.data_as(POINTER(c_float)),
+        c_int(num_points),
+        c_int(k),
+        c_bool(x),
+        c_bool(y),
+        c_bool(z),
+        out_ids.ctypes.data_as(POINTER(c_int)),
+        out_distances.ctypes.data_as(POINTER(c_float)),
+    )
+
+    if error_code == HF_STATUS.OUT_OF_RANGE:
+        raise OutOfRangeException(f"k must be at least 1, but was {k}")
+
+    assert error_code == HF_STATUS.OK
+
+    return out_ids, out_distances
+
+def C_GetNodesWithinRadius(
+    graph_ptr: c_void_p, points: ndarray, radius: float, x: bool, y: bool, z: bool
+) -> Tuple[ndarray, ndarray, ndarray]:
+    """ Find every node in the graph within radius of every point in points
+
+    Args:
+        graph_ptr (c_void_p): Pointer to the graph to search
+        points (ndarray): n x m array of points where m is the number of axes set to True
+        radius (float): Maximum distance from each point
+        x (bool): Include the x axis in distance calculations
+        y (bool): Include the y axis in distance calculations
+        z (bool): Include the z axis in distance calculations
+
+    Returns:
+        Tuple[ndarray, ndarray, ndarray]: n + 1 offsets, the IDs of every node in range,
+        and the distance to each of those nodes. Nodes in range of the point at index i
+        are stored between offsets[i] and offsets[i + 1], sorted from nearest to furthest.
+    """
+
+    points = _points_to_array(points, int(x) + int(y) + int(z))
+    num_points = points.shape[0]
+
+    offsets_vector, offsets_data = c_void_p(0), POINTER(c_int)()
+    ids_vector, ids_data = c_void_p(0), POINTER(c_int)()
+    distances_vector, distances_data = c_void_p(0), POINTER(c_float)()
+    out_size = c_int(0)
+
+    error_code = HFPython.GetNodesWithinRadius(
+        graph_ptr,
+        points.ctypes.data_as(POINTER(c_float)),
+        c_int(num_points),
+        c_float(radius),
+        c_bool(x),
+        c_bool(y),
+        c_bool(z),
+        byref(offsets_vector),
+        byref(offsets_data),
+        byref(ids_vector),
+        byref(ids_data),
+        byref(distances_vector),
+        byref(distances_data),
+        byref(out_size),
+    )
+
+    assert error_code == HF_STATUS.OK
+
+    # Copy the results into numpy, then free the C++ vectors
+    offsets = numpy.ctypeslib.as_array(offsets_data, shape=(num_points + 1,)).copy()
+    if out_size.value > 0:
+        ids = numpy.ctypeslib.as_array(ids_data, shape=(out_size.value,)).copy()
+        distances = numpy.ctypeslib.as_array(distances_data, shape=(out_size.value,)).copy()
+    else:
+        ids = numpy.empty(0, dtype=int32)
+        distances = numpy.empty(0, dtype=float32)
+
+    HFPython.DestroyIntVector(offsets_vector)
+    HFPython.DestroyIntVector(ids_vector)
+    HFPython.DestroyFloatVector(distances_vector)
+
+    return offsets, ids, distances
+
+
 
 
 ### Destructors
@@ -1,4 +1,4 @@
-from ctypes import c_void_p
+from ctypes import c_void_p, cast, POINTER
 from typing import *
 from enum import Enum
 
@@ -6,14 +6,14 @@ import numpy as np
 
 from dhart.spatialstructures import NodeList
 from dhart.spatialstructures.node import CreateListOfNodeStructs
-from dhart.raytracer import EmbreeBVH, RayResultList
+from dhart.raytracer import EmbreeBVH, RayResultList, ResultStruct
 
 from . import viewanalysis_native_functions
 from .view_analysis_scores import ViewAnalysisAggregates, ViewAnalysisDirections
 
 from .. import utils
 
-__all__ = ['AggregationType','SphericalViewAnalysisAggregate','SphericalViewAnalysis','SphericallyDistributeRays']
+__all__ = ['AggregationType','SphericalViewAnalysisAggregate','SphericalViewAnalysis','SphericalViewAnalysisChunks','SphericallyDistributeRays']
 
 class AggregationType(Enum):
     """ Aggregation method to use for view analysis """
@@ -181,6 +181,91 @@ def SphericalViewAnalysis(
     return RayResultList(score_vector_ptr, score_data_ptr, size, ray_count)
 
 
+def SphericalViewAnalysisChunks(
+    bvh: EmbreeBVH,
+    nodes: List[Tuple[float, float, float]],
+    ray_count: int,
+    height: float,
+    chunk_size: int = 1024,
+    upward_fov=50,
+    downward_fov=70,
+) -> Iterator[Tuple[int, np.ndarray]]:
+    """ Conduct view analysis on every node in nodes, yielding the result of every ray cast
+    one chunk of nodes at a time
+
+    Identical to SphericalViewAnalysis, but only the results of chunk_size nodes are held
+    in memory at once, so results for very large sets of nodes can be written to disk or
+    summarized as they're calculated. Rays for each chunk are only cast once the
+    previous chunk has been consumed.
+
+    Args:
+        bvh: the BVH for the geometry you're shooting at
+        nodes: A list of tuples containing x,y,z coordinates of points to analyze
+        ray_count: Amount of rays to shoot, evenly distributed in a sphere around the center
+        height: height to offset nodes from the ground in meters
+        chunk_size: Maximum number of nodes in each chunk
+        upward_fov: maximum angle up from the user's eyelevel to be considred
+        downward_fov: maximum angle down from the user's eyelevel  to be considred
+
+    Yields:
+        int: The index of the first node in this chunk
+        np.ndarray: Results of shape (number of nodes in chunk, actual ray count), with
+            the same fields as SphericalViewAnalysis
+
+    Raises:
+        OutOfRangeException: chunk_size was less than 1
+
+    Examples:
+
+        Sum the number of hits for every node, two nodes at a time
+
+        >>> from dhart.geometry import CommonRotations
+        >>> from dhart.raytracer import EmbreeBVH
+        >>> from dhart.geometry.mesh_info import ConstructPlane
+        >>> from dhart.viewanalysis import SphericalViewAnalysisChunks
+
+        >>> MI = ConstructPlane()
+        >>> MI.Rotate(CommonRotations.Zup_to_Yup)
+        >>> BVH = EmbreeBVH(MI)
+        >>> origins = [(0,0,1), (1,0,1), (2,0,50)]
+        >>> for start, results in SphericalViewAnalysisChunks(BVH, origins, 10, 1.7, chunk_size=2):
+        ...     print(start, (results['distance'] > 0).sum(axis=1))
+        0 [2 2]
+        2 [0]
+
+    """
+
+    # If the input was a single point make it a list
+    if utils.is_point(nodes):
+        nodes = [nodes]
+
+    np_nodes = np.asarray(nodes, dtype=np.float32).reshape(-1, 3)
+    stream_ptr, num_rays = viewanalysis_native_functions.C_CreateViewAnalysisStream(
+        bvh.pointer,
+        np_nodes.ctypes.data_as(c_void_p),
+        len(np_nodes),
+        ray_count,
+        height,
+        chunk_size,
+        upper_fov=upward_fov,
+        lower_fov=downward_fov,
+    )
+
+    try:
+        while True:
+            results_ptr, start, count = viewanalysis_native_functions.C_ViewAnalysisStreamNext(stream_ptr)
+            if count == 0:
+                break
+
+            # Copy the results since the stream will overwrite them for the next chunk
+            results = np.ctypeslib.as_array(
+                cast(results_ptr, POINTER(ResultStruct)), shape=(count * num_rays,)
+            )
+            yield start, results.reshape(count, num_rays).copy()
+    finally:
+        viewanalysis_native_functions.C_DestroyViewAnalysisStream(stream_ptr)
+
+
 def SphericallyDistributeRays(num_rays: int, upward_fov : float = 50, downward_fov: float = 70) -> ViewAnalysisDirections:
     """ Distribute directions evenly in a sphere. 
     
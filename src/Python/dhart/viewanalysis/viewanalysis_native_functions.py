@@ -82,6 +82,75 @@ def C_SphericalViewAnalysis(bvh: c_void_p, nodes: c_void_p, node_count: int,
     return (result_vector_ptr, result_data_ptr, num_rays.value)
 
 
+def C_CreateViewAnalysisStream(
+    bvh: c_void_p,
+    nodes: c_void_p,
+    node_count: int,
+    ray_count: int,
+    height: float,
+    chunk_size: int,
+    upper_fov=50,
+    lower_fov=70,
+) -> Tuple[c_void_p, int]:
+    """ Start a view analysis that is calculated in chunks of nodes
+
+    Args:
+        nodes: Pointer to node_count * 3 floats
+
+    Returns:
+        c_void_p: Pointer to the stream in C++
+        int: The actual number of rays cast from each node
+
+    Raises:
+        OutOfRangeException: chunk_size was less than 1
+    """
+    stream_ptr = c_void_p(0)
+    num_rays = c_int(ray_count)
+
+    error_code = HFPython.CreateViewAnalysisStream(
+        bvh,
+        nodes,
+        c_int(node_count),
+        byref(num_rays),
+        c_float(upper_fov),
+        c_float(lower_fov),
+        c_float(height),
+        c_int(chunk_size),
+        byref(stream_ptr),
+    )
+
+    if error_code == HF_STATUS.OUT_OF_RANGE:
+        raise OutOfRangeException
+    assert error_code == HF_STATUS.OK
+
+    return stream_ptr, num_rays.value
+
+
+def C_ViewAnalysisStreamNext(stream_ptr: c_void_p) -> Tuple[c_void_p, int, int]:
+    """ Analyze the next chunk of nodes in a view analysis stream
+
+    Returns:
+        c_void_p: Pointer to the results of the chunk. Owned by the stream and
+            overwritten by the next call to this function.
+        int: Index of the first node in the chunk
+        int: Number of nodes in the chunk. 0 once every node has been analyzed.
+    """
+    results_ptr = c_void_p(0)
+    start = c_int(0)
+    count = c_int(0)
+
+    error_code = HFPython.ViewAnalysisStreamNext(
+        stream_ptr, byref(results_ptr), byref(start), byref(count)
+    )
+    assert error_code == HF_STATUS.OK
+
+    return results_ptr, start.value, count.value
+
+
+def C_DestroyViewAnalysisStream(stream_ptr: c_void_p):
+    HFPython.DestroyViewAnalysisStream(stream_ptr)
+
+
 def C_DistributeSpherical(
     num_rays: int, upper_fov=50, lower_fov=70
 ) -> Tuple[c_void_p, c_void_p]:
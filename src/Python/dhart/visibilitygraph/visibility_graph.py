@@ -8,7 +8,13 @@ from . import visibility_graph_native_functions
 __all__ = ['VisibilityGraphAllToAll','VisibilityGraphUndirectedAllToAll','VisibilityGraphGroupToGroup']
 
 def VisibilityGraphAllToAll(
-    bvh: EmbreeBVH, nodes: List[Tuple[float, float, float]], height: float
+    bvh: EmbreeBVH,
+    nodes: List[Tuple[float, float, float]],
+    height: float,
+    max_distance: float = -1,
+    fov: float = 360,
+    view_directions: Union[List[Tuple[float, float, float]], None] = None,
+    cores: int = -1,
 ) -> Graph:
 
     """ Construct a directed visibility graph using all nodes in nodes
@@ -19,6 +25,21 @@ def VisibilityGraphAllToAll(
     Args:
         bvh: A pointer to a valid BVH object. 
         nodes: a list of nodes,
+        height: height to evaluate the visibility graph from
+        max_distance: If greater than zero, nodes further apart than this
+            will never be connected. Nodes are placed in a spatial grid so
+            only nearby pairs are checked, making this suitable for large
+            sets of nodes.
+        fov: If less than 360, nodes will only connect to nodes within a
+            cone of this many degrees around their view direction.
+        view_directions: Directions nodes are looking in. Either a single
+            direction for every node, or one direction per node. Required
+            if fov is less than 360.
+        cores: number of cores to use when max_distance or fov are set.
+            -1 will use all available cores.
+
+    Raises:
+        OutOfRangeException: view_directions was the wrong size
 
     
     Example:
@@ -43,9 +64,14 @@ def VisibilityGraphAllToAll(
 
 
     """
-    graph_ptr = visibility_graph_native_functions.C_VisibilityGraphAllToAll(
-        bvh.pointer, nodes, height
-    )
+    if max_distance > 0 or fov < 360:
+        graph_ptr = visibility_graph_native_functions.C_VisibilityGraphAllToAllCulled(
+            bvh.pointer, nodes, height, max_distance, fov, view_directions, cores
+        )
+    else:
+        graph_ptr = visibility_graph_native_functions.C_VisibilityGraphAllToAll(
+            bvh.pointer, nodes, height
+        )
     return Graph(graph_ptr)
 
 
@@ -54,6 +80,7 @@ def VisibilityGraphUndirectedAllToAll(
     nodes: List[Tuple[float, float, float]],
     height: float,
     cores: int = -1,
+    max_distance: float = -1,
 ) -> Graph:
     """ Construct visibility graph using all nodes in nodes
 
@@ -65,6 +92,8 @@ def VisibilityGraphUndirectedAllToAll(
         nodes: a list of nodes as (x,y,z) tuples
         height: height to evaluate the visibility graph from
         cores: number of cores to use in the evaluation. 0 will not be parallelized
+        max_distance: If greater than zero, nodes further apart than this
+            will never be connected, and only nearby pairs are checked.
 
     Example:
         Create a visibility graph between 3 nodes
@@ -89,9 +118,14 @@ def VisibilityGraphUndirectedAllToAll(
     Returns:
         Graph : An undirected graph created in C++
      """
-    graph_ptr = visibility_graph_native_functions.C_VisibilityGraphAlltoAllUndirected(
-        bvh.pointer, nodes, height, cores
-    )
+    if max_distance > 0:
+        graph_ptr = visibility_graph_native_functions.C_VisibilityGraphAllToAllUndirectedCulled(
+            bvh.pointer, nodes, height, max_distance, cores
+        )
+    else:
+        graph_ptr = visibility_graph_native_functions.C_VisibilityGraphAlltoAllUndirected(
+            bvh.pointer, nodes, height, cores
+        )
     return Graph(graph_ptr)
 
     
@@ -101,6 +135,9 @@ def VisibilityGraphGroupToGroup(
     group_b: List[Tuple[float, float, float]],
     height: float,
     cores: int = -1,
+    max_distance: float = -1,
+    fov: float = 360,
+    view_directions: Union[List[Tuple[float, float, float]], None] = None,
 ) -> Union[Graph, None]:
     """ Construct visibility graph between all nodes in group_a, and group_b
 
@@ -114,6 +151,16 @@ def VisibilityGraphGroupToGroup(
         group_b: a list of nodes as (x,y,z) tuples
         height: height to evaluate the visibility graph from
         cores: number of cores to use in the evaluation. 0 will not be parallelized
+        max_distance: If greater than zero, nodes further apart than this
+            will never be connected, and only nearby pairs are checked.
+        fov: If less than 360, nodes in group_a will only connect to nodes
+            within a cone of this many degrees around their view direction.
+        view_directions: Directions nodes in group_a are looking in. Either
+            a single direction, or one direction per node in group_a.
+            Required if fov is less than 360.
+
+    Raises:
+        OutOfRangeException: view_directions was the wrong size
     
     Examples:
         Create a new visibility graph from one group of nodes to another group of nodes
@@ -139,9 +186,14 @@ def VisibilityGraphGroupToGroup(
         Graph : An undirected graph created in C++
         None: If the given inputs produced a graph with no edges
      """
-    graph_ptr = visibility_graph_native_functions.C_VisibilityGraphGroupToGroup(
-        bvh.pointer, group_a, group_b, height, cores
-    )
+    if max_distance > 0 or fov < 360:
+        graph_ptr = visibility_graph_native_functions.C_VisibilityGraphGroupToGroupCulled(
+            bvh.pointer, group_a, group_b, height, max_distance, fov, view_directions, cores
+        )
+    else:
+        graph_ptr = visibility_graph_native_functions.C_VisibilityGraphGroupToGroup(
+            bvh.pointer, group_a, group_b, height, cores
+        )
     if graph_ptr:
         return Graph(graph_ptr)
     else:
@@ -84,3 +84,127 @@ def C_VisibilityGraphGroupToGroup(
         return graph_ptr
     else:
         return None
+
+
+def _view_directions_to_array(
+    view_directions: Union[List[Tuple[float, float, float]], None]
+) -> Tuple[Union[Array, None], int]:
+    """ Convert a list of view directions to a C array and its length """
+    if view_directions is None or len(view_directions) == 0:
+        return None, 0
+    return ConvertPointsToArray(view_directions), len(view_directions)
+
+
+def C_VisibilityGraphAllToAllCulled(
+    bvh: c_void_p,
+    nodes: List[Tuple[float, float, float]],
+    height: float,
+    max_distance: float,
+    fov: float = 360,
+    view_directions: Union[List[Tuple[float, float, float]], None] = None,
+    cores: int = -1,
+) -> c_void_p:
+    """ Create a directed visibility graph in C++ that only connects nodes
+        within max_distance and inside of each node's field of view
+
+    Raises:
+        OutOfRangeException: view_directions didn't contain 0, 1, or one
+            direction per node, or was empty while fov was less than 360.
+    """
+    num_nodes = len(nodes)
+    node_ptr = ConvertPointsToArray(nodes)
+    dir_ptr, num_dirs = _view_directions_to_array(view_directions)
+    graph_ptr = c_void_p(0)
+
+    error_code = HFPython.CreateVisibilityGraphAllToAllCulled(
+        bvh,
+        node_ptr,
+        c_int(num_nodes),
+        byref(graph_ptr),
+        c_float(height),
+        c_float(max_distance),
+        c_float(fov),
+        dir_ptr,
+        c_int(num_dirs),
+        c_int(cores),
+    )
+
+    if error_code == HF_STATUS.OUT_OF_RANGE:
+        raise OutOfRangeException
+    assert error_code == HF_STATUS.OK
+    return graph_ptr
+
+
+def C_VisibilityGraphAllToAllUndirectedCulled(
+    bvh: c_void_p,
+    nodes: List[Tuple[float, float, float]],
+    height: float,
+    max_distance: float,
+    cores: int = -1,
+) -> c_void_p:
+    """ Create an undirected visibility graph in C++ that only connects
+        nodes within max_distance of each other
+    """
+    num_nodes = len(nodes)
+    node_ptr = ConvertPointsToArray(nodes)
+    graph_ptr = c_void_p(0)
+
+    error_code = HFPython.CreateVisibilityGraphAllToAllUndirectedCulled(
+        bvh,
+        node_ptr,
+        c_int(num_nodes),
+        byref(graph_ptr),
+        c_float(height),
+        c_float(max_distance),
+        c_int(cores),
+    )
+
+    assert error_code == HF_STATUS.OK
+    return graph_ptr
+
+
+def C_VisibilityGraphGroupToGroupCulled(
+    bvh: c_void_p,
+    nodes_a: List[Tuple[float, float, float]],
+    nodes_b: List[Tuple[float, float, float]],
+    height: float,
+    max_distance: float,
+    fov: float = 360,
+    view_directions: Union[List[Tuple[float, float, float]], None] = None,
+    cores: int = -1,
+) -> Union[c_void_p, None]:
+    """ Create a visibility graph in C++ from nodes_a to the nodes in
+        nodes_b within max_distance and inside of each node's field of view
+
+        Returns none if no edges were produced
+
+    Raises:
+        OutOfRangeException: view_directions didn't contain 0, 1, or one
+            direction per node in nodes_a, or was empty while fov was less than 360.
+    """
+    node_a_ptr = ConvertPointsToArray(nodes_a)
+    node_b_ptr = ConvertPointsToArray(nodes_b)
+    dir_ptr, num_dirs = _view_directions_to_array(view_directions)
+    graph_ptr = c_void_p(0)
+
+    error_code = HFPython.CreateVisibilityGraphGroupToGroupCulled(
+        bvh,
+        node_a_ptr,
+        c_int(len(nodes_a)),
+        node_b_ptr,
+        c_int(len(nodes_b)),
+        byref(graph_ptr),
+        c_float(height),
+        c_float(max_distance),
+        c_float(fov),
+        dir_ptr,
+        c_int(num_dirs),
+        c_int(cores),
+    )
+
+    if error_code == HF_STATUS.OUT_OF_RANGE:
+        raise OutOfRangeException
+    if error_code == HF_STATUS.OK:
+        return graph_ptr
+    else:
+        return None